@@ -0,0 +1,213 @@
+/**
+ * @file LoRaGf256Bench.cpp
+ * @brief Throughput benchmark of the GF(256) kernels and the frame parity
+ * @date 2026-10-19
+ *
+ * For every kernel LoRaGf256 can run on this CPU, the benchmark first checks
+ * mulAddRegion() against the scalar kernel and then measures its throughput
+ * for each symbol size given with --sizes. Symbols of a few dozen bytes are
+ * what the per-frame parity uses; larger ones show the peak rate of a kernel.
+ *
+ * It then measures LoRaReedSolomon on maximum-size frames: encoding, and
+ * decoding with correctableBytes() damaged bytes per frame, once per kernel.
+ *
+ * Each measurement runs for --seconds. The exit code is 1 if a kernel
+ * disagrees with the scalar kernel or a decode fails, so the benchmark also
+ * serves as a test.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTextStream>
+#include <vector>
+#include "LoRaGf256.hpp"
+#include "LoRaReedSolomon.hpp"
+#include "LoRaUsbAdapter_E22_400T22U.hpp"
+
+namespace {
+
+/**
+ * @brief Kernels in the order they are reported
+ */
+const LoRaGf256::Kernel ALL_KERNELS[] = {LoRaGf256::Kernel::Scalar, LoRaGf256::Kernel::Ssse3,
+                                         LoRaGf256::Kernel::Avx2, LoRaGf256::Kernel::Neon};
+
+/**
+ * @brief Results of a loop run for a fixed time
+ */
+struct Rate {
+    double bytesPerSecond = 0.0; ///< Bytes processed per second
+    double nsPerCall = 0.0;      ///< Mean time of one call
+};
+
+/**
+ * @brief Calls a function repeatedly for the given time
+ * @param seconds Measurement time
+ * @param bytesPerCall Bytes processed by one call
+ * @param call Function to measure
+ */
+template <typename Call>
+Rate measure(double seconds, int bytesPerCall, Call call) {
+    // Warm up tables and caches before timing
+    for (int i = 0; i < 1000; ++i) {
+        call();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 budgetNs = static_cast<qint64>(seconds * 1e9);
+    quint64 calls = 0;
+    qint64 elapsedNs = 0;
+    do {
+        for (int i = 0; i < 1000; ++i) {
+            call();
+        }
+        calls += 1000;
+        elapsedNs = timer.nsecsElapsed();
+    } while (elapsedNs < budgetNs);
+
+    Rate rate;
+    rate.nsPerCall = static_cast<double>(elapsedNs) / static_cast<double>(calls);
+    rate.bytesPerSecond = static_cast<double>(bytesPerCall) * 1e9 / rate.nsPerCall;
+    return rate;
+}
+
+/**
+ * @brief Returns random bytes of the given size
+ */
+std::vector<quint8> randomBytes(QRandomGenerator &rng, int size) {
+    std::vector<quint8> bytes(static_cast<size_t>(size));
+    for (quint8 &byte : bytes) {
+        byte = static_cast<quint8>(rng.bounded(256));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Compares mulAddRegion() of the selected kernel with the scalar kernel
+ * @return true if they agree for every constant and the given sizes
+ */
+bool matchesScalar(LoRaGf256::Kernel kernel, QRandomGenerator &rng, const QList<int> &sizes) {
+    for (int size : sizes) {
+        const std::vector<quint8> src = randomBytes(rng, size);
+        const std::vector<quint8> initial = randomBytes(rng, size);
+        for (int c = 0; c < 256; ++c) {
+            std::vector<quint8> expected = initial;
+            std::vector<quint8> actual = initial;
+            LoRaGf256::setKernel(LoRaGf256::Kernel::Scalar);
+            LoRaGf256::mulAddRegion(expected.data(), src.data(), static_cast<quint8>(c), size);
+            LoRaGf256::setKernel(kernel);
+            LoRaGf256::mulAddRegion(actual.data(), src.data(), static_cast<quint8>(c), size);
+            if (actual != expected) return false;
+        }
+    }
+    return true;
+}
+
+QList<int> intList(const QString &value) {
+    QList<int> values;
+    for (const QString &item : value.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const int parsed = item.trimmed().toInt(&ok);
+        if (ok && parsed > 0) {
+            values.append(parsed);
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("LoRaGf256Bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Throughput of the GF(256) kernels and of the per-frame Reed-Solomon code");
+    parser.addHelpOption();
+    const QCommandLineOption sizesOpt("sizes", "Symbol sizes in bytes (comma-separated).", "list", "24,240,4096");
+    const QCommandLineOption secondsOpt("seconds", "Measurement time per result.", "s", "0.5");
+    const QCommandLineOption parityOpt("parity", "Parity bytes per frame for the Reed-Solomon results.", "n", "8");
+    for (const auto &opt : {sizesOpt, secondsOpt, parityOpt}) {
+        parser.addOption(opt);
+    }
+    parser.process(app);
+
+    const QList<int> sizes = intList(parser.value(sizesOpt));
+    const double seconds = qBound(0.001, parser.value(secondsOpt).toDouble(), 60.0);
+    const LoRaReedSolomon code(qMax(parser.value(parityOpt).toInt(), 2));
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (sizes.isEmpty()) {
+        err << "No symbol sizes\n";
+        return 1;
+    }
+
+    const LoRaGf256::Kernel defaultKernel = LoRaGf256::kernel();
+    QRandomGenerator rng(1);
+    std::vector<LoRaGf256::Kernel> kernels;
+    for (LoRaGf256::Kernel kernel : ALL_KERNELS) {
+        if (!LoRaGf256::isSupported(kernel)) continue;
+
+        if (!matchesScalar(kernel, rng, {1, 15, 16, 17, 31, 32, 33, 100})) {
+            err << "FAIL: " << LoRaGf256::kernelName(kernel) << " differs from the scalar kernel\n";
+            return 1;
+        }
+        kernels.push_back(kernel);
+    }
+    out << "Default kernel: " << LoRaGf256::kernelName(defaultKernel) << "\n\n";
+
+    out << "mulAddRegion    size      GB/s   ns/call\n";
+    for (LoRaGf256::Kernel kernel : kernels) {
+        LoRaGf256::setKernel(kernel);
+        for (int size : sizes) {
+            std::vector<quint8> dst = randomBytes(rng, size);
+            const std::vector<quint8> src = randomBytes(rng, size);
+            quint8 c = 0x53;
+            const Rate rate = measure(seconds, size, [&]() {
+                LoRaGf256::mulAddRegion(dst.data(), src.data(), c, size);
+                c = static_cast<quint8>(c * 5 + 1) | 1;
+            });
+            out << QString::asprintf("%-12s %7d %9.2f %9.1f\n", LoRaGf256::kernelName(kernel), size,
+                                     rate.bytesPerSecond / 1e9, rate.nsPerCall);
+        }
+    }
+
+    // Largest frame the parity covers: a full DATA_ACK frame
+    const int frameSize = static_cast<int>(LoRaUsbAdapter_E22_400T22U::FrameSize::MAX_FRAME_SIZE) +
+                          static_cast<int>(LoRaUsbAdapter_E22_400T22U::FrameSize::ACK_FIELD_SIZE);
+    std::vector<quint8> frameBytes = randomBytes(rng, frameSize);
+    const QByteArray frame(reinterpret_cast<const char *>(frameBytes.data()), frameSize);
+    const QByteArray codeword = frame + code.parity(frame);
+    QByteArray damaged = codeword;
+    for (int i = 0; i < code.correctableBytes(); ++i) {
+        damaged[i * 3] = static_cast<char>(damaged[i * 3] ^ 0x5A);
+    }
+
+    out << QString::asprintf("\nReed-Solomon, %d-byte frames, %d parity bytes, %d damaged bytes per decode\n",
+                             frameSize, code.parityBytes(), code.correctableBytes());
+    out << "kernel       encode MB/s  decode MB/s\n";
+    bool decoded = true;
+    for (LoRaGf256::Kernel kernel : kernels) {
+        LoRaGf256::setKernel(kernel);
+        QByteArray parity;
+        const Rate encode = measure(seconds, frameSize, [&]() { parity = code.parity(frame); });
+        const Rate decode = measure(seconds, frameSize, [&]() {
+            QByteArray received = damaged;
+            decoded = decoded && code.decode(received) == code.correctableBytes() && received == codeword;
+        });
+        out << QString::asprintf("%-12s %11.1f %12.1f\n", LoRaGf256::kernelName(kernel),
+                                 encode.bytesPerSecond / 1e6, decode.bytesPerSecond / 1e6);
+    }
+    LoRaGf256::setKernel(defaultKernel);
+
+    if (!decoded) {
+        err << "FAIL: damaged frames were not restored\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include "LoRaChannelSimulator.hpp"
+#include <QDebug>
+#include <QTimer>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+LoRaChannelSimulator::LoRaChannelSimulator(QObject *parent)
+    : QObject(parent)
+    , m_rng(m_config.seed)
+{
+    m_clock.start();
+}
+
+LoRaChannelSimulator::~LoRaChannelSimulator() {
+    close();
+}
+
+bool LoRaChannelSimulator::openPty(int &masterFd, int &slaveFd, QString &slavePath) {
+    masterFd = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0) return false;
+
+    if (::grantpt(masterFd) != 0 || ::unlockpt(masterFd) != 0) return false;
+
+    const char *name = ::ptsname(masterFd);
+    if (!name) return false;
+    slavePath = QString::fromLocal8Bit(name);
+
+    // Keep one slave descriptor open: without it the master reports a hangup
+    // whenever the worker closes its port
+    slaveFd = ::open(name, O_RDWR | O_NOCTTY);
+    if (slaveFd < 0) return false;
+
+    termios tio {};
+    if (::tcgetattr(slaveFd, &tio) != 0) return false;
+    ::cfmakeraw(&tio);
+    if (::tcsetattr(slaveFd, TCSANOW, &tio) != 0) return false;
+
+    const int flags = ::fcntl(masterFd, F_GETFL);
+    ::fcntl(masterFd, F_SETFL, flags | O_NONBLOCK);
+    return true;
+}
+
+bool LoRaChannelSimulator::openEndpoint(Endpoint &endpoint) {
+    return openPty(endpoint.masterFd, endpoint.slaveFd, endpoint.slavePath);
+}
+
+bool LoRaChannelSimulator::open() {
+    if (isOpen()) return true;
+
+    for (int i = 0; i < 2; ++i) {
+        if (!openEndpoint(m_endpoints[i])) {
+            qWarning() << "LoRaChannelSimulator: failed to create pty:" << strerror(errno);
+            close();
+            return false;
+        }
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        auto &endpoint = m_endpoints[i];
+        endpoint.notifier = std::make_unique<QSocketNotifier>(endpoint.masterFd, QSocketNotifier::Read);
+        connect(endpoint.notifier.get(), &QSocketNotifier::activated, this, [this, i]() { forward(i); });
+    }
+
+    m_rng.seed(m_config.seed);
+    m_inBurst = false;
+    m_stats = Stats{};
+    return true;
+}
+
+void LoRaChannelSimulator::close() {
+    for (auto &endpoint : m_endpoints) {
+        endpoint.notifier.reset();
+        if (endpoint.slaveFd >= 0) ::close(endpoint.slaveFd);
+        if (endpoint.masterFd >= 0) ::close(endpoint.masterFd);
+        endpoint.slaveFd = -1;
+        endpoint.masterFd = -1;
+        endpoint.slavePath.clear();
+        endpoint.busyUntilMs = 0;
+    }
+}
+
+bool LoRaChannelSimulator::isOpen() const {
+    return m_endpoints[0].masterFd >= 0 && m_endpoints[1].masterFd >= 0;
+}
+
+QString LoRaChannelSimulator::portA() const {
+    return m_endpoints[0].slavePath;
+}
+
+QString LoRaChannelSimulator::portB() const {
+    return m_endpoints[1].slavePath;
+}
+
+void LoRaChannelSimulator::setConfig(const Config &config) {
+    m_config = config;
+    m_config.airRateBps = qMax(m_config.airRateBps, 1);
+    m_rng.seed(m_config.seed);
+    m_inBurst = false;
+}
+
+LoRaChannelSimulator::Config LoRaChannelSimulator::config() const {
+    return m_config;
+}
+
+LoRaChannelSimulator::Stats LoRaChannelSimulator::stats() const {
+    return m_stats;
+}
+
+void LoRaChannelSimulator::resetStats() {
+    m_stats = Stats{};
+}
+
+double LoRaChannelSimulator::airtimeMs(int bytes, int airRateBps) {
+    return bytes * 8.0 * 1000.0 / qMax(airRateBps, 1);
+}
+
+void LoRaChannelSimulator::forward(int from) {
+    char buf[512];
+    const ssize_t n = ::read(m_endpoints[from].masterFd, buf, sizeof(buf));
+    if (n <= 0) return;
+
+    transmit(from, QByteArray(buf, static_cast<int>(n)));
+}
+
+void LoRaChannelSimulator::transmit(int from, QByteArray data) {
+    if (from != 0 && from != 1) return;
+
+    const double airtime = airtimeMs(data.size(), m_config.airRateBps);
+    m_stats.transmissions++;
+    m_stats.bytes += static_cast<quint64>(data.size());
+    m_stats.airtimeMs += airtime;
+
+    if (nextIsLost()) {
+        m_stats.dropped++;
+        emit transmitted(from, data, false);
+        return;
+    }
+    emit transmitted(from, data, true);
+
+    if (corrupt(data)) {
+        m_stats.corrupted++;
+    }
+
+    const int to = 1 - from;
+    auto &target = m_endpoints[to];
+    const qint64 now = m_clock.elapsed();
+    const qint64 deliverAt = qMax(now, target.busyUntilMs) + m_config.latencyMs +
+                             static_cast<qint64>(airtime * m_config.timeScale);
+    target.busyUntilMs = deliverAt;
+
+    if (deliverAt <= now) {
+        deliver(to, data);
+    } else {
+        QTimer::singleShot(static_cast<int>(deliverAt - now), this, [this, to, data]() { deliver(to, data); });
+    }
+}
+
+bool LoRaChannelSimulator::nextIsLost() {
+    // Two-state Gilbert-Elliott model
+    if (m_inBurst) {
+        if (m_rng.generateDouble() < m_config.burstExitRate) m_inBurst = false;
+    } else {
+        if (m_rng.generateDouble() < m_config.burstEnterRate) m_inBurst = true;
+    }
+
+    const double lossRate = m_inBurst ? m_config.burstLossRate : m_config.lossRate;
+    return m_rng.generateDouble() < lossRate;
+}
+
+bool LoRaChannelSimulator::corrupt(QByteArray &data) {
+    if (m_config.bitErrorRate <= 0.0) return false;
+
+    bool flipped = false;
+    for (int i = 0; i < data.size(); ++i) {
+        for (int bit = 0; bit < 8; ++bit) {
+            if (m_rng.generateDouble() < m_config.bitErrorRate) {
+                data[i] = static_cast<char>(data[i] ^ (1 << bit));
+                flipped = true;
+            }
+        }
+    }
+    return flipped;
+}
+
+void LoRaChannelSimulator::deliver(int to, const QByteArray &data) {
+    emit received(to, data);
+    const int fd = m_endpoints[to].masterFd;
+    if (fd < 0) return;
+
+    qint64 offset = 0;
+    while (offset < data.size()) {
+        const ssize_t n = ::write(fd, data.constData() + offset, static_cast<size_t>(data.size() - offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            // EAGAIN means the receiver is not draining its port: lose the
+            // rest like an overrun UART would, rather than blocking the loop
+            qWarning() << "LoRaChannelSimulator: write failed:" << strerror(errno);
+            return;
+        }
+        offset += n;
+    }
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <memory>
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QSocketNotifier>
+
+/**
+ * @file LoRaChannelSimulator.hpp
+ * @brief Header file for the LoRaChannelSimulator class
+ * @date 2026-10-18
+ */
+
+/**
+ * @class LoRaChannelSimulator
+ * @brief Simulated radio link between two pseudo-terminals
+ * @details Creates two pty pairs and forwards everything written to one slave
+ *          to the other, so two unmodified LoRaWorker instances can talk to
+ *          each other by opening portA() and portB() as serial ports.
+ *
+ *          Each read from a pty master is treated as one over-the-air
+ *          transmission. The adapter writes one frame at a time and waits
+ *          for it to be flushed, so a transmission is normally one frame.
+ *          Every transmission can be:
+ *          - Dropped, independently (Config::lossRate) or in bursts following
+ *            a two-state Gilbert-Elliott model (Config::burstEnterRate,
+ *            Config::burstExitRate)
+ *          - Corrupted by independent bit flips (Config::bitErrorRate)
+ *          - Delayed by a fixed latency plus its airtime at Config::airRateBps,
+ *            scaled by Config::timeScale
+ *
+ *          Airtime is always accounted in stats(), even when timeScale is 0,
+ *          so a test can run hours of virtual channel time in minutes.
+ *          Deliveries in one direction never overtake each other.
+ *
+ *          In-process radios such as LoRaE22Emulator use the channel without
+ *          pseudo-terminals: they call transmit() and listen to received().
+ *          open() is then not needed.
+ *
+ * @note Only available on platforms with POSIX pseudo-terminals.
+ */
+class LoRaChannelSimulator : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Config
+     * @brief Channel impairments and timing
+     */
+    struct Config {
+        double lossRate = 0.0;        ///< Probability of dropping a transmission in the good state
+        double burstEnterRate = 0.0;  ///< Probability of switching from the good to the bad (burst) state
+        double burstExitRate = 1.0;   ///< Probability of switching from the bad back to the good state
+        double burstLossRate = 1.0;   ///< Probability of dropping a transmission in the bad state
+        double bitErrorRate = 0.0;    ///< Probability of flipping each delivered bit
+        int airRateBps = 2400;        ///< Simulated air data rate in bits per second
+        int latencyMs = 0;            ///< Fixed latency added to every delivery
+        double timeScale = 0.0;       ///< Fraction of the airtime actually waited (0 = deliver at once)
+        quint32 seed = 1;             ///< Seed of the impairment random generator
+    };
+
+    /**
+     * @struct Stats
+     * @brief Channel counters since open() or resetStats()
+     */
+    struct Stats {
+        quint64 transmissions = 0;    ///< Number of transmissions
+        quint64 dropped = 0;          ///< Number of transmissions dropped
+        quint64 corrupted = 0;        ///< Number of transmissions delivered with bit errors
+        quint64 bytes = 0;            ///< Number of bytes transmitted
+        double airtimeMs = 0.0;       ///< Virtual channel time consumed by all transmissions
+    };
+
+    /**
+     * @brief Constructor for LoRaChannelSimulator
+     * @param parent Parent QObject for memory management (default: nullptr)
+     */
+    explicit LoRaChannelSimulator(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor, closes the pseudo-terminals
+     */
+    ~LoRaChannelSimulator() override;
+
+    /**
+     * @brief Creates both pseudo-terminal pairs and starts forwarding
+     * @return true on success, false if a pty could not be created
+     */
+    bool open();
+
+    /**
+     * @brief Stops forwarding and closes the pseudo-terminals
+     */
+    void close();
+
+    /**
+     * @brief Returns whether the simulator is open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Returns the serial port name of endpoint A
+     */
+    QString portA() const;
+
+    /**
+     * @brief Returns the serial port name of endpoint B
+     */
+    QString portB() const;
+
+    /**
+     * @brief Replaces the channel configuration
+     * @param config New configuration; the random generator is reseeded
+     */
+    void setConfig(const Config &config);
+
+    /**
+     * @brief Returns the channel configuration
+     */
+    Config config() const;
+
+    /**
+     * @brief Returns the channel counters
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Clears the channel counters
+     */
+    void resetStats();
+
+    /**
+     * @brief Calculates the airtime of a transmission
+     * @param bytes Size of the transmission in bytes
+     * @param airRateBps Air data rate in bits per second
+     * @return Airtime in milliseconds
+     */
+    static double airtimeMs(int bytes, int airRateBps);
+
+    /**
+     * @brief Creates a pseudo-terminal pair in raw mode
+     * @param masterFd Output parameter for the non-blocking master descriptor
+     * @param slaveFd Output parameter for a slave descriptor kept open so the
+     *        master never hangs up
+     * @param slavePath Output parameter for the slave device path
+     * @return true on success; on failure the descriptors opened so far are
+     *         returned for the caller to close
+     */
+    static bool openPty(int &masterFd, int &slaveFd, QString &slavePath);
+
+public slots:
+    /**
+     * @brief Sends a transmission over the channel
+     * @param from Index of the sending endpoint (0 = A, 1 = B)
+     * @param data Bytes on the air
+     * @details Applies loss, corruption and delay like a transmission read
+     *          from a pseudo-terminal, then delivers it to the other endpoint.
+     */
+    void transmit(int from, QByteArray data);
+
+signals:
+    /**
+     * @brief Signal emitted for every transmission
+     * @param from Index of the sending endpoint (0 = A, 1 = B)
+     * @param data Bytes as written by the sender
+     * @param delivered False if the transmission was dropped
+     */
+    void transmitted(int from, const QByteArray &data, bool delivered);
+
+    /**
+     * @brief Signal emitted when a transmission reaches an endpoint
+     * @param to Index of the receiving endpoint (0 = A, 1 = B)
+     * @param data Bytes as delivered, with any bit errors
+     */
+    void received(int to, const QByteArray &data);
+
+private:
+    /**
+     * @struct Endpoint
+     * @brief One side of the simulated link
+     */
+    struct Endpoint {
+        int masterFd = -1;                          ///< Master side, used by the simulator
+        int slaveFd = -1;                           ///< Slave kept open so the master never hangs up
+        QString slavePath;                          ///< Slave device path, opened by the worker
+        std::unique_ptr<QSocketNotifier> notifier;  ///< Read notifier on the master
+        qint64 busyUntilMs = 0;                     ///< Time the last delivery towards this endpoint completes
+    };
+
+    /**
+     * @brief Creates one pseudo-terminal pair in raw mode
+     * @param endpoint Endpoint to initialise
+     * @return true on success
+     */
+    bool openEndpoint(Endpoint &endpoint);
+
+    /**
+     * @brief Reads a transmission from an endpoint's pseudo-terminal and transmits it
+     * @param from Index of the sending endpoint
+     */
+    void forward(int from);
+
+    /**
+     * @brief Decides whether the next transmission is lost
+     * @return true if it must be dropped
+     */
+    bool nextIsLost();
+
+    /**
+     * @brief Applies bit errors to a transmission
+     * @param data Transmission to corrupt in place
+     * @return true if at least one bit was flipped
+     */
+    bool corrupt(QByteArray &data);
+
+    /**
+     * @brief Writes a transmission to an endpoint
+     * @param to Index of the receiving endpoint
+     * @param data Bytes to deliver
+     */
+    void deliver(int to, const QByteArray &data);
+
+    /**
+     * @brief Both endpoints, A at index 0 and B at index 1
+     */
+    Endpoint m_endpoints[2];
+
+    /**
+     * @brief Channel configuration
+     */
+    Config m_config;
+
+    /**
+     * @brief Channel counters
+     */
+    Stats m_stats;
+
+    /**
+     * @brief Random generator for impairments
+     */
+    QRandomGenerator m_rng;
+
+    /**
+     * @brief Whether the Gilbert-Elliott model is in the bad state
+     */
+    bool m_inBurst = false;
+
+    /**
+     * @brief Clock for delivery scheduling
+     */
+    QElapsedTimer m_clock;
+};
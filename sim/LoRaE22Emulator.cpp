@@ -0,0 +1,368 @@
+#include "LoRaE22Emulator.hpp"
+#include "LoRaChannelSimulator.hpp"
+#include <QDebug>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Air data rates selected by REG0 bits 2-0, in bits per second
+ */
+constexpr int AIR_RATES_BPS[] = {300, 1200, 2400, 4800, 9600, 19200, 38400, 62500};
+
+/**
+ * @brief UART baud rates selected by REG0 bits 7-5
+ */
+constexpr int UART_BAUDS[] = {1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200};
+
+/**
+ * @brief Sub-packet sizes selected by REG1 bits 7-6, in bytes
+ */
+constexpr int SUB_PACKET_SIZES[] = {240, 128, 64, 32};
+
+/**
+ * @brief Fixed product information returned for the PID registers
+ */
+constexpr quint8 PRODUCT_INFO[LoRaE22Emulator::PID_SIZE] = {0x00, 0x22, 0x04, 0x00, 0x16, 0x00, 0x00};
+
+// CRC-16/CCITT-FALSE, standing in for the radio's payload CRC
+quint16 crc16(const QByteArray &data) {
+    quint16 crc = 0xFFFF;
+    for (quint8 byte : data) {
+        crc ^= static_cast<quint16>(byte) << 8;
+        for (int i = 0; i < 8; ++i) {
+            crc = (crc & 0x8000) ? static_cast<quint16>((crc << 1) ^ 0x1021) : static_cast<quint16>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+QByteArray errorReply() {
+    return QByteArray(3, static_cast<char>(0xFF));
+}
+
+QByteArray commandReply(quint8 address, const QByteArray &values) {
+    QByteArray reply;
+    reply.append(static_cast<char>(LoRaE22Emulator::CMD_READ));
+    reply.append(static_cast<char>(address));
+    reply.append(static_cast<char>(values.size()));
+    reply.append(values);
+    return reply;
+}
+
+} // namespace
+
+LoRaE22Emulator::LoRaE22Emulator(QObject *parent)
+    : QObject(parent)
+{
+    m_registers[REG0] = 0x62;  // 9600 baud, 8N1, 2.4 kbit/s
+    m_registers[REG1] = 0x00;  // 240-byte sub-packets, noise query off, 22 dBm
+    m_registers[REG2] = 0x17;  // Channel 23
+    m_registers[REG3] = 0x03;  // Transparent mode, 2000 ms wake-up cycle
+
+    m_uartIdleTimer.setSingleShot(true);
+    connect(&m_uartIdleTimer, &QTimer::timeout, this, &LoRaE22Emulator::pump);
+    m_airTimer.setSingleShot(true);
+    connect(&m_airTimer, &QTimer::timeout, this, &LoRaE22Emulator::pump);
+}
+
+LoRaE22Emulator::~LoRaE22Emulator() {
+    close();
+}
+
+bool LoRaE22Emulator::open() {
+    if (isOpen()) return true;
+
+    if (!LoRaChannelSimulator::openPty(m_masterFd, m_slaveFd, m_portName)) {
+        qWarning() << "LoRaE22Emulator: failed to create pty:" << strerror(errno);
+        close();
+        return false;
+    }
+    m_notifier = std::make_unique<QSocketNotifier>(m_masterFd, QSocketNotifier::Read);
+    connect(m_notifier.get(), &QSocketNotifier::activated, this, &LoRaE22Emulator::onHostData);
+
+    m_stats = Stats{};
+    m_txBuffer.clear();
+    m_commandBuffer.clear();
+    m_haveTarget = false;
+    return true;
+}
+
+void LoRaE22Emulator::close() {
+    m_notifier.reset();
+    if (m_slaveFd >= 0) ::close(m_slaveFd);
+    if (m_masterFd >= 0) ::close(m_masterFd);
+    m_slaveFd = -1;
+    m_masterFd = -1;
+    m_portName.clear();
+    m_uartIdleTimer.stop();
+    m_airTimer.stop();
+}
+
+bool LoRaE22Emulator::isOpen() const {
+    return m_masterFd >= 0;
+}
+
+QString LoRaE22Emulator::portName() const {
+    return m_portName;
+}
+
+void LoRaE22Emulator::link(LoRaChannelSimulator *channel, int endpoint) {
+    connect(this, &LoRaE22Emulator::airTransmit, channel, [channel, endpoint](const QByteArray &airPacket) {
+        channel->transmit(endpoint, airPacket);
+    });
+    connect(channel, &LoRaChannelSimulator::received, this, [this, endpoint](int to, const QByteArray &airPacket) {
+        if (to == endpoint) {
+            airReceive(airPacket);
+        }
+    });
+}
+
+void LoRaE22Emulator::setMode(Mode mode) {
+    m_mode = mode;
+    m_commandBuffer.clear();
+    pump();
+}
+
+LoRaE22Emulator::Mode LoRaE22Emulator::mode() const {
+    return m_mode;
+}
+
+bool LoRaE22Emulator::writeRegisters(quint8 address, const QByteArray &values) {
+    if (values.isEmpty() || address + values.size() > REGISTER_COUNT) return false;
+
+    for (int i = 0; i < values.size(); ++i) {
+        m_registers[address + i] = static_cast<quint8>(values[i]);
+    }
+    return true;
+}
+
+QByteArray LoRaE22Emulator::readRegisters(quint8 address, int length) const {
+    QByteArray values;
+    if (length <= 0) return values;
+
+    if (address >= PID && address + length <= PID + PID_SIZE) {
+        for (int i = 0; i < length; ++i) {
+            values.append(static_cast<char>(PRODUCT_INFO[address - PID + i]));
+        }
+    } else if (address + length <= REGISTER_COUNT) {
+        for (int i = 0; i < length; ++i) {
+            const int reg = address + i;
+            values.append(static_cast<char>(reg == CRYPT_H || reg == CRYPT_L ? 0 : m_registers[reg]));
+        }
+    }
+    return values;
+}
+
+void LoRaE22Emulator::setAirRateBps(int bps) {
+    int code = 0;
+    for (int i = 0; i < static_cast<int>(std::size(AIR_RATES_BPS)); ++i) {
+        if (AIR_RATES_BPS[i] <= bps) code = i;
+    }
+    m_registers[REG0] = static_cast<quint8>((m_registers[REG0] & 0xF8) | code);
+}
+
+int LoRaE22Emulator::airRateBps() const {
+    return AIR_RATES_BPS[m_registers[REG0] & 0x07];
+}
+
+int LoRaE22Emulator::subPacketSize() const {
+    return SUB_PACKET_SIZES[(m_registers[REG1] >> 6) & 0x03];
+}
+
+void LoRaE22Emulator::setConfig(const Config &config) {
+    m_config = config;
+    m_config.uartBufferSize = qMax(m_config.uartBufferSize, 1);
+}
+
+LoRaE22Emulator::Config LoRaE22Emulator::config() const {
+    return m_config;
+}
+
+LoRaE22Emulator::Stats LoRaE22Emulator::stats() const {
+    return m_stats;
+}
+
+int LoRaE22Emulator::uartIdleMs() const {
+    const int baud = UART_BAUDS[(m_registers[REG0] >> 5) & 0x07];
+    // 10 bits per byte on an 8N1 line
+    return qMax(1, (3 * 10 * 1000 + baud - 1) / baud);
+}
+
+int LoRaE22Emulator::wakeUpCycleMs() const {
+    return ((m_registers[REG3] & 0x07) + 1) * 500;
+}
+
+void LoRaE22Emulator::onHostData() {
+    char buf[512];
+    QByteArray data;
+    for (;;) {
+        const ssize_t n = ::read(m_masterFd, buf, sizeof(buf));
+        if (n <= 0) break;
+        data.append(buf, static_cast<int>(n));
+    }
+    if (data.isEmpty()) return;
+
+    switch (m_mode) {
+    case Mode::Configuration:
+        m_commandBuffer.append(data);
+        handleCommands();
+        return;
+    case Mode::PowerSaving:
+        // The UART receiver is off
+        return;
+    default:
+        break;
+    }
+
+    if ((m_registers[REG1] & 0x20) && handleRssiQuery(data)) return;
+
+    const int room = m_config.uartBufferSize - m_txBuffer.size();
+    if (data.size() > room) {
+        m_stats.uartOverflowBytes += static_cast<quint64>(data.size() - qMax(room, 0));
+        data.truncate(qMax(room, 0));
+    }
+    m_txBuffer.append(data);
+    m_uartIdleTimer.start(uartIdleMs());
+    pump();
+}
+
+void LoRaE22Emulator::handleCommands() {
+    while (m_commandBuffer.size() >= 3) {
+        const quint8 command = static_cast<quint8>(m_commandBuffer[0]);
+        const quint8 address = static_cast<quint8>(m_commandBuffer[1]);
+        const int length = static_cast<quint8>(m_commandBuffer[2]);
+
+        if (command == CMD_READ) {
+            const QByteArray values = readRegisters(address, length);
+            writeHost(values.isEmpty() ? errorReply() : commandReply(address, values));
+            m_commandBuffer.remove(0, 3);
+        } else if (command == CMD_WRITE || command == CMD_WRITE_TEMP) {
+            if (m_commandBuffer.size() < 3 + length) return;
+            const bool written = writeRegisters(address, m_commandBuffer.mid(3, length));
+            writeHost(written ? commandReply(address, readRegisters(address, length)) : errorReply());
+            m_commandBuffer.remove(0, 3 + length);
+        } else {
+            // Not a command: the module answers once and discards the rest
+            writeHost(errorReply());
+            m_commandBuffer.clear();
+        }
+    }
+}
+
+bool LoRaE22Emulator::handleRssiQuery(const QByteArray &data) {
+    static const QByteArray prefix("\xC0\xC1\xC2\xC3", 4);
+    if (data.size() != 6 || !data.startsWith(prefix)) return false;
+
+    const quint8 address = static_cast<quint8>(data[4]);
+    const int length = static_cast<quint8>(data[5]);
+    QByteArray values;
+    values.append(static_cast<char>(qBound(0, 256 + m_config.noiseDbm, 255)));
+    values.append(static_cast<char>(m_lastRssi));
+    if (length == 0 || address + length > values.size()) {
+        writeHost(errorReply());
+    } else {
+        writeHost(commandReply(address, values.mid(address, length)));
+    }
+    return true;
+}
+
+void LoRaE22Emulator::pump() {
+    if (m_airTimer.isActive() || m_mode == Mode::Configuration || m_mode == Mode::PowerSaving) return;
+
+    const bool idle = !m_uartIdleTimer.isActive();
+    const bool fixed = m_registers[REG3] & 0x40;
+    if (fixed && !m_haveTarget) {
+        if (m_txBuffer.size() < 3) {
+            // A message too short for its header goes nowhere
+            if (idle) m_txBuffer.clear();
+            return;
+        }
+        m_target = m_txBuffer.left(3);
+        m_txBuffer.remove(0, 3);
+        m_haveTarget = true;
+    }
+
+    if (m_txBuffer.isEmpty() || (m_txBuffer.size() < subPacketSize() && !idle)) {
+        if (m_txBuffer.isEmpty() && idle) m_haveTarget = false;
+        return;
+    }
+
+    QByteArray airPacket;
+    if (fixed) {
+        airPacket.append(m_target);
+    } else {
+        airPacket.append(static_cast<char>(m_registers[ADDH]));
+        airPacket.append(static_cast<char>(m_registers[ADDL]));
+        airPacket.append(static_cast<char>(m_registers[REG2]));
+    }
+    airPacket.append(static_cast<char>(m_registers[NETID]));
+    airPacket.append(static_cast<char>(m_mode == Mode::WakeUp ? AIR_FLAG_WAKEUP : 0));
+    airPacket.append(m_txBuffer.left(subPacketSize()));
+    m_txBuffer.remove(0, qMin(subPacketSize(), m_txBuffer.size()));
+    const quint16 crc = crc16(airPacket);
+    airPacket.append(static_cast<char>(crc >> 8));
+    airPacket.append(static_cast<char>(crc & 0xFF));
+    if (m_txBuffer.isEmpty() && idle) m_haveTarget = false;
+
+    double airtime = LoRaChannelSimulator::airtimeMs(airPacket.size(), airRateBps());
+    if (m_mode == Mode::WakeUp) {
+        airtime += wakeUpCycleMs();
+    }
+    m_stats.subPacketsSent++;
+    m_airTimer.start(static_cast<int>(airtime * m_config.timeScale));
+    emit airTransmit(airPacket);
+}
+
+void LoRaE22Emulator::airReceive(const QByteArray &airPacket) {
+    if (airPacket.size() < AIR_HEADER_SIZE + 2) {
+        m_stats.crcErrors++;
+        return;
+    }
+    const QByteArray body = airPacket.left(airPacket.size() - 2);
+    const quint16 crc = static_cast<quint16>((static_cast<quint8>(airPacket[airPacket.size() - 2]) << 8) |
+                                             static_cast<quint8>(airPacket[airPacket.size() - 1]));
+    if (crc16(body) != crc) {
+        m_stats.crcErrors++;
+        return;
+    }
+
+    if (m_mode == Mode::Configuration) return;
+    const quint8 flags = static_cast<quint8>(body[4]);
+    if (m_mode == Mode::PowerSaving && !(flags & AIR_FLAG_WAKEUP)) return;
+
+    const quint16 target = static_cast<quint16>((static_cast<quint8>(body[0]) << 8) | static_cast<quint8>(body[1]));
+    const quint16 own = static_cast<quint16>((m_registers[ADDH] << 8) | m_registers[ADDL]);
+    if (static_cast<quint8>(body[2]) != m_registers[REG2] || static_cast<quint8>(body[3]) != m_registers[NETID] ||
+        (target != own && target != 0xFFFF && own != 0xFFFF)) {
+        m_stats.filtered++;
+        return;
+    }
+
+    QByteArray payload = body.mid(AIR_HEADER_SIZE);
+    m_lastRssi = static_cast<quint8>(qBound(0, 256 + m_config.rssiDbm, 255));
+    if (m_registers[REG3] & 0x80) {
+        payload.append(static_cast<char>(m_lastRssi));
+    }
+    m_stats.subPacketsReceived++;
+    writeHost(payload);
+}
+
+void LoRaE22Emulator::writeHost(const QByteArray &data) {
+    if (m_masterFd < 0) return;
+
+    qint64 offset = 0;
+    while (offset < data.size()) {
+        const ssize_t n = ::write(m_masterFd, data.constData() + offset, static_cast<size_t>(data.size() - offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            // The host is not draining its port: lose the rest like an overrun UART
+            qWarning() << "LoRaE22Emulator: write failed:" << strerror(errno);
+            return;
+        }
+        offset += n;
+    }
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <memory>
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QTimer>
+#include <QSocketNotifier>
+
+class LoRaChannelSimulator;
+
+/**
+ * @file LoRaE22Emulator.hpp
+ * @brief Header file for the LoRaE22Emulator class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaE22Emulator
+ * @brief Software E22-400T22U module presented as a pseudo-terminal
+ * @details Behaves like the module on its UART, so LoRaWorker can open
+ *          portName() as if it were the USB dongle, while the radio side is
+ *          a LoRaChannelSimulator endpoint (see link()). Two linked
+ *          emulators run the whole stack from LoRaWorker::openPort() down
+ *          without hardware.
+ *
+ *          Emulated behaviour:
+ *          - Operating modes (setMode()), normally selected with M0/M1:
+ *            Transmission, WakeUp (transmits with a wake-up preamble),
+ *            PowerSaving (receives only wake-up transmissions, ignores the
+ *            UART) and Configuration (register commands only)
+ *          - Register commands in Configuration mode: C0 (write), C1 (read),
+ *            C2 (temporary write), answered with C1 or FF FF FF on error
+ *          - UART transmit buffer of Config::uartBufferSize bytes; bytes
+ *            beyond it are lost
+ *          - Sub-packets: the buffer goes on the air in pieces of the
+ *            REG1 sub-packet size, a piece leaving when it is full or when
+ *            the UART has been idle for three byte times
+ *          - Air timing: one sub-packet at a time, each taking its airtime
+ *            at the REG0 air rate, scaled by Config::timeScale
+ *          - Addressing: transparent mode delivers to modules with the same
+ *            address, channel and network ID; fixed mode (REG3 bit 6) takes
+ *            the target address and channel from the first three bytes of
+ *            each message. Address 0xFFFF broadcasts and monitors.
+ *          - RSSI byte appended to each received sub-packet (REG3 bit 7),
+ *            and the noise/RSSI query C0 C1 C2 C3 (REG1 bit 5)
+ *          - The radio's own CRC: sub-packets damaged on the channel are
+ *            dropped rather than passed to the UART
+ *
+ *          Listen-before-talk, relaying and encryption registers are stored
+ *          but have no effect.
+ *
+ * @note Only available on platforms with POSIX pseudo-terminals.
+ */
+class LoRaE22Emulator : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Mode
+     * @brief Operating mode, selected by the M0/M1 pins on the module
+     */
+    enum class Mode : quint8 {
+        Transmission = 0,   ///< M1=0 M0=0: normal transmit and receive
+        WakeUp = 1,         ///< M1=0 M0=1: transmit with a wake-up preamble
+        PowerSaving = 2,    ///< M1=1 M0=0: wake-on-radio receiver, UART transmit off
+        Configuration = 3   ///< M1=1 M0=1: register commands, radio off
+    };
+
+    /**
+     * @enum Register
+     * @brief Register addresses
+     */
+    enum Register : quint8 {
+        ADDH = 0x00,        ///< Module address, high byte
+        ADDL = 0x01,        ///< Module address, low byte
+        NETID = 0x02,       ///< Network ID
+        REG0 = 0x03,        ///< UART baud (7-5), parity (4-3), air rate (2-0)
+        REG1 = 0x04,        ///< Sub-packet size (7-6), RSSI noise enable (5), power (1-0)
+        REG2 = 0x05,        ///< Channel
+        REG3 = 0x06,        ///< RSSI byte (7), fixed mode (6), relay (5), LBT (4), WOR role (3), WOR cycle (2-0)
+        CRYPT_H = 0x07,     ///< Key, high byte (write-only)
+        CRYPT_L = 0x08,     ///< Key, low byte (write-only)
+        REGISTER_COUNT = 9, ///< Number of configuration registers
+        PID = 0x80          ///< First of PID_SIZE read-only product information bytes
+    };
+
+    /**
+     * @brief Command bytes of the configuration protocol
+     */
+    enum Command : quint8 {
+        CMD_WRITE = 0xC0,       ///< Writes registers and keeps them
+        CMD_READ = 0xC1,        ///< Reads registers; also the reply to every command
+        CMD_WRITE_TEMP = 0xC2   ///< Writes registers until power-off
+    };
+
+    /**
+     * @brief Number of product information bytes
+     */
+    static constexpr int PID_SIZE = 7;
+
+    /**
+     * @struct Config
+     * @brief Emulation settings that are not module registers
+     */
+    struct Config {
+        double timeScale = 0.0;     ///< Fraction of the airtime actually waited (0 = send at once)
+        int uartBufferSize = 1000;  ///< Transmit buffer of the module in bytes
+        int rssiDbm = -60;          ///< RSSI reported for received sub-packets
+        int noiseDbm = -110;        ///< Ambient noise reported by the noise query
+    };
+
+    /**
+     * @struct Stats
+     * @brief Module counters since open()
+     */
+    struct Stats {
+        quint64 subPacketsSent = 0;     ///< Sub-packets put on the air
+        quint64 subPacketsReceived = 0; ///< Sub-packets passed to the UART
+        quint64 uartOverflowBytes = 0;  ///< Host bytes lost to a full transmit buffer
+        quint64 filtered = 0;           ///< Sub-packets for another address, channel or network
+        quint64 crcErrors = 0;          ///< Sub-packets dropped for a radio CRC error
+    };
+
+    /**
+     * @brief Constructor for LoRaE22Emulator
+     * @param parent Parent QObject for memory management (default: nullptr)
+     * @details Registers start at the factory defaults: address 0, channel
+     *          23, 9600 8N1, 2.4 kbit/s, 240-byte sub-packets, transparent mode.
+     */
+    explicit LoRaE22Emulator(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor, closes the pseudo-terminal
+     */
+    ~LoRaE22Emulator() override;
+
+    /**
+     * @brief Creates the pseudo-terminal and starts serving it
+     * @return true on success
+     */
+    bool open();
+
+    /**
+     * @brief Closes the pseudo-terminal
+     */
+    void close();
+
+    /**
+     * @brief Returns whether the emulator is open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Returns the serial port name to open instead of the dongle
+     */
+    QString portName() const;
+
+    /**
+     * @brief Connects the radio side to a channel endpoint
+     * @param channel Channel carrying the sub-packets
+     * @param endpoint Endpoint index of this module (0 = A, 1 = B)
+     */
+    void link(LoRaChannelSimulator *channel, int endpoint);
+
+    /**
+     * @brief Sets the operating mode
+     * @param mode New mode; switching drops a partly received command
+     */
+    void setMode(Mode mode);
+
+    /**
+     * @brief Returns the operating mode
+     */
+    Mode mode() const;
+
+    /**
+     * @brief Writes registers, as the C0 command does
+     * @param address First register
+     * @param values Register values
+     * @return false if the range is not writable
+     */
+    bool writeRegisters(quint8 address, const QByteArray &values);
+
+    /**
+     * @brief Reads registers, as the C1 command does
+     * @param address First register
+     * @param length Number of registers
+     * @return Register values (the key reads as zero), or an empty array if
+     *         the range is not readable
+     */
+    QByteArray readRegisters(quint8 address, int length) const;
+
+    /**
+     * @brief Sets the air rate register to the fastest rate not above a value
+     * @param bps Air data rate in bits per second
+     */
+    void setAirRateBps(int bps);
+
+    /**
+     * @brief Returns the air data rate selected by REG0 in bits per second
+     */
+    int airRateBps() const;
+
+    /**
+     * @brief Returns the sub-packet size selected by REG1 in bytes
+     */
+    int subPacketSize() const;
+
+    /**
+     * @brief Replaces the emulation settings
+     * @param config New settings
+     */
+    void setConfig(const Config &config);
+
+    /**
+     * @brief Returns the emulation settings
+     */
+    Config config() const;
+
+    /**
+     * @brief Returns the module counters
+     */
+    Stats stats() const;
+
+signals:
+    /**
+     * @brief Signal emitted when a sub-packet goes on the air
+     * @param airPacket Sub-packet with its addressing header and radio CRC
+     */
+    void airTransmit(const QByteArray &airPacket);
+
+public slots:
+    /**
+     * @brief Receives a sub-packet from the air
+     * @param airPacket Sub-packet as emitted by airTransmit(), possibly damaged
+     */
+    void airReceive(const QByteArray &airPacket);
+
+private:
+    /**
+     * @brief Air header: target address (2), channel, network ID, flags
+     */
+    static constexpr int AIR_HEADER_SIZE = 5;
+
+    /**
+     * @brief Air header flag of a transmission with a wake-up preamble
+     */
+    static constexpr quint8 AIR_FLAG_WAKEUP = 0x01;
+
+    /**
+     * @brief Reads host bytes from the pseudo-terminal
+     */
+    void onHostData();
+
+    /**
+     * @brief Handles host bytes in Configuration mode
+     */
+    void handleCommands();
+
+    /**
+     * @brief Answers the noise/RSSI query
+     * @param data Host bytes of one UART write
+     * @return true if data was a query and has been answered
+     */
+    bool handleRssiQuery(const QByteArray &data);
+
+    /**
+     * @brief Puts the next sub-packet on the air if the radio is free
+     */
+    void pump();
+
+    /**
+     * @brief Writes bytes to the host side of the pseudo-terminal
+     * @param data Bytes for the host
+     */
+    void writeHost(const QByteArray &data);
+
+    /**
+     * @brief Returns the duration of three UART byte times in milliseconds
+     */
+    int uartIdleMs() const;
+
+    /**
+     * @brief Returns the wake-up preamble duration selected by REG3 in milliseconds
+     */
+    int wakeUpCycleMs() const;
+
+    /**
+     * @brief Emulation settings
+     */
+    Config m_config;
+
+    /**
+     * @brief Module counters
+     */
+    Stats m_stats;
+
+    /**
+     * @brief Operating mode
+     */
+    Mode m_mode = Mode::Transmission;
+
+    /**
+     * @brief Configuration registers
+     */
+    quint8 m_registers[REGISTER_COUNT] = {};
+
+    /**
+     * @brief Master side of the pseudo-terminal, -1 when closed
+     */
+    int m_masterFd = -1;
+
+    /**
+     * @brief Slave kept open so the master never hangs up
+     */
+    int m_slaveFd = -1;
+
+    /**
+     * @brief Slave device path, opened by the host
+     */
+    QString m_portName;
+
+    /**
+     * @brief Read notifier on the master
+     */
+    std::unique_ptr<QSocketNotifier> m_notifier;
+
+    /**
+     * @brief Host bytes not yet on the air
+     */
+    QByteArray m_txBuffer;
+
+    /**
+     * @brief Whether the fixed-mode header of the current message has been taken
+     */
+    bool m_haveTarget = false;
+
+    /**
+     * @brief Fixed-mode target: address high, address low, channel
+     */
+    QByteArray m_target;
+
+    /**
+     * @brief Host bytes of a partly received command
+     */
+    QByteArray m_commandBuffer;
+
+    /**
+     * @brief Runs while the UART is receiving; a sub-packet may leave when it stops
+     */
+    QTimer m_uartIdleTimer;
+
+    /**
+     * @brief Runs while the radio is sending a sub-packet
+     */
+    QTimer m_airTimer;
+
+    /**
+     * @brief RSSI of the last received sub-packet, as reported in the RSSI byte
+     */
+    quint8 m_lastRssi = 0;
+};
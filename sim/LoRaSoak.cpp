@@ -0,0 +1,442 @@
+/**
+ * @file LoRaSoak.cpp
+ * @brief Long-duration soak harness for the LoRa protocol stack
+ * @date 2026-10-18
+ *
+ * Runs two LoRaWorker instances against each other over a
+ * LoRaChannelSimulator and pushes mixed traffic in both directions until the
+ * requested amount of virtual channel time has been used. Airtime is accounted
+ * at the simulated air rate but not waited for, so hours of virtual time take
+ * minutes of wall time (plus one TIMEOUT_MS per lost frame).
+ *
+ * With --emulator the workers open two LoRaE22Emulator modules linked over
+ * the channel instead of the channel's own pseudo-terminals, so module
+ * behaviour (sub-packets, UART buffering, radio CRC) is part of the run.
+ *
+ * At regular virtual-time intervals the harness samples:
+ * - Resident set size (from /proc/self/statm)
+ * - Heap bytes in use (mallinfo2(), glibc only)
+ * - Live and total operator new allocations
+ * - Send latency percentiles (p50/p95/p99) of the packets completed since
+ *   the previous sample
+ *
+ * After the warm-up samples, the average of the first three samples is
+ * compared with the average of the last three. The run fails (exit code 1)
+ * if memory or allocations grow beyond their thresholds, if p99 latency
+ * creeps beyond the allowed ratio, or if any packet arrives corrupted.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include "LoRaChannelSimulator.hpp"
+#include "LoRaE22Emulator.hpp"
+#include "LoRaWorker.hpp"
+
+namespace {
+
+std::atomic<qint64> g_liveAllocations { 0 };
+std::atomic<qint64> g_totalAllocations { 0 };
+
+void *countedAlloc(std::size_t size) {
+    void *p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    g_liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    g_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void countedFree(void *p) noexcept {
+    if (!p) return;
+    g_liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+} // namespace
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void *p) noexcept { countedFree(p); }
+void operator delete[](void *p) noexcept { countedFree(p); }
+void operator delete(void *p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void *p, std::size_t) noexcept { countedFree(p); }
+
+namespace {
+
+/**
+ * @struct Sample
+ * @brief One measurement point of the soak run
+ */
+struct Sample {
+    double virtualHours = 0.0;  ///< Virtual channel time elapsed
+    qint64 rssKb = 0;           ///< Resident set size
+    qint64 heapKb = 0;          ///< Heap bytes in use (0 if unavailable)
+    qint64 liveAllocations = 0; ///< operator new allocations not yet freed
+    qint64 totalAllocations = 0;///< operator new allocations since start
+    double p50Ms = 0.0;         ///< Median send latency of the window
+    double p95Ms = 0.0;         ///< 95th percentile send latency of the window
+    double p99Ms = 0.0;         ///< 99th percentile send latency of the window
+    quint64 packets = 0;        ///< Packets completed in the window
+};
+
+/**
+ * @struct Thresholds
+ * @brief Drift limits between the start and the end of the run
+ */
+struct Thresholds {
+    qint64 maxRssGrowthKb = 1024;
+    qint64 maxHeapGrowthKb = 512;
+    qint64 maxAllocationGrowth = 2000;
+    double maxLatencyRatio = 1.5;
+    double latencySlackMs = 50.0;
+};
+
+qint64 residentKb() {
+    FILE *f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    long pages = 0;
+    long resident = 0;
+    const int n = std::fscanf(f, "%ld %ld", &pages, &resident);
+    std::fclose(f);
+    if (n != 2) return 0;
+    return static_cast<qint64>(resident) * ::sysconf(_SC_PAGESIZE) / 1024;
+}
+
+qint64 heapKb() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return static_cast<qint64>(::mallinfo2().uordblks / 1024);
+#else
+    return 0;
+#endif
+}
+
+double percentile(std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const auto index = static_cast<size_t>(std::max(0.0, p * sorted.size() - 1.0));
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/**
+ * @class Flow
+ * @brief Closed-loop traffic from one worker to the other
+ * @details Sends the next packet as soon as the previous one completes.
+ *          Packet sizes are mixed: mostly small telemetry-like packets, some
+ *          medium and a few large ones. Each payload carries an id and a
+ *          checksum so the receiver can detect corruption and reordering.
+ */
+class Flow
+{
+public:
+    Flow(LoRaWorker *sender, LoRaWorker *receiver, int maxSize, quint32 seed)
+        : m_sender(sender), m_maxSize(maxSize), m_rng(seed)
+    {
+        QObject::connect(sender, &LoRaWorker::packetSent, sender, [this](bool success) {
+            if (success) {
+                m_latencies.push_back(m_timer.nsecsElapsed() / 1e6);
+            } else {
+                m_failures++;
+            }
+            QTimer::singleShot(0, m_sender, [this]() { sendNext(); });
+        });
+        QObject::connect(receiver, &LoRaWorker::packetReceived, receiver, [this](const QByteArray &data) {
+            check(data);
+        });
+    }
+
+    void sendNext() {
+        const int roll = m_rng.bounded(100);
+        int size;
+        if (roll < 70) {
+            size = m_rng.bounded(HEADER_SIZE, 48);
+        } else if (roll < 95) {
+            size = m_rng.bounded(48, qMax(49, m_maxSize / 2));
+        } else {
+            size = m_rng.bounded(qMax(HEADER_SIZE, m_maxSize / 2), m_maxSize + 1);
+        }
+
+        QByteArray payload(size, Qt::Uninitialized);
+        for (int i = HEADER_SIZE; i < size; ++i) {
+            payload[i] = static_cast<char>(m_rng.bounded(256));
+        }
+        const quint32 id = m_nextId++;
+        for (int i = 0; i < 4; ++i) {
+            payload[i] = static_cast<char>((id >> (8 * i)) & 0xFF);
+        }
+        const quint16 sum = qChecksum(QByteArrayView(payload).sliced(HEADER_SIZE));
+        payload[4] = static_cast<char>(sum & 0xFF);
+        payload[5] = static_cast<char>(sum >> 8);
+
+        m_timer.start();
+        m_sender->sendPacket(payload);
+    }
+
+    std::vector<double> takeLatencies() {
+        std::vector<double> window;
+        window.swap(m_latencies);
+        return window;
+    }
+
+    quint64 failures() const { return m_failures; }
+    quint64 corrupted() const { return m_corrupted; }
+
+private:
+    static constexpr int HEADER_SIZE = 6;
+
+    void check(const QByteArray &data) {
+        if (data.size() < HEADER_SIZE) {
+            m_corrupted++;
+            return;
+        }
+        quint32 id = 0;
+        for (int i = 3; i >= 0; --i) {
+            id = (id << 8) | static_cast<quint8>(data[i]);
+        }
+        const quint16 sum = static_cast<quint8>(data[4]) | (static_cast<quint8>(data[5]) << 8);
+        // Ids may repeat (lost final ACK) or skip (failed send) but never go back
+        if (sum != qChecksum(QByteArrayView(data).sliced(HEADER_SIZE)) || (m_seenAny && id < m_lastId)) {
+            m_corrupted++;
+            return;
+        }
+        m_seenAny = true;
+        m_lastId = id;
+    }
+
+    LoRaWorker *m_sender;
+    int m_maxSize;
+    QRandomGenerator m_rng;
+    QElapsedTimer m_timer;
+    std::vector<double> m_latencies;
+    quint32 m_nextId = 0;
+    quint32 m_lastId = 0;
+    bool m_seenAny = false;
+    quint64 m_failures = 0;
+    quint64 m_corrupted = 0;
+};
+
+Sample average(const std::vector<Sample> &samples, size_t first, size_t count) {
+    Sample avg;
+    for (size_t i = first; i < first + count; ++i) {
+        avg.rssKb += samples[i].rssKb;
+        avg.heapKb += samples[i].heapKb;
+        avg.liveAllocations += samples[i].liveAllocations;
+        avg.p99Ms += samples[i].p99Ms;
+    }
+    const auto n = static_cast<qint64>(count);
+    avg.rssKb /= n;
+    avg.heapKb /= n;
+    avg.liveAllocations /= n;
+    avg.p99Ms /= static_cast<double>(count);
+    return avg;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("LoRaSoak");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Soak test: mixed traffic over a simulated link with drift detection");
+    parser.addHelpOption();
+    const QCommandLineOption hoursOpt("hours", "Virtual channel hours to run.", "hours", "1");
+    const QCommandLineOption samplesOpt("samples", "Number of samples over the run.", "n", "20");
+    const QCommandLineOption warmupOpt("warmup", "Samples ignored at the start.", "n", "2");
+    const QCommandLineOption lossOpt("loss", "Frame loss probability.", "p", "0.01");
+    const QCommandLineOption burstOpt("burst", "Probability of entering a loss burst.", "p", "0");
+    const QCommandLineOption berOpt("ber", "Bit error rate.", "p", "0");
+    const QCommandLineOption airRateOpt("air-rate", "Simulated air rate in bit/s.", "bps", "2400");
+    const QCommandLineOption maxSizeOpt("max-size", "Largest packet in bytes.", "bytes", "2048");
+    const QCommandLineOption seedOpt("seed", "Random seed.", "seed", "1");
+    const QCommandLineOption dedupOpt("dedup", "Enable chunk deduplication on both ends.");
+    const QCommandLineOption monitorOpt("monitor", "Enable link monitoring on both ends.");
+    const QCommandLineOption emulatorOpt("emulator", "Run the workers on emulated E22 modules.");
+    const QCommandLineOption protectedHeaderOpt("protected-header", "Protect frame headers on both ends.");
+    const QCommandLineOption parityOpt("parity", "Reed-Solomon parity bytes per frame on both ends.", "bytes", "0");
+    const QCommandLineOption rssOpt("max-rss-growth-kb", "Allowed RSS growth.", "kb", "1024");
+    const QCommandLineOption heapOpt("max-heap-growth-kb", "Allowed heap growth.", "kb", "512");
+    const QCommandLineOption allocOpt("max-alloc-growth", "Allowed growth of live allocations.", "n", "2000");
+    const QCommandLineOption latencyOpt("max-latency-ratio", "Allowed p99 latency growth ratio.", "ratio", "1.5");
+    const QCommandLineOption wallOpt("max-wall-minutes", "Abort after this much wall time (0 = never).", "min", "0");
+    for (const auto &opt : {hoursOpt, samplesOpt, warmupOpt, lossOpt, burstOpt, berOpt, airRateOpt, maxSizeOpt,
+                            seedOpt, dedupOpt, monitorOpt, emulatorOpt, protectedHeaderOpt, parityOpt, rssOpt, heapOpt,
+                            allocOpt, latencyOpt, wallOpt}) {
+        parser.addOption(opt);
+    }
+    parser.process(app);
+
+    const double hours = parser.value(hoursOpt).toDouble();
+    const int sampleCount = qMax(parser.value(samplesOpt).toInt(), 1);
+    const size_t warmup = static_cast<size_t>(qMax(parser.value(warmupOpt).toInt(), 0));
+    Thresholds limits;
+    limits.maxRssGrowthKb = parser.value(rssOpt).toLongLong();
+    limits.maxHeapGrowthKb = parser.value(heapOpt).toLongLong();
+    limits.maxAllocationGrowth = parser.value(allocOpt).toLongLong();
+    limits.maxLatencyRatio = parser.value(latencyOpt).toDouble();
+
+    QTextStream out(stdout);
+
+    LoRaChannelSimulator channel;
+    LoRaChannelSimulator::Config config;
+    config.lossRate = parser.value(lossOpt).toDouble();
+    config.burstEnterRate = parser.value(burstOpt).toDouble();
+    config.burstExitRate = 0.3;
+    config.bitErrorRate = parser.value(berOpt).toDouble();
+    config.airRateBps = parser.value(airRateOpt).toInt();
+    config.seed = parser.value(seedOpt).toUInt();
+    channel.setConfig(config);
+
+    const bool emulate = parser.isSet(emulatorOpt);
+    LoRaE22Emulator moduleA;
+    LoRaE22Emulator moduleB;
+    QString portA;
+    QString portB;
+    if (emulate) {
+        int endpoint = 0;
+        for (LoRaE22Emulator *module : {&moduleA, &moduleB}) {
+            module->setAirRateBps(config.airRateBps);
+            module->link(&channel, endpoint++);
+            if (!module->open()) {
+                out << "FAIL: could not create emulated module\n";
+                return 1;
+            }
+        }
+        portA = moduleA.portName();
+        portB = moduleB.portName();
+    } else {
+        if (!channel.open()) {
+            out << "FAIL: could not create simulated link\n";
+            return 1;
+        }
+        portA = channel.portA();
+        portB = channel.portB();
+    }
+
+    LoRaWorker nodeA;
+    LoRaWorker nodeB;
+    bool opened = true;
+    for (LoRaWorker *node : {&nodeA, &nodeB}) {
+        // Deduplication and link probes are only used once negotiated
+        node->setCapabilityNegotiationEnabled(true);
+        QObject::connect(node, &LoRaWorker::portOpened, node, [&opened, &out](bool ok, const QString &error) {
+            if (!ok) {
+                out << "FAIL: " << error << "\n";
+                opened = false;
+            }
+        });
+    }
+    nodeA.openPort(portA);
+    nodeB.openPort(portB);
+    if (!opened) return 1;
+
+    const bool dedup = parser.isSet(dedupOpt);
+    const bool monitor = parser.isSet(monitorOpt);
+    const bool protectedHeader = parser.isSet(protectedHeaderOpt);
+    const int parity = parser.value(parityOpt).toInt();
+    for (LoRaWorker *node : {&nodeA, &nodeB}) {
+        node->setDedupEnabled(dedup);
+        node->setLinkMonitorEnabled(monitor);
+        node->setProtectedHeaderEnabled(protectedHeader);
+        node->setFrameParity(parity);
+    }
+
+    const int maxSize = qMax(parser.value(maxSizeOpt).toInt(), 64);
+    Flow forward(&nodeA, &nodeB, maxSize, config.seed + 1);
+    Flow backward(&nodeB, &nodeA, maxSize / 4, config.seed + 2);
+
+    std::vector<Sample> samples;
+    const double hoursPerSample = hours / sampleCount;
+    QElapsedTimer wall;
+    wall.start();
+    const qint64 maxWallMs = static_cast<qint64>(parser.value(wallOpt).toDouble() * 60000.0);
+
+    out << "virt_h   rss_kb  heap_kb  live_alloc  total_alloc  packets  p50_ms  p95_ms  p99_ms\n";
+
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &app, [&]() {
+        const double virtualHours = channel.stats().airtimeMs / 3.6e6;
+        if (virtualHours < hoursPerSample * static_cast<double>(samples.size() + 1)) {
+            if (maxWallMs > 0 && wall.elapsed() > maxWallMs) {
+                out << "FAIL: wall-clock limit reached at " << virtualHours << " virtual hours\n";
+                app.exit(1);
+            }
+            return;
+        }
+
+        std::vector<double> window = forward.takeLatencies();
+        const std::vector<double> back = backward.takeLatencies();
+        window.insert(window.end(), back.begin(), back.end());
+        std::sort(window.begin(), window.end());
+
+        Sample s;
+        s.virtualHours = virtualHours;
+        s.rssKb = residentKb();
+        s.heapKb = heapKb();
+        s.liveAllocations = g_liveAllocations.load();
+        s.totalAllocations = g_totalAllocations.load();
+        s.p50Ms = percentile(window, 0.50);
+        s.p95Ms = percentile(window, 0.95);
+        s.p99Ms = percentile(window, 0.99);
+        s.packets = window.size();
+        samples.push_back(s);
+
+        out << QString::asprintf("%6.3f %8lld %8lld %11lld %12lld %8llu %7.1f %7.1f %7.1f\n",
+                                 s.virtualHours, s.rssKb, s.heapKb, s.liveAllocations, s.totalAllocations,
+                                 static_cast<unsigned long long>(s.packets), s.p50Ms, s.p95Ms, s.p99Ms);
+        out.flush();
+
+        if (static_cast<int>(samples.size()) >= sampleCount) {
+            app.exit(0);
+        }
+    });
+    poll.start(50);
+
+    QTimer::singleShot(0, &app, [&]() {
+        forward.sendNext();
+        backward.sendNext();
+    });
+    if (app.exec() != 0) return 1;
+
+    const quint64 corrupted = forward.corrupted() + backward.corrupted();
+    const LoRaChannelSimulator::Stats channelStats = channel.stats();
+    out << "transmissions " << channelStats.transmissions << ", dropped " << channelStats.dropped
+        << ", corrupted " << channelStats.corrupted << ", failed packets "
+        << (forward.failures() + backward.failures()) << "\n";
+
+    if (samples.size() < warmup + 3) {
+        out << "FAIL: not enough samples after warm-up; increase --samples\n";
+        return 1;
+    }
+
+    const Sample start = average(samples, warmup, 3);
+    const Sample end = average(samples, samples.size() - 3, 3);
+    bool failed = false;
+    auto check = [&](bool ok, const QString &what) {
+        out << (ok ? "ok   " : "FAIL ") << what << "\n";
+        failed |= !ok;
+    };
+    check(end.rssKb - start.rssKb <= limits.maxRssGrowthKb,
+          QString("RSS growth %1 kB (limit %2)").arg(end.rssKb - start.rssKb).arg(limits.maxRssGrowthKb));
+    check(end.heapKb - start.heapKb <= limits.maxHeapGrowthKb,
+          QString("heap growth %1 kB (limit %2)").arg(end.heapKb - start.heapKb).arg(limits.maxHeapGrowthKb));
+    check(end.liveAllocations - start.liveAllocations <= limits.maxAllocationGrowth,
+          QString("live allocation growth %1 (limit %2)")
+              .arg(end.liveAllocations - start.liveAllocations).arg(limits.maxAllocationGrowth));
+    check(end.p99Ms <= start.p99Ms * limits.maxLatencyRatio + limits.latencySlackMs,
+          QString("p99 latency %1 ms -> %2 ms (ratio limit %3)")
+              .arg(start.p99Ms, 0, 'f', 1).arg(end.p99Ms, 0, 'f', 1).arg(limits.maxLatencyRatio));
+    check(corrupted == 0, QString("%1 corrupted packets delivered").arg(corrupted));
+
+    return failed ? 1 : 0;
+}
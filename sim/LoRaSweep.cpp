@@ -0,0 +1,379 @@
+/**
+ * @file LoRaSweep.cpp
+ * @brief Offline parameter sweep of the LoRa protocol over a simulated channel
+ * @date 2026-10-18
+ *
+ * Runs two LoRaUsbAdapter_E22_400T22U instances against each other over a
+ * LoRaChannelSimulator, once for every combination of protocol settings and
+ * channel conditions given on the command line:
+ * - Settings: chunk size (--chunk-size), delayed-ACK window (--ack-delay)
+ *   and send window (--window, the number of logical ports driven at once;
+ *   each port is stop-and-wait, so this is the number of chunks in flight)
+ * - Conditions: frame loss (--loss), loss bursts (--burst) and air rate
+ *   (--air-rate)
+ *
+ * Node A sends fixed-size packets to node B, closed-loop on every port of the
+ * window, and B answers each packet with a short reply so that ACKs have
+ * reverse data to ride on. Each configuration runs until --packets packets
+ * have been delivered, or its wall-clock budget is used up.
+ *
+ * For every configuration the sweep reports:
+ * - Goodput: payload bits delivered to B per second
+ * - Send latency percentiles (p50/p95/p99) of the packets of A
+ * - Airtime per delivered kilobyte and channel utilisation
+ *
+ * Within each channel condition, the settings that no other setting beats on
+ * goodput, p95 latency and airtime at once are Pareto-optimal and marked
+ * with '*'.
+ *
+ * Airtime is waited for at --time-scale of its duration, and all times are
+ * reported in channel time (wall time divided by the scale). Protocol timers
+ * are not scaled, so scales below 1 overstate the cost of timeouts and of
+ * the delayed-ACK window.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "LoRaChannelSimulator.hpp"
+#include "LoRaUsbAdapter_E22_400T22U.hpp"
+
+namespace {
+
+/**
+ * @struct Settings
+ * @brief Protocol parameters under test
+ */
+struct Settings {
+    int chunkSize = 24;     ///< Chunk payload size in bytes
+    int ackDelayMs = 50;    ///< Delayed-ACK window
+    int window = 1;         ///< Logical ports sending at once
+};
+
+/**
+ * @struct Condition
+ * @brief Channel conditions under test
+ */
+struct Condition {
+    double lossRate = 0.0;  ///< Frame loss probability
+    double burstRate = 0.0; ///< Probability of entering a loss burst
+    int airRateBps = 2400;  ///< Air data rate
+};
+
+/**
+ * @struct Result
+ * @brief Measurements of one configuration
+ */
+struct Result {
+    Condition condition;
+    Settings settings;
+    quint64 delivered = 0;      ///< Packets received by B
+    quint64 failed = 0;         ///< Packets of A reported failed
+    double goodputBps = 0.0;    ///< Payload bits delivered per second of channel time
+    double p50Ms = 0.0;         ///< Median send latency
+    double p95Ms = 0.0;         ///< 95th percentile send latency
+    double p99Ms = 0.0;         ///< 99th percentile send latency
+    double airMsPerKb = 0.0;    ///< Airtime per delivered kilobyte
+    double utilisation = 0.0;   ///< Fraction of channel time spent transmitting
+    bool complete = false;      ///< Whether the packet target was reached in time
+    bool pareto = false;        ///< Whether no other setting dominates this one
+};
+
+/**
+ * @struct Options
+ * @brief Run parameters shared by all configurations
+ */
+struct Options {
+    int packetSize = 240;
+    int replySize = 16;
+    quint64 packets = 20;
+    double timeScale = 1.0;
+    qint64 maxWallMs = 120000;
+    quint32 seed = 1;
+};
+
+// First port of the window; ports 0 and 1 are reserved by LoRaWorker
+constexpr quint8 FIRST_PORT = 2;
+
+template <typename T, typename Convert>
+std::vector<T> parseList(const QString &text, Convert convert) {
+    std::vector<T> values;
+    for (const QString &item : text.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const T value = convert(item.trimmed(), &ok);
+        if (ok) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+std::vector<int> intList(const QString &text) {
+    return parseList<int>(text, [](const QString &item, bool *ok) { return item.toInt(ok); });
+}
+
+std::vector<double> doubleList(const QString &text) {
+    return parseList<double>(text, [](const QString &item, bool *ok) { return item.toDouble(ok); });
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const auto index = static_cast<size_t>(std::max(0.0, p * sorted.size() - 1.0));
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+bool openSerial(QCrossPlatformSerialPort &serial, const QString &name) {
+    serial.setPortName(name);
+    serial.setBaudRate(9600);
+    serial.setDataBits(QCrossPlatformDataBits::Data8);
+    serial.setParity(QCrossPlatformParity::NoParity);
+    serial.setStopBits(QCrossPlatformStopBits::OneStop);
+    serial.setFlowControl(QCrossPlatformFlowControl::NoFlowControl);
+    return serial.open(QIODevice::ReadWrite);
+}
+
+/**
+ * @brief Runs one configuration
+ * @param condition Channel conditions
+ * @param settings Protocol parameters
+ * @param options Run parameters
+ * @param result Output parameter for the measurements
+ * @return false if the simulated link could not be set up
+ */
+bool runConfiguration(const Condition &condition, const Settings &settings, const Options &options,
+                      Result &result) {
+    using Adapter = LoRaUsbAdapter_E22_400T22U;
+    result.condition = condition;
+    result.settings = settings;
+
+    LoRaChannelSimulator channel;
+    LoRaChannelSimulator::Config config;
+    config.lossRate = condition.lossRate;
+    config.burstEnterRate = condition.burstRate;
+    config.burstExitRate = 0.3;
+    config.airRateBps = condition.airRateBps;
+    config.timeScale = options.timeScale;
+    config.seed = options.seed;
+    channel.setConfig(config);
+    if (!channel.open()) return false;
+
+    auto serialA = std::make_shared<QCrossPlatformSerialPort>();
+    auto serialB = std::make_shared<QCrossPlatformSerialPort>();
+    if (!openSerial(*serialA, channel.portA()) || !openSerial(*serialB, channel.portB())) return false;
+
+    Adapter nodeA(serialA);
+    Adapter nodeB(serialB);
+    for (Adapter *node : {&nodeA, &nodeB}) {
+        node->setChunkSize(settings.chunkSize);
+        node->setAckDelay(settings.ackDelayMs);
+    }
+
+    // Both ends must agree on ports and DATA_ACK before traffic starts
+    QEventLoop loop;
+    QTimer deadline;
+    deadline.setSingleShot(true);
+    QObject::connect(&deadline, &QTimer::timeout, &loop, &QEventLoop::quit);
+    QObject::connect(&nodeA, &Adapter::capabilitiesNegotiated, &loop, &QEventLoop::quit);
+    deadline.start(static_cast<int>(options.maxWallMs));
+    nodeA.startHandshake();
+    loop.exec();
+    if (!nodeA.isHandshakeComplete()) return false;
+    QObject::disconnect(&nodeA, &Adapter::capabilitiesNegotiated, &loop, &QEventLoop::quit);
+
+    channel.resetStats();
+    std::vector<QElapsedTimer> sendTimers(settings.window);
+    std::vector<double> latencies;
+    quint64 deliveredBytes = 0;
+    const QByteArray payload(options.packetSize, 'x');
+    const QByteArray reply(options.replySize, 'r');
+
+    auto sendNext = [&](quint8 port) {
+        sendTimers[port - FIRST_PORT].start();
+        nodeA.sendPacket(payload, port);
+    };
+
+    QObject::connect(&nodeA, &Adapter::packetSent, &loop, [&](bool success, quint8 port) {
+        if (port < FIRST_PORT || port >= FIRST_PORT + settings.window) return;
+        if (success) {
+            latencies.push_back(sendTimers[port - FIRST_PORT].nsecsElapsed() / 1e6 / options.timeScale);
+        } else {
+            result.failed++;
+        }
+        QTimer::singleShot(0, &nodeA, [&sendNext, port]() { sendNext(port); });
+    });
+    QObject::connect(&nodeB, &Adapter::packetReceived, &loop, [&](const QByteArray &data, quint8 port) {
+        deliveredBytes += data.size();
+        if (++result.delivered >= options.packets) {
+            loop.quit();
+            return;
+        }
+        nodeB.sendPacket(reply, port);
+    });
+
+    QElapsedTimer wall;
+    wall.start();
+    deadline.start(static_cast<int>(options.maxWallMs));
+    for (int i = 0; i < settings.window; ++i) {
+        sendNext(static_cast<quint8>(FIRST_PORT + i));
+    }
+    loop.exec();
+
+    const double elapsedMs = wall.nsecsElapsed() / 1e6 / options.timeScale;
+    const LoRaChannelSimulator::Stats stats = channel.stats();
+    std::sort(latencies.begin(), latencies.end());
+    result.complete = result.delivered >= options.packets;
+    result.goodputBps = elapsedMs > 0.0 ? deliveredBytes * 8.0 * 1000.0 / elapsedMs : 0.0;
+    result.p50Ms = percentile(latencies, 0.50);
+    result.p95Ms = percentile(latencies, 0.95);
+    result.p99Ms = percentile(latencies, 0.99);
+    result.airMsPerKb = deliveredBytes > 0 ? stats.airtimeMs * 1024.0 / deliveredBytes : 0.0;
+    result.utilisation = elapsedMs > 0.0 ? stats.airtimeMs / elapsedMs : 0.0;
+    return true;
+}
+
+bool sameCondition(const Condition &a, const Condition &b) {
+    return a.lossRate == b.lossRate && a.burstRate == b.burstRate && a.airRateBps == b.airRateBps;
+}
+
+/**
+ * @brief Returns whether a is at least as good as b everywhere and better somewhere
+ */
+bool dominates(const Result &a, const Result &b) {
+    const bool noWorse = a.goodputBps >= b.goodputBps && a.p95Ms <= b.p95Ms && a.airMsPerKb <= b.airMsPerKb;
+    const bool better = a.goodputBps > b.goodputBps || a.p95Ms < b.p95Ms || a.airMsPerKb < b.airMsPerKb;
+    return noWorse && better;
+}
+
+/**
+ * @brief Marks the Pareto-optimal settings of each channel condition
+ * @details Configurations that missed their packet target are never optimal.
+ */
+void markPareto(std::vector<Result> &results) {
+    for (Result &candidate : results) {
+        candidate.pareto = candidate.complete;
+        for (const Result &other : results) {
+            if (!candidate.pareto) break;
+            if (&other != &candidate && other.complete && sameCondition(other.condition, candidate.condition) &&
+                dominates(other, candidate)) {
+                candidate.pareto = false;
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("LoRaSweep");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Parameter sweep: protocol settings x channel conditions over a simulated link");
+    parser.addHelpOption();
+    const QCommandLineOption chunkOpt("chunk-size", "Chunk sizes in bytes (comma-separated).", "list", "12,24");
+    const QCommandLineOption ackDelayOpt("ack-delay", "Delayed-ACK windows in ms.", "list", "0,50");
+    const QCommandLineOption windowOpt("window", "Logical ports sending at once.", "list", "1,2");
+    const QCommandLineOption lossOpt("loss", "Frame loss probabilities.", "list", "0,0.05");
+    const QCommandLineOption burstOpt("burst", "Probabilities of entering a loss burst.", "list", "0");
+    const QCommandLineOption airRateOpt("air-rate", "Air rates in bit/s.", "list", "2400");
+    const QCommandLineOption sizeOpt("packet-size", "Size of the packets of node A.", "bytes", "240");
+    const QCommandLineOption replyOpt("reply-size", "Size of the replies of node B.", "bytes", "16");
+    const QCommandLineOption packetsOpt("packets", "Packets to deliver per configuration.", "n", "20");
+    const QCommandLineOption scaleOpt("time-scale", "Fraction of the airtime actually waited, in (0, 1].",
+                                      "scale", "1");
+    const QCommandLineOption wallOpt("max-wall-seconds", "Wall-clock budget per configuration.", "s", "120");
+    const QCommandLineOption seedOpt("seed", "Random seed of the channel.", "seed", "1");
+    const QCommandLineOption csvOpt("csv", "Print comma-separated values instead of a table.");
+    for (const auto &opt : {chunkOpt, ackDelayOpt, windowOpt, lossOpt, burstOpt, airRateOpt, sizeOpt, replyOpt,
+                            packetsOpt, scaleOpt, wallOpt, seedOpt, csvOpt}) {
+        parser.addOption(opt);
+    }
+    parser.process(app);
+
+    Options options;
+    options.packetSize = qMax(parser.value(sizeOpt).toInt(), 1);
+    options.replySize = qMax(parser.value(replyOpt).toInt(), 1);
+    options.packets = static_cast<quint64>(qMax(parser.value(packetsOpt).toInt(), 1));
+    options.timeScale = qBound(0.001, parser.value(scaleOpt).toDouble(), 1.0);
+    options.maxWallMs = static_cast<qint64>(qMax(parser.value(wallOpt).toDouble(), 1.0) * 1000.0);
+    options.seed = parser.value(seedOpt).toUInt();
+    const bool csv = parser.isSet(csvOpt);
+
+    const int maxChunkSize = static_cast<int>(LoRaUsbAdapter_E22_400T22U::FrameSize::MAX_PAYLOAD_SIZE);
+    const int maxWindow = LoRaUsbAdapter_E22_400T22U::MAX_PORTS - FIRST_PORT;
+    std::vector<Settings> grid;
+    for (int chunkSize : intList(parser.value(chunkOpt))) {
+        for (int ackDelay : intList(parser.value(ackDelayOpt))) {
+            for (int window : intList(parser.value(windowOpt))) {
+                grid.push_back({qBound(1, chunkSize, maxChunkSize), qMax(ackDelay, 0), qBound(1, window, maxWindow)});
+            }
+        }
+    }
+    std::vector<Condition> conditions;
+    for (int airRate : intList(parser.value(airRateOpt))) {
+        for (double burst : doubleList(parser.value(burstOpt))) {
+            for (double loss : doubleList(parser.value(lossOpt))) {
+                conditions.push_back({loss, burst, qMax(airRate, 1)});
+            }
+        }
+    }
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (grid.empty() || conditions.empty()) {
+        err << "Nothing to sweep\n";
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (const Condition &condition : conditions) {
+        for (const Settings &settings : grid) {
+            Result result;
+            if (!runConfiguration(condition, settings, options, result)) {
+                err << "FAIL: could not set up simulated link\n";
+                return 1;
+            }
+            err << QString::asprintf("loss %.3f burst %.3f air %d: chunk %d ack %d window %d done\n",
+                                     condition.lossRate, condition.burstRate, condition.airRateBps,
+                                     settings.chunkSize, settings.ackDelayMs, settings.window);
+            err.flush();
+            results.push_back(result);
+        }
+    }
+    markPareto(results);
+
+    if (csv) {
+        out << "loss,burst,air_bps,chunk,ack_ms,window,delivered,failed,goodput_bps,p50_ms,p95_ms,p99_ms,"
+               "air_ms_per_kb,utilisation,complete,pareto\n";
+    } else {
+        out << "  loss  burst   air  chunk  ack  win  deliv  fail  goodput_bps  p50_ms  p95_ms  p99_ms"
+               "  air_ms/kb  util\n";
+    }
+    for (const Result &r : results) {
+        const auto delivered = static_cast<unsigned long long>(r.delivered);
+        const auto failed = static_cast<unsigned long long>(r.failed);
+        if (csv) {
+            out << QString::asprintf("%g,%g,%d,%d,%d,%d,%llu,%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f,%d,%d\n",
+                                     r.condition.lossRate, r.condition.burstRate, r.condition.airRateBps,
+                                     r.settings.chunkSize, r.settings.ackDelayMs, r.settings.window, delivered,
+                                     failed, r.goodputBps, r.p50Ms, r.p95Ms, r.p99Ms, r.airMsPerKb, r.utilisation,
+                                     r.complete ? 1 : 0, r.pareto ? 1 : 0);
+        } else {
+            out << QString::asprintf("%6.3f %6.3f %5d %6d %4d %4d %6llu %5llu %12.1f %7.1f %7.1f %7.1f %10.1f %5.2f",
+                                     r.condition.lossRate, r.condition.burstRate, r.condition.airRateBps,
+                                     r.settings.chunkSize, r.settings.ackDelayMs, r.settings.window, delivered,
+                                     failed, r.goodputBps, r.p50Ms, r.p95Ms, r.p99Ms, r.airMsPerKb, r.utilisation)
+                << (r.pareto ? "  *" : "") << (r.complete ? "" : "  (incomplete)") << "\n";
+        }
+    }
+    if (!csv) {
+        out << "* Pareto-optimal for its channel condition (goodput, p95 latency, airtime)\n";
+    }
+    return 0;
+}
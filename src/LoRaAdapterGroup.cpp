@@ -0,0 +1,185 @@
+#include "LoRaAdapterGroup.hpp"
+
+LoRaAdapterGroup::LoRaAdapterGroup(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void LoRaAdapterGroup::addAdapter(std::shared_ptr<LoRaUsbAdapter_E22_400T22U> adapter) {
+    if (!adapter || indexOf(adapter.get()) >= 0) return;
+
+    LoRaUsbAdapter_E22_400T22U *member = adapter.get();
+    member->setHoldOnDeviceFailure(true);
+    member->setStandby(!m_adapters.isEmpty());
+    member->setFrameForwarding(m_diversityEnabled);
+    m_adapters.append(adapter);
+    m_failed.append(false);
+    if (m_active < 0) {
+        m_active = 0;
+    }
+
+    connect(member, &LoRaUsbAdapter_E22_400T22U::packetSent, this, &LoRaAdapterGroup::packetSent);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::packetReceived, this, &LoRaAdapterGroup::packetReceived);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::packetReceivedToDevice,
+            this, &LoRaAdapterGroup::packetReceivedToDevice);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::packetReceivedPartial,
+            this, &LoRaAdapterGroup::packetReceivedPartial);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::packetProgress, this, &LoRaAdapterGroup::packetProgress);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::packetSendProgress,
+            this, &LoRaAdapterGroup::packetSendProgress);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::linkUp, this, &LoRaAdapterGroup::linkUp);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::linkDown, this, &LoRaAdapterGroup::linkDown);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::error, this, &LoRaAdapterGroup::error);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::frameHeard, this,
+            [this, member](const QByteArray &frame) { onFrameHeard(member, frame); });
+    connect(member, &LoRaUsbAdapter_E22_400T22U::frameDamaged, this, [this](const QByteArray &frame) {
+        // Damaged copies from every antenna feed the active adapter's frame recovery
+        if (LoRaUsbAdapter_E22_400T22U *active = activeAdapter()) {
+            active->recoverFrame(frame);
+        }
+    });
+    // Reported from inside a write; take over once the failed adapter has unwound
+    connect(member, &LoRaUsbAdapter_E22_400T22U::deviceFailed, this,
+            [this, member]() { onDeviceFailed(member); }, Qt::QueuedConnection);
+    connect(member, &LoRaUsbAdapter_E22_400T22U::linkDown, this, [this, member]() {
+        if (m_failoverOnLinkDown && member == activeAdapter()) {
+            failOver();
+        }
+    }, Qt::QueuedConnection);
+}
+
+int LoRaAdapterGroup::adapterCount() const {
+    return m_adapters.size();
+}
+
+LoRaUsbAdapter_E22_400T22U *LoRaAdapterGroup::adapter(int index) const {
+    return index >= 0 && index < m_adapters.size() ? m_adapters[index].get() : nullptr;
+}
+
+LoRaUsbAdapter_E22_400T22U *LoRaAdapterGroup::activeAdapter() const {
+    return adapter(m_active);
+}
+
+int LoRaAdapterGroup::activeIndex() const {
+    return m_active;
+}
+
+bool LoRaAdapterGroup::isFailed(int index) const {
+    return index >= 0 && index < m_failed.size() && m_failed[index];
+}
+
+void LoRaAdapterGroup::reinstate(int index) {
+    if (index < 0 || index >= m_failed.size()) return;
+
+    m_failed[index] = false;
+}
+
+void LoRaAdapterGroup::setFailoverOnLinkDown(bool enabled) {
+    m_failoverOnLinkDown = enabled;
+}
+
+bool LoRaAdapterGroup::isFailoverOnLinkDown() const {
+    return m_failoverOnLinkDown;
+}
+
+int LoRaAdapterGroup::failoverCount() const {
+    return m_failovers;
+}
+
+void LoRaAdapterGroup::setDiversityEnabled(bool enabled) {
+    if (enabled == m_diversityEnabled) return;
+
+    m_diversityEnabled = enabled;
+    if (enabled) {
+        m_combiner.reset();
+    }
+    for (const auto &member : m_adapters) {
+        member->setFrameForwarding(enabled);
+    }
+}
+
+bool LoRaAdapterGroup::isDiversityEnabled() const {
+    return m_diversityEnabled;
+}
+
+LoRaDiversityCombiner *LoRaAdapterGroup::diversityCombiner() {
+    return &m_combiner;
+}
+
+QVector<LoRaDiversityCombiner::AntennaStats> LoRaAdapterGroup::antennaStats() const {
+    QVector<LoRaDiversityCombiner::AntennaStats> stats = m_combiner.stats();
+    stats.resize(m_adapters.size());
+    for (int i = 0; i < m_adapters.size(); ++i) {
+        stats[i].crcErrors = m_adapters[i]->metrics().crcErrors;
+    }
+    return stats;
+}
+
+void LoRaAdapterGroup::sendPacket(const QByteArray &data, quint8 port) {
+    LoRaUsbAdapter_E22_400T22U *active = activeAdapter();
+    if (!active) {
+        emit error("No adapter in group");
+        emit packetSent(false, port);
+        return;
+    }
+
+    active->sendPacket(data, port);
+}
+
+void LoRaAdapterGroup::cancelSend() {
+    if (LoRaUsbAdapter_E22_400T22U *active = activeAdapter()) {
+        active->cancelSend();
+    }
+}
+
+bool LoRaAdapterGroup::isSending() const {
+    const LoRaUsbAdapter_E22_400T22U *active = activeAdapter();
+    return active && active->isSending();
+}
+
+bool LoRaAdapterGroup::failOver() {
+    const int next = nextStandby();
+    if (next < 0) {
+        emit error("No standby adapter to fail over to");
+        return false;
+    }
+
+    const int previous = m_active;
+    m_active = next;
+    m_failovers++;
+    m_adapters[next]->takeOver(*m_adapters[previous]);
+    emit failedOver(previous, next);
+    return true;
+}
+
+void LoRaAdapterGroup::onDeviceFailed(LoRaUsbAdapter_E22_400T22U *adapter) {
+    const int index = indexOf(adapter);
+    if (index < 0 || m_failed[index]) return;
+
+    m_failed[index] = true;
+    if (index == m_active) {
+        failOver();
+    }
+}
+
+void LoRaAdapterGroup::onFrameHeard(LoRaUsbAdapter_E22_400T22U *adapter, const QByteArray &frame) {
+    LoRaUsbAdapter_E22_400T22U *active = activeAdapter();
+    if (!active || !m_combiner.accept(frame, indexOf(adapter))) return;
+
+    active->receiveFrame(frame);
+}
+
+int LoRaAdapterGroup::nextStandby() const {
+    for (int step = 1; step < m_adapters.size(); ++step) {
+        const int index = (m_active + step) % m_adapters.size();
+        if (!m_failed[index] && m_adapters[index]->isDeviceOpen()) return index;
+    }
+    return -1;
+}
+
+int LoRaAdapterGroup::indexOf(const LoRaUsbAdapter_E22_400T22U *adapter) const {
+    for (int i = 0; i < m_adapters.size(); ++i) {
+        if (m_adapters[i].get() == adapter) return i;
+    }
+    return -1;
+}
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <memory>
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include "LoRaUsbAdapter_E22_400T22U.hpp"
+#include "LoRaDiversityCombiner.hpp"
+
+/**
+ * @file LoRaAdapterGroup.hpp
+ * @brief Header file for the LoRaAdapterGroup class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaAdapterGroup
+ * @brief Several dongles on one radio channel acting as one node
+ * @details The first adapter added is active; the others keep their dongles
+ *          open in standby (see LoRaUsbAdapter_E22_400T22U::setStandby()).
+ *          When the active dongle fails, the next healthy standby continues
+ *          its session with LoRaUsbAdapter_E22_400T22U::takeOver(): queued
+ *          packets, the chunk in flight and half-reassembled packets carry
+ *          over, and the frame in flight is resent at once, so the peer
+ *          sees the gap as at most one lost frame.
+ *
+ *          A failure is detected when a write to the active dongle fails or
+ *          times out (deviceFailed()). Members hold their packets on such a
+ *          failure instead of failing them, so nothing is reported lost
+ *          before the takeover. Optionally a link-down report of the
+ *          active adapter's link monitor fails over too, for a dongle that
+ *          still accepts writes but no longer reaches the air.
+ *
+ *          Every standby must use the same module settings (channel,
+ *          address, air rate) as the active dongle. Settings of the
+ *          protocol are taken over from the failed adapter; per-adapter
+ *          features such as the link monitor should be enabled on the
+ *          active adapter only.
+ *
+ *          With receive diversity (see setDiversityEnabled()), every
+ *          member hears the channel through its own antenna and hands its
+ *          CRC-valid frames to a LoRaDiversityCombiner. The first copy of
+ *          each frame goes to the active adapter, so one reassembly context
+ *          sees the union of what the antennas heard and a chunk is only
+ *          retransmitted when all of them missed it. Damaged frames go to
+ *          the active adapter's frame recovery, if enabled, so copies from
+ *          different antennas can be combined. Only the active adapter
+ *          transmits.
+ *
+ *          The group forwards the packet-path signals of its members and
+ *          sends through the active one.
+ */
+class LoRaAdapterGroup : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor for LoRaAdapterGroup
+     * @param parent Parent QObject for memory management (default: nullptr)
+     */
+    explicit LoRaAdapterGroup(QObject *parent = nullptr);
+
+    /**
+     * @brief Default destructor
+     */
+    ~LoRaAdapterGroup() override = default;
+
+    /**
+     * @brief Adds an adapter to the group
+     * @param adapter Adapter on its own dongle; the first one added becomes active
+     * @details Later adapters are put in standby. All members hold their
+     *          packets on a device failure.
+     */
+    void addAdapter(std::shared_ptr<LoRaUsbAdapter_E22_400T22U> adapter);
+
+    /**
+     * @brief Returns the number of adapters in the group
+     */
+    int adapterCount() const;
+
+    /**
+     * @brief Returns an adapter of the group
+     * @param index Index in the order of addAdapter()
+     * @return The adapter, or nullptr if index is out of range
+     */
+    LoRaUsbAdapter_E22_400T22U *adapter(int index) const;
+
+    /**
+     * @brief Returns the adapter currently carrying the session, or nullptr if the group is empty
+     */
+    LoRaUsbAdapter_E22_400T22U *activeAdapter() const;
+
+    /**
+     * @brief Returns the index of the active adapter, -1 if the group is empty
+     */
+    int activeIndex() const;
+
+    /**
+     * @brief Returns whether an adapter was taken out of service after a device failure
+     * @param index Index in the order of addAdapter()
+     */
+    bool isFailed(int index) const;
+
+    /**
+     * @brief Puts a failed adapter back into service as a standby
+     * @param index Index in the order of addAdapter()
+     * @details Call after its dongle was reconnected and reopened.
+     */
+    void reinstate(int index);
+
+    /**
+     * @brief Sets whether a link-down report of the active adapter fails over
+     * @param enabled true to fail over when the active adapter's link monitor
+     *        declares the link down
+     * @details Off by default: with the peer gone, every standby would be
+     *          tried in turn without helping.
+     */
+    void setFailoverOnLinkDown(bool enabled);
+
+    /**
+     * @brief Returns whether a link-down report fails over
+     */
+    bool isFailoverOnLinkDown() const;
+
+    /**
+     * @brief Returns the number of takeovers since construction
+     */
+    int failoverCount() const;
+
+    /**
+     * @brief Enables or disables receive diversity
+     * @param enabled true to combine the frames heard by all members
+     * @details Place the dongles' antennas apart, so that they fade
+     *          independently. Enabling restarts the antenna statistics.
+     */
+    void setDiversityEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether receive diversity is enabled
+     */
+    bool isDiversityEnabled() const;
+
+    /**
+     * @brief Returns the combiner, e.g. to change its window
+     */
+    LoRaDiversityCombiner *diversityCombiner();
+
+    /**
+     * @brief Returns the contribution of each member's antenna
+     * @return One entry per member, in the order of addAdapter(); crcErrors
+     *         is the member's LoRaUsbAdapter_E22_400T22U::Metrics::crcErrors
+     */
+    QVector<LoRaDiversityCombiner::AntennaStats> antennaStats() const;
+
+    /**
+     * @brief Sends a packet through the active adapter
+     * @param data Packet data
+     * @param port Logical port (default: 0)
+     * @see LoRaUsbAdapter_E22_400T22U::sendPacket()
+     */
+    void sendPacket(const QByteArray &data, quint8 port = 0);
+
+    /**
+     * @brief Aborts all packets being sent or queued on the active adapter
+     */
+    void cancelSend();
+
+    /**
+     * @brief Returns whether the active adapter is sending or has packets queued
+     */
+    bool isSending() const;
+
+public slots:
+    /**
+     * @brief Moves the session to the next healthy standby
+     * @return false if no standby has an open device
+     * @details The active adapter becomes a standby and is not marked failed.
+     */
+    bool failOver();
+
+signals:
+    /**
+     * @brief Signal emitted when a standby has taken over the session
+     * @param fromIndex Index of the adapter that was active
+     * @param toIndex Index of the adapter now active
+     */
+    void failedOver(int fromIndex, int toIndex);
+
+    /**
+     * @brief Forwarded LoRaUsbAdapter_E22_400T22U::packetSent()
+     */
+    void packetSent(bool success, quint8 port);
+
+    /**
+     * @brief Forwarded LoRaUsbAdapter_E22_400T22U::packetReceived()
+     */
+    void packetReceived(const QByteArray &data, quint8 port);
+
+    /**
+     * @brief Forwarded LoRaUsbAdapter_E22_400T22U::packetReceivedToDevice()
+     */
+    void packetReceivedToDevice(qint64 size, quint8 port);
+
+    /**
+     * @brief Forwarded LoRaUsbAdapter_E22_400T22U::packetReceivedPartial()
+     */
+    void packetReceivedPartial(const QByteArray &data, const QBitArray &present, int chunkSize, quint8 port);
+
+    /**
+     * @brief Forwarded LoRaUsbAdapter_E22_400T22U::packetProgress()
+     */
+    void packetProgress(int receivedBytes, int totalBytes, quint8 port);
+
+    /**
+     * @brief Forwarded LoRaUsbAdapter_E22_400T22U::packetSendProgress()
+     */
+    void packetSendProgress(int sentBytes, int totalBytes, quint8 port);
+
+    /**
+     * @brief Forwarded LoRaUsbAdapter_E22_400T22U::linkUp()
+     */
+    void linkUp();
+
+    /**
+     * @brief Forwarded LoRaUsbAdapter_E22_400T22U::linkDown()
+     */
+    void linkDown();
+
+    /**
+     * @brief Errors of the members, and a failover without a healthy standby
+     * @param msg Error message
+     */
+    void error(const QString &msg);
+
+private:
+    /**
+     * @brief Handles a device failure reported by a member
+     * @param adapter Member whose write failed
+     * @details Marks the member failed and fails over if it is the active one.
+     */
+    void onDeviceFailed(LoRaUsbAdapter_E22_400T22U *adapter);
+
+    /**
+     * @brief Passes the first copy of a frame to the active adapter
+     * @param adapter Member that heard the frame
+     * @param frame CRC-valid frame
+     */
+    void onFrameHeard(LoRaUsbAdapter_E22_400T22U *adapter, const QByteArray &frame);
+
+    /**
+     * @brief Returns the index of the next healthy standby after the active adapter, or -1
+     */
+    int nextStandby() const;
+
+    /**
+     * @brief Returns the index of a member, or -1
+     * @param adapter Member
+     */
+    int indexOf(const LoRaUsbAdapter_E22_400T22U *adapter) const;
+
+    /**
+     * @brief Members in the order of addAdapter()
+     */
+    QList<std::shared_ptr<LoRaUsbAdapter_E22_400T22U>> m_adapters;
+
+    /**
+     * @brief Per member, whether its device failed
+     */
+    QVector<bool> m_failed;
+
+    /**
+     * @brief Index of the active member, -1 while the group is empty
+     */
+    int m_active = -1;
+
+    /**
+     * @brief Whether a link-down report fails over
+     */
+    bool m_failoverOnLinkDown = false;
+
+    /**
+     * @brief Number of takeovers
+     */
+    int m_failovers = 0;
+
+    /**
+     * @brief Whether receive diversity is enabled
+     */
+    bool m_diversityEnabled = false;
+
+    /**
+     * @brief Combiner of the members' frames, indexed by member
+     */
+    LoRaDiversityCombiner m_combiner;
+};
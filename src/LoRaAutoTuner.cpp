@@ -0,0 +1,139 @@
+#include "LoRaAutoTuner.hpp"
+
+LoRaAutoTuner::LoRaAutoTuner(QObject *parent)
+    : QObject(parent)
+{
+    m_epochTimer.setInterval(DEFAULT_EPOCH_MS);
+    connect(&m_epochTimer, &QTimer::timeout, this, &LoRaAutoTuner::onEpoch);
+}
+
+void LoRaAutoTuner::start(int chunkSize, int ackDelayMs) {
+    const Setting setting{qBound(m_bounds.minChunkSize, chunkSize, m_bounds.maxChunkSize),
+                          qBound(m_bounds.minAckDelayMs, ackDelayMs, m_bounds.maxAckDelayMs)};
+    m_stats = Stats{};
+    m_direction = 0;
+    m_current = setting;
+    if (setting.chunkSize != chunkSize || setting.ackDelayMs != ackDelayMs) {
+        apply(setting);
+    } else {
+        m_active = setting;
+        m_stats.chunkSize = setting.chunkSize;
+        m_stats.ackDelayMs = setting.ackDelayMs;
+    }
+
+    m_clock.start();
+    resetEpoch();
+    m_epochTimer.start();
+}
+
+void LoRaAutoTuner::stop() {
+    m_epochTimer.stop();
+}
+
+bool LoRaAutoTuner::isRunning() const {
+    return m_epochTimer.isActive();
+}
+
+void LoRaAutoTuner::setBounds(const Bounds &bounds) {
+    m_bounds = bounds;
+    m_bounds.maxChunkSize = qMax(m_bounds.maxChunkSize, m_bounds.minChunkSize);
+    m_bounds.maxAckDelayMs = qMax(m_bounds.maxAckDelayMs, m_bounds.minAckDelayMs);
+    m_bounds.chunkSizeStep = qMax(m_bounds.chunkSizeStep, 1);
+    m_bounds.ackDelayStepMs = qMax(m_bounds.ackDelayStepMs, 1);
+}
+
+LoRaAutoTuner::Bounds LoRaAutoTuner::bounds() const {
+    return m_bounds;
+}
+
+void LoRaAutoTuner::setEpochDuration(int ms) {
+    m_epochTimer.setInterval(qMax(ms, 1));
+}
+
+void LoRaAutoTuner::recordBytes(int bytes) {
+    if (!isRunning()) return;
+
+    const qint64 now = m_clock.elapsed();
+    if (m_lastActivityMs >= 0 && now - m_lastActivityMs <= IDLE_GAP_MS) {
+        m_busyMs += now - m_lastActivityMs;
+    }
+    m_lastActivityMs = now;
+    m_epochBytes += bytes;
+}
+
+void LoRaAutoTuner::onEpoch() {
+    if (m_busyMs >= static_cast<qint64>(m_epochTimer.interval() * MIN_BUSY_FRACTION)) {
+        evaluate(m_epochBytes * 8000.0 / m_busyMs);
+    } else {
+        m_stats.skippedEpochs++;
+    }
+    resetEpoch();
+}
+
+void LoRaAutoTuner::evaluate(double goodputBps) {
+    if (!isRunning()) return;
+
+    m_stats.epochs++;
+    m_stats.lastGoodputBps = goodputBps;
+    if (!m_stats.probing) {
+        m_stats.baselineGoodputBps = goodputBps;
+        startProbe();
+        return;
+    }
+
+    if (goodputBps > m_stats.baselineGoodputBps * (1.0 + IMPROVEMENT_THRESHOLD)) {
+        // Keep going the same way while it pays off
+        m_stats.accepted++;
+        m_stats.baselineGoodputBps = goodputBps;
+        m_current = m_active;
+        startProbe();
+    } else {
+        // Back off and measure again: conditions may have changed meanwhile
+        m_stats.reverted++;
+        m_stats.probing = false;
+        m_direction = (m_direction + 1) % DIRECTIONS;
+        apply(m_current);
+    }
+}
+
+LoRaAutoTuner::Stats LoRaAutoTuner::stats() const {
+    return m_stats;
+}
+
+bool LoRaAutoTuner::neighbour(const Setting &from, int direction, Setting &to) const {
+    to = from;
+    switch (direction) {
+    case 0: to.chunkSize += m_bounds.chunkSizeStep; break;
+    case 1: to.chunkSize -= m_bounds.chunkSizeStep; break;
+    case 2: to.ackDelayMs += m_bounds.ackDelayStepMs; break;
+    default: to.ackDelayMs -= m_bounds.ackDelayStepMs; break;
+    }
+    return to.chunkSize >= m_bounds.minChunkSize && to.chunkSize <= m_bounds.maxChunkSize &&
+           to.ackDelayMs >= m_bounds.minAckDelayMs && to.ackDelayMs <= m_bounds.maxAckDelayMs;
+}
+
+void LoRaAutoTuner::startProbe() {
+    for (int i = 0; i < DIRECTIONS; ++i) {
+        Setting probe;
+        if (neighbour(m_current, m_direction, probe)) {
+            m_stats.probing = true;
+            apply(probe);
+            return;
+        }
+        m_direction = (m_direction + 1) % DIRECTIONS;
+    }
+    m_stats.probing = false;
+}
+
+void LoRaAutoTuner::apply(const Setting &setting) {
+    m_active = setting;
+    m_stats.chunkSize = setting.chunkSize;
+    m_stats.ackDelayMs = setting.ackDelayMs;
+    emit parametersChanged(setting.chunkSize, setting.ackDelayMs);
+}
+
+void LoRaAutoTuner::resetEpoch() {
+    m_lastActivityMs = -1;
+    m_busyMs = 0;
+    m_epochBytes = 0;
+}
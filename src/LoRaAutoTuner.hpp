@@ -0,0 +1,267 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+/**
+ * @file LoRaAutoTuner.hpp
+ * @brief Header file for the LoRaAutoTuner class
+ * @date 2026-10-18
+ */
+
+/**
+ * @class LoRaAutoTuner
+ * @brief Online hill-climber for chunk size and delayed-ACK window
+ * @details Channel conditions shift through the day, and a fixed setting is
+ *          only optimal at one point. The tuner measures goodput in epochs
+ *          and moves the parameters one step at a time:
+ *          1. An epoch at the current setting gives the baseline goodput
+ *          2. The next epoch runs at a neighbouring setting (one step up or
+ *             down in chunk size or ACK delay, within Bounds)
+ *          3. If the probe beats the baseline by IMPROVEMENT_THRESHOLD it
+ *             becomes the current setting and the next step goes the same
+ *             way; otherwise the tuner reverts and tries the next direction
+ *             after a fresh baseline
+ *
+ *          Goodput counts payload bytes acknowledged by the peer and
+ *          received from it, divided by the time the link was busy. Gaps
+ *          longer than IDLE_GAP_MS are not busy, so a lightly loaded link
+ *          does not look slow. Epochs busy for less than MIN_BUSY_FRACTION
+ *          of their duration are skipped, since they say little about the
+ *          setting.
+ *
+ *          Like LoRaLinkMonitor, the tuner only keeps state and timers; its
+ *          owner reports traffic with recordBytes() and applies
+ *          parametersChanged().
+ */
+class LoRaAutoTuner : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Bounds
+     * @brief Range and step of each tuned parameter
+     */
+    struct Bounds {
+        int minChunkSize = 8;       ///< Smallest chunk payload size in bytes
+        int maxChunkSize = 24;      ///< Largest chunk payload size in bytes
+        int chunkSizeStep = 4;      ///< Chunk size change per move
+        int minAckDelayMs = 0;      ///< Shortest delayed-ACK window
+        int maxAckDelayMs = 100;    ///< Longest delayed-ACK window, well below the minimum RTO
+        int ackDelayStepMs = 25;    ///< Delayed-ACK window change per move
+    };
+
+    /**
+     * @struct Stats
+     * @brief Tuner state, for monitoring
+     */
+    struct Stats {
+        int chunkSize = 0;              ///< Chunk size in effect (the probe while probing)
+        int ackDelayMs = 0;             ///< Delayed-ACK window in effect
+        double baselineGoodputBps = 0.0;///< Goodput of the accepted setting
+        double lastGoodputBps = 0.0;    ///< Goodput of the last evaluated epoch
+        quint32 epochs = 0;             ///< Epochs evaluated
+        quint32 skippedEpochs = 0;      ///< Epochs skipped for lack of traffic
+        quint32 accepted = 0;           ///< Probes that became the current setting
+        quint32 reverted = 0;           ///< Probes that were undone
+        bool probing = false;           ///< Whether the setting in effect is a probe
+    };
+
+    /**
+     * @brief Default epoch duration in milliseconds
+     */
+    static constexpr int DEFAULT_EPOCH_MS = 15000;
+
+    /**
+     * @brief Silence in milliseconds after which the link counts as idle
+     */
+    static constexpr int IDLE_GAP_MS = 2000;
+
+    /**
+     * @brief Fraction of an epoch the link must be busy for it to be evaluated
+     */
+    static constexpr double MIN_BUSY_FRACTION = 0.5;
+
+    /**
+     * @brief Relative goodput gain a probe needs to be accepted
+     */
+    static constexpr double IMPROVEMENT_THRESHOLD = 0.05;
+
+    /**
+     * @brief Constructor for LoRaAutoTuner
+     * @param parent Parent QObject for memory management (default: nullptr)
+     * @note The tuner is idle until start() is called.
+     */
+    explicit LoRaAutoTuner(QObject *parent = nullptr);
+
+    /**
+     * @brief Default destructor
+     */
+    ~LoRaAutoTuner() override = default;
+
+    /**
+     * @brief Starts tuning from the given setting
+     * @param chunkSize Current chunk size, clamped to the bounds
+     * @param ackDelayMs Current delayed-ACK window, clamped to the bounds
+     * @details Forgets the previous baseline. Emits parametersChanged() if
+     *          clamping changed the setting.
+     */
+    void start(int chunkSize, int ackDelayMs);
+
+    /**
+     * @brief Stops tuning and keeps the setting in effect
+     */
+    void stop();
+
+    /**
+     * @brief Returns whether the tuner is running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Sets the range and step of the tuned parameters
+     * @param bounds New bounds; takes effect at the next start()
+     */
+    void setBounds(const Bounds &bounds);
+
+    /**
+     * @brief Returns the range and step of the tuned parameters
+     */
+    Bounds bounds() const;
+
+    /**
+     * @brief Sets the epoch duration
+     * @param ms Epoch duration in milliseconds (default: DEFAULT_EPOCH_MS)
+     */
+    void setEpochDuration(int ms);
+
+    /**
+     * @brief Reports payload bytes acknowledged by or received from the peer
+     * @param bytes Payload bytes
+     * @details Also marks the link busy since the previous report, unless
+     *          that was more than IDLE_GAP_MS ago. Does nothing while stopped.
+     */
+    void recordBytes(int bytes);
+
+    /**
+     * @brief Evaluates the goodput of the epoch that just ended
+     * @param goodputBps Goodput at the setting in effect, in bits per second
+     * @details Called at the end of every busy epoch. Public so that an
+     *          owner with its own goodput measurement can drive the tuner.
+     * @note May emit parametersChanged()
+     */
+    void evaluate(double goodputBps);
+
+    /**
+     * @brief Returns the tuner state
+     */
+    Stats stats() const;
+
+signals:
+    /**
+     * @brief Signal emitted when the owner must apply a new setting
+     * @param chunkSize Chunk payload size in bytes
+     * @param ackDelayMs Delayed-ACK window in milliseconds
+     */
+    void parametersChanged(int chunkSize, int ackDelayMs);
+
+private slots:
+    /**
+     * @brief Slot called at the end of each epoch
+     * @details Evaluates the epoch if it was busy enough, then starts the next one.
+     */
+    void onEpoch();
+
+private:
+    /**
+     * @struct Setting
+     * @brief One point of the parameter space
+     */
+    struct Setting {
+        int chunkSize = 0;      ///< Chunk payload size in bytes
+        int ackDelayMs = 0;     ///< Delayed-ACK window in milliseconds
+    };
+
+    /**
+     * @brief Number of directions a probe can take
+     */
+    static constexpr int DIRECTIONS = 4;
+
+    /**
+     * @brief Returns the neighbour of a setting in a direction
+     * @param from Setting to move from
+     * @param direction 0/1: chunk size up/down, 2/3: ACK delay up/down
+     * @param to Output parameter for the neighbour
+     * @return false if the neighbour is out of bounds
+     */
+    bool neighbour(const Setting &from, int direction, Setting &to) const;
+
+    /**
+     * @brief Moves to a neighbour of the current setting, starting with m_direction
+     * @details Stays on the current setting if no neighbour is in bounds.
+     */
+    void startProbe();
+
+    /**
+     * @brief Makes a setting the one in effect and emits parametersChanged()
+     * @param setting Setting to apply
+     */
+    void apply(const Setting &setting);
+
+    /**
+     * @brief Clears the traffic counters of the epoch
+     */
+    void resetEpoch();
+
+    /**
+     * @brief Range and step of the tuned parameters
+     */
+    Bounds m_bounds;
+
+    /**
+     * @brief Accepted setting
+     */
+    Setting m_current;
+
+    /**
+     * @brief Setting in effect, a neighbour of m_current while probing
+     */
+    Setting m_active;
+
+    /**
+     * @brief Direction of the next probe
+     */
+    int m_direction = 0;
+
+    /**
+     * @brief Tuner state reported by stats()
+     */
+    Stats m_stats;
+
+    /**
+     * @brief Timer ending each epoch
+     */
+    QTimer m_epochTimer;
+
+    /**
+     * @brief Clock for busy time
+     */
+    QElapsedTimer m_clock;
+
+    /**
+     * @brief m_clock time of the last recordBytes(), -1 if none this epoch
+     */
+    qint64 m_lastActivityMs = -1;
+
+    /**
+     * @brief Busy time of the epoch in milliseconds
+     */
+    qint64 m_busyMs = 0;
+
+    /**
+     * @brief Payload bytes of the epoch
+     */
+    qint64 m_epochBytes = 0;
+};
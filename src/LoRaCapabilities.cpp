@@ -0,0 +1,74 @@
+#include "LoRaCapabilities.hpp"
+#include <QRandomGenerator>
+#include <QSysInfo>
+
+LoRaCapabilities LoRaCapabilities::legacy(quint8 maxPayload) {
+    LoRaCapabilities caps;
+    caps.maxPayload = maxPayload;
+    return caps;
+}
+
+quint32 LoRaCapabilities::defaultNodeId() {
+    const QByteArray machineId = QSysInfo::machineUniqueId();
+    quint32 id = 0;
+    if (!machineId.isEmpty()) {
+        // FNV-1a: stable across runs, unlike the seeded qHash()
+        id = 2166136261u;
+        for (quint8 byte : machineId) {
+            id = (id ^ byte) * 16777619u;
+        }
+    }
+    while (id == 0) {
+        id = QRandomGenerator::global()->generate();
+    }
+    return id;
+}
+
+bool LoRaCapabilities::isLegacy() const {
+    return version == 0;
+}
+
+bool LoRaCapabilities::has(Feature feature) const {
+    return (features & feature) != 0;
+}
+
+LoRaCapabilities LoRaCapabilities::negotiate(const LoRaCapabilities &peer) const {
+    LoRaCapabilities common;
+    common.version = qMin(version, peer.version);
+    common.features = common.version == 0 ? 0 : (features & peer.features);
+    common.maxPayload = qMin(maxPayload, peer.maxPayload);
+    common.nodeId = peer.nodeId;
+    return common;
+}
+
+QByteArray LoRaCapabilities::encode() const {
+    QByteArray data;
+    data.reserve(ENCODED_SIZE);
+    data.append(static_cast<char>(version));
+    for (int i = 0; i < 4; ++i) {
+        data.append(static_cast<char>((features >> (8 * i)) & 0xFF));
+    }
+    data.append(static_cast<char>(maxPayload));
+    for (int i = 0; i < 4; ++i) {
+        data.append(static_cast<char>((nodeId >> (8 * i)) & 0xFF));
+    }
+    return data;
+}
+
+bool LoRaCapabilities::decode(const QByteArray &data, LoRaCapabilities &caps) {
+    if (data.size() < ENCODED_SIZE) return false;
+
+    LoRaCapabilities decoded;
+    decoded.version = static_cast<quint8>(data[0]);
+    for (int i = 3; i >= 0; --i) {
+        decoded.features = (decoded.features << 8) | static_cast<quint8>(data[1 + i]);
+    }
+    decoded.maxPayload = static_cast<quint8>(data[5]);
+    for (int i = 3; i >= 0; --i) {
+        decoded.nodeId = (decoded.nodeId << 8) | static_cast<quint8>(data[6 + i]);
+    }
+    if (decoded.version == 0 || decoded.maxPayload == 0) return false;
+
+    caps = decoded;
+    return true;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QByteArray>
+
+/**
+ * @file LoRaCapabilities.hpp
+ * @brief Header file for the LoRaCapabilities struct
+ * @date 2026-10-18
+ */
+
+/**
+ * @struct LoRaCapabilities
+ * @brief Protocol capabilities announced in the HELLO handshake
+ * @details Each end announces what it supports; negotiate() yields the best
+ *          frame format and feature set both ends understand. A peer that
+ *          never answers HELLO is treated as legacy(): the original frame
+ *          format with no optional features. So is a peer no handshake
+ *          was started with: every feature is used only once announced.
+ *
+ *          Wire format (HELLO and HELLO_ACK payload, little-endian):
+ *          [Version(1)][Features(4)][MaxPayload(1)][NodeId(4)]
+ *
+ *          Trailing bytes are ignored by decode(), so later versions can
+ *          append fields without breaking older nodes.
+ */
+struct LoRaCapabilities {
+    /**
+     * @enum Feature
+     * @brief Optional protocol features, one bit each
+     */
+    enum Feature : quint32 {
+        DEDUP = 1u << 0,        ///< Understands DATA_REF frames (deduplication enabled)
+        LINK_PROBE = 1u << 1,   ///< Answers PING with PONG
+        PIGGYBACK_ACK = 1u << 2,///< Understands DATA_ACK frames (ACK carried on reverse data)
+        RPC = 1u << 3,          ///< Answers RPC_REQUEST frames (see LoRaRpc)
+        PUBSUB = 1u << 4,       ///< Packets start with a topic ID (see LoRaPubSub)
+        PORTS = 1u << 5,        ///< Accepts packets on logical ports other than 0
+        PARTIAL_RELIABILITY = 1u << 6 ///< Understands SKIP frames (abandoned chunks)
+    };
+
+    /**
+     * @brief Highest frame format version implemented by this node
+     */
+    static constexpr quint8 PROTOCOL_VERSION = 1;
+
+    /**
+     * @brief Size in bytes of the encoded capabilities
+     */
+    static constexpr int ENCODED_SIZE = 10;
+
+    quint8 version = 0;       ///< Frame format version (0 = legacy, no handshake)
+    quint32 features = 0;     ///< Bitwise OR of Feature values
+    quint8 maxPayload = 0;    ///< Largest chunk payload accepted, in bytes
+    quint32 nodeId = 0;       ///< Stable identifier of the node (0 = anonymous)
+
+    /**
+     * @brief Returns the capabilities assumed for a peer that does not answer HELLO
+     * @param maxPayload Chunk payload size of the original frame format
+     */
+    static LoRaCapabilities legacy(quint8 maxPayload);
+
+    /**
+     * @brief Returns a node identifier that stays the same across restarts
+     * @details Derived from the machine id when the platform provides one,
+     *          random otherwise. Never 0.
+     */
+    static quint32 defaultNodeId();
+
+    /**
+     * @brief Returns whether these are the capabilities of a legacy peer
+     */
+    bool isLegacy() const;
+
+    /**
+     * @brief Returns whether a feature is supported
+     * @param feature Feature to test
+     */
+    bool has(Feature feature) const;
+
+    /**
+     * @brief Returns what both ends support
+     * @param peer Capabilities announced by the peer
+     * @return Lowest common version and payload size, common features, and
+     *         the peer's node identifier
+     */
+    LoRaCapabilities negotiate(const LoRaCapabilities &peer) const;
+
+    /**
+     * @brief Encodes the capabilities for a HELLO or HELLO_ACK frame
+     * @return ENCODED_SIZE bytes
+     */
+    QByteArray encode() const;
+
+    /**
+     * @brief Decodes capabilities received from the peer
+     * @param data HELLO or HELLO_ACK payload
+     * @param caps Output parameter for the decoded capabilities
+     * @return true on success, false if data is too short or announces
+     *         version 0 or a payload size of 0
+     */
+    static bool decode(const QByteArray &data, LoRaCapabilities &caps);
+};
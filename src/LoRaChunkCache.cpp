@@ -0,0 +1,79 @@
+#include "LoRaChunkCache.hpp"
+#include <QCryptographicHash>
+
+LoRaChunkCache::LoRaChunkCache(int capacity)
+    : m_chunks(qMax(capacity, 0))
+{
+}
+
+quint64 LoRaChunkCache::keyOf(const QByteArray &chunk) {
+    const QByteArray digest = QCryptographicHash::hash(chunk, QCryptographicHash::Sha1);
+    quint64 key = 0;
+    for (int i = KEY_SIZE - 1; i >= 0; --i) {
+        key = (key << 8) | static_cast<quint8>(digest[i]);
+    }
+    return key;
+}
+
+QByteArray LoRaChunkCache::encodeKey(quint64 key) {
+    QByteArray data;
+    data.reserve(KEY_SIZE);
+    for (int i = 0; i < KEY_SIZE; ++i) {
+        data.append(static_cast<char>((key >> (8 * i)) & 0xFF));
+    }
+    return data;
+}
+
+bool LoRaChunkCache::decodeKey(const QByteArray &data, quint64 &key) {
+    if (data.size() != KEY_SIZE) return false;
+
+    key = 0;
+    for (int i = KEY_SIZE - 1; i >= 0; --i) {
+        key = (key << 8) | static_cast<quint8>(data[i]);
+    }
+    return true;
+}
+
+bool LoRaChunkCache::isCacheable(const QByteArray &chunk) {
+    return chunk.size() > KEY_SIZE;
+}
+
+quint64 LoRaChunkCache::insert(const QByteArray &chunk) {
+    const quint64 key = keyOf(chunk);
+    if (isCacheable(chunk) && m_chunks.maxCost() > 0) {
+        m_chunks.insert(key, new QByteArray(chunk));
+    }
+    return key;
+}
+
+bool LoRaChunkCache::contains(quint64 key) const {
+    return m_chunks.contains(key);
+}
+
+bool LoRaChunkCache::lookup(quint64 key, QByteArray &chunk) {
+    const QByteArray *cached = m_chunks.object(key);
+    if (!cached) return false;
+
+    chunk = *cached;
+    return true;
+}
+
+void LoRaChunkCache::remove(quint64 key) {
+    m_chunks.remove(key);
+}
+
+void LoRaChunkCache::clear() {
+    m_chunks.clear();
+}
+
+void LoRaChunkCache::setCapacity(int capacity) {
+    m_chunks.setMaxCost(qMax(capacity, 0));
+}
+
+int LoRaChunkCache::capacity() const {
+    return static_cast<int>(m_chunks.maxCost());
+}
+
+int LoRaChunkCache::size() const {
+    return static_cast<int>(m_chunks.size());
+}
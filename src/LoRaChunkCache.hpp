@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCache>
+
+/**
+ * @file LoRaChunkCache.hpp
+ * @brief Header file for the LoRaChunkCache class
+ * @date 2026-10-18
+ */
+
+/**
+ * @class LoRaChunkCache
+ * @brief Bounded cache of recently transferred chunks, keyed by content hash
+ * @details Backs the optional chunk deduplication of LoRaUsbAdapter_E22_400T22U.
+ *          Both ends of a link keep one cache and fill it with the same chunks:
+ *          the sender once a chunk is acknowledged, the receiver once a chunk
+ *          arrives. A sender can then replace a chunk the peer already holds
+ *          with its KEY_SIZE-byte key.
+ *
+ *          The caches are only loosely synchronised: either end may evict an
+ *          entry the other still holds. A receiver that cannot resolve a key
+ *          answers with NACK and the sender falls back to the full chunk.
+ *
+ *          The key is the first KEY_SIZE bytes of the SHA-1 of the chunk
+ *          interpreted as a little-endian integer. Eviction is least recently
+ *          used, as provided by QCache.
+ */
+class LoRaChunkCache
+{
+public:
+    /**
+     * @brief Size in bytes of a chunk key on the wire
+     */
+    static constexpr int KEY_SIZE = 8;
+
+    /**
+     * @brief Default number of chunks kept in the cache
+     */
+    static constexpr int DEFAULT_CAPACITY = 4096;
+
+    /**
+     * @brief Constructor for LoRaChunkCache
+     * @param capacity Maximum number of chunks kept (default: DEFAULT_CAPACITY)
+     */
+    explicit LoRaChunkCache(int capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Calculates the key of a chunk
+     * @param chunk Chunk payload
+     * @return Truncated SHA-1 of the payload
+     */
+    static quint64 keyOf(const QByteArray &chunk);
+
+    /**
+     * @brief Encodes a key for transmission
+     * @param key Key to encode
+     * @return KEY_SIZE bytes, little-endian
+     */
+    static QByteArray encodeKey(quint64 key);
+
+    /**
+     * @brief Decodes a key received from the peer
+     * @param data Encoded key
+     * @param key Output parameter for the decoded key
+     * @return true on success, false if data is not KEY_SIZE bytes long
+     */
+    static bool decodeKey(const QByteArray &data, quint64 &key);
+
+    /**
+     * @brief Tells whether a chunk is worth replacing with its key
+     * @param chunk Chunk payload
+     * @return true if the chunk is longer than a key
+     */
+    static bool isCacheable(const QByteArray &chunk);
+
+    /**
+     * @brief Adds a chunk to the cache, evicting the least recently used one if full
+     * @param chunk Chunk payload
+     * @return Key of the chunk
+     * @note Chunks that are not cacheable are not stored.
+     */
+    quint64 insert(const QByteArray &chunk);
+
+    /**
+     * @brief Tells whether a chunk is cached, without touching its LRU position
+     * @param key Key of the chunk
+     * @return true if the chunk is cached
+     */
+    bool contains(quint64 key) const;
+
+    /**
+     * @brief Looks up a cached chunk and marks it as recently used
+     * @param key Key of the chunk
+     * @param chunk Output parameter for the chunk payload
+     * @return true if the chunk was found
+     */
+    bool lookup(quint64 key, QByteArray &chunk);
+
+    /**
+     * @brief Drops a chunk from the cache
+     * @param key Key of the chunk
+     * @details Used by the sender when the peer reported a miss, so that the
+     *          chunk is not referenced again until it has been resent in full.
+     */
+    void remove(quint64 key);
+
+    /**
+     * @brief Removes all chunks from the cache
+     */
+    void clear();
+
+    /**
+     * @brief Changes the maximum number of chunks kept
+     * @param capacity New capacity; excess chunks are evicted immediately
+     */
+    void setCapacity(int capacity);
+
+    /**
+     * @brief Returns the maximum number of chunks kept
+     */
+    int capacity() const;
+
+    /**
+     * @brief Returns the number of chunks currently cached
+     */
+    int size() const;
+
+private:
+    /**
+     * @brief Chunk storage, one unit of cost per chunk
+     */
+    QCache<quint64, QByteArray> m_chunks;
+};
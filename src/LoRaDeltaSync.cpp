@@ -0,0 +1,271 @@
+#include "LoRaDeltaSync.hpp"
+#include <QCryptographicHash>
+#include <cmath>
+
+quint32 LoRaDeltaSync::weakChecksum(const char *data, int len) {
+    quint32 a = 0;
+    quint32 b = 0;
+    for (int i = 0; i < len; ++i) {
+        const quint8 byte = static_cast<quint8>(data[i]);
+        a += byte;
+        b += static_cast<quint32>(len - i) * byte;
+    }
+    return (a & 0xFFFF) | ((b & 0xFFFF) << 16);
+}
+
+quint16 LoRaDeltaSync::strongHash(const char *data, int len) {
+    const QByteArray digest = QCryptographicHash::hash(QByteArray::fromRawData(data, len),
+                                                       QCryptographicHash::Sha1);
+    return static_cast<quint16>(static_cast<quint8>(digest[0])) |
+           (static_cast<quint16>(static_cast<quint8>(digest[1])) << 8);
+}
+
+void LoRaDeltaSync::appendVarint(QByteArray &out, quint32 value) {
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+bool LoRaDeltaSync::readVarint(const QByteArray &in, int &pos, quint32 &value) {
+    value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        if (pos >= in.size()) return false;
+        const quint8 byte = static_cast<quint8>(in[pos++]);
+        value |= static_cast<quint32>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+void LoRaDeltaSync::flushCopy(QByteArray &out, quint32 firstBlock, quint32 &blockCount) {
+    if (blockCount == 0) return;
+    out.append(static_cast<char>(DeltaOp::COPY));
+    appendVarint(out, firstBlock);
+    appendVarint(out, blockCount);
+    blockCount = 0;
+}
+
+void LoRaDeltaSync::flushLiteral(QByteArray &out, QByteArray &literal) {
+    if (literal.isEmpty()) return;
+    out.append(static_cast<char>(DeltaOp::LITERAL));
+    appendVarint(out, static_cast<quint32>(literal.size()));
+    out.append(literal);
+    literal.clear();
+}
+
+QByteArray LoRaDeltaSync::makeSignature(const QByteArray &base, int blockSize) {
+    if (blockSize <= 0) {
+        const int root = static_cast<int>(std::sqrt(static_cast<double>(base.size())));
+        blockSize = qBound(MIN_BLOCK_SIZE, root, MAX_BLOCK_SIZE);
+    }
+
+    const int blocks = (base.size() + blockSize - 1) / blockSize;
+    QByteArray sig;
+    sig.reserve(1 + 10 + blocks * SIGNATURE_ENTRY_SIZE);
+    sig.append(SIGNATURE_MAGIC);
+    appendVarint(sig, static_cast<quint32>(blockSize));
+    appendVarint(sig, static_cast<quint32>(base.size()));
+
+    for (int i = 0; i < blocks; ++i) {
+        const char *block = base.constData() + i * blockSize;
+        const int len = qMin(blockSize, base.size() - i * blockSize);
+        const quint32 weak = weakChecksum(block, len);
+        const quint16 strong = strongHash(block, len);
+        // Append weak as little-endian 32-bit value
+        sig.append(static_cast<char>(weak & 0xFF));
+        sig.append(static_cast<char>((weak >> 8) & 0xFF));
+        sig.append(static_cast<char>((weak >> 16) & 0xFF));
+        sig.append(static_cast<char>((weak >> 24) & 0xFF));
+        // Append strong as little-endian 16-bit value
+        sig.append(static_cast<char>(strong & 0xFF));
+        sig.append(static_cast<char>((strong >> 8) & 0xFF));
+    }
+    return sig;
+}
+
+QByteArray LoRaDeltaSync::makeDelta(const QByteArray &signature, const QByteArray &target) {
+    if (signature.isEmpty() || signature[0] != SIGNATURE_MAGIC) return {};
+
+    int pos = 1;
+    quint32 blockSizeField = 0;
+    quint32 baseSize = 0;
+    if (!readVarint(signature, pos, blockSizeField) || !readVarint(signature, pos, baseSize)) return {};
+    if (blockSizeField == 0 || blockSizeField > 0xFFFF) return {};
+
+    const int blockSize = static_cast<int>(blockSizeField);
+    // In 64 bits: a forged base size must neither wrap to zero blocks nor
+    // overflow the expected signature size
+    const quint64 blockCount = (static_cast<quint64>(baseSize) + blockSizeField - 1) / blockSizeField;
+    if (blockCount == 0 && baseSize != 0) return {};
+    if (static_cast<quint64>(signature.size() - pos) != blockCount * SIGNATURE_ENTRY_SIZE) return {};
+    const int blocks = static_cast<int>(blockCount);
+
+    // Only full blocks take part in the rolling search; a short trailing
+    // block can only match the tail of the target
+    const int tailLen = static_cast<int>(baseSize % blockSizeField);
+    const int fullBlocks = tailLen ? blocks - 1 : blocks;
+
+    // Index the receiver's blocks by weak checksum
+    QHash<quint32, QList<quint32>> weakIndex;
+    QList<quint32> weaks;
+    QList<quint16> strongs;
+    weakIndex.reserve(fullBlocks);
+    weaks.reserve(blocks);
+    strongs.reserve(blocks);
+    for (int i = 0; i < blocks; ++i) {
+        const int off = pos + i * SIGNATURE_ENTRY_SIZE;
+        const quint32 weak = static_cast<quint32>(static_cast<quint8>(signature[off])) |
+                             (static_cast<quint32>(static_cast<quint8>(signature[off + 1])) << 8) |
+                             (static_cast<quint32>(static_cast<quint8>(signature[off + 2])) << 16) |
+                             (static_cast<quint32>(static_cast<quint8>(signature[off + 3])) << 24);
+        const quint16 strong = static_cast<quint16>(static_cast<quint8>(signature[off + 4])) |
+                               (static_cast<quint16>(static_cast<quint8>(signature[off + 5])) << 8);
+        if (i < fullBlocks) {
+            weakIndex[weak].append(static_cast<quint32>(i));
+        }
+        weaks.append(weak);
+        strongs.append(strong);
+    }
+
+    QByteArray delta;
+    delta.append(DELTA_MAGIC);
+    appendVarint(delta, blockSizeField);
+    appendVarint(delta, static_cast<quint32>(target.size()));
+    delta.append(QCryptographicHash::hash(target, QCryptographicHash::Sha1).left(TARGET_HASH_SIZE));
+
+    const char *data = target.constData();
+    const int size = target.size();
+    QByteArray literal;
+    quint32 runFirst = 0;
+    quint32 runCount = 0;
+    int cur = 0;
+
+    quint32 a = 0;
+    quint32 b = 0;
+    if (fullBlocks > 0 && size >= blockSize) {
+        const quint32 weak = weakChecksum(data, blockSize);
+        a = weak & 0xFFFF;
+        b = weak >> 16;
+    }
+
+    while (fullBlocks > 0 && cur + blockSize <= size) {
+        const quint32 weak = (a & 0xFFFF) | ((b & 0xFFFF) << 16);
+        qint64 match = -1;
+        const auto it = weakIndex.constFind(weak);
+        if (it != weakIndex.constEnd()) {
+            const quint16 strong = strongHash(data + cur, blockSize);
+            for (quint32 candidate : it.value()) {
+                if (strongs[candidate] != strong) continue;
+                match = candidate;
+                // Prefer the block that extends the current COPY run
+                if (runCount > 0 && candidate == runFirst + runCount) break;
+            }
+        }
+
+        if (match >= 0) {
+            flushLiteral(delta, literal);
+            if (runCount > 0 && static_cast<quint32>(match) == runFirst + runCount) {
+                runCount++;
+            } else {
+                flushCopy(delta, runFirst, runCount);
+                runFirst = static_cast<quint32>(match);
+                runCount = 1;
+            }
+            cur += blockSize;
+            if (cur + blockSize <= size) {
+                const quint32 next = weakChecksum(data + cur, blockSize);
+                a = next & 0xFFFF;
+                b = next >> 16;
+            }
+            continue;
+        }
+
+        flushCopy(delta, runFirst, runCount);
+        const quint8 out = static_cast<quint8>(data[cur]);
+        literal.append(data[cur]);
+        if (cur + blockSize < size) {
+            // Roll the window one byte forward
+            const quint8 in = static_cast<quint8>(data[cur + blockSize]);
+            a = a - out + in;
+            b = b - static_cast<quint32>(blockSize) * out + a;
+        }
+        cur++;
+    }
+
+    const int tailBlock = blocks - 1;
+    if (tailLen > 0 && size - cur == tailLen &&
+        weakChecksum(data + cur, tailLen) == weaks[tailBlock] &&
+        strongHash(data + cur, tailLen) == strongs[tailBlock]) {
+        flushLiteral(delta, literal);
+        if (runCount > 0 && static_cast<quint32>(tailBlock) == runFirst + runCount) {
+            runCount++;
+        } else {
+            flushCopy(delta, runFirst, runCount);
+            runFirst = static_cast<quint32>(tailBlock);
+            runCount = 1;
+        }
+        cur = size;
+    }
+
+    flushCopy(delta, runFirst, runCount);
+    literal.append(target.mid(cur));
+    flushLiteral(delta, literal);
+    return delta;
+}
+
+bool LoRaDeltaSync::applyDelta(const QByteArray &base, const QByteArray &delta, QByteArray &result) {
+    if (delta.isEmpty() || delta[0] != DELTA_MAGIC) return false;
+
+    int pos = 1;
+    quint32 blockSize = 0;
+    quint32 targetSize = 0;
+    if (!readVarint(delta, pos, blockSize) || !readVarint(delta, pos, targetSize)) return false;
+    if (blockSize == 0 || delta.size() - pos < TARGET_HASH_SIZE) return false;
+
+    const QByteArray targetHash = delta.mid(pos, TARGET_HASH_SIZE);
+    pos += TARGET_HASH_SIZE;
+
+    // Blocks that can be copied from the base, counting a short last block
+    const qint64 baseBlocks = base.size() / blockSize + 1;
+
+    QByteArray out;
+    // The target size is not verified yet, so it must not drive a large allocation
+    out.reserve(static_cast<int>(qMin<qint64>(targetSize, base.size() + delta.size())));
+    while (pos < delta.size()) {
+        const auto op = static_cast<DeltaOp>(static_cast<quint8>(delta[pos++]));
+        quint32 first = 0;
+        quint32 count = 0;
+        switch (op) {
+        case DeltaOp::COPY: {
+            if (!readVarint(delta, pos, first) || !readVarint(delta, pos, count)) return false;
+            // Bounded before multiplying, so the offsets cannot overflow
+            if (first > baseBlocks || count > baseBlocks) return false;
+            const qint64 start = static_cast<qint64>(first) * blockSize;
+            qint64 len = static_cast<qint64>(count) * blockSize;
+            // Only the last block of the base may be short
+            if (count == 0 || start + len - blockSize >= base.size()) return false;
+            len = qMin(len, base.size() - start);
+            out.append(base.constData() + start, static_cast<int>(len));
+            break;
+        }
+        case DeltaOp::LITERAL: {
+            if (!readVarint(delta, pos, count)) return false;
+            if (count > static_cast<quint32>(delta.size() - pos)) return false;
+            out.append(delta.constData() + pos, static_cast<int>(count));
+            pos += static_cast<int>(count);
+            break;
+        }
+        default:
+            return false;
+        }
+        if (static_cast<quint32>(out.size()) > targetSize) return false;
+    }
+
+    if (static_cast<quint32>(out.size()) != targetSize) return false;
+    if (QCryptographicHash::hash(out, QCryptographicHash::Sha1).left(TARGET_HASH_SIZE) != targetHash) return false;
+
+    result = out;
+    return true;
+}
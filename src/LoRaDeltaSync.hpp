@@ -0,0 +1,165 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+/**
+ * @file LoRaDeltaSync.hpp
+ * @brief Header file for the LoRaDeltaSync class
+ * @date 2026-10-18
+ */
+
+/**
+ * @class LoRaDeltaSync
+ * @brief rsync-style delta encoder for files and configuration blobs
+ * @details Lets a sender transmit only the parts of a blob that changed
+ *          relative to the version the receiver already holds. The exchange
+ *          is layered on top of the reliable packet API: every message below
+ *          is an ordinary packet passed to sendPacket().
+ *
+ *          Exchange:
+ *          1. Receiver calls makeSignature() on its current version and sends it
+ *          2. Sender calls makeDelta() with that signature and the new version
+ *             and sends the result
+ *          3. Receiver calls applyDelta() on its current version to rebuild
+ *             the new one; the result is verified against a hash of the target
+ *
+ *          Signature format:
+ *          [Magic 'S'(1)][BlockSize(varint)][BaseSize(varint)]
+ *          then per block: [Weak(4)][Strong(2)]
+ *
+ *          Delta format:
+ *          [Magic 'D'(1)][BlockSize(varint)][TargetSize(varint)][TargetHash(4)]
+ *          then a list of operations (see DeltaOp enum):
+ *          - COPY:    [0x01][FirstBlock(varint)][BlockCount(varint)]
+ *          - LITERAL: [0x02][Length(varint)][Bytes...]
+ *
+ *          The weak checksum is the rsync rolling checksum, so matching blocks
+ *          are found at any byte offset of the target, not only at block
+ *          boundaries. Airtime is therefore proportional to the change plus
+ *          a signature of SIGNATURE_ENTRY_SIZE bytes per block.
+ */
+class LoRaDeltaSync
+{
+public:
+    /**
+     * @enum DeltaOp
+     * @brief Operation codes used inside a delta
+     */
+    enum class DeltaOp : quint8 {
+        COPY = 0x01,     ///< Copy a run of blocks from the receiver's base version
+        LITERAL = 0x02   ///< Insert literal bytes carried in the delta
+    };
+
+    /**
+     * @brief Smallest block size chosen automatically by makeSignature()
+     */
+    static constexpr int MIN_BLOCK_SIZE = 32;
+
+    /**
+     * @brief Largest block size chosen automatically by makeSignature()
+     */
+    static constexpr int MAX_BLOCK_SIZE = 1024;
+
+    /**
+     * @brief Size in bytes of one block entry in a signature (weak + strong)
+     */
+    static constexpr int SIGNATURE_ENTRY_SIZE = 6;
+
+    /**
+     * @brief Builds the block signature of the receiver's current version
+     * @param base The version currently held by the receiver
+     * @param blockSize Block size in bytes, or 0 to pick one from the base size
+     * @return Encoded signature, ready to be sent with sendPacket()
+     * @details When blockSize is 0 the block size is roughly the square root
+     *          of the base size, clamped to [MIN_BLOCK_SIZE, MAX_BLOCK_SIZE],
+     *          which balances signature size against match granularity.
+     *          A trailing partial block is signed too, but can only match
+     *          the tail of the target.
+     */
+    static QByteArray makeSignature(const QByteArray &base, int blockSize = 0);
+
+    /**
+     * @brief Computes the delta that turns the receiver's version into target
+     * @param signature Signature received from the peer (see makeSignature())
+     * @param target The new version to be transferred
+     * @return Encoded delta, or an empty array if the signature is malformed
+     */
+    static QByteArray makeDelta(const QByteArray &signature, const QByteArray &target);
+
+    /**
+     * @brief Rebuilds the target version from the base version and a delta
+     * @param base The version the signature was computed from
+     * @param delta Delta received from the peer (see makeDelta())
+     * @param result Output parameter for the rebuilt version
+     * @return true if the delta was applied and the result hash matches,
+     *         false if the delta is malformed or does not fit this base
+     * @note On failure the caller should fall back to a full transfer.
+     */
+    static bool applyDelta(const QByteArray &base, const QByteArray &delta, QByteArray &result);
+
+    /**
+     * @brief Calculates the rsync rolling weak checksum of a block
+     * @param data Pointer to the first byte of the block
+     * @param len Length of the block in bytes
+     * @return 32-bit checksum with the byte sum in the low and the
+     *         position-weighted sum in the high 16 bits
+     */
+    static quint32 weakChecksum(const char *data, int len);
+
+private:
+    /**
+     * @brief Magic byte identifying a signature
+     */
+    static constexpr char SIGNATURE_MAGIC = 'S';
+
+    /**
+     * @brief Magic byte identifying a delta
+     */
+    static constexpr char DELTA_MAGIC = 'D';
+
+    /**
+     * @brief Size in bytes of the target hash stored in a delta
+     */
+    static constexpr int TARGET_HASH_SIZE = 4;
+
+    /**
+     * @brief Calculates the truncated strong hash of a block
+     * @param data Pointer to the first byte of the block
+     * @param len Length of the block in bytes
+     * @return First two bytes of the SHA-1 digest as a little-endian value
+     */
+    static quint16 strongHash(const char *data, int len);
+
+    /**
+     * @brief Appends an unsigned LEB128 varint to a buffer
+     * @param out Buffer to append to
+     * @param value Value to encode
+     */
+    static void appendVarint(QByteArray &out, quint32 value);
+
+    /**
+     * @brief Reads an unsigned LEB128 varint from a buffer
+     * @param in Buffer to read from
+     * @param pos Read position, advanced past the varint on success
+     * @param value Output parameter for the decoded value
+     * @return true on success, false if the buffer ends inside the varint
+     */
+    static bool readVarint(const QByteArray &in, int &pos, quint32 &value);
+
+    /**
+     * @brief Appends a pending COPY run to a delta and clears it
+     * @param out Delta buffer to append to
+     * @param firstBlock First block of the run
+     * @param blockCount Number of blocks in the run (nothing appended if 0)
+     */
+    static void flushCopy(QByteArray &out, quint32 firstBlock, quint32 &blockCount);
+
+    /**
+     * @brief Appends pending literal bytes to a delta and clears them
+     * @param out Delta buffer to append to
+     * @param literal Pending literal bytes (nothing appended if empty)
+     */
+    static void flushLiteral(QByteArray &out, QByteArray &literal);
+};
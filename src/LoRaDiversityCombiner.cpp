@@ -0,0 +1,65 @@
+#include "LoRaDiversityCombiner.hpp"
+
+LoRaDiversityCombiner::LoRaDiversityCombiner(int windowMs)
+    : m_windowMs(qMax(windowMs, 0))
+{
+    m_clock.start();
+}
+
+void LoRaDiversityCombiner::setWindow(int ms) {
+    m_windowMs = qMax(ms, 0);
+}
+
+int LoRaDiversityCombiner::window() const {
+    return m_windowMs;
+}
+
+bool LoRaDiversityCombiner::accept(const QByteArray &frame, int antenna) {
+    return accept(frame, antenna, m_clock.elapsed());
+}
+
+bool LoRaDiversityCombiner::accept(const QByteArray &frame, int antenna, qint64 nowMs) {
+    if (antenna < 0 || antenna >= MAX_ANTENNAS) return true;
+
+    expire(nowMs);
+    if (antenna >= m_stats.size()) {
+        m_stats.resize(antenna + 1);
+    }
+    m_stats[antenna].framesHeard++;
+
+    const quint32 bit = 1u << antenna;
+    const auto it = m_recent.find(frame);
+    if (it != m_recent.end()) {
+        it->antennas |= bit;
+        return false;
+    }
+
+    m_recent.insert(frame, Copies{nowMs, antenna, bit});
+    m_order.enqueue(frame);
+    m_stats[antenna].framesFirst++;
+    return true;
+}
+
+QVector<LoRaDiversityCombiner::AntennaStats> LoRaDiversityCombiner::stats() const {
+    return m_stats;
+}
+
+void LoRaDiversityCombiner::reset() {
+    m_recent.clear();
+    m_order.clear();
+    m_stats.clear();
+}
+
+void LoRaDiversityCombiner::expire(qint64 nowMs) {
+    while (!m_order.isEmpty()) {
+        const auto it = m_recent.constFind(m_order.head());
+        if (nowMs - it->firstMs < m_windowMs) break;
+
+        if ((it->antennas & (it->antennas - 1)) == 0) {
+            // Only one antenna heard it
+            m_stats[it->firstAntenna].framesExclusive++;
+        }
+        m_recent.erase(it);
+        m_order.dequeue();
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QQueue>
+#include <QVector>
+#include <QElapsedTimer>
+
+/**
+ * @file LoRaDiversityCombiner.hpp
+ * @brief Header file for the LoRaDiversityCombiner class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaDiversityCombiner
+ * @brief Selection combining of frames heard by several antennas
+ * @details Backs the receive diversity of LoRaAdapterGroup. Every dongle on
+ *          the channel hears the same transmission; the combiner passes the
+ *          first CRC-valid copy of a frame and drops the copies that arrive
+ *          from the other antennas within the combining window. A frame one
+ *          antenna misses is still delivered if another one hears it.
+ *
+ *          Copies are recognised by their bytes. The window must be shorter
+ *          than the peer's shortest retransmission timeout, so that a
+ *          retransmission, which is byte-identical too, is passed again and
+ *          acknowledged.
+ *
+ *          Per antenna, the combiner counts the frames heard, the frames it
+ *          contributed first, and the frames no other antenna heard, which
+ *          are retransmissions saved by diversity.
+ */
+class LoRaDiversityCombiner
+{
+public:
+    /**
+     * @brief Default combining window in milliseconds
+     * @details Below the adapter's minimum retransmission timeout of 200 ms.
+     */
+    static constexpr int DEFAULT_WINDOW_MS = 100;
+
+    /**
+     * @brief Number of antennas that can be told apart
+     */
+    static constexpr int MAX_ANTENNAS = 32;
+
+    /**
+     * @struct AntennaStats
+     * @brief Contribution of one antenna
+     */
+    struct AntennaStats {
+        quint64 framesHeard = 0;     ///< CRC-valid frames heard
+        quint64 framesFirst = 0;     ///< Frames this antenna delivered first
+        quint64 framesExclusive = 0; ///< Frames heard by no other antenna, counted once the window has passed
+        quint64 crcErrors = 0;       ///< Damaged frames, filled in by the owner of the receivers
+    };
+
+    /**
+     * @brief Constructor for LoRaDiversityCombiner
+     * @param windowMs Combining window in milliseconds (default: DEFAULT_WINDOW_MS)
+     */
+    explicit LoRaDiversityCombiner(int windowMs = DEFAULT_WINDOW_MS);
+
+    /**
+     * @brief Sets the combining window
+     * @param ms Time in milliseconds during which copies of a frame are dropped
+     */
+    void setWindow(int ms);
+
+    /**
+     * @brief Returns the combining window in milliseconds
+     */
+    int window() const;
+
+    /**
+     * @brief Decides whether a frame is the first copy
+     * @param frame CRC-valid frame
+     * @param antenna Antenna that heard it, below MAX_ANTENNAS
+     * @return true if the frame should be handled, false for a copy
+     * @note Frames from an antenna out of range are always passed and not counted.
+     */
+    bool accept(const QByteArray &frame, int antenna);
+
+    /**
+     * @brief Decides whether a frame is the first copy, at a given time
+     * @param frame CRC-valid frame
+     * @param antenna Antenna that heard it
+     * @param nowMs Current time in milliseconds, never decreasing
+     * @return true if the frame should be handled, false for a copy
+     */
+    bool accept(const QByteArray &frame, int antenna, qint64 nowMs);
+
+    /**
+     * @brief Returns the statistics of each antenna heard so far
+     * @return One entry per antenna up to the highest one heard
+     */
+    QVector<AntennaStats> stats() const;
+
+    /**
+     * @brief Forgets the recent frames and clears the statistics
+     */
+    void reset();
+
+private:
+    /**
+     * @struct Copies
+     * @brief Antennas that heard a recent frame
+     */
+    struct Copies {
+        qint64 firstMs = 0;     ///< Time of the first copy
+        int firstAntenna = 0;   ///< Antenna of the first copy
+        quint32 antennas = 0;   ///< Bit per antenna that heard the frame
+    };
+
+    /**
+     * @brief Forgets the frames whose window has passed
+     * @param nowMs Current time in milliseconds
+     */
+    void expire(qint64 nowMs);
+
+    /**
+     * @brief Combining window in milliseconds
+     */
+    int m_windowMs;
+
+    /**
+     * @brief Clock of accept() without a time
+     */
+    QElapsedTimer m_clock;
+
+    /**
+     * @brief Frames still within their window
+     */
+    QHash<QByteArray, Copies> m_recent;
+
+    /**
+     * @brief Keys of m_recent, oldest first
+     */
+    QQueue<QByteArray> m_order;
+
+    /**
+     * @brief Statistics per antenna
+     */
+    QVector<AntennaStats> m_stats;
+};
@@ -0,0 +1,201 @@
+#include "LoRaFrameRecovery.hpp"
+#include <algorithm>
+
+LoRaFrameRecovery::LoRaFrameRecovery(int capacity)
+    : m_capacity(qMax(capacity, 1))
+{
+}
+
+void LoRaFrameRecovery::setValidator(Validator validator) {
+    m_validator = std::move(validator);
+}
+
+void LoRaFrameRecovery::setMaxCandidates(int count) {
+    m_maxCandidates = qMax(count, 1);
+}
+
+int LoRaFrameRecovery::maxCandidates() const {
+    return m_maxCandidates;
+}
+
+void LoRaFrameRecovery::setMaxAge(int ms) {
+    m_maxAgeMs = qMax(ms, 0);
+}
+
+int LoRaFrameRecovery::maxAge() const {
+    return m_maxAgeMs;
+}
+
+QByteArray LoRaFrameRecovery::recover(const QByteArray &damaged, qint64 nowMs) {
+    m_stats.offered++;
+    while (!m_copies.isEmpty() && nowMs - m_copies.first().atMs > m_maxAgeMs) {
+        m_copies.removeFirst();
+    }
+
+    // Newest first, so that ties in the vote favour the latest copy
+    QList<QByteArray> group{damaged};
+    QList<int> used;
+    for (int i = m_copies.size() - 1; i >= 0; --i) {
+        if (isSimilar(damaged, m_copies[i].frame)) {
+            group.append(m_copies[i].frame);
+            used.append(i);
+        }
+    }
+
+    QByteArray recovered;
+    if (group.size() > 1 && m_validator) {
+        QList<QByteArray> alternatives;
+        const QByteArray voted = vote(group, alternatives);
+
+        QList<QByteArray> candidates{voted};
+        bool withinBudget = true;
+        for (int pos = 0; pos < alternatives.size() && withinBudget; ++pos) {
+            if (alternatives[pos].isEmpty()) continue;
+
+            QList<QByteArray> expanded;
+            for (const QByteArray &candidate : candidates) {
+                for (char value : alternatives[pos]) {
+                    QByteArray next = candidate;
+                    next[pos] = value;
+                    expanded.append(next);
+                }
+            }
+            withinBudget = expanded.size() <= m_maxCandidates;
+            candidates = expanded;
+        }
+        int found = 0;
+        if (withinBudget) {
+            recovered = uniqueValid(candidates, found);
+            if (!recovered.isEmpty()) {
+                m_stats.recoveredByVote++;
+            }
+        }
+
+        if (found == 0) {
+            // Errors the copies share survive the vote; look where they disagree
+            QList<int> suspectBits;
+            for (int pos = 0; pos < voted.size(); ++pos) {
+                quint8 disagree = 0;
+                for (const QByteArray &copy : group) {
+                    disagree |= static_cast<quint8>(copy[pos] ^ voted[pos]);
+                }
+                for (int bit = 0; bit < 8; ++bit) {
+                    if (disagree & (1 << bit)) {
+                        suspectBits.append(pos * 8 + bit);
+                    }
+                }
+            }
+            const int count = suspectBits.size();
+            if (count > 0 && count + count * (count - 1) / 2 <= m_maxCandidates) {
+                const auto flip = [](QByteArray &frame, int bit) {
+                    frame[bit / 8] = static_cast<char>(frame[bit / 8] ^ (1 << (bit % 8)));
+                };
+                candidates.clear();
+                for (int i = 0; i < count; ++i) {
+                    QByteArray single = voted;
+                    flip(single, suspectBits[i]);
+                    candidates.append(single);
+                    for (int j = i + 1; j < count; ++j) {
+                        QByteArray pair = single;
+                        flip(pair, suspectBits[j]);
+                        candidates.append(pair);
+                    }
+                }
+                recovered = uniqueValid(candidates, found);
+                if (!recovered.isEmpty()) {
+                    m_stats.recoveredByBitFlip++;
+                }
+            }
+        }
+        if (found > 1) {
+            m_stats.ambiguous++;
+        }
+    }
+
+    if (!recovered.isEmpty()) {
+        // Indices are in descending order
+        for (int index : used) {
+            m_copies.removeAt(index);
+        }
+        return recovered;
+    }
+
+    m_copies.append(Copy{damaged, nowMs});
+    while (m_copies.size() > m_capacity) {
+        m_copies.removeFirst();
+    }
+    return {};
+}
+
+void LoRaFrameRecovery::frameReceived(const QByteArray &frame) {
+    for (int i = m_copies.size() - 1; i >= 0; --i) {
+        if (isSimilar(frame, m_copies[i].frame)) {
+            m_copies.removeAt(i);
+        }
+    }
+}
+
+void LoRaFrameRecovery::clear() {
+    m_copies.clear();
+    m_stats = Stats{};
+}
+
+int LoRaFrameRecovery::size() const {
+    return m_copies.size();
+}
+
+LoRaFrameRecovery::Stats LoRaFrameRecovery::stats() const {
+    return m_stats;
+}
+
+bool LoRaFrameRecovery::isSimilar(const QByteArray &a, const QByteArray &b) {
+    if (a.size() != b.size()) return false;
+
+    int differing = 0;
+    for (int i = 0; i < a.size(); ++i) {
+        if (a[i] != b[i]) {
+            differing++;
+        }
+    }
+    return differing * 4 <= a.size();
+}
+
+QByteArray LoRaFrameRecovery::vote(const QList<QByteArray> &copies, QList<QByteArray> &alternatives) {
+    QByteArray voted = copies.first();
+    alternatives.clear();
+    for (int pos = 0; pos < voted.size(); ++pos) {
+        QByteArray values;
+        QList<int> counts;
+        for (const QByteArray &copy : copies) {
+            const int index = values.indexOf(copy[pos]);
+            if (index < 0) {
+                values.append(copy[pos]);
+                counts.append(1);
+            } else {
+                counts[index]++;
+            }
+        }
+        const int best = *std::max_element(counts.begin(), counts.end());
+        QByteArray tied;
+        for (int i = 0; i < values.size(); ++i) {
+            if (counts[i] == best) {
+                tied.append(values[i]);
+            }
+        }
+        // values starts with the newest copy's byte
+        voted[pos] = tied[0];
+        alternatives.append(tied.size() > 1 ? tied : QByteArray());
+    }
+    return voted;
+}
+
+QByteArray LoRaFrameRecovery::uniqueValid(const QList<QByteArray> &candidates, int &found) const {
+    QList<QByteArray> valid;
+    for (const QByteArray &candidate : candidates) {
+        if (!valid.contains(candidate) && m_validator(candidate)) {
+            valid.append(candidate);
+        }
+    }
+    found = valid.size();
+    return found == 1 ? valid.first() : QByteArray();
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <functional>
+#include <QByteArray>
+#include <QList>
+
+/**
+ * @file LoRaFrameRecovery.hpp
+ * @brief Header file for the LoRaFrameRecovery class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaFrameRecovery
+ * @brief Rebuilds a frame from several damaged copies
+ * @details Backs the optional frame recovery of LoRaUsbAdapter_E22_400T22U.
+ *          A frame that fails its CRC usually differs from what was sent in
+ *          only a few bytes, and the same frame arrives again as a
+ *          retransmission or through another antenna. Damaged frames are
+ *          kept for a while; when another damaged copy arrives, the copies
+ *          of the same length that differ in at most a quarter of their
+ *          bytes are combined:
+ *          -# Byte-wise majority vote. Bytes without a majority are tried
+ *             with each of their tied values.
+ *          -# If no candidate is valid, single and double bit flips of the
+ *             bits the copies disagree on, starting from the vote.
+ *
+ *          Each stage builds at most maxCandidates() candidates and checks
+ *          them with the validator (CRC and header plausibility). A stage
+ *          succeeds only if exactly one distinct candidate is valid, since
+ *          an 8-bit CRC alone would accept one wrong candidate in 256.
+ *          A single damaged frame is never repaired on its own.
+ *
+ *          The recovery only keeps frames; it never touches the serial port.
+ */
+class LoRaFrameRecovery
+{
+public:
+    /**
+     * @brief Checks a candidate frame
+     * @details Returns true if the frame's CRC matches and its header is plausible.
+     */
+    using Validator = std::function<bool(const QByteArray &frame)>;
+
+    /**
+     * @brief Default number of damaged frames kept
+     */
+    static constexpr int DEFAULT_CAPACITY = 32;
+
+    /**
+     * @brief Default time in milliseconds a damaged frame is kept
+     * @details Covers retransmissions up to the adapter's maximum backoff.
+     */
+    static constexpr int DEFAULT_MAX_AGE_MS = 30000;
+
+    /**
+     * @brief Default number of candidates validated per stage
+     */
+    static constexpr int DEFAULT_MAX_CANDIDATES = 16;
+
+    /**
+     * @struct Stats
+     * @brief Recovery counters since construction or clear()
+     */
+    struct Stats {
+        quint64 offered = 0;            ///< Damaged frames passed to recover()
+        quint64 recoveredByVote = 0;    ///< Frames rebuilt by the majority vote
+        quint64 recoveredByBitFlip = 0; ///< Frames rebuilt by the bit-flip search
+        quint64 ambiguous = 0;          ///< Combinations with more than one valid candidate
+    };
+
+    /**
+     * @brief Constructor for LoRaFrameRecovery
+     * @param capacity Maximum number of damaged frames kept (default: DEFAULT_CAPACITY)
+     */
+    explicit LoRaFrameRecovery(int capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Sets the check applied to candidate frames
+     * @param validator Check; without one, nothing is recovered
+     */
+    void setValidator(Validator validator);
+
+    /**
+     * @brief Sets the number of candidates validated per stage
+     * @param count Candidates; a stage that would need more is skipped
+     */
+    void setMaxCandidates(int count);
+
+    /**
+     * @brief Returns the number of candidates validated per stage
+     */
+    int maxCandidates() const;
+
+    /**
+     * @brief Sets how long damaged frames are kept
+     * @param ms Age in milliseconds
+     */
+    void setMaxAge(int ms);
+
+    /**
+     * @brief Returns how long damaged frames are kept in milliseconds
+     */
+    int maxAge() const;
+
+    /**
+     * @brief Tries to rebuild a frame from a damaged copy and the kept ones
+     * @param damaged Frame that failed its CRC
+     * @param nowMs Current time in milliseconds, never decreasing
+     * @return The rebuilt frame, or an empty array if it could not be
+     *         rebuilt yet; the damaged copy is kept then
+     */
+    QByteArray recover(const QByteArray &damaged, qint64 nowMs);
+
+    /**
+     * @brief Drops the kept copies of a frame that arrived intact
+     * @param frame Valid frame
+     */
+    void frameReceived(const QByteArray &frame);
+
+    /**
+     * @brief Drops all kept frames and clears the counters
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of damaged frames kept
+     */
+    int size() const;
+
+    /**
+     * @brief Returns the recovery counters
+     */
+    Stats stats() const;
+
+private:
+    /**
+     * @struct Copy
+     * @brief Damaged frame and its arrival time
+     */
+    struct Copy {
+        QByteArray frame;   ///< Frame as received
+        qint64 atMs = 0;    ///< Time passed to recover()
+    };
+
+    /**
+     * @brief Returns whether two frames may be copies of the same frame
+     * @details Same length and at most a quarter of the bytes differ.
+     */
+    static bool isSimilar(const QByteArray &a, const QByteArray &b);
+
+    /**
+     * @brief Majority vote over the copies
+     * @param copies Copies of equal length, newest first
+     * @param alternatives Output: per byte, the tied values if there is no majority
+     * @return The vote, ties resolved to the newest copy
+     */
+    static QByteArray vote(const QList<QByteArray> &copies, QList<QByteArray> &alternatives);
+
+    /**
+     * @brief Validates candidates and returns the only valid one
+     * @param candidates Candidate frames
+     * @param found Output: number of distinct valid candidates
+     * @return The valid candidate if found is 1, otherwise an empty array
+     */
+    QByteArray uniqueValid(const QList<QByteArray> &candidates, int &found) const;
+
+    /**
+     * @brief Candidate check
+     */
+    Validator m_validator;
+
+    /**
+     * @brief Damaged frames, oldest first
+     */
+    QList<Copy> m_copies;
+
+    /**
+     * @brief Maximum number of damaged frames kept
+     */
+    int m_capacity;
+
+    /**
+     * @brief Candidates validated per stage
+     */
+    int m_maxCandidates = DEFAULT_MAX_CANDIDATES;
+
+    /**
+     * @brief Time in milliseconds a damaged frame is kept
+     */
+    int m_maxAgeMs = DEFAULT_MAX_AGE_MS;
+
+    /**
+     * @brief Recovery counters
+     */
+    Stats m_stats;
+};
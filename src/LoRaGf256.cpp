@@ -0,0 +1,318 @@
+#include "LoRaGf256.hpp"
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define LORA_GF256_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define LORA_GF256_NEON
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang compile the x86 kernels for their instruction set only;
+// MSVC accepts the intrinsics anywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define LORA_GF256_TARGET(isa) __attribute__((target(isa)))
+#else
+#define LORA_GF256_TARGET(isa)
+#endif
+
+namespace {
+
+/**
+ * @struct Tables
+ * @brief Lookup tables of the field, built on first use
+ */
+struct Tables {
+    std::array<quint8, 512> exp{};                      ///< alpha^i, doubled to skip a reduction
+    std::array<int, 256> log{};                         ///< i for alpha^i, undefined for 0
+    std::array<std::array<quint8, 256>, 256> mul{};     ///< Full product table for the scalar kernel
+    std::array<std::array<quint8, 32>, 256> nibbles{}; ///< c * low nibble, then c * high nibble
+};
+
+const Tables &tables() {
+    // Allocated once and kept until exit; too large for the stack of a worker thread
+    static const Tables *built = []() {
+        auto *t = new Tables;
+        int x = 1;
+        for (int i = 0; i < 255; ++i) {
+            t->exp[i] = static_cast<quint8>(x);
+            t->log[x] = i;
+            x <<= 1;
+            if (x & 0x100) {
+                x ^= 0x11D;
+            }
+        }
+        for (int i = 255; i < 512; ++i) {
+            t->exp[i] = t->exp[i - 255];
+        }
+        for (int a = 1; a < 256; ++a) {
+            for (int b = 1; b < 256; ++b) {
+                t->mul[a][b] = t->exp[t->log[a] + t->log[b]];
+            }
+        }
+        for (int c = 0; c < 256; ++c) {
+            for (int i = 0; i < 16; ++i) {
+                t->nibbles[c][i] = t->mul[c][i];
+                t->nibbles[c][16 + i] = t->mul[c][i << 4];
+            }
+        }
+        return t;
+    }();
+    return *built;
+}
+
+template <bool Add>
+void regionScalar(quint8 *dst, const quint8 *src, quint8 c, int size) {
+    const std::array<quint8, 256> &row = tables().mul[c];
+    for (int i = 0; i < size; ++i) {
+        dst[i] = Add ? static_cast<quint8>(dst[i] ^ row[src[i]]) : row[src[i]];
+    }
+}
+
+#ifdef LORA_GF256_X86
+template <bool Add>
+LORA_GF256_TARGET("ssse3") inline void stepSsse3(__m128i low, __m128i high, const quint8 *src, quint8 *dst) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    __m128i product = _mm_xor_si128(_mm_shuffle_epi8(low, _mm_and_si128(x, mask)),
+                                    _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi64(x, 4), mask)));
+    if (Add) {
+        product = _mm_xor_si128(product, _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), product);
+}
+
+template <bool Add>
+LORA_GF256_TARGET("ssse3") void regionSsse3(quint8 *dst, const quint8 *src, quint8 c, int size) {
+    const quint8 *nibbles = tables().nibbles[c].data();
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(nibbles));
+    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(nibbles + 16));
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        stepSsse3<Add>(low, high, src + i, dst + i);
+    }
+    if (i < size) {
+        // The tail takes a full step on copies, cheaper than a table lookup per byte
+        quint8 in[16] = {};
+        quint8 out[16] = {};
+        std::memcpy(in, src + i, static_cast<size_t>(size - i));
+        std::memcpy(out, dst + i, static_cast<size_t>(size - i));
+        stepSsse3<Add>(low, high, in, out);
+        std::memcpy(dst + i, out, static_cast<size_t>(size - i));
+    }
+}
+
+template <bool Add>
+LORA_GF256_TARGET("avx2") void regionAvx2(quint8 *dst, const quint8 *src, quint8 c, int size) {
+    const quint8 *nibbles = tables().nibbles[c].data();
+    const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(nibbles)));
+    const __m256i high =
+        _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(nibbles + 16)));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    int i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        __m256i product = _mm256_xor_si256(_mm256_shuffle_epi8(low, _mm256_and_si256(x, mask)),
+                                           _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask)));
+        if (Add) {
+            product = _mm256_xor_si256(product, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), product);
+    }
+    // Frame-sized regions are often shorter than one step
+    regionSsse3<Add>(dst + i, src + i, c, size - i);
+}
+
+bool cpuSupports(LoRaGf256::Kernel kernel) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool ssse3 = (info[2] & (1 << 9)) != 0;
+    const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osSavesYmm) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    return kernel == LoRaGf256::Kernel::Avx2 ? avx2 : ssse3;
+#else
+    __builtin_cpu_init();
+    return kernel == LoRaGf256::Kernel::Avx2 ? __builtin_cpu_supports("avx2") != 0
+                                             : __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+#endif
+
+#ifdef LORA_GF256_NEON
+template <bool Add>
+void regionNeon(quint8 *dst, const quint8 *src, quint8 c, int size) {
+    const quint8 *nibbles = tables().nibbles[c].data();
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+#if defined(__aarch64__) || defined(_M_ARM64)
+    const uint8x16_t low = vld1q_u8(nibbles);
+    const uint8x16_t high = vld1q_u8(nibbles + 16);
+    const auto lookup = [](uint8x16_t table, uint8x16_t index) { return vqtbl1q_u8(table, index); };
+#else
+    // ARMv7 only has 8-byte lookups, from a table of up to 32 bytes
+    const uint8x8x2_t low = {{vld1_u8(nibbles), vld1_u8(nibbles + 8)}};
+    const uint8x8x2_t high = {{vld1_u8(nibbles + 16), vld1_u8(nibbles + 24)}};
+    const auto lookup = [](uint8x8x2_t table, uint8x16_t index) {
+        return vcombine_u8(vtbl2_u8(table, vget_low_u8(index)), vtbl2_u8(table, vget_high_u8(index)));
+    };
+#endif
+    const auto step = [&](const quint8 *in, quint8 *out) {
+        const uint8x16_t x = vld1q_u8(in);
+        uint8x16_t product = veorq_u8(lookup(low, vandq_u8(x, mask)), lookup(high, vshrq_n_u8(x, 4)));
+        if (Add) {
+            product = veorq_u8(product, vld1q_u8(out));
+        }
+        vst1q_u8(out, product);
+    };
+    int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        step(src + i, dst + i);
+    }
+    if (i < size) {
+        quint8 in[16] = {};
+        quint8 out[16] = {};
+        std::memcpy(in, src + i, static_cast<size_t>(size - i));
+        std::memcpy(out, dst + i, static_cast<size_t>(size - i));
+        step(in, out);
+        std::memcpy(dst + i, out, static_cast<size_t>(size - i));
+    }
+}
+#endif
+
+LoRaGf256::Kernel bestKernel() {
+    for (LoRaGf256::Kernel kernel : {LoRaGf256::Kernel::Avx2, LoRaGf256::Kernel::Ssse3, LoRaGf256::Kernel::Neon}) {
+        if (LoRaGf256::isSupported(kernel)) return kernel;
+    }
+    return LoRaGf256::Kernel::Scalar;
+}
+
+std::atomic<LoRaGf256::Kernel> &activeKernel() {
+    static std::atomic<LoRaGf256::Kernel> active{bestKernel()};
+    return active;
+}
+
+/**
+ * @brief Regions shorter than this are left to the scalar kernel
+ * @details Below one vector step, loading the nibble tables and copying the
+ *          tail cost more than a table lookup per byte. Parity and syndromes
+ *          of the per-frame code are this short.
+ */
+constexpr int MIN_VECTOR_SIZE = 16;
+
+template <bool Add>
+void region(quint8 *dst, const quint8 *src, quint8 c, int size) {
+    if (size <= 0) return;
+
+    const LoRaGf256::Kernel kernel =
+        size < MIN_VECTOR_SIZE ? LoRaGf256::Kernel::Scalar : activeKernel().load(std::memory_order_relaxed);
+    switch (kernel) {
+#ifdef LORA_GF256_X86
+    case LoRaGf256::Kernel::Avx2:
+        regionAvx2<Add>(dst, src, c, size);
+        return;
+    case LoRaGf256::Kernel::Ssse3:
+        regionSsse3<Add>(dst, src, c, size);
+        return;
+#endif
+#ifdef LORA_GF256_NEON
+    case LoRaGf256::Kernel::Neon:
+        regionNeon<Add>(dst, src, c, size);
+        return;
+#endif
+    default:
+        regionScalar<Add>(dst, src, c, size);
+        return;
+    }
+}
+
+} // namespace
+
+quint8 LoRaGf256::mul(quint8 a, quint8 b) {
+    return tables().mul[a][b];
+}
+
+quint8 LoRaGf256::div(quint8 a, quint8 b) {
+    if (a == 0) return 0;
+
+    const Tables &t = tables();
+    return t.exp[t.log[a] + 255 - t.log[b]];
+}
+
+quint8 LoRaGf256::exp(int power) {
+    const int reduced = ((power % 255) + 255) % 255;
+    return tables().exp[reduced];
+}
+
+int LoRaGf256::log(quint8 a) {
+    return tables().log[a];
+}
+
+void LoRaGf256::mulRegion(quint8 *dst, const quint8 *src, quint8 c, int size) {
+    region<false>(dst, src, c, size);
+}
+
+void LoRaGf256::mulAddRegion(quint8 *dst, const quint8 *src, quint8 c, int size) {
+    if (c == 0) return;
+
+    region<true>(dst, src, c, size);
+}
+
+LoRaGf256::Kernel LoRaGf256::kernel() {
+    return activeKernel().load(std::memory_order_relaxed);
+}
+
+bool LoRaGf256::isSupported(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Scalar:
+        return true;
+    case Kernel::Ssse3:
+    case Kernel::Avx2:
+#ifdef LORA_GF256_X86
+        return cpuSupports(kernel);
+#else
+        return false;
+#endif
+    case Kernel::Neon:
+#ifdef LORA_GF256_NEON
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+bool LoRaGf256::setKernel(Kernel kernel) {
+    if (!isSupported(kernel)) return false;
+
+    activeKernel().store(kernel, std::memory_order_relaxed);
+    return true;
+}
+
+const char *LoRaGf256::kernelName(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Scalar:
+        return "scalar";
+    case Kernel::Ssse3:
+        return "ssse3";
+    case Kernel::Avx2:
+        return "avx2";
+    case Kernel::Neon:
+        return "neon";
+    }
+    return "unknown";
+}
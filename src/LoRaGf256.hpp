@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @file LoRaGf256.hpp
+ * @brief Header file for the LoRaGf256 class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaGf256
+ * @brief Arithmetic in GF(256) with vectorised region kernels
+ * @details Field polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11D), generator
+ *          alpha = 2, as used by LoRaReedSolomon.
+ *
+ *          Forward error correction spends most of its time multiplying a
+ *          block of bytes by a constant and adding it to another block. The
+ *          region functions do that with one of several kernels:
+ *          - Kernel::Avx2 and Kernel::Ssse3 on x86, 32 or 16 bytes per step
+ *          - Kernel::Neon on ARM, 16 bytes per step
+ *          - Kernel::Scalar everywhere, one byte per step from a 64 KiB
+ *            product table
+ *
+ *          The vector kernels split each byte into nibbles and look up both
+ *          halves of the product in 16-entry tables held in a register
+ *          (pshufb, tbl). The fastest kernel the CPU supports is selected
+ *          on first use; setKernel() overrides it, e.g. for benchmarks.
+ *
+ *          All functions are thread-safe. The class only has static members.
+ */
+class LoRaGf256
+{
+public:
+    /**
+     * @enum Kernel
+     * @brief Implementations of the region functions
+     */
+    enum class Kernel {
+        Scalar, ///< Table lookup per byte, always available
+        Ssse3,  ///< 16 bytes per step with pshufb (x86)
+        Avx2,   ///< 32 bytes per step with vpshufb (x86)
+        Neon    ///< 16 bytes per step with tbl (ARM)
+    };
+
+    LoRaGf256() = delete;
+
+    /**
+     * @brief Returns the product of two field elements
+     */
+    static quint8 mul(quint8 a, quint8 b);
+
+    /**
+     * @brief Returns the quotient of two field elements
+     * @param b Divisor, not 0
+     */
+    static quint8 div(quint8 a, quint8 b);
+
+    /**
+     * @brief Returns alpha^power
+     * @param power Exponent, may be negative
+     */
+    static quint8 exp(int power);
+
+    /**
+     * @brief Returns the discrete logarithm of a nonzero element
+     * @param a Element, not 0
+     * @return power in 0-254 with alpha^power == a
+     */
+    static int log(quint8 a);
+
+    /**
+     * @brief Multiplies a region by a constant: dst[i] = c * src[i]
+     * @param dst Destination, may equal src
+     * @param src Source
+     * @param c Constant
+     * @param size Number of bytes
+     */
+    static void mulRegion(quint8 *dst, const quint8 *src, quint8 c, int size);
+
+    /**
+     * @brief Multiplies a region by a constant and adds it: dst[i] ^= c * src[i]
+     * @param dst Destination, must not overlap src unless equal to it
+     * @param src Source
+     * @param c Constant
+     * @param size Number of bytes
+     */
+    static void mulAddRegion(quint8 *dst, const quint8 *src, quint8 c, int size);
+
+    /**
+     * @brief Returns the kernel used by the region functions
+     */
+    static Kernel kernel();
+
+    /**
+     * @brief Returns whether this build and CPU can run a kernel
+     */
+    static bool isSupported(Kernel kernel);
+
+    /**
+     * @brief Selects the kernel used by the region functions
+     * @param kernel Kernel to use
+     * @return false if the kernel is not supported; the selection is unchanged then
+     */
+    static bool setKernel(Kernel kernel);
+
+    /**
+     * @brief Returns the name of a kernel, e.g. "avx2"
+     */
+    static const char *kernelName(Kernel kernel);
+};
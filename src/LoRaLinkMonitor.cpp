@@ -0,0 +1,114 @@
+#include "LoRaLinkMonitor.hpp"
+
+LoRaLinkMonitor::LoRaLinkMonitor(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &LoRaLinkMonitor::onTimer);
+}
+
+void LoRaLinkMonitor::start() {
+    m_running = true;
+    m_state = State::Unknown;
+    m_probeOutstanding = false;
+    m_missed = 0;
+    m_interval = m_minInterval;
+    m_timer.start(m_interval);
+}
+
+void LoRaLinkMonitor::stop() {
+    m_running = false;
+    m_probeOutstanding = false;
+    m_timer.stop();
+}
+
+bool LoRaLinkMonitor::isRunning() const {
+    return m_running;
+}
+
+void LoRaLinkMonitor::frameReceived() {
+    if (!m_running) return;
+
+    m_missed = 0;
+    if (m_probeOutstanding) {
+        // The link is quiet but healthy: probe less often
+        m_probeOutstanding = false;
+        m_interval = qMin(m_interval * 2, m_maxInterval);
+    }
+    setState(State::Up);
+    m_timer.start(m_interval);
+}
+
+void LoRaLinkMonitor::responseMissed() {
+    if (!m_running) return;
+
+    const State previous = m_state;
+    recordMiss();
+    if (previous != State::Down && m_state == State::Down) {
+        // Start probing for the peer's return
+        m_probeOutstanding = false;
+        m_timer.start(m_interval);
+    }
+}
+
+LoRaLinkMonitor::State LoRaLinkMonitor::state() const {
+    return m_state;
+}
+
+bool LoRaLinkMonitor::isUp() const {
+    return m_state != State::Down;
+}
+
+int LoRaLinkMonitor::probeInterval() const {
+    return m_interval;
+}
+
+void LoRaLinkMonitor::setProbeIntervals(int minMs, int maxMs) {
+    m_minInterval = qMax(minMs, 1);
+    m_maxInterval = qMax(maxMs, m_minInterval);
+    m_interval = qBound(m_minInterval, m_interval, m_maxInterval);
+}
+
+void LoRaLinkMonitor::setProbeSender(ProbeSender sender) {
+    m_probeSender = std::move(sender);
+}
+
+void LoRaLinkMonitor::onTimer() {
+    if (!m_running) return;
+
+    if (m_probeOutstanding) {
+        recordMiss();
+    }
+
+    m_probeOutstanding = m_probeSender && m_probeSender();
+    if (!m_probeOutstanding) {
+        // Nothing to wait for; idle silence is no evidence of a dead link
+        m_timer.start(m_interval);
+        return;
+    }
+    m_timer.start(m_state == State::Down ? m_interval : PROBE_TIMEOUT_MS);
+}
+
+void LoRaLinkMonitor::recordMiss() {
+    m_missed++;
+    if (m_state == State::Down) {
+        m_interval = qMin(m_interval * 2, m_maxInterval);
+        return;
+    }
+
+    m_interval = m_minInterval;
+    if (m_missed >= MISSED_LIMIT) {
+        setState(State::Down);
+    }
+}
+
+void LoRaLinkMonitor::setState(State state) {
+    if (m_state == state) return;
+
+    m_state = state;
+    if (state == State::Up) {
+        emit linkUp();
+    } else if (state == State::Down) {
+        emit linkDown();
+    }
+}
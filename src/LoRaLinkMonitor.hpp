@@ -0,0 +1,225 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <functional>
+
+/**
+ * @file LoRaLinkMonitor.hpp
+ * @brief Header file for the LoRaLinkMonitor class
+ * @date 2026-10-18
+ */
+
+/**
+ * @class LoRaLinkMonitor
+ * @brief Tracks whether the peer is reachable with as little airtime as possible
+ * @details Liveness is piggybacked on existing traffic: every valid frame from
+ *          the peer (DATA, ACK, PACKET_ACK, ...) is reported with frameReceived()
+ *          and proves the link is up. Only when nothing has been heard for the
+ *          current probe interval does the monitor ask the probe sender
+ *          (see setProbeSender()) for a PING frame; the peer's PONG arrives as
+ *          a regular frameReceived(). A probe that could not be sent is not
+ *          waited for, so it never counts as missed.
+ *
+ *          The probe interval adapts to the link:
+ *          - Each answered probe doubles the interval, up to the maximum,
+ *            so a stable idle link costs one probe per maximum interval
+ *          - A missed response resets it to the minimum to confirm quickly
+ *          - While the link is down, probes back off exponentially again
+ *
+ *          Missed data ACKs reported with responseMissed() count like missed
+ *          probes. After MISSED_LIMIT consecutive misses the link is declared
+ *          down; the first frame heard afterwards brings it back up.
+ *
+ *          The monitor only keeps state and timers; it never touches the
+ *          serial port itself.
+ */
+class LoRaLinkMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @enum State
+     * @brief Link states reported by the monitor
+     */
+    enum class State : quint8 {
+        Unknown, ///< Nothing heard since start(); sends are allowed
+        Up,      ///< The peer answered recently
+        Down     ///< MISSED_LIMIT consecutive responses were missed
+    };
+
+    /**
+     * @brief Function sending a probe to the peer
+     * @return true if a probe went out and an answer can be expected
+     */
+    using ProbeSender = std::function<bool()>;
+
+    /**
+     * @brief Default minimum probe interval in milliseconds
+     */
+    static constexpr int DEFAULT_MIN_PROBE_INTERVAL_MS = 5000;
+
+    /**
+     * @brief Default maximum probe interval in milliseconds
+     */
+    static constexpr int DEFAULT_MAX_PROBE_INTERVAL_MS = 60000;
+
+    /**
+     * @brief Time in milliseconds to wait for the answer to a probe
+     */
+    static constexpr int PROBE_TIMEOUT_MS = 2000;
+
+    /**
+     * @brief Number of consecutive missed responses that mark the link down
+     */
+    static constexpr int MISSED_LIMIT = 3;
+
+    /**
+     * @brief Constructor for LoRaLinkMonitor
+     * @param parent Parent QObject for memory management (default: nullptr)
+     * @note The monitor is idle until start() is called.
+     */
+    explicit LoRaLinkMonitor(QObject *parent = nullptr);
+
+    /**
+     * @brief Default destructor
+     */
+    ~LoRaLinkMonitor() override = default;
+
+    /**
+     * @brief Starts monitoring from the Unknown state
+     */
+    void start();
+
+    /**
+     * @brief Stops monitoring and the probe timer
+     */
+    void stop();
+
+    /**
+     * @brief Returns whether the monitor is running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Reports a valid frame received from the peer
+     * @details Marks the link up and restarts the idle period. Does nothing
+     *          while the monitor is stopped.
+     */
+    void frameReceived();
+
+    /**
+     * @brief Reports a response the peer failed to send in time
+     * @details Called by the owner when a data chunk times out.
+     *          Does nothing while the monitor is stopped.
+     */
+    void responseMissed();
+
+    /**
+     * @brief Returns the current link state
+     */
+    State state() const;
+
+    /**
+     * @brief Returns whether sends may proceed
+     * @return false only while the link is Down
+     */
+    bool isUp() const;
+
+    /**
+     * @brief Returns the current probe interval in milliseconds
+     */
+    int probeInterval() const;
+
+    /**
+     * @brief Sets the bounds of the adaptive probe interval
+     * @param minMs Minimum interval in milliseconds
+     * @param maxMs Maximum interval in milliseconds (raised to minMs if smaller)
+     */
+    void setProbeIntervals(int minMs, int maxMs);
+
+    /**
+     * @brief Sets the function called when the link has been idle for the probe interval
+     * @param sender Function sending a PING, or an empty function to never probe
+     * @details Without a sender, or while it returns false, only responseMissed()
+     *          and frameReceived() change the link state.
+     */
+    void setProbeSender(ProbeSender sender);
+
+signals:
+    /**
+     * @brief Signal emitted when the peer is heard after start() or after being down
+     */
+    void linkUp();
+
+    /**
+     * @brief Signal emitted when the peer stopped responding
+     */
+    void linkDown();
+
+private slots:
+    /**
+     * @brief Slot called when the idle period or a probe timeout expires
+     * @details Counts an unanswered probe as a miss, then sends the next probe.
+     *          When no probe goes out, waits for another interval instead.
+     */
+    void onTimer();
+
+private:
+    /**
+     * @brief Records a missed response and updates state and interval
+     */
+    void recordMiss();
+
+    /**
+     * @brief Changes the state and emits linkUp()/linkDown() on transitions
+     * @param state New state
+     */
+    void setState(State state);
+
+    /**
+     * @brief Timer for the idle period, probe timeouts and down-state probing
+     */
+    QTimer m_timer;
+
+    /**
+     * @brief Function sending a probe
+     */
+    ProbeSender m_probeSender;
+
+    /**
+     * @brief Current link state
+     */
+    State m_state = State::Unknown;
+
+    /**
+     * @brief Whether the monitor is running
+     */
+    bool m_running = false;
+
+    /**
+     * @brief Whether a probe was sent and not answered yet
+     */
+    bool m_probeOutstanding = false;
+
+    /**
+     * @brief Number of consecutive missed responses
+     */
+    int m_missed = 0;
+
+    /**
+     * @brief Current probe interval in milliseconds
+     */
+    int m_interval = DEFAULT_MIN_PROBE_INTERVAL_MS;
+
+    /**
+     * @brief Minimum probe interval in milliseconds
+     */
+    int m_minInterval = DEFAULT_MIN_PROBE_INTERVAL_MS;
+
+    /**
+     * @brief Maximum probe interval in milliseconds
+     */
+    int m_maxInterval = DEFAULT_MAX_PROBE_INTERVAL_MS;
+};
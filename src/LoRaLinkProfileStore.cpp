@@ -0,0 +1,133 @@
+#include "LoRaLinkProfileStore.hpp"
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QSaveFile>
+#include <cmath>
+
+bool LoRaLinkProfile::isValid() const {
+    return rttSamples > 0 || chunkSize > 0 || airRateBps > 0 || rssiBaselineDbm != 0 ||
+           !peerCapabilities.isLegacy();
+}
+
+LoRaLinkProfile LoRaLinkProfile::aged(qint64 nowSecs, qint64 halfLifeSecs) const {
+    LoRaLinkProfile result = *this;
+    const qint64 age = qMax<qint64>(0, nowSecs - updatedAtSecs);
+    if (age == 0 || halfLifeSecs <= 0) return result;
+
+    // Weight of the old history: 1 when fresh, 0.5 after one half-life
+    const double weight = std::pow(0.5, static_cast<double>(age) / static_cast<double>(halfLifeSecs));
+    result.rttSamples = static_cast<quint32>(rttSamples * weight);
+    // Widen the variation towards srtt so the first timeouts are conservative
+    result.rttVarMs = static_cast<quint32>(rttVarMs * weight + srttMs * (1.0 - weight));
+    return result;
+}
+
+LoRaLinkProfileStore::LoRaLinkProfileStore(const QString &path)
+    : m_path(path)
+{
+}
+
+QString LoRaLinkProfileStore::path() const {
+    return m_path;
+}
+
+void LoRaLinkProfileStore::setPath(const QString &path) {
+    m_path = path;
+}
+
+bool LoRaLinkProfileStore::load() {
+    m_profiles.clear();
+    if (m_path.isEmpty() || !QFile::exists(m_path)) return true;
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    in.setByteOrder(QDataStream::LittleEndian);
+    quint32 magic = 0;
+    quint8 version = 0;
+    quint32 count = 0;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != FILE_MAGIC || version < 1 || version > FILE_VERSION) return false;
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    for (quint32 i = 0; i < count; ++i) {
+        QString peerId;
+        LoRaLinkProfile p;
+        in >> peerId >> p.srttMs >> p.rttVarMs >> p.rttSamples >> p.chunkSize
+           >> p.airRateBps >> p.rssiBaselineDbm >> p.updatedAtSecs;
+        if (version >= 2) {
+            QByteArray caps;
+            in >> caps;
+            if (!caps.isEmpty() && !LoRaCapabilities::decode(caps, p.peerCapabilities)) {
+                m_profiles.clear();
+                return false;
+            }
+        }
+        if (in.status() != QDataStream::Ok) {
+            m_profiles.clear();
+            return false;
+        }
+        if (now - p.updatedAtSecs <= m_maxAgeSecs) {
+            m_profiles.insert(peerId, p);
+        }
+    }
+    return true;
+}
+
+bool LoRaLinkProfileStore::save() const {
+    if (m_path.isEmpty()) return false;
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << FILE_MAGIC << FILE_VERSION << static_cast<quint32>(m_profiles.size());
+    for (auto it = m_profiles.constBegin(); it != m_profiles.constEnd(); ++it) {
+        const LoRaLinkProfile &p = it.value();
+        out << it.key() << p.srttMs << p.rttVarMs << p.rttSamples << p.chunkSize
+            << p.airRateBps << p.rssiBaselineDbm << p.updatedAtSecs
+            << (p.peerCapabilities.isLegacy() ? QByteArray() : p.peerCapabilities.encode());
+    }
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+LoRaLinkProfile LoRaLinkProfileStore::profile(const QString &peerId, qint64 nowSecs) const {
+    const auto it = m_profiles.constFind(peerId);
+    if (it == m_profiles.constEnd()) return {};
+
+    if (nowSecs == 0) {
+        nowSecs = QDateTime::currentSecsSinceEpoch();
+    }
+    if (nowSecs - it.value().updatedAtSecs > m_maxAgeSecs) return {};
+    return it.value().aged(nowSecs, m_halfLifeSecs);
+}
+
+void LoRaLinkProfileStore::setProfile(const QString &peerId, const LoRaLinkProfile &profile) {
+    LoRaLinkProfile p = profile;
+    if (p.updatedAtSecs == 0) {
+        p.updatedAtSecs = QDateTime::currentSecsSinceEpoch();
+    }
+    m_profiles.insert(peerId, p);
+}
+
+void LoRaLinkProfileStore::removeProfile(const QString &peerId) {
+    m_profiles.remove(peerId);
+}
+
+int LoRaLinkProfileStore::size() const {
+    return static_cast<int>(m_profiles.size());
+}
+
+void LoRaLinkProfileStore::setAging(qint64 halfLifeSecs, qint64 maxAgeSecs) {
+    m_halfLifeSecs = halfLifeSecs;
+    m_maxAgeSecs = maxAgeSecs;
+}
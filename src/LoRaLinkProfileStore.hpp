@@ -0,0 +1,171 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include "LoRaCapabilities.hpp"
+
+/**
+ * @file LoRaLinkProfileStore.hpp
+ * @brief Header file for the LoRaLinkProfile struct and LoRaLinkProfileStore class
+ * @date 2026-10-18
+ */
+
+/**
+ * @struct LoRaLinkProfile
+ * @brief Link parameters learned for one peer
+ * @details Zero in any field means "not learned yet"; the adapter then uses
+ *          its built-in default for that parameter.
+ */
+struct LoRaLinkProfile {
+    quint32 srttMs = 0;           ///< Smoothed round-trip time of a chunk and its ACK
+    quint32 rttVarMs = 0;         ///< Round-trip time variation
+    quint32 rttSamples = 0;       ///< Number of RTT samples behind srttMs
+    quint16 chunkSize = 0;        ///< Chunk payload size in bytes
+    quint32 airRateBps = 0;       ///< Air data rate in bits per second
+    qint16 rssiBaselineDbm = 0;   ///< Typical RSSI of the peer's frames
+    LoRaCapabilities peerCapabilities; ///< Capabilities the peer announced in its last handshake
+    qint64 updatedAtSecs = 0;     ///< Time of the last update, seconds since the Unix epoch
+
+    /**
+     * @brief Returns whether anything has been learned
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Returns a copy discounted for its age
+     * @param nowSecs Current time in seconds since the Unix epoch
+     * @param halfLifeSecs Age at which the RTT history counts half
+     * @return Aged profile; RTT variation grows and the sample count
+     *         shrinks as the profile gets older, so the adapter starts with
+     *         a more conservative timeout and re-learns faster
+     */
+    LoRaLinkProfile aged(qint64 nowSecs, qint64 halfLifeSecs) const;
+};
+
+/**
+ * @class LoRaLinkProfileStore
+ * @brief Compact on-disk cache of learned link profiles, keyed by peer
+ * @details Lets the adapter start with the RTT, chunk size and radio
+ *          parameters it had learned before a restart, instead of spending
+ *          the first minutes relearning them.
+ *
+ *          File format (QDataStream, little-endian):
+ *          [Magic 'LRLP'(4)][Version(1)][Count(4)]
+ *          then per peer: [PeerId(QString)][SrttMs(4)][RttVarMs(4)][RttSamples(4)]
+ *          [ChunkSize(2)][AirRateBps(4)][RssiBaselineDbm(2)][UpdatedAtSecs(8)]
+ *          [PeerCapabilities(QByteArray, LoRaCapabilities::encode())]
+ *
+ *          Version 1 files, which lack the capabilities, are still read.
+ *
+ *          Profiles older than the maximum age are dropped when loaded or
+ *          read. Younger profiles are aged (see LoRaLinkProfile::aged()).
+ *          The file is written atomically with QSaveFile.
+ */
+class LoRaLinkProfileStore
+{
+public:
+    /**
+     * @brief Default age at which a profile's RTT history counts half (1 day)
+     */
+    static constexpr qint64 DEFAULT_HALF_LIFE_SECS = 24 * 3600;
+
+    /**
+     * @brief Default age after which a profile is discarded (30 days)
+     */
+    static constexpr qint64 DEFAULT_MAX_AGE_SECS = 30 * 24 * 3600;
+
+    /**
+     * @brief Constructor for LoRaLinkProfileStore
+     * @param path Path of the profile file (see load() and save())
+     */
+    explicit LoRaLinkProfileStore(const QString &path = {});
+
+    /**
+     * @brief Returns the path of the profile file
+     */
+    QString path() const;
+
+    /**
+     * @brief Sets the path of the profile file
+     * @param path New path; the profiles in memory are kept
+     */
+    void setPath(const QString &path);
+
+    /**
+     * @brief Reads the profile file
+     * @return true if the file was read or does not exist yet,
+     *         false if it exists but is unreadable or malformed
+     * @note Replaces the profiles in memory.
+     */
+    bool load();
+
+    /**
+     * @brief Writes all profiles to the profile file
+     * @return true on success
+     */
+    bool save() const;
+
+    /**
+     * @brief Returns the aged profile of a peer
+     * @param peerId Peer identifier
+     * @param nowSecs Current time in seconds since the Unix epoch (0 = now)
+     * @return Aged profile, or an invalid profile if none is stored or it is too old
+     */
+    LoRaLinkProfile profile(const QString &peerId, qint64 nowSecs = 0) const;
+
+    /**
+     * @brief Stores the profile of a peer
+     * @param peerId Peer identifier
+     * @param profile Profile to store; updatedAtSecs is set to now if 0
+     */
+    void setProfile(const QString &peerId, const LoRaLinkProfile &profile);
+
+    /**
+     * @brief Removes the profile of a peer
+     * @param peerId Peer identifier
+     */
+    void removeProfile(const QString &peerId);
+
+    /**
+     * @brief Returns the number of stored profiles
+     */
+    int size() const;
+
+    /**
+     * @brief Sets the aging parameters
+     * @param halfLifeSecs Age at which the RTT history counts half
+     * @param maxAgeSecs Age after which a profile is discarded
+     */
+    void setAging(qint64 halfLifeSecs, qint64 maxAgeSecs);
+
+private:
+    /**
+     * @brief Magic bytes at the start of the profile file
+     */
+    static constexpr quint32 FILE_MAGIC = 0x504C524C; // "LRLP"
+
+    /**
+     * @brief Current file format version
+     */
+    static constexpr quint8 FILE_VERSION = 2;
+
+    /**
+     * @brief Path of the profile file
+     */
+    QString m_path;
+
+    /**
+     * @brief Profiles by peer identifier
+     */
+    QHash<QString, LoRaLinkProfile> m_profiles;
+
+    /**
+     * @brief Age at which the RTT history counts half
+     */
+    qint64 m_halfLifeSecs = DEFAULT_HALF_LIFE_SECS;
+
+    /**
+     * @brief Age after which a profile is discarded
+     */
+    qint64 m_maxAgeSecs = DEFAULT_MAX_AGE_SECS;
+};
@@ -0,0 +1,157 @@
+#include "LoRaPayloadPipeline.hpp"
+#include <QCoreApplication>
+#include <atomic>
+
+namespace {
+
+/**
+ * @brief Returns an identifier for new thread settings, unique across pipelines
+ * @details 0 is never returned, so a thread that has applied nothing yet
+ *          always applies the settings of its first stage.
+ */
+quint64 nextThreadSettingsId() {
+    static std::atomic<quint64> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+LoRaPayloadPipeline::LoRaPayloadPipeline(QObject *parent) :
+    QObject(parent)
+    , m_threadSettingsId(nextThreadSettingsId())
+{
+}
+
+LoRaPayloadPipeline::~LoRaPayloadPipeline() {
+    // Stages post their results to this object, so none may outlive it
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void LoRaPayloadPipeline::setEncodeStage(Stage stage) {
+    m_encodeStage = std::move(stage);
+}
+
+void LoRaPayloadPipeline::setDecodeStage(Stage stage) {
+    m_decodeStage = std::move(stage);
+}
+
+bool LoRaPayloadPipeline::hasEncodeStage() const {
+    return static_cast<bool>(m_encodeStage);
+}
+
+bool LoRaPayloadPipeline::hasDecodeStage() const {
+    return static_cast<bool>(m_decodeStage);
+}
+
+void LoRaPayloadPipeline::setMaxThreads(int threads) {
+    m_pool.setMaxThreadCount(qMax(threads, 1));
+}
+
+int LoRaPayloadPipeline::maxThreads() const {
+    return m_pool.maxThreadCount();
+}
+
+void LoRaPayloadPipeline::setMaxPendingEncodes(int count) {
+    m_maxPendingEncodes = qMax(count, 1);
+}
+
+int LoRaPayloadPipeline::maxPendingEncodes() const {
+    return m_maxPendingEncodes;
+}
+
+void LoRaPayloadPipeline::setThreadSettings(const LoRaRealtime::Settings &settings) {
+    m_threadSettings = settings;
+    m_threadSettingsId = nextThreadSettingsId();
+}
+
+LoRaRealtime::Settings LoRaPayloadPipeline::threadSettings() const {
+    return m_threadSettings;
+}
+
+bool LoRaPayloadPipeline::encode(quint8 port, const QByteArray &data) {
+    if (m_pendingEncodes >= m_maxPendingEncodes) return false;
+
+    m_pendingEncodes++;
+    submit(Direction::Encode, port, data);
+    return true;
+}
+
+void LoRaPayloadPipeline::decode(quint8 port, const QByteArray &data) {
+    m_pendingDecodes++;
+    submit(Direction::Decode, port, data);
+}
+
+int LoRaPayloadPipeline::pendingEncodes() const {
+    return m_pendingEncodes;
+}
+
+int LoRaPayloadPipeline::pendingDecodes() const {
+    return m_pendingDecodes;
+}
+
+bool LoRaPayloadPipeline::waitForDone(int msecs) {
+    if (!m_pool.waitForDone(msecs)) return false;
+
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    return m_pendingEncodes == 0 && m_pendingDecodes == 0;
+}
+
+void LoRaPayloadPipeline::submit(Direction direction, quint8 port, const QByteArray &data) {
+    Stream &stream = direction == Direction::Encode ? m_encodeStreams[port] : m_decodeStreams[port];
+    const quint64 ticket = stream.nextTicket++;
+    const Stage stage = direction == Direction::Encode ? m_encodeStage : m_decodeStage;
+
+    if (!stage) {
+        // Queued like a stage result, so it cannot overtake packets still in a stage
+        QMetaObject::invokeMethod(this, [this, direction, port, ticket, data]() {
+            finish(direction, port, ticket, data, true);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    const LoRaRealtime::Settings settings = m_threadSettings;
+    const quint64 settingsId = m_threadSettingsId;
+    m_pool.start([this, direction, port, ticket, stage, settings, settingsId, data]() {
+        thread_local quint64 appliedSettingsId = 0;
+        if (appliedSettingsId != settingsId) {
+            appliedSettingsId = settingsId;
+            QString failure;
+            if (!LoRaRealtime::applyToCurrentThread(settings, failure)) {
+                QMetaObject::invokeMethod(this, [this, failure]() {
+                    emit error(QString("Pipeline thread settings: %1").arg(failure));
+                }, Qt::QueuedConnection);
+            }
+        }
+
+        QByteArray output = data;
+        const bool ok = stage(output);
+        QMetaObject::invokeMethod(this, [this, direction, port, ticket, ok, result = ok ? output : data]() {
+            finish(direction, port, ticket, result, ok);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void LoRaPayloadPipeline::finish(Direction direction, quint8 port, quint64 ticket, const QByteArray &data, bool ok) {
+    QHash<quint8, Stream> &streams = direction == Direction::Encode ? m_encodeStreams : m_decodeStreams;
+    streams[port].done.insert(ticket, {data, ok});
+
+    // The stream is looked up again after every emit: a slot may submit more
+    // packets, or flush results with waitForDone(), while this one runs
+    while (true) {
+        Stream &stream = streams[port];
+        const auto next = stream.done.find(stream.nextResult);
+        if (next == stream.done.end()) break;
+
+        const Result result = next.value();
+        stream.done.erase(next);
+        stream.nextResult++;
+        if (direction == Direction::Encode) {
+            m_pendingEncodes--;
+            emit encoded(port, result.data, result.ok);
+        } else {
+            m_pendingDecodes--;
+            emit decoded(port, result.data, result.ok);
+        }
+    }
+}
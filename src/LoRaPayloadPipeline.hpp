@@ -0,0 +1,284 @@
+#pragma once
+
+#include <functional>
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QThreadPool>
+#include "LoRaRealtime.hpp"
+
+/**
+ * @file LoRaPayloadPipeline.hpp
+ * @brief Header file for the LoRaPayloadPipeline class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaPayloadPipeline
+ * @brief Runs CPU-heavy payload stages on a thread pool, in order per port
+ * @details Compression, encryption, erasure coding or delta encoding of a
+ *          packet of several hundred kilobytes can take longer than an ACK
+ *          window. Run on the thread of the adapter, they would delay ACKs
+ *          and retransmissions for as long. The pipeline runs them on its
+ *          own threads instead:
+ *          - encode() runs the encode stage on outgoing data; encoded()
+ *            hands back the buffer to send
+ *          - decode() runs the decode stage on received data; decoded()
+ *            hands back the buffer to deliver
+ *
+ *          Packets of one port and direction are processed in parallel, but
+ *          their results are emitted in the order they were submitted, so a
+ *          slow packet holds back the faster ones behind it. Results are
+ *          emitted in the thread the pipeline belongs to.
+ *
+ *          At most maxPendingEncodes() packets wait for their encoding;
+ *          encode() refuses more, so a fast producer cannot queue up
+ *          unbounded memory. Decoding is not limited: received packets
+ *          arrive no faster than the radio delivers them.
+ *
+ *          The pool threads are started by the thread that submits work.
+ *          On Linux they would inherit its real-time priority and CPU set,
+ *          so every thread applies threadSettings() before its first stage.
+ *          The default settings return them to the time-sharing scheduler.
+ */
+class LoRaPayloadPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Transforms a payload in place
+     * @details Called on a pool thread; several calls may run at once.
+     *          Returns false if the payload cannot be processed, e.g. a
+     *          decryption that fails authentication.
+     */
+    using Stage = std::function<bool(QByteArray &data)>;
+
+    /**
+     * @brief Default limit of packets waiting for their encoding
+     */
+    static constexpr int DEFAULT_MAX_PENDING_ENCODES = 16;
+
+    /**
+     * @brief Constructor for LoRaPayloadPipeline
+     * @param parent Parent QObject (default: nullptr)
+     * @details Starts without stages, so data passes through unchanged, and
+     *          with one thread per CPU core.
+     */
+    explicit LoRaPayloadPipeline(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor for LoRaPayloadPipeline
+     * @details Drops the packets that have not started and waits for the
+     *          stages that are running. Their results are discarded.
+     */
+    ~LoRaPayloadPipeline() override;
+
+    /**
+     * @brief Sets the stage run by encode()
+     * @param stage Stage, or an empty function to pass data through
+     * @details Packets already submitted keep the stage they were submitted with.
+     */
+    void setEncodeStage(Stage stage);
+
+    /**
+     * @brief Sets the stage run by decode()
+     * @param stage Stage, or an empty function to pass data through
+     * @details Packets already submitted keep the stage they were submitted with.
+     */
+    void setDecodeStage(Stage stage);
+
+    /**
+     * @brief Returns whether an encode stage is set
+     */
+    bool hasEncodeStage() const;
+
+    /**
+     * @brief Returns whether a decode stage is set
+     */
+    bool hasDecodeStage() const;
+
+    /**
+     * @brief Sets the number of pool threads
+     * @param threads Thread count, at least 1
+     */
+    void setMaxThreads(int threads);
+
+    /**
+     * @brief Returns the number of pool threads
+     */
+    int maxThreads() const;
+
+    /**
+     * @brief Sets the limit of packets waiting for their encoding
+     * @param count Limit, at least 1 (default: DEFAULT_MAX_PENDING_ENCODES)
+     */
+    void setMaxPendingEncodes(int count);
+
+    /**
+     * @brief Returns the limit of packets waiting for their encoding
+     */
+    int maxPendingEncodes() const;
+
+    /**
+     * @brief Sets the scheduling settings of the pool threads
+     * @param settings Settings each thread applies before its next stage
+     * @details Use a Policy::Default setting with the CPUs not reserved
+     *          for the radio thread.
+     */
+    void setThreadSettings(const LoRaRealtime::Settings &settings);
+
+    /**
+     * @brief Returns the scheduling settings of the pool threads
+     */
+    LoRaRealtime::Settings threadSettings() const;
+
+    /**
+     * @brief Submits outgoing data to the encode stage
+     * @param port Logical port; results keep their order within a port
+     * @param data Payload
+     * @return false if maxPendingEncodes() packets are already waiting;
+     *         the data is dropped then and encoded() is not emitted
+     */
+    bool encode(quint8 port, const QByteArray &data);
+
+    /**
+     * @brief Submits received data to the decode stage
+     * @param port Logical port; results keep their order within a port
+     * @param data Payload
+     */
+    void decode(quint8 port, const QByteArray &data);
+
+    /**
+     * @brief Returns the number of packets submitted to encode() and not yet emitted
+     */
+    int pendingEncodes() const;
+
+    /**
+     * @brief Returns the number of packets submitted to decode() and not yet emitted
+     */
+    int pendingDecodes() const;
+
+    /**
+     * @brief Waits for every submitted packet and emits the results
+     * @param msecs Time limit, or -1 to wait without limit
+     * @return false if the limit expired before all stages finished
+     * @details Results are emitted before returning, without an event loop.
+     * @note Must be called from the thread the pipeline belongs to
+     */
+    bool waitForDone(int msecs = -1);
+
+signals:
+    /**
+     * @brief Emitted with the result of encode(), in order per port
+     * @param port Port given to encode()
+     * @param data Encoded payload; the original payload if ok is false
+     * @param ok false if the stage failed
+     */
+    void encoded(quint8 port, const QByteArray &data, bool ok);
+
+    /**
+     * @brief Emitted with the result of decode(), in order per port
+     * @param port Port given to decode()
+     * @param data Decoded payload; the received payload if ok is false
+     * @param ok false if the stage failed
+     */
+    void decoded(quint8 port, const QByteArray &data, bool ok);
+
+    /**
+     * @brief Emitted when a pool thread could not apply threadSettings()
+     * @param msg Description of what failed
+     */
+    void error(const QString &msg);
+
+private:
+    /**
+     * @enum Direction
+     * @brief Stage a packet was submitted to
+     */
+    enum class Direction : quint8 {
+        Encode,
+        Decode
+    };
+
+    /**
+     * @struct Result
+     * @brief Output of a stage waiting for its turn
+     */
+    struct Result {
+        QByteArray data;  ///< Payload after the stage
+        bool ok = false;  ///< Whether the stage succeeded
+    };
+
+    /**
+     * @struct Stream
+     * @brief Packets of one port and direction
+     */
+    struct Stream {
+        quint64 nextTicket = 0;        ///< Ticket of the next packet submitted
+        quint64 nextResult = 0;        ///< Ticket of the next result to emit
+        QMap<quint64, Result> done;    ///< Finished results not yet emitted, by ticket
+    };
+
+    /**
+     * @brief Starts a stage on the pool
+     */
+    void submit(Direction direction, quint8 port, const QByteArray &data);
+
+    /**
+     * @brief Stores the result of a stage and emits the results now in order
+     * @details Runs in the thread of the pipeline.
+     */
+    void finish(Direction direction, quint8 port, quint64 ticket, const QByteArray &data, bool ok);
+
+    /**
+     * @brief Threads running the stages
+     */
+    QThreadPool m_pool;
+
+    /**
+     * @brief Stage run by encode()
+     */
+    Stage m_encodeStage;
+
+    /**
+     * @brief Stage run by decode()
+     */
+    Stage m_decodeStage;
+
+    /**
+     * @brief Scheduling settings of the pool threads
+     */
+    LoRaRealtime::Settings m_threadSettings;
+
+    /**
+     * @brief Identifies the current threadSettings(); threads reapply them when it changes
+     */
+    quint64 m_threadSettingsId = 0;
+
+    /**
+     * @brief Encode streams by port
+     */
+    QHash<quint8, Stream> m_encodeStreams;
+
+    /**
+     * @brief Decode streams by port
+     */
+    QHash<quint8, Stream> m_decodeStreams;
+
+    /**
+     * @brief Limit of packets waiting for their encoding
+     */
+    int m_maxPendingEncodes = DEFAULT_MAX_PENDING_ENCODES;
+
+    /**
+     * @brief Packets submitted to encode() and not yet emitted
+     */
+    int m_pendingEncodes = 0;
+
+    /**
+     * @brief Packets submitted to decode() and not yet emitted
+     */
+    int m_pendingDecodes = 0;
+};
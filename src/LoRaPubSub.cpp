@@ -0,0 +1,185 @@
+#include "LoRaPubSub.hpp"
+
+LoRaPubSub::LoRaPubSub(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool LoRaPubSub::publish(const QString &topic, const QByteArray &data) {
+    auto it = m_localIds.constFind(topic);
+    if (it == m_localIds.constEnd()) {
+        if (m_nextId > MAX_TOPIC_ID) return false;
+
+        it = m_localIds.insert(topic, m_nextId);
+        m_localNames.insert(m_nextId, topic);
+        m_nextId++;
+    }
+
+    const quint16 id = it.value();
+    if (!m_announced.contains(id)) {
+        announce(id);
+    }
+    emit sendPacket(encodeId(id) + data);
+    return true;
+}
+
+QByteArray LoRaPubSub::wrapPlain(const QByteArray &data) {
+    return encodeId(PLAIN_TOPIC_ID) + data;
+}
+
+void LoRaPubSub::subscribe(const QString &topic, QObject *context, Callback callback) {
+    if (!callback) return;
+
+    m_subscribers[topic].append({context, std::move(callback)});
+}
+
+void LoRaPubSub::unsubscribe(const QString &topic, QObject *context) {
+    const auto it = m_subscribers.find(topic);
+    if (it == m_subscribers.end()) return;
+
+    it->removeIf([context](const Subscriber &s) { return s.context.isNull() || s.context == context; });
+    if (it->isEmpty()) {
+        m_subscribers.erase(it);
+    }
+}
+
+bool LoRaPubSub::isSubscribed(const QString &topic) const {
+    const auto it = m_subscribers.constFind(topic);
+    if (it == m_subscribers.constEnd()) return false;
+
+    for (const Subscriber &s : *it) {
+        if (!s.context.isNull()) return true;
+    }
+    return false;
+}
+
+void LoRaPubSub::resetPeer() {
+    m_announced.clear();
+    m_peerNames.clear();
+    m_awaitingAnnounce.clear();
+}
+
+QByteArray LoRaPubSub::encodeId(quint16 id) {
+    QByteArray data;
+    if (id < 0x80) {
+        data.append(static_cast<char>(id));
+    } else {
+        data.append(static_cast<char>((id & 0x7F) | 0x80));
+        data.append(static_cast<char>((id >> 7) & 0x7F));
+    }
+    return data;
+}
+
+bool LoRaPubSub::decodeId(const QByteArray &data, int &pos, quint16 &id) {
+    if (pos >= data.size()) return false;
+
+    const quint8 first = static_cast<quint8>(data[pos]);
+    if (!(first & 0x80)) {
+        id = first;
+        pos += 1;
+        return true;
+    }
+
+    if (pos + 1 >= data.size()) return false;
+    const quint8 second = static_cast<quint8>(data[pos + 1]);
+    if (second & 0x80) return false;
+
+    id = static_cast<quint16>((first & 0x7F) | (second << 7));
+    pos += 2;
+    return true;
+}
+
+void LoRaPubSub::packetReceived(const QByteArray &packet) {
+    int pos = 0;
+    quint16 id = 0;
+    if (!decodeId(packet, pos, id)) {
+        emit error("Invalid topic ID");
+        return;
+    }
+
+    if (id == PLAIN_TOPIC_ID) {
+        emit plainPacketReceived(packet.mid(pos));
+        return;
+    }
+    if (id == CONTROL_TOPIC_ID) {
+        handleControl(packet, pos);
+        return;
+    }
+
+    const auto it = m_peerNames.constFind(id);
+    if (it == m_peerNames.constEnd()) {
+        const bool queried = m_awaitingAnnounce.contains(id);
+        // Stored first: the announcement may arrive while sendPacket() is emitted
+        m_awaitingAnnounce.insert(id, packet.mid(pos));
+        if (!queried) {
+            QByteArray query = encodeId(CONTROL_TOPIC_ID);
+            query.append(static_cast<char>(ControlOp::QUERY));
+            query.append(encodeId(id));
+            emit sendPacket(query);
+        }
+        return;
+    }
+
+    // Filter before copying the payload out of the packet
+    if (!isSubscribed(it.value())) return;
+    deliver(it.value(), packet.mid(pos));
+}
+
+void LoRaPubSub::handleControl(const QByteArray &packet, int pos) {
+    if (pos >= packet.size()) {
+        emit error("Empty topic control message");
+        return;
+    }
+    const auto op = static_cast<ControlOp>(static_cast<quint8>(packet[pos++]));
+
+    quint16 id = 0;
+    if (!decodeId(packet, pos, id) || id < FIRST_TOPIC_ID) {
+        emit error("Invalid topic ID in control message");
+        return;
+    }
+
+    switch (op) {
+    case ControlOp::ANNOUNCE: {
+        const QString name = QString::fromUtf8(packet.mid(pos));
+        m_peerNames.insert(id, name);
+        const auto waiting = m_awaitingAnnounce.find(id);
+        if (waiting != m_awaitingAnnounce.end()) {
+            const QByteArray data = waiting.value();
+            m_awaitingAnnounce.erase(waiting);
+            if (isSubscribed(name)) {
+                deliver(name, data);
+            }
+        }
+        break;
+    }
+
+    case ControlOp::QUERY:
+        if (m_localNames.contains(id)) {
+            announce(id);
+        }
+        break;
+
+    default:
+        emit error("Unknown topic control message");
+        break;
+    }
+}
+
+void LoRaPubSub::announce(quint16 id) {
+    QByteArray packet = encodeId(CONTROL_TOPIC_ID);
+    packet.append(static_cast<char>(ControlOp::ANNOUNCE));
+    packet.append(encodeId(id));
+    packet.append(m_localNames.value(id).toUtf8());
+    m_announced.insert(id);
+    emit sendPacket(packet);
+}
+
+void LoRaPubSub::deliver(const QString &topic, const QByteArray &data) {
+    // Callbacks may subscribe or unsubscribe, so work on a copy
+    const QList<Subscriber> subscribers = m_subscribers.value(topic);
+    for (const Subscriber &s : subscribers) {
+        if (!s.context.isNull()) {
+            s.callback(data);
+        }
+    }
+}
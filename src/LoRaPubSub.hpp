@@ -0,0 +1,238 @@
+#pragma once
+
+#include <functional>
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+
+/**
+ * @file LoRaPubSub.hpp
+ * @brief Header file for the LoRaPubSub class
+ * @date 2026-10-18
+ */
+
+/**
+ * @class LoRaPubSub
+ * @brief Topic-based publish/subscribe over reliable packets
+ * @details Topics are strings in the API but travel as 1-2 byte IDs. Every
+ *          packet starts with a topic ID, encoded as a varint:
+ *          IDs below 0x80 take one byte, IDs up to MAX_TOPIC_ID two.
+ *          - PLAIN_TOPIC_ID (0): untagged packet from sendPacket()
+ *          - CONTROL_TOPIC_ID (1): topic registration messages (below)
+ *          - FIRST_TOPIC_ID and up: publications, [TopicId][Data]
+ *
+ *          Each side numbers the topics it publishes. Before the first
+ *          publication of a topic to a peer, the publisher sends
+ *          [1][ANNOUNCE][TopicId][Name], so the name crosses the link once.
+ *          A receiver that does not know an ID (it restarted, for example)
+ *          answers [1][QUERY][TopicId]. It keeps the latest publication
+ *          for that ID and delivers it once the announcement arrives.
+ *
+ *          Publications are filtered on the receiving side before
+ *          delivery: topics without subscribers are dropped without
+ *          copying, and each subscriber is called for its own topics only.
+ *
+ *          Like LoRaRpc, the class only keeps state; its owner sends the
+ *          packets of sendPacket() and feeds received ones to packetReceived().
+ */
+class LoRaPubSub : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Subscriber callback, receives the data of one publication
+     */
+    using Callback = std::function<void(const QByteArray &data)>;
+
+    /**
+     * @brief Topic ID of untagged packets
+     */
+    static constexpr quint16 PLAIN_TOPIC_ID = 0;
+
+    /**
+     * @brief Topic ID of registration messages
+     */
+    static constexpr quint16 CONTROL_TOPIC_ID = 1;
+
+    /**
+     * @brief First ID given to a topic
+     */
+    static constexpr quint16 FIRST_TOPIC_ID = 2;
+
+    /**
+     * @brief Largest topic ID, the limit of a two-byte varint
+     */
+    static constexpr quint16 MAX_TOPIC_ID = 0x3FFF;
+
+    /**
+     * @enum ControlOp
+     * @brief Registration message types, following CONTROL_TOPIC_ID
+     */
+    enum class ControlOp : quint8 {
+        ANNOUNCE = 0x01,  ///< [TopicId][Name UTF-8]: the sender publishes Name as TopicId
+        QUERY = 0x02      ///< [TopicId]: the sender does not know TopicId
+    };
+
+    /**
+     * @brief Constructor for LoRaPubSub
+     * @param parent Parent QObject for memory management (default: nullptr)
+     */
+    explicit LoRaPubSub(QObject *parent = nullptr);
+
+    /**
+     * @brief Publishes data on a topic
+     * @param topic Topic name
+     * @param data Message data
+     * @return false if no topic ID is left
+     * @note Emits sendPacket() once, or twice if the topic must be announced first
+     */
+    bool publish(const QString &topic, const QByteArray &data);
+
+    /**
+     * @brief Tags an untagged packet with PLAIN_TOPIC_ID
+     * @param data Packet data
+     * @return Packet to send
+     */
+    static QByteArray wrapPlain(const QByteArray &data);
+
+    /**
+     * @brief Subscribes to a topic
+     * @param topic Topic name
+     * @param context Subscriber; the subscription ends when it is destroyed
+     * @param callback Called with the data of every publication on the topic
+     */
+    void subscribe(const QString &topic, QObject *context, Callback callback);
+
+    /**
+     * @brief Ends the subscriptions of a subscriber to a topic
+     * @param topic Topic name
+     * @param context Subscriber given to subscribe()
+     */
+    void unsubscribe(const QString &topic, QObject *context);
+
+    /**
+     * @brief Returns whether a topic has subscribers
+     * @param topic Topic name
+     */
+    bool isSubscribed(const QString &topic) const;
+
+    /**
+     * @brief Forgets what was learned from and announced to the peer
+     * @details Call when the peer changes or may have restarted. Topics are
+     *          announced again before their next publication.
+     */
+    void resetPeer();
+
+    /**
+     * @brief Encodes a topic ID as a varint
+     * @param id Topic ID, at most MAX_TOPIC_ID
+     * @return One or two bytes
+     */
+    static QByteArray encodeId(quint16 id);
+
+    /**
+     * @brief Decodes a varint topic ID
+     * @param data Buffer holding the ID
+     * @param pos Position of the ID; advanced past it on success
+     * @param id Output parameter for the topic ID
+     * @return false if the buffer ends early or the ID is too long
+     */
+    static bool decodeId(const QByteArray &data, int &pos, quint16 &id);
+
+public slots:
+    /**
+     * @brief Handles a packet received from the peer
+     * @param packet Packet starting with a topic ID
+     * @note Emits plainPacketReceived() for untagged packets
+     */
+    void packetReceived(const QByteArray &packet);
+
+signals:
+    /**
+     * @brief Signal emitted when a packet must be sent to the peer
+     * @param packet Packet data
+     */
+    void sendPacket(const QByteArray &packet);
+
+    /**
+     * @brief Signal emitted for a received untagged packet
+     * @param data Packet data without its topic ID
+     */
+    void plainPacketReceived(const QByteArray &data);
+
+    /**
+     * @brief Signal emitted when a packet cannot be decoded
+     * @param msg Error message describing the problem
+     */
+    void error(const QString &msg);
+
+private:
+    /**
+     * @struct Subscriber
+     * @brief One subscription to a topic
+     */
+    struct Subscriber {
+        QPointer<QObject> context;  ///< Subscriber, null once destroyed
+        Callback callback;          ///< Called for each publication
+    };
+
+    /**
+     * @brief Delivers a publication to the subscribers of its topic
+     * @param topic Topic name
+     * @param data Message data
+     */
+    void deliver(const QString &topic, const QByteArray &data);
+
+    /**
+     * @brief Handles a registration message
+     * @param packet Packet starting with CONTROL_TOPIC_ID
+     * @param pos Position of the operation byte
+     */
+    void handleControl(const QByteArray &packet, int pos);
+
+    /**
+     * @brief Sends the announcement of a local topic
+     * @param id Topic ID
+     */
+    void announce(quint16 id);
+
+    /**
+     * @brief IDs of the topics published by this side, by name
+     */
+    QHash<QString, quint16> m_localIds;
+
+    /**
+     * @brief Names of the topics published by this side, by ID
+     */
+    QHash<quint16, QString> m_localNames;
+
+    /**
+     * @brief Local topic IDs announced to the current peer
+     */
+    QSet<quint16> m_announced;
+
+    /**
+     * @brief Names of the topics published by the peer, by ID
+     */
+    QHash<quint16, QString> m_peerNames;
+
+    /**
+     * @brief Latest publication of each unknown peer topic, awaiting its announcement
+     */
+    QHash<quint16, QByteArray> m_awaitingAnnounce;
+
+    /**
+     * @brief Subscriptions, by topic name
+     */
+    QHash<QString, QList<Subscriber>> m_subscribers;
+
+    /**
+     * @brief ID given to the next local topic
+     */
+    quint16 m_nextId = FIRST_TOPIC_ID;
+};
@@ -0,0 +1,104 @@
+#include "LoRaRealtime.hpp"
+#include <QStringList>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+bool LoRaRealtime::isSupported() {
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LoRaRealtime::applyToCurrentThread(const Settings &settings, QString &error) {
+    QStringList failures;
+
+#ifdef Q_OS_LINUX
+    int policy = SCHED_OTHER;
+    switch (settings.policy) {
+    case Policy::Fifo: policy = SCHED_FIFO; break;
+    case Policy::RoundRobin: policy = SCHED_RR; break;
+    default: break;
+    }
+    sched_param param {};
+    param.sched_priority = policy == SCHED_OTHER ? 0 :
+                           qBound(sched_get_priority_min(policy), settings.priority, sched_get_priority_max(policy));
+    // pthread_* functions return the error instead of setting errno
+    int rc = pthread_setschedparam(pthread_self(), policy, &param);
+    if (rc != 0) {
+        failures << QString("scheduling policy: %1").arg(strerror(rc));
+    }
+
+    if (!settings.cpus.isEmpty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        bool valid = true;
+        for (int cpu : settings.cpus) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                valid = false;
+                break;
+            }
+            CPU_SET(cpu, &set);
+        }
+        rc = valid ? pthread_setaffinity_np(pthread_self(), sizeof(set), &set) : EINVAL;
+        if (rc != 0) {
+            failures << QString("CPU affinity: %1").arg(strerror(rc));
+        }
+    }
+
+    if (settings.lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        failures << QString("memory lock: %1").arg(strerror(errno));
+    }
+#else
+    if (settings.policy != Policy::Default || !settings.cpus.isEmpty() || settings.lockMemory) {
+        failures << "not supported on this platform";
+    }
+#endif
+
+    error = failures.join("; ");
+    return failures.isEmpty();
+}
+
+LoRaRealtime::LatencyStats LoRaRealtime::measureWakeupLatency(int samples, int intervalUs) {
+    using Clock = std::chrono::steady_clock;
+
+    LatencyStats stats;
+    if (samples <= 0) return stats;
+
+    std::vector<qint64> latencies;
+    latencies.reserve(samples);
+    const auto interval = std::chrono::microseconds(qMax(intervalUs, 1));
+    Clock::time_point deadline = Clock::now();
+    for (int i = 0; i < samples; ++i) {
+        deadline += interval;
+        std::this_thread::sleep_until(deadline);
+        const auto late = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - deadline);
+        latencies.push_back(late.count());
+        if (late > interval) {
+            // Overrun: measure the next wake-up from now rather than queueing up missed ones
+            deadline = Clock::now();
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) {
+        return latencies[qMin(static_cast<int>(latencies.size() * p), static_cast<int>(latencies.size()) - 1)];
+    };
+    stats.samples = samples;
+    stats.minUs = latencies.front();
+    stats.p50Us = percentile(0.50);
+    stats.p99Us = percentile(0.99);
+    stats.maxUs = latencies.back();
+    return stats;
+}
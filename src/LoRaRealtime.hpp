@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+/**
+ * @file LoRaRealtime.hpp
+ * @brief Header file for the LoRaRealtime class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaRealtime
+ * @brief Real-time scheduling for the radio I/O thread, and a diagnostic of its timing
+ * @details ACKs and retransmissions are timed by the thread running the
+ *          adapter. On a loaded host that thread can wake up late, and
+ *          every late wake-up delays an ACK or fires a spurious
+ *          retransmission. applyToCurrentThread() raises the thread above
+ *          ordinary workloads:
+ *          - SCHED_FIFO or SCHED_RR with a fixed priority
+ *          - A set of CPUs the thread runs on, e.g. one kept free of other work
+ *          - mlockall(), so the process is never paged out
+ *
+ *          measureWakeupLatency() reports how late the calling thread
+ *          actually wakes up from timed sleeps, in the manner of cyclictest,
+ *          to check the effect of the settings under the real load.
+ *
+ *          Only Linux supports the settings. Elsewhere applying anything but
+ *          the defaults fails; the diagnostic works on every platform.
+ *          Raising the priority and locking memory usually need root or the
+ *          CAP_SYS_NICE and CAP_IPC_LOCK capabilities.
+ */
+class LoRaRealtime
+{
+public:
+    /**
+     * @enum Policy
+     * @brief Scheduling policy of the thread
+     */
+    enum class Policy : quint8 {
+        Default,    ///< Time-sharing scheduler (SCHED_OTHER)
+        Fifo,       ///< Runs until it blocks or a higher priority preempts it (SCHED_FIFO)
+        RoundRobin  ///< Like Fifo, with time slices among equal priorities (SCHED_RR)
+    };
+
+    /**
+     * @struct Settings
+     * @brief Scheduling settings of a thread
+     */
+    struct Settings {
+        Policy policy = Policy::Default; ///< Scheduling policy
+        int priority = 0;                ///< Real-time priority, clamped to the policy's range; unused for Default
+        QList<int> cpus;                 ///< CPUs the thread may run on; empty leaves the affinity unchanged
+        bool lockMemory = false;         ///< Locks current and future pages of the whole process in RAM
+    };
+
+    /**
+     * @struct LatencyStats
+     * @brief Wake-up latency of a thread, in microseconds past the requested time
+     */
+    struct LatencyStats {
+        int samples = 0;    ///< Number of wake-ups measured
+        qint64 minUs = 0;   ///< Smallest latency
+        qint64 p50Us = 0;   ///< Median latency
+        qint64 p99Us = 0;   ///< 99th percentile latency
+        qint64 maxUs = 0;   ///< Largest latency
+    };
+
+    /**
+     * @brief Default number of wake-ups measured by measureWakeupLatency()
+     */
+    static constexpr int DEFAULT_LATENCY_SAMPLES = 1000;
+
+    /**
+     * @brief Default sleep between wake-ups in microseconds
+     */
+    static constexpr int DEFAULT_LATENCY_INTERVAL_US = 1000;
+
+    /**
+     * @brief Returns whether this platform supports the settings
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Applies scheduling settings to the calling thread
+     * @param settings Settings to apply
+     * @param error Output parameter for a description of what failed
+     * @return true if every setting was applied
+     * @details Each setting is attempted even if an earlier one failed.
+     *          lockMemory affects the whole process; false leaves an
+     *          existing lock in place.
+     * @note Call it from the thread to configure, e.g. the worker's thread
+     */
+    static bool applyToCurrentThread(const Settings &settings, QString &error);
+
+    /**
+     * @brief Measures how late the calling thread wakes up from timed sleeps
+     * @param samples Number of wake-ups (default: DEFAULT_LATENCY_SAMPLES)
+     * @param intervalUs Sleep between wake-ups in microseconds (default: DEFAULT_LATENCY_INTERVAL_US)
+     * @return Latency statistics
+     * @details Sleeps until absolute deadlines, so latency does not
+     *          accumulate. Blocks the thread for about samples * intervalUs;
+     *          its event loop, and with it the adapter, stalls meanwhile.
+     */
+    static LatencyStats measureWakeupLatency(int samples = DEFAULT_LATENCY_SAMPLES,
+                                             int intervalUs = DEFAULT_LATENCY_INTERVAL_US);
+};
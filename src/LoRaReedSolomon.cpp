@@ -0,0 +1,151 @@
+#include "LoRaReedSolomon.hpp"
+#include "LoRaGf256.hpp"
+#include <algorithm>
+#include <cstring>
+
+LoRaReedSolomon::LoRaReedSolomon(int parityBytes)
+    : m_parityBytes(qBound(0, parityBytes, MAX_PARITY_BYTES))
+{
+    // g(x) = (x - alpha^0)(x - alpha^1)...(x - alpha^(n-1))
+    m_generator = QByteArray(1, static_cast<char>(1));
+    for (int i = 0; i < m_parityBytes; ++i) {
+        QByteArray next(m_generator.size() + 1, '\0');
+        for (int j = 0; j < m_generator.size(); ++j) {
+            const quint8 coefficient = static_cast<quint8>(m_generator[j]);
+            next[j] = static_cast<char>(static_cast<quint8>(next[j]) ^ coefficient);
+            next[j + 1] = static_cast<char>(static_cast<quint8>(next[j + 1]) ^
+                                            LoRaGf256::mul(coefficient, LoRaGf256::exp(i)));
+        }
+        m_generator = next;
+    }
+
+    m_syndromeRows = QByteArray(MAX_CODEWORD_SIZE * m_parityBytes, '\0');
+    for (int degree = 0; degree < MAX_CODEWORD_SIZE; ++degree) {
+        for (int i = 0; i < m_parityBytes; ++i) {
+            m_syndromeRows[degree * m_parityBytes + i] = static_cast<char>(LoRaGf256::exp(i * degree));
+        }
+    }
+}
+
+int LoRaReedSolomon::parityBytes() const {
+    return m_parityBytes;
+}
+
+int LoRaReedSolomon::correctableBytes() const {
+    return m_parityBytes / 2;
+}
+
+QByteArray LoRaReedSolomon::parity(const QByteArray &data) const {
+    // Remainder of data(x) * x^n divided by g(x), as a shift register
+    quint8 remainder[MAX_PARITY_BYTES + 1] = {};
+    const auto *generator = reinterpret_cast<const quint8 *>(m_generator.constData()) + 1;
+    if (m_parityBytes > 0) {
+        for (char byte : data) {
+            const quint8 feedback = static_cast<quint8>(byte) ^ remainder[0];
+            std::memmove(remainder, remainder + 1, static_cast<size_t>(m_parityBytes));
+            LoRaGf256::mulAddRegion(remainder, generator, feedback, m_parityBytes);
+        }
+    }
+    return QByteArray(reinterpret_cast<const char *>(remainder), m_parityBytes);
+}
+
+int LoRaReedSolomon::decode(QByteArray &codeword) const {
+    const int n = codeword.size();
+    if (m_parityBytes == 0) return 0;
+    if (n < m_parityBytes || n > MAX_CODEWORD_SIZE) return -1;
+
+    quint8 syndrome[MAX_PARITY_BYTES];
+    if (!syndromes(codeword, syndrome)) return 0;
+
+    // Berlekamp-Massey: error locator lambda(x), lowest degree first
+    quint8 lambda[MAX_PARITY_BYTES + 1] = {1};
+    quint8 previous[MAX_PARITY_BYTES + 1] = {1};
+    int errors = 0;
+    int shift = 1;
+    quint8 previousDiscrepancy = 1;
+    for (int step = 0; step < m_parityBytes; ++step) {
+        quint8 discrepancy = syndrome[step];
+        for (int i = 1; i <= errors; ++i) {
+            discrepancy ^= LoRaGf256::mul(lambda[i], syndrome[step - i]);
+        }
+        if (discrepancy == 0) {
+            shift++;
+            continue;
+        }
+
+        const quint8 scale = LoRaGf256::div(discrepancy, previousDiscrepancy);
+        quint8 saved[MAX_PARITY_BYTES + 1];
+        std::copy(lambda, lambda + m_parityBytes + 1, saved);
+        for (int i = 0; i + shift <= m_parityBytes; ++i) {
+            lambda[i + shift] ^= LoRaGf256::mul(scale, previous[i]);
+        }
+        if (2 * errors <= step) {
+            errors = step + 1 - errors;
+            std::copy(saved, saved + m_parityBytes + 1, previous);
+            previousDiscrepancy = discrepancy;
+            shift = 1;
+        } else {
+            shift++;
+        }
+    }
+    if (errors > correctableBytes()) return -1;
+
+    // Error evaluator omega(x) = S(x) * lambda(x) mod x^n
+    quint8 omega[MAX_PARITY_BYTES] = {};
+    for (int i = 0; i < m_parityBytes; ++i) {
+        for (int j = 0; j <= qMin(i, errors); ++j) {
+            omega[i] ^= LoRaGf256::mul(syndrome[i - j], lambda[j]);
+        }
+    }
+
+    // Chien search over the codeword positions, then Forney for each root
+    QByteArray corrected = codeword;
+    int found = 0;
+    for (int pos = 0; pos < n; ++pos) {
+        const int degree = n - 1 - pos;
+        const quint8 inverse = LoRaGf256::exp(-degree);
+
+        quint8 value = 0;
+        quint8 derivative = 0;
+        quint8 x = 1;
+        for (int i = 0; i <= errors; ++i) {
+            const quint8 term = LoRaGf256::mul(lambda[i], x);
+            value ^= term;
+            if (i % 2 == 1) {
+                // Formal derivative: odd terms only, one degree lower
+                derivative ^= LoRaGf256::div(term, inverse);
+            }
+            x = LoRaGf256::mul(x, inverse);
+        }
+        if (value != 0) continue;
+        if (derivative == 0) return -1;
+
+        quint8 evaluated = 0;
+        x = 1;
+        for (int i = 0; i < m_parityBytes; ++i) {
+            evaluated ^= LoRaGf256::mul(omega[i], x);
+            x = LoRaGf256::mul(x, inverse);
+        }
+        const quint8 magnitude = LoRaGf256::mul(LoRaGf256::exp(degree), LoRaGf256::div(evaluated, derivative));
+        corrected[pos] = static_cast<char>(static_cast<quint8>(corrected[pos]) ^ magnitude);
+        found++;
+    }
+    if (found != errors) return -1;
+
+    if (syndromes(corrected, syndrome)) return -1;
+
+    codeword = corrected;
+    return found;
+}
+
+bool LoRaReedSolomon::syndromes(const QByteArray &codeword, quint8 *syndromes) const {
+    std::fill(syndromes, syndromes + m_parityBytes, 0);
+    const auto *rows = reinterpret_cast<const quint8 *>(m_syndromeRows.constData());
+    const int n = codeword.size();
+    for (int pos = 0; pos < n; ++pos) {
+        const int degree = n - 1 - pos;
+        LoRaGf256::mulAddRegion(syndromes, rows + degree * m_parityBytes, static_cast<quint8>(codeword[pos]),
+                                m_parityBytes);
+    }
+    return std::any_of(syndromes, syndromes + m_parityBytes, [](quint8 value) { return value != 0; });
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QByteArray>
+
+/**
+ * @file LoRaReedSolomon.hpp
+ * @brief Header file for the LoRaReedSolomon class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaReedSolomon
+ * @brief Reed-Solomon code over GF(256) for single frames
+ * @details Backs the optional frame parity of LoRaUsbAdapter_E22_400T22U.
+ *          parityBytes() check bytes appended to a frame let the receiver
+ *          correct up to parityBytes() / 2 damaged bytes anywhere in the
+ *          frame, parity included, whatever the number of bit errors in each.
+ *
+ *          The code is systematic: the data stays unchanged in front of the
+ *          parity. Field polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11D),
+ *          generator roots alpha^0 to alpha^(parityBytes() - 1). Decoding
+ *          uses Berlekamp-Massey, a Chien search and the Forney algorithm.
+ *          Encoding and syndromes run on the region kernels of LoRaGf256.
+ *
+ *          With more errors than it can correct, a decoder may "correct" a
+ *          codeword into a different one. Decoded frames are therefore
+ *          still checked by their CRC.
+ */
+class LoRaReedSolomon
+{
+public:
+    /**
+     * @brief Largest number of parity bytes supported
+     */
+    static constexpr int MAX_PARITY_BYTES = 32;
+
+    /**
+     * @brief Largest codeword, data and parity, in bytes
+     */
+    static constexpr int MAX_CODEWORD_SIZE = 255;
+
+    /**
+     * @brief Constructor for LoRaReedSolomon
+     * @param parityBytes Parity bytes per codeword, clamped to 0-MAX_PARITY_BYTES
+     *        (0 = no parity, nothing is corrected)
+     */
+    explicit LoRaReedSolomon(int parityBytes = 0);
+
+    /**
+     * @brief Returns the number of parity bytes per codeword
+     */
+    int parityBytes() const;
+
+    /**
+     * @brief Returns the number of damaged bytes a codeword may have and still be corrected
+     */
+    int correctableBytes() const;
+
+    /**
+     * @brief Calculates the parity of data
+     * @param data At most MAX_CODEWORD_SIZE - parityBytes() bytes
+     * @return parityBytes() bytes to append to the data
+     */
+    QByteArray parity(const QByteArray &data) const;
+
+    /**
+     * @brief Corrects a codeword in place
+     * @param codeword Data followed by its parity
+     * @return Number of bytes corrected (0 if the codeword was intact), or -1
+     *         if it has more errors than can be corrected; it is left
+     *         unchanged then
+     */
+    int decode(QByteArray &codeword) const;
+
+private:
+    /**
+     * @brief Evaluates the codeword polynomial at alpha^i for each root of the generator
+     * @param codeword Coefficients, highest degree first
+     * @param syndromes Output: parityBytes() values, all 0 for a valid codeword
+     * @return true if any syndrome is not 0
+     */
+    bool syndromes(const QByteArray &codeword, quint8 *syndromes) const;
+
+    /**
+     * @brief Generator polynomial, highest degree first, parityBytes() + 1 coefficients
+     */
+    QByteArray m_generator;
+
+    /**
+     * @brief Contribution of each codeword position to the syndromes
+     * @details Row d holds alpha^(i * d) for each root i; a byte of degree d
+     *          adds its value times row d to the syndromes.
+     */
+    QByteArray m_syndromeRows;
+
+    /**
+     * @brief Parity bytes per codeword
+     */
+    int m_parityBytes;
+};
@@ -0,0 +1,152 @@
+#include "LoRaRpc.hpp"
+#include <QRandomGenerator>
+
+LoRaRpc::LoRaRpc(QObject *parent)
+    : QObject(parent)
+    , m_nextId(static_cast<quint16>(QRandomGenerator::global()->generate()))
+{
+    m_clock.start();
+}
+
+LoRaRpc::~LoRaRpc() {
+    cancelAll();
+}
+
+QFuture<LoRaRpcReply> LoRaRpc::call(quint32 service, const QByteArray &request, int timeoutMs) {
+    auto promise = std::make_shared<QPromise<LoRaRpcReply>>();
+    promise->start();
+    QFuture<LoRaRpcReply> future = promise->future();
+
+    if (request.size() > MAX_MESSAGE_SIZE || service > 0xFFFFFF) {
+        finish(*promise, {LoRaRpcReply::RequestTooLarge, {}});
+        return future;
+    }
+
+    // Skip IDs still in flight after a wrap-around
+    quint16 id = m_nextId++;
+    while (m_pending.contains(id)) {
+        id = m_nextId++;
+    }
+
+    PendingCall &pending = m_pending[id];
+    pending.promise = promise;
+    pending.service = service;
+    pending.request = request;
+    pending.deadlineMs = m_clock.elapsed() + qMax(timeoutMs, 0);
+    pending.timer = std::make_shared<QTimer>();
+    pending.timer->setSingleShot(true);
+    connect(pending.timer.get(), &QTimer::timeout, this, [this, id]() { onRetransmit(id); });
+    pending.timer->start(qMin(m_retransmitMs, qMax(timeoutMs, 0)));
+
+    emit sendRequest(id, service, request);
+    return future;
+}
+
+void LoRaRpc::cancelAll(LoRaRpcReply::Status status) {
+    const QList<quint16> ids = m_pending.keys();
+    for (quint16 id : ids) {
+        complete(id, {status, {}});
+    }
+}
+
+int LoRaRpc::pendingCalls() const {
+    return static_cast<int>(m_pending.size());
+}
+
+void LoRaRpc::setHandler(quint32 service, Handler handler, bool atMostOnce) {
+    if (!handler) {
+        m_services.remove(service);
+        return;
+    }
+    m_services.insert(service, {std::move(handler), atMostOnce});
+}
+
+void LoRaRpc::setRetransmitInterval(int ms) {
+    m_retransmitMs = qMax(ms, 1);
+}
+
+void LoRaRpc::requestReceived(quint16 id, quint32 service, const QByteArray &request) {
+    expireReplies();
+
+    const auto cached = m_replyCache.constFind(id);
+    if (cached != m_replyCache.constEnd() && cached->service == service && cached->request == request) {
+        // Our reply was lost: answer again without running the handler
+        emit sendReply(id, cached->status, cached->reply);
+        return;
+    }
+
+    const auto it = m_services.constFind(service);
+    if (it == m_services.constEnd()) {
+        emit sendReply(id, LoRaRpcReply::UnknownService, {});
+        return;
+    }
+
+    QByteArray reply = it->handler(request);
+    quint8 status = LoRaRpcReply::Ok;
+    if (reply.size() > MAX_MESSAGE_SIZE) {
+        reply.clear();
+        status = LoRaRpcReply::HandlerFailed;
+    }
+
+    if (it->atMostOnce) {
+        if (!m_replyCache.contains(id)) {
+            m_replyOrder.enqueue(id);
+        }
+        m_replyCache.insert(id, {service, request, status, reply, m_clock.elapsed()});
+        while (m_replyOrder.size() > REPLY_CACHE_SIZE) {
+            m_replyCache.remove(m_replyOrder.dequeue());
+        }
+    }
+    emit sendReply(id, status, reply);
+}
+
+void LoRaRpc::replyReceived(quint16 id, quint8 status, const QByteArray &reply) {
+    if (!m_pending.contains(id)) return;
+
+    if (status >= LoRaRpcReply::LOCAL_STATUS) {
+        // Local codes are never sent; treat it like an unknown failure
+        status = LoRaRpcReply::HandlerFailed;
+    }
+    complete(id, {static_cast<LoRaRpcReply::Status>(status), reply});
+}
+
+void LoRaRpc::onRetransmit(quint16 id) {
+    const auto it = m_pending.find(id);
+    if (it == m_pending.end()) return;
+
+    // complete() drops the call, and with it this timer, while it is emitting
+    const std::shared_ptr<QTimer> timer = it->timer;
+    const qint64 remaining = it->deadlineMs - m_clock.elapsed();
+    if (remaining <= 0) {
+        complete(id, {LoRaRpcReply::Timeout, {}});
+        return;
+    }
+
+    timer->start(static_cast<int>(qMin<qint64>(m_retransmitMs, remaining)));
+    emit sendRequest(id, it->service, it->request);
+}
+
+void LoRaRpc::complete(quint16 id, const LoRaRpcReply &reply) {
+    const auto it = m_pending.find(id);
+    if (it == m_pending.end()) return;
+
+    // Detach first: the continuation may start new calls
+    std::shared_ptr<QPromise<LoRaRpcReply>> promise = std::move(it->promise);
+    m_pending.erase(it);
+    finish(*promise, reply);
+}
+
+void LoRaRpc::finish(QPromise<LoRaRpcReply> &promise, const LoRaRpcReply &reply) {
+    promise.addResult(reply);
+    promise.finish();
+}
+
+void LoRaRpc::expireReplies() {
+    const qint64 now = m_clock.elapsed();
+    while (!m_replyOrder.isEmpty()) {
+        const auto it = m_replyCache.constFind(m_replyOrder.head());
+        if (it != m_replyCache.constEnd() && now - it->storedAtMs < REPLY_CACHE_TTL_MS) break;
+
+        m_replyCache.remove(m_replyOrder.dequeue());
+    }
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QPromise>
+#include <QQueue>
+#include <QTimer>
+
+/**
+ * @file LoRaRpc.hpp
+ * @brief Header file for the LoRaRpcReply struct and LoRaRpc class
+ * @date 2026-10-18
+ */
+
+/**
+ * @struct LoRaRpcReply
+ * @brief Outcome of a remote procedure call
+ */
+struct LoRaRpcReply {
+    /**
+     * @enum Status
+     * @brief Result codes; values below LOCAL_STATUS are sent on the air
+     */
+    enum Status : quint8 {
+        Ok = 0,                 ///< The handler ran and data holds its reply
+        UnknownService = 1,     ///< The peer has no handler for the service
+        HandlerFailed = 2,      ///< The handler's reply did not fit in one frame
+        Timeout = 0x80,         ///< No reply before the call's timeout (local)
+        RequestTooLarge = 0x81, ///< The request does not fit in one frame (local)
+        NotConnected = 0x82     ///< The call could not be sent (local)
+    };
+
+    /**
+     * @brief First status code that is never sent by a peer
+     */
+    static constexpr quint8 LOCAL_STATUS = 0x80;
+
+    Status status = Timeout;  ///< Result of the call
+    QByteArray data;          ///< Reply payload, valid when status is Ok
+
+    /**
+     * @brief Returns whether the call succeeded
+     */
+    bool isOk() const { return status == Ok; }
+};
+
+/**
+ * @class LoRaRpc
+ * @brief Request/response calls where the reply acknowledges the request
+ * @details Small commands and their replies each travel in a single frame:
+ *          the request in an RPC_REQUEST frame, the reply in an RPC_REPLY
+ *          frame carrying the same correlation ID. No chunk ACK or
+ *          PACKET_ACK is exchanged, so a round trip is two frames. A lost
+ *          request or reply is recovered by resending the request every
+ *          retransmission timeout until the call's own timeout expires.
+ *
+ *          Resending means a handler can run more than once for the same
+ *          call. Handlers registered as at-most-once are protected by a
+ *          reply cache: a repeated request gets the cached reply and the
+ *          handler does not run again. Cache entries are matched on
+ *          correlation ID, service and request bytes, and expire after
+ *          REPLY_CACHE_TTL_MS.
+ *
+ *          Like LoRaLinkMonitor, the class only keeps state and timers; its
+ *          owner delivers frames through sendRequest() and sendReply() and
+ *          feeds received ones to requestReceived() and replyReceived().
+ */
+class LoRaRpc : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Server-side handler: maps a request payload to a reply payload
+     */
+    using Handler = std::function<QByteArray(const QByteArray &request)>;
+
+    /**
+     * @brief Largest request or reply payload, one frame
+     */
+    static constexpr int MAX_MESSAGE_SIZE = 24;
+
+    /**
+     * @brief Default time in milliseconds a call waits for its reply
+     */
+    static constexpr int DEFAULT_TIMEOUT_MS = 10000;
+
+    /**
+     * @brief Number of replies kept for at-most-once handlers
+     */
+    static constexpr int REPLY_CACHE_SIZE = 64;
+
+    /**
+     * @brief Time in milliseconds a cached reply is kept
+     */
+    static constexpr int REPLY_CACHE_TTL_MS = 60000;
+
+    /**
+     * @brief Constructor for LoRaRpc
+     * @param parent Parent QObject for memory management (default: nullptr)
+     */
+    explicit LoRaRpc(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor, completes outstanding calls with NotConnected
+     */
+    ~LoRaRpc() override;
+
+    /**
+     * @brief Calls a service on the peer
+     * @param service Service number on the peer (24 bits)
+     * @param request Request payload, at most MAX_MESSAGE_SIZE bytes
+     * @param timeoutMs Time to wait for the reply (default: DEFAULT_TIMEOUT_MS)
+     * @return Future that finishes with the reply or a local error status
+     * @note Emits sendRequest() at once and for every retransmission
+     */
+    QFuture<LoRaRpcReply> call(quint32 service, const QByteArray &request,
+                               int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    /**
+     * @brief Completes all outstanding calls
+     * @param status Status reported to the callers (default: NotConnected)
+     */
+    void cancelAll(LoRaRpcReply::Status status = LoRaRpcReply::NotConnected);
+
+    /**
+     * @brief Returns the number of calls waiting for a reply
+     */
+    int pendingCalls() const;
+
+    /**
+     * @brief Registers the handler of a service
+     * @param service Service number (24 bits)
+     * @param handler Handler, or an empty function to remove the service
+     * @param atMostOnce True to answer repeated requests from the reply
+     *        cache instead of running the handler again
+     */
+    void setHandler(quint32 service, Handler handler, bool atMostOnce = false);
+
+    /**
+     * @brief Sets the interval between retransmissions of a request
+     * @param ms Interval in milliseconds, typically the link's retransmission timeout
+     */
+    void setRetransmitInterval(int ms);
+
+public slots:
+    /**
+     * @brief Handles a request received from the peer
+     * @param id Correlation ID
+     * @param service Service number
+     * @param request Request payload
+     * @note Emits sendReply()
+     */
+    void requestReceived(quint16 id, quint32 service, const QByteArray &request);
+
+    /**
+     * @brief Handles a reply received from the peer
+     * @param id Correlation ID of the call
+     * @param status Status code sent by the peer
+     * @param reply Reply payload
+     * @details Replies to unknown or completed calls are ignored.
+     */
+    void replyReceived(quint16 id, quint8 status, const QByteArray &reply);
+
+signals:
+    /**
+     * @brief Signal emitted when a request frame must be sent
+     * @param id Correlation ID
+     * @param service Service number
+     * @param request Request payload
+     */
+    void sendRequest(quint16 id, quint32 service, const QByteArray &request);
+
+    /**
+     * @brief Signal emitted when a reply frame must be sent
+     * @param id Correlation ID of the request
+     * @param status Status code
+     * @param reply Reply payload
+     */
+    void sendReply(quint16 id, quint8 status, const QByteArray &reply);
+
+private:
+    /**
+     * @struct PendingCall
+     * @brief A call waiting for its reply
+     */
+    struct PendingCall {
+        std::shared_ptr<QPromise<LoRaRpcReply>> promise;  ///< Completed by the reply or the timeout
+        quint32 service = 0;                              ///< Service number
+        QByteArray request;                               ///< Request payload, kept for retransmission
+        qint64 deadlineMs = 0;                            ///< m_clock time at which the call times out
+        std::shared_ptr<QTimer> timer;                    ///< Retransmission timer
+    };
+
+    /**
+     * @struct CachedReply
+     * @brief Reply kept for an at-most-once handler
+     */
+    struct CachedReply {
+        quint32 service = 0;      ///< Service number of the request
+        QByteArray request;       ///< Request payload, to tell reused IDs apart
+        quint8 status = 0;        ///< Status sent
+        QByteArray reply;         ///< Reply sent
+        qint64 storedAtMs = 0;    ///< m_clock time the reply was stored
+    };
+
+    /**
+     * @struct Service
+     * @brief A registered handler
+     */
+    struct Service {
+        Handler handler;          ///< Handler function
+        bool atMostOnce = false;  ///< Whether replies are cached
+    };
+
+    /**
+     * @brief Resends a request or times the call out
+     * @param id Correlation ID of the call
+     */
+    void onRetransmit(quint16 id);
+
+    /**
+     * @brief Removes a call and finishes its future
+     * @param id Correlation ID of the call
+     * @param reply Result reported to the caller
+     */
+    void complete(quint16 id, const LoRaRpcReply &reply);
+
+    /**
+     * @brief Finishes a future with a result
+     * @param promise Promise of the call
+     * @param reply Result reported to the caller
+     */
+    static void finish(QPromise<LoRaRpcReply> &promise, const LoRaRpcReply &reply);
+
+    /**
+     * @brief Drops expired entries from the reply cache
+     */
+    void expireReplies();
+
+    /**
+     * @brief Calls waiting for their reply, by correlation ID
+     */
+    QHash<quint16, PendingCall> m_pending;
+
+    /**
+     * @brief Registered handlers, by service number
+     */
+    QHash<quint32, Service> m_services;
+
+    /**
+     * @brief Replies of at-most-once handlers, by correlation ID
+     */
+    QHash<quint16, CachedReply> m_replyCache;
+
+    /**
+     * @brief Correlation IDs in m_replyCache, oldest first
+     */
+    QQueue<quint16> m_replyOrder;
+
+    /**
+     * @brief Correlation ID of the next call
+     * @details Starts at a random value so that IDs reused after a restart
+     *          are unlikely to hit the peer's reply cache.
+     */
+    quint16 m_nextId = 0;
+
+    /**
+     * @brief Interval between retransmissions of a request
+     */
+    int m_retransmitMs = 1000;
+
+    /**
+     * @brief Clock for deadlines and cache expiry
+     */
+    QElapsedTimer m_clock;
+};
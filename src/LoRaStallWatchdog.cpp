@@ -0,0 +1,122 @@
+#include "LoRaStallWatchdog.hpp"
+#include <QStringList>
+
+LoRaStallWatchdog::LoRaStallWatchdog(QObject *parent)
+    : QObject(parent)
+    , m_histogram(BUCKET_COUNT, 0)
+{
+    m_heartbeat.setTimerType(Qt::PreciseTimer);
+    m_heartbeat.setInterval(DEFAULT_HEARTBEAT_MS);
+    connect(&m_heartbeat, &QTimer::timeout, this, &LoRaStallWatchdog::onHeartbeat);
+}
+
+void LoRaStallWatchdog::start() {
+    m_histogram.fill(0);
+    m_recent.clear();
+    m_stallCount = 0;
+    m_maxStallMs = 0;
+    m_sections.clear();
+    m_slowestSection.clear();
+    m_slowestSectionMs = -1;
+
+    m_clock.start();
+    m_lastBeatMs = 0;
+    m_heartbeat.start();
+}
+
+void LoRaStallWatchdog::stop() {
+    m_heartbeat.stop();
+    m_sections.clear();
+}
+
+bool LoRaStallWatchdog::isRunning() const {
+    return m_heartbeat.isActive();
+}
+
+void LoRaStallWatchdog::setHeartbeatInterval(int ms) {
+    m_heartbeat.setInterval(qMax(ms, 1));
+}
+
+void LoRaStallWatchdog::setStallThreshold(int ms) {
+    m_thresholdMs = qMax(ms, 1);
+}
+
+void LoRaStallWatchdog::setStateProvider(StateProvider provider) {
+    m_stateProvider = std::move(provider);
+}
+
+void LoRaStallWatchdog::beginSection(const char *name) {
+    if (!isRunning()) return;
+
+    m_sections.append(Section{name, m_clock.elapsed()});
+}
+
+void LoRaStallWatchdog::endSection() {
+    if (m_sections.isEmpty()) return;
+
+    const qint64 durationMs = m_clock.elapsed() - m_sections.last().startMs;
+    if (durationMs > m_slowestSectionMs) {
+        m_slowestSectionMs = durationMs;
+        m_slowestSection = sectionPath(m_sections.size());
+    }
+    m_sections.removeLast();
+}
+
+QVector<quint64> LoRaStallWatchdog::histogram() const {
+    return m_histogram;
+}
+
+QList<LoRaStallWatchdog::Stall> LoRaStallWatchdog::recentStalls() const {
+    return m_recent;
+}
+
+quint64 LoRaStallWatchdog::stallCount() const {
+    return m_stallCount;
+}
+
+int LoRaStallWatchdog::maxStallMs() const {
+    return m_maxStallMs;
+}
+
+void LoRaStallWatchdog::onHeartbeat() {
+    const qint64 now = m_clock.elapsed();
+    const qint64 lateMs = now - m_lastBeatMs - m_heartbeat.interval();
+    m_lastBeatMs = now;
+    if (lateMs >= m_thresholdMs) {
+        recordStall(static_cast<int>(lateMs));
+    }
+    m_slowestSection.clear();
+    m_slowestSectionMs = -1;
+}
+
+void LoRaStallWatchdog::recordStall(int durationMs) {
+    int bucket = 0;
+    while (bucket < static_cast<int>(BUCKET_BOUNDS_MS.size()) && durationMs >= BUCKET_BOUNDS_MS[bucket]) {
+        bucket++;
+    }
+    m_histogram[bucket]++;
+    m_stallCount++;
+    m_maxStallMs = qMax(m_maxStallMs, durationMs);
+
+    Stall stall;
+    stall.atMs = m_clock.isValid() ? m_clock.elapsed() : 0;
+    stall.durationMs = durationMs;
+    // An open section means the heartbeat fired in a nested event loop inside it
+    stall.section = m_sections.isEmpty() ? m_slowestSection : sectionPath(m_sections.size());
+    if (m_stateProvider) {
+        stall.state = m_stateProvider();
+    }
+    m_recent.append(stall);
+    if (m_recent.size() > MAX_RECENT_STALLS) {
+        m_recent.removeFirst();
+    }
+    emit stallDetected(stall);
+}
+
+QString LoRaStallWatchdog::sectionPath(int depth) const {
+    QStringList names;
+    for (int i = 0; i < depth && i < m_sections.size(); ++i) {
+        names << QString::fromLatin1(m_sections[i].name);
+    }
+    return names.join('/');
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <array>
+#include <functional>
+
+/**
+ * @file LoRaStallWatchdog.hpp
+ * @brief Header file for the LoRaStallWatchdog class
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaStallWatchdog
+ * @brief Detects and records event-loop stalls of the thread it lives in
+ * @details A heartbeat timer fires every heartbeat interval. When it fires
+ *          more than the stall threshold late, the thread's event loop was
+ *          blocked for that long, and the stall is recorded:
+ *          - In a histogram of stall durations (see BUCKET_BOUNDS_MS)
+ *          - In a list of the most recent stalls, with the code section that
+ *            ran longest since the previous heartbeat and the protocol state
+ *            returned by the state provider
+ *
+ *          Sections are named stretches of the owner's code, marked with
+ *          beginSection() and endSection(). They may nest; a section that
+ *          is still open when the stall is detected (a nested QEventLoop)
+ *          is reported with its full path, e.g.
+ *          "onReadyRead/waitForBytesWritten".
+ *
+ *          Like LoRaLinkMonitor, the watchdog only keeps state and timers;
+ *          it costs one timer event per heartbeat while running and nothing
+ *          while stopped.
+ */
+class LoRaStallWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Stall
+     * @brief One detected stall
+     */
+    struct Stall {
+        qint64 atMs = 0;       ///< Detection time, milliseconds since start()
+        int durationMs = 0;    ///< Time the heartbeat was late
+        QString section;       ///< Slowest section since the previous heartbeat, empty if none
+        QString state;         ///< Protocol state at detection, from the state provider
+    };
+
+    /**
+     * @brief Function returning a short description of the owner's state
+     */
+    using StateProvider = std::function<QString()>;
+
+    /**
+     * @brief Default heartbeat interval in milliseconds
+     */
+    static constexpr int DEFAULT_HEARTBEAT_MS = 10;
+
+    /**
+     * @brief Default lateness in milliseconds from which a heartbeat counts as a stall
+     */
+    static constexpr int DEFAULT_STALL_THRESHOLD_MS = 20;
+
+    /**
+     * @brief Number of recent stalls kept by recentStalls()
+     */
+    static constexpr int MAX_RECENT_STALLS = 64;
+
+    /**
+     * @brief Exclusive upper bounds of the histogram buckets in milliseconds
+     * @details The last bucket, at index BUCKET_BOUNDS_MS.size(), holds
+     *          longer stalls.
+     */
+    static constexpr std::array<int, 7> BUCKET_BOUNDS_MS = {50, 100, 200, 500, 1000, 2000, 5000};
+
+    /**
+     * @brief Number of histogram buckets
+     */
+    static constexpr int BUCKET_COUNT = static_cast<int>(BUCKET_BOUNDS_MS.size()) + 1;
+
+    /**
+     * @brief Constructor for LoRaStallWatchdog
+     * @param parent Parent QObject for memory management (default: nullptr)
+     * @note The watchdog is idle until start() is called.
+     */
+    explicit LoRaStallWatchdog(QObject *parent = nullptr);
+
+    /**
+     * @brief Default destructor
+     */
+    ~LoRaStallWatchdog() override = default;
+
+    /**
+     * @brief Starts the heartbeat and clears the recorded stalls
+     */
+    void start();
+
+    /**
+     * @brief Stops the heartbeat; recorded stalls are kept
+     */
+    void stop();
+
+    /**
+     * @brief Returns whether the watchdog is running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Sets the heartbeat interval
+     * @param ms Interval in milliseconds (default: DEFAULT_HEARTBEAT_MS)
+     */
+    void setHeartbeatInterval(int ms);
+
+    /**
+     * @brief Sets the lateness from which a heartbeat counts as a stall
+     * @param ms Threshold in milliseconds (default: DEFAULT_STALL_THRESHOLD_MS)
+     */
+    void setStallThreshold(int ms);
+
+    /**
+     * @brief Sets the function describing the protocol state of a stall
+     * @param provider Function called once per detected stall
+     */
+    void setStateProvider(StateProvider provider);
+
+    /**
+     * @brief Marks the start of a named section of code
+     * @param name Section name; must outlive the section (a string literal)
+     * @note Does nothing while stopped
+     */
+    void beginSection(const char *name);
+
+    /**
+     * @brief Marks the end of the innermost open section
+     */
+    void endSection();
+
+    /**
+     * @brief Returns the number of stalls per histogram bucket
+     * @return BUCKET_COUNT counters
+     */
+    QVector<quint64> histogram() const;
+
+    /**
+     * @brief Returns the most recent stalls, oldest first
+     */
+    QList<Stall> recentStalls() const;
+
+    /**
+     * @brief Returns the number of stalls since start()
+     */
+    quint64 stallCount() const;
+
+    /**
+     * @brief Returns the longest stall since start() in milliseconds
+     */
+    int maxStallMs() const;
+
+    /**
+     * @brief Records a stall
+     * @param durationMs Stall duration in milliseconds
+     * @details Called by the heartbeat. Public so that tests and owners
+     *          with their own detection can feed the histogram.
+     * @note Emits stallDetected()
+     */
+    void recordStall(int durationMs);
+
+signals:
+    /**
+     * @brief Signal emitted for every detected stall
+     * @param stall The stall as added to recentStalls()
+     */
+    void stallDetected(const LoRaStallWatchdog::Stall &stall);
+
+private slots:
+    /**
+     * @brief Slot called by the heartbeat timer
+     * @details Compares the time since the previous heartbeat with the interval.
+     */
+    void onHeartbeat();
+
+private:
+    /**
+     * @struct Section
+     * @brief One open section
+     */
+    struct Section {
+        const char *name = nullptr; ///< Section name
+        qint64 startMs = 0;         ///< m_clock time it was entered
+    };
+
+    /**
+     * @brief Returns the names of the open sections joined with '/'
+     * @param depth Number of outermost sections to include
+     */
+    QString sectionPath(int depth) const;
+
+    /**
+     * @brief Timer firing every heartbeat interval
+     */
+    QTimer m_heartbeat;
+
+    /**
+     * @brief Monotonic clock for heartbeats and sections
+     */
+    QElapsedTimer m_clock;
+
+    /**
+     * @brief m_clock time of the previous heartbeat
+     */
+    qint64 m_lastBeatMs = 0;
+
+    /**
+     * @brief Lateness from which a heartbeat counts as a stall
+     */
+    int m_thresholdMs = DEFAULT_STALL_THRESHOLD_MS;
+
+    /**
+     * @brief Function describing the protocol state
+     */
+    StateProvider m_stateProvider;
+
+    /**
+     * @brief Open sections, outermost first
+     */
+    QVector<Section> m_sections;
+
+    /**
+     * @brief Path of the slowest section closed since the previous heartbeat
+     */
+    QString m_slowestSection;
+
+    /**
+     * @brief Duration of m_slowestSection in milliseconds, -1 if none
+     */
+    qint64 m_slowestSectionMs = -1;
+
+    /**
+     * @brief Stall counters per histogram bucket
+     */
+    QVector<quint64> m_histogram;
+
+    /**
+     * @brief Most recent stalls, oldest first
+     */
+    QList<Stall> m_recent;
+
+    /**
+     * @brief Number of stalls since start()
+     */
+    quint64 m_stallCount = 0;
+
+    /**
+     * @brief Longest stall since start()
+     */
+    int m_maxStallMs = 0;
+};
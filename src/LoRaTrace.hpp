@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * @file LoRaTrace.hpp
+ * @brief USDT tracepoints of the protocol hot paths
+ * @date 2026-10-19
+ * @details With the LORACORE_USDT CMake option, LORA_TRACE() places a
+ *          SystemTap/DTrace static probe (sys/sdt.h) in provider "loracore".
+ *          A probe is a single NOP plus an ELF note; perf, bpftrace or
+ *          SystemTap patch it into a trap only while attached, so an
+ *          untraced process runs at full speed. Without the option the
+ *          macro expands to nothing and its arguments are not evaluated.
+ *
+ *          Probes and their arguments:
+ *          | Probe           | Arguments |
+ *          |-----------------|-----------|
+ *          | frame_in        | type byte, seq, total, payload length |
+ *          | frame_out       | type byte, seq, total, payload length |
+ *          | chunk_ack       | port, seq, total, ms since the chunk was sent, retries |
+ *          | retransmit      | port, seq, retry number, timeout in ms |
+ *          | packet_sent     | port, success, packet bytes, ms since the packet started |
+ *          | packet_received | port, packet bytes, chunks, abandoned chunks |
+ *          | error           | message (C string) |
+ *
+ *          Example:
+ *          @code
+ *          bpftrace -e 'usdt:./app:loracore:retransmit { @[arg0] = count(); }'
+ *          @endcode
+ */
+
+#ifdef LORACORE_USDT
+#define SDT_USE_VARIADIC 1
+#include <sys/sdt.h>
+#define LORA_TRACE(name, ...) STAP_PROBEV(loracore, name, __VA_ARGS__)
+#else
+#define LORA_TRACE(name, ...) do {} while (0)
+#endif
@@ -1,4 +1,5 @@
 #include "LoRaUsbAdapter_E22_400T22U.hpp"
+#include "LoRaTrace.hpp"
 #include <QDebug>
 #include <QEventLoop>
 
@@ -12,9 +13,45 @@ LoRaUsbAdapter_E22_400T22U::LoRaUsbAdapter_E22_400T22U(std::shared_ptr<QCrossPla
         return;
     }
 
+    m_clock.start();
     connect(m_serial.get(), &QCrossPlatformSerialPort::readyRead, this, &LoRaUsbAdapter_E22_400T22U::onReadyRead);
-    m_timer.setSingleShot(true);
-    connect(&m_timer, &QTimer::timeout, this, &LoRaUsbAdapter_E22_400T22U::onSendTimeout);
+    for (int i = 0; i < MAX_PORTS; ++i) {
+        const quint8 port = static_cast<quint8>(i);
+        m_ports[i].timer.setSingleShot(true);
+        connect(&m_ports[i].timer, &QTimer::timeout, this, [this, port]() {
+            m_stallWatchdog.beginSection("onSendTimeout");
+            onSendTimeout(port);
+            m_stallWatchdog.endSection();
+        });
+        m_ports[i].recvResetTimer.setSingleShot(true);
+        connect(&m_ports[i].recvResetTimer, &QTimer::timeout, this, [this, port]() { resetReceiveState(port); });
+    }
+    m_helloTimer.setSingleShot(true);
+    connect(&m_helloTimer, &QTimer::timeout, this, &LoRaUsbAdapter_E22_400T22U::onHelloTimeout);
+    m_ackTimer.setSingleShot(true);
+    connect(&m_ackTimer, &QTimer::timeout, this, &LoRaUsbAdapter_E22_400T22U::flushAck);
+    m_linkMonitor.setProbeSender([this]() { return sendProbe(); });
+    connect(&m_linkMonitor, &LoRaLinkMonitor::linkUp, this, &LoRaUsbAdapter_E22_400T22U::onLinkUp);
+    connect(&m_linkMonitor, &LoRaLinkMonitor::linkUp, this, &LoRaUsbAdapter_E22_400T22U::linkUp);
+    connect(&m_linkMonitor, &LoRaLinkMonitor::linkDown, this, &LoRaUsbAdapter_E22_400T22U::linkDown);
+    connect(&m_autoTuner, &LoRaAutoTuner::parametersChanged, this, [this](int chunkSize, int ackDelayMs) {
+        m_chunkSize = qBound(1, chunkSize, static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE));
+        m_ackDelayMs = qMax(ackDelayMs, 0);
+    });
+    m_stallWatchdog.setStateProvider([this]() { return protocolState(); });
+    m_frameRecovery.setValidator(&LoRaUsbAdapter_E22_400T22U::isPlausibleFrame);
+    connect(&m_stallWatchdog, &LoRaStallWatchdog::stallDetected, this, [this](const LoRaStallWatchdog::Stall &stall) {
+        emit stallDetected(stall.durationMs, stall.section, stall.state);
+    });
+    // Packet outcomes are reported from many places; count them where they converge
+    connect(this, &LoRaUsbAdapter_E22_400T22U::packetSent, this, [this](bool success) {
+        success ? m_metrics.packetsSent++ : m_metrics.packetsFailed++;
+    });
+#ifdef LORACORE_USDT
+    connect(this, &LoRaUsbAdapter_E22_400T22U::error, this, [](const QString &message) {
+        LORA_TRACE(error, message.toUtf8().constData());
+    });
+#endif
 }
 
 quint8 LoRaUsbAdapter_E22_400T22U::crc8(const QByteArray &data) {
@@ -32,11 +69,39 @@ quint8 LoRaUsbAdapter_E22_400T22U::crc8(const QByteArray &data) {
     return crc;
 }
 
+bool LoRaUsbAdapter_E22_400T22U::isPortFrameType(FrameType type) {
+    switch (type) {
+    case FrameType::DATA:
+    case FrameType::ACK:
+    case FrameType::NACK:
+    case FrameType::DATA_REF:
+    case FrameType::PACKET_ACK:
+    case FrameType::DATA_ACK:
+    case FrameType::SKIP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::splitTypeByte(quint8 typeByte, FrameType &type, quint8 &port) {
+    const auto base = static_cast<FrameType>(typeByte & 0xF0);
+    if (isPortFrameType(base)) {
+        type = base;
+        port = typeByte & 0x0F;
+    } else {
+        type = static_cast<FrameType>(typeByte);
+        port = 0;
+    }
+}
+
 QByteArray LoRaUsbAdapter_E22_400T22U::makeFrame(FrameType type, quint16 seq, quint32 total,
-                                            const QByteArray &payload) {
-    const int payloadLen = qMin(payload.size(), static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE));
+                                            const QByteArray &payload, quint8 port) {
+    const int maxLen = static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE) +
+                       (type == FrameType::DATA_ACK ? static_cast<int>(FrameSize::ACK_FIELD_SIZE) : 0);
+    const int payloadLen = qMin(payload.size(), maxLen);
     QByteArray header;
-    header.append(static_cast<quint8>(type));
+    header.append(static_cast<quint8>(static_cast<quint8>(type) | (isPortFrameType(type) ? (port & 0x0F) : 0)));
     // Append seq as little-endian 16-bit value
     header.append(static_cast<quint8>(seq & 0xFF));
     header.append(static_cast<quint8>((seq >> 8) & 0xFF));
@@ -52,7 +117,7 @@ QByteArray LoRaUsbAdapter_E22_400T22U::makeFrame(FrameType type, quint16 seq, qu
 }
 
 bool LoRaUsbAdapter_E22_400T22U::parseFrame(const QByteArray &raw, FrameType &type,
-                                       quint16 &seq, quint32 &total, QByteArray &payload) {
+                                       quint16 &seq, quint32 &total, QByteArray &payload, quint8 &port) {
     if (raw.size() < static_cast<int>(FrameSize::MIN_FRAME_SIZE)) return false;
 
     const quint8 len = static_cast<quint8>(raw[static_cast<int>(FramePosition::LEN_POS)]);
@@ -63,11 +128,12 @@ bool LoRaUsbAdapter_E22_400T22U::parseFrame(const QByteArray &raw, FrameType &ty
     quint8 actualCrc = static_cast<quint8>(raw[static_cast<int>(FrameSize::MIN_FRAME_SIZE) + len - 1]);
 
     if (expectedCrc != actualCrc) {
+        m_metrics.crcErrors++;
         emit error("CRC mismatch");
         return false;
     }
 
-    type = static_cast<FrameType>(static_cast<quint8>(raw[static_cast<int>(FramePosition::TYPE_POS)]));
+    splitTypeByte(static_cast<quint8>(raw[static_cast<int>(FramePosition::TYPE_POS)]), type, port);
 
     seq = static_cast<quint16>(raw[static_cast<int>(FramePosition::SEQ_LOW_POS)]) |
           (static_cast<quint16>(raw[static_cast<int>(FramePosition::SEQ_HIGH_POS)]) << 8);
@@ -79,283 +145,1451 @@ bool LoRaUsbAdapter_E22_400T22U::parseFrame(const QByteArray &raw, FrameType &ty
     return true;
 }
 
-void LoRaUsbAdapter_E22_400T22U::sendPacket(const QByteArray &data) {
+bool LoRaUsbAdapter_E22_400T22U::isPlausibleFrame(const QByteArray &frame) {
+    if (frame.size() < static_cast<int>(FrameSize::MIN_FRAME_SIZE)) return false;
+
+    const quint8 len = static_cast<quint8>(frame[static_cast<int>(FramePosition::LEN_POS)]);
+    if (frame.size() != static_cast<int>(FrameSize::MIN_FRAME_SIZE) + len ||
+        len > static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE) + static_cast<int>(FrameSize::ACK_FIELD_SIZE)) {
+        return false;
+    }
+    if (crc8(frame.left(static_cast<int>(FrameSize::HEADER_SIZE) + len)) !=
+        static_cast<quint8>(frame[frame.size() - 1])) {
+        return false;
+    }
+
+    FrameType type;
+    quint8 port;
+    splitTypeByte(static_cast<quint8>(frame[static_cast<int>(FramePosition::TYPE_POS)]), type, port);
+    const auto byteAt = [&frame](FramePosition pos) {
+        return static_cast<quint32>(static_cast<quint8>(frame[static_cast<int>(pos)]));
+    };
+    const quint32 seq = byteAt(FramePosition::SEQ_LOW_POS) | (byteAt(FramePosition::SEQ_HIGH_POS) << 8);
+    const quint32 total = byteAt(FramePosition::TOTAL_LOW_POS) | (byteAt(FramePosition::TOTAL_MIDDLE_POS) << 8) |
+                          (byteAt(FramePosition::TOTAL_HIGH_POS) << 16);
+    switch (type) {
+    case FrameType::DATA:
+    case FrameType::ACK:
+    case FrameType::NACK:
+    case FrameType::DATA_REF:
+    case FrameType::DATA_ACK:
+    case FrameType::SKIP:
+        return seq < total && total <= static_cast<quint32>(MAX_PACKET_CHUNKS);
+    case FrameType::PACKET_ACK:
+    case FrameType::PING:
+    case FrameType::PONG:
+    case FrameType::HELLO:
+    case FrameType::HELLO_ACK:
+    case FrameType::RPC_REQUEST:
+    case FrameType::RPC_REPLY:
+        return true;
+    }
+    return false;
+}
+
+void LoRaUsbAdapter_E22_400T22U::sendPacket(const QByteArray &data, quint8 port) {
     if (!m_serial || !m_serial->isOpen()) {
         emit error("Serial port not open");
-        emit packetSent(false);
+        emit packetSent(false, port);
         return;
     }
 
-    m_chunks.clear();
-    const int chunkSize = static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE);
-    const quint32 total = (data.size() + chunkSize - 1) / chunkSize;
+    if (port >= MAX_PORTS) {
+        emit error("Invalid port");
+        emit packetSent(false, port);
+        return;
+    }
 
-    m_totalPacketBytes = data.size();
-    for (quint32 i = 0; i < total; ++i) {
-        int start = i * chunkSize;
-        int len = qMin(chunkSize, data.size() - start);
-        m_chunks.append({static_cast<quint16>(i), total, data.mid(start, len)});
+    if (port != 0 && !negotiatedCapabilities().has(LoRaCapabilities::PORTS)) {
+        emit error("Peer does not support ports");
+        emit packetSent(false, port);
+        return;
     }
 
-    m_currentChunkIndex = -1;
-    m_retries = 0;
-    m_sentBytes = 0;
-    sendChunk(0);
-}
+    if (data.size() > maxPacketSize()) {
+        emit error("Packet too large");
+        emit packetSent(false, port);
+        return;
+    }
 
-void LoRaUsbAdapter_E22_400T22U::sendChunk(int index) {
-    if (index < 0 || index >= m_chunks.size()) return;
+    const int lifetimeMs = m_ports[port].lifetimeMs;
+    const OutgoingPacket packet{data, lifetimeMs > 0 ? m_clock.elapsed() + lifetimeMs : -1};
+    if (isSending(port) || !m_linkMonitor.isUp()) {
+        m_ports[port].outbox.enqueue(packet);
+        return;
+    }
 
-    m_currentChunkIndex = index;
-    const auto &chunk = m_chunks[index];
+    startPacket(port, packet);
+}
 
-    QByteArray frame = makeFrame(FrameType::DATA, chunk.seq, chunk.total, chunk.payload);
-    // New max frame size: Type(1) + Seq(2) + Total(3) + Len(1) + Payload(24) + CRC(1) = 32 bytes
-    if (frame.size() > static_cast<int>(FrameSize::MAX_FRAME_SIZE)) {
-        emit error("Frame too large!");
+void LoRaUsbAdapter_E22_400T22U::startPacket(quint8 port, const OutgoingPacket &packet) {
+    Port &p = m_ports[port];
+    p.chunkSize = sendChunkSize();
+    p.sendData = packet.data;
+    p.totalChunks = (p.sendData.size() + p.chunkSize - 1) / p.chunkSize;
+    p.totalPacketBytes = p.sendData.size();
+    p.deadline = packet.deadline;
+    p.startedAt = m_clock.elapsed();
+    if (p.totalChunks > MAX_PACKET_CHUNKS) {
+        // Queued before the peer announced a smaller payload size
+        emit error("Packet too large");
+        finishPacket(port, false);
         return;
     }
 
-    qint64 written = m_serial->write(frame);
-    if (written != frame.size()) {
-        emit error("Serial write failed");
-        emit packetSent(false);
-        resetSendState();
+    p.currentChunkIndex = -1;
+    p.retries = 0;
+    p.sentBytes = 0;
+    sendChunk(port, 0);
+}
+
+void LoRaUsbAdapter_E22_400T22U::startNextPacket(quint8 port) {
+    Port &p = m_ports[port];
+    while (p.currentChunkIndex < 0 && !p.outbox.isEmpty() && m_linkMonitor.isUp()) {
+        const OutgoingPacket packet = p.outbox.dequeue();
+        if (packet.deadline >= 0 && m_clock.elapsed() >= packet.deadline) {
+            // Stale before it went on the air; the handler may queue more
+            emit packetSent(false, port);
+            continue;
+        }
+        startPacket(port, packet);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::finishPacket(quint8 port, bool success) {
+    Port &p = m_ports[port];
+    const bool abandoned = p.abandonedChunks > 0;
+    LORA_TRACE(packet_sent, port, success, p.totalPacketBytes, m_clock.elapsed() - p.startedAt);
+    resetSendState(port);
+    int aborted = 0;
+    if (!success && !abandoned && p.delivery == Delivery::Ordered) {
+        // Later packets must not reach the peer without this one
+        aborted = p.outbox.size();
+        p.outbox.clear();
+    }
+    emit packetSent(success, port);
+    for (int i = 0; i < aborted; ++i) {
+        emit packetSent(false, port);
+    }
+    startNextPacket(port);
+}
+
+void LoRaUsbAdapter_E22_400T22U::cancelSend() {
+    for (int i = 0; i < MAX_PORTS; ++i) {
+        cancelSend(static_cast<quint8>(i));
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::cancelSend(quint8 port) {
+    if (port >= MAX_PORTS || !isSending(port)) return;
+
+    Port &p = m_ports[port];
+    const int aborted = (p.currentChunkIndex >= 0 ? 1 : 0) + p.outbox.size();
+    p.outbox.clear();
+    resetSendState(port);
+    for (int i = 0; i < aborted; ++i) {
+        emit packetSent(false, port);
+    }
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isSending() const {
+    for (const Port &p : m_ports) {
+        if (p.currentChunkIndex >= 0 || !p.outbox.isEmpty()) return true;
+    }
+    return false;
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isSending(quint8 port) const {
+    if (port >= MAX_PORTS) return false;
+
+    const Port &p = m_ports[port];
+    return p.currentChunkIndex >= 0 || !p.outbox.isEmpty();
+}
+
+void LoRaUsbAdapter_E22_400T22U::setPortDelivery(quint8 port, Delivery delivery) {
+    if (port >= MAX_PORTS) return;
+
+    m_ports[port].delivery = delivery;
+}
+
+LoRaUsbAdapter_E22_400T22U::Delivery LoRaUsbAdapter_E22_400T22U::portDelivery(quint8 port) const {
+    return port < MAX_PORTS ? m_ports[port].delivery : Delivery::Unordered;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setPortLifetime(quint8 port, int ms) {
+    if (port >= MAX_PORTS) return;
+
+    m_ports[port].lifetimeMs = qMax(0, ms);
+}
+
+int LoRaUsbAdapter_E22_400T22U::portLifetime(quint8 port) const {
+    return port < MAX_PORTS ? m_ports[port].lifetimeMs : 0;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setReceiveDevice(QIODevice *device, quint8 port) {
+    if (port >= MAX_PORTS) return;
+
+    m_ports[port].receiveDevice = device;
+    m_ports[port].receiveDeviceOffset = 0;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setDedupEnabled(bool enabled) {
+    if (enabled == m_dedupEnabled) return;
+
+    m_dedupEnabled = enabled;
+    if (!enabled) {
+        m_chunkCache.clear();
+    }
+    if (m_handshakeComplete && m_serial && m_serial->isOpen()) {
+        // Tell the peer whether DATA_REF can be resolved here now
+        startHandshake(m_peerCaps);
+    }
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isDedupEnabled() const {
+    return m_dedupEnabled;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setPubSubEnabled(bool enabled) {
+    if (enabled == m_pubSubEnabled) return;
+
+    m_pubSubEnabled = enabled;
+    if (m_handshakeComplete && m_serial && m_serial->isOpen()) {
+        startHandshake(m_peerCaps);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::setChunkCacheCapacity(int capacity) {
+    m_chunkCache.setCapacity(capacity);
+}
+
+void LoRaUsbAdapter_E22_400T22U::setLinkMonitorEnabled(bool enabled) {
+    if (enabled == m_linkMonitor.isRunning()) return;
+
+    if (enabled) {
+        if (m_handshakeComplete && !negotiatedCapabilities().has(LoRaCapabilities::LINK_PROBE)) {
+            // The peer would never answer PING
+            emit error("Peer does not answer PING, link monitoring not started");
+            return;
+        }
+        m_linkMonitor.start();
+    } else {
+        m_linkMonitor.stop();
+        // Resume anything that was held back while the link was down
+        onLinkUp();
+    }
+}
+
+LoRaLinkMonitor *LoRaUsbAdapter_E22_400T22U::linkMonitor() {
+    return &m_linkMonitor;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setAutoTuningEnabled(bool enabled) {
+    if (enabled == m_autoTuner.isRunning()) return;
+
+    if (enabled) {
+        m_autoTuner.start(m_chunkSize, m_ackDelayMs);
+    } else {
+        m_autoTuner.stop();
+    }
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isAutoTuningEnabled() const {
+    return m_autoTuner.isRunning();
+}
+
+LoRaAutoTuner *LoRaUsbAdapter_E22_400T22U::autoTuner() {
+    return &m_autoTuner;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setStallWatchdogEnabled(bool enabled) {
+    if (enabled == m_stallWatchdog.isRunning()) return;
+
+    if (enabled) {
+        m_stallWatchdog.start();
+    } else {
+        m_stallWatchdog.stop();
+    }
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isStallWatchdogEnabled() const {
+    return m_stallWatchdog.isRunning();
+}
+
+LoRaStallWatchdog *LoRaUsbAdapter_E22_400T22U::stallWatchdog() {
+    return &m_stallWatchdog;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setFrameRecoveryEnabled(bool enabled) {
+    m_frameRecoveryEnabled = enabled;
+    if (!enabled) {
+        m_frameRecovery.clear();
+    }
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isFrameRecoveryEnabled() const {
+    return m_frameRecoveryEnabled;
+}
+
+LoRaFrameRecovery *LoRaUsbAdapter_E22_400T22U::frameRecovery() {
+    return &m_frameRecovery;
+}
+
+void LoRaUsbAdapter_E22_400T22U::recoverFrame(const QByteArray &frame) {
+    if (!m_frameRecoveryEnabled) return;
+
+    const QByteArray recovered = m_frameRecovery.recover(frame, m_clock.elapsed());
+    if (recovered.isEmpty()) return;
+
+    m_metrics.framesRecovered++;
+    receiveFrame(recovered);
+}
+
+void LoRaUsbAdapter_E22_400T22U::setProtectedHeaderEnabled(bool enabled) {
+    if (enabled == m_protectedHeader) return;
+
+    m_protectedHeader = enabled;
+    m_rxBuffer.clear();
+    m_rxSynced = true;
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isProtectedHeaderEnabled() const {
+    return m_protectedHeader;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setFrameParity(int bytes) {
+    const int parityBytes = qBound(0, bytes, LoRaReedSolomon::MAX_PARITY_BYTES);
+    if (parityBytes == m_frameCode.parityBytes()) return;
+
+    m_frameCode = LoRaReedSolomon(parityBytes);
+    m_rxBuffer.clear();
+    m_rxSynced = true;
+}
+
+int LoRaUsbAdapter_E22_400T22U::frameParity() const {
+    return m_frameCode.parityBytes();
+}
+
+void LoRaUsbAdapter_E22_400T22U::setStandby(bool standby) {
+    m_standby = standby;
+    m_rxBuffer.clear();
+    m_rxSynced = true;
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isStandby() const {
+    return m_standby;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setFrameForwarding(bool forward) {
+    m_forwardFrames = forward;
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isFrameForwarding() const {
+    return m_forwardFrames;
+}
+
+void LoRaUsbAdapter_E22_400T22U::setHoldOnDeviceFailure(bool hold) {
+    m_holdOnDeviceFailure = hold;
+}
+
+bool LoRaUsbAdapter_E22_400T22U::holdsOnDeviceFailure() const {
+    return m_holdOnDeviceFailure;
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isDeviceOpen() const {
+    return m_serial && m_serial->isOpen();
+}
+
+void LoRaUsbAdapter_E22_400T22U::takeOver(LoRaUsbAdapter_E22_400T22U &failed) {
+    if (&failed == this) return;
+
+    // Deadlines are times of the owning adapter's clock
+    const qint64 clockOffset = m_clock.elapsed() - failed.m_clock.elapsed();
+    const auto shift = [clockOffset](qint64 time) { return time >= 0 ? time + clockOffset : time; };
+
+    m_nodeId = failed.m_nodeId;
+    m_dedupEnabled = failed.m_dedupEnabled;
+    m_pubSubEnabled = failed.m_pubSubEnabled;
+    m_frameRecoveryEnabled = failed.m_frameRecoveryEnabled;
+    setProtectedHeaderEnabled(failed.m_protectedHeader);
+    setFrameParity(failed.frameParity());
+    m_chunkSize = failed.m_chunkSize;
+    m_ackDelayMs = failed.m_ackDelayMs;
+    m_srttMs = failed.m_srttMs;
+    m_rttVarMs = failed.m_rttVarMs;
+    m_rttSamples = failed.m_rttSamples;
+    m_rtoMs = failed.m_rtoMs;
+    m_appliedProfile = failed.m_appliedProfile;
+    m_handshakeStarted = failed.m_handshakeStarted;
+    m_handshakeComplete = failed.m_handshakeComplete;
+    m_peerCaps = failed.m_peerCaps;
+    m_ackPending = failed.m_ackPending;
+    m_pendingAckSeq = failed.m_pendingAckSeq;
+    m_pendingAckTotal = failed.m_pendingAckTotal;
+    m_pendingAckPort = failed.m_pendingAckPort;
+
+    for (int i = 0; i < MAX_PORTS; ++i) {
+        const quint8 port = static_cast<quint8>(i);
+        Port &p = m_ports[i];
+        Port &f = failed.m_ports[i];
+        resetSendState(port);
+        p.sendData = f.sendData;
+        p.totalChunks = f.totalChunks;
+        p.chunkSize = f.chunkSize;
+        p.currentChunkIndex = f.currentChunkIndex;
+        p.retries = f.retries;
+        p.totalPacketBytes = f.totalPacketBytes;
+        p.sentBytes = f.sentBytes;
+        p.sendFullChunk = f.sendFullChunk;
+        p.deadline = shift(f.deadline);
+        p.startedAt = shift(f.startedAt);
+        p.skipCount = f.skipCount;
+        p.abandonedChunks = f.abandonedChunks;
+        p.outbox = f.outbox;
+        for (OutgoingPacket &packet : p.outbox) {
+            packet.deadline = shift(packet.deadline);
+        }
+        p.delivery = f.delivery;
+        p.lifetimeMs = f.lifetimeMs;
+        p.recvState = f.recvState;
+        p.receiveDevice = f.receiveDevice;
+        p.receiveDeviceOffset = f.receiveDeviceOffset;
+        p.recvResetTimer.stop();
+        if (f.recvResetTimer.isActive()) {
+            p.recvResetTimer.start(f.recvResetTimer.remainingTime());
+        }
+
+        f.outbox.clear();
+        failed.resetSendState(port);
+        failed.resetReceiveState(port);
+        f.recvResetTimer.stop();
+    }
+
+    failed.m_ackPending = false;
+    failed.m_ackTimer.stop();
+    failed.m_helloTimer.stop();
+    failed.setStandby(true);
+    if (failed.m_linkMonitor.isRunning()) {
+        failed.m_linkMonitor.stop();
+        m_linkMonitor.start();
+    }
+    setStandby(false);
+
+    if (m_handshakeStarted && !m_handshakeComplete) {
+        startHandshake(m_peerCaps);
+    }
+    flushAck();
+    for (int i = 0; i < MAX_PORTS; ++i) {
+        const quint8 port = static_cast<quint8>(i);
+        if (m_ports[i].currentChunkIndex < 0) {
+            startNextPacket(port);
+            continue;
+        }
+        // Resent at once, the failed device may never have put it on the air
+        m_metrics.retransmissions++;
+        LORA_TRACE(retransmit, port, m_ports[i].currentChunkIndex, m_ports[i].retries, 0);
+        resendCurrent(port);
+    }
+}
+
+QString LoRaUsbAdapter_E22_400T22U::protocolState() const {
+    static const char *const linkStates[] = {"unknown", "up", "down"};
+    QStringList parts;
+    parts << QString("link=%1").arg(m_linkMonitor.isRunning() ?
+                                    linkStates[static_cast<int>(m_linkMonitor.state())] : "unmonitored");
+    parts << QString("handshake=%1").arg(m_handshakeComplete ? "done" : "pending");
+    parts << QString("rto=%1ms").arg(m_rtoMs);
+    if (m_ackPending) {
+        parts << QString("ack=%1:%2").arg(m_pendingAckPort).arg(m_pendingAckSeq);
+    }
+    for (int i = 0; i < MAX_PORTS; ++i) {
+        const Port &p = m_ports[i];
+        if (p.currentChunkIndex >= 0) {
+            parts << QString("tx%1=%2/%3 retry %4 queued %5").arg(i).arg(p.currentChunkIndex)
+                         .arg(p.totalChunks).arg(p.retries).arg(p.outbox.size());
+        }
+        if (p.recvState.total > 0 && !p.recvState.packetAckSent) {
+            parts << QString("rx%1=%2/%3").arg(i).arg(p.recvState.receivedCount).arg(p.recvState.total);
+        }
+    }
+    return parts.join(' ');
+}
+
+LoRaUsbAdapter_E22_400T22U::Metrics LoRaUsbAdapter_E22_400T22U::metrics() const {
+    Metrics metrics = m_metrics;
+    metrics.chunkSize = m_chunkSize;
+    metrics.ackDelayMs = m_ackDelayMs;
+    metrics.retransmitTimeoutMs = m_rtoMs;
+    metrics.autoTuning = m_autoTuner.isRunning();
+    metrics.tuner = m_autoTuner.stats();
+    metrics.stalls = m_stallWatchdog.stallCount();
+    metrics.maxStallMs = m_stallWatchdog.maxStallMs();
+    metrics.stallHistogram = m_stallWatchdog.histogram();
+    return metrics;
+}
+
+void LoRaUsbAdapter_E22_400T22U::resetMetrics() {
+    m_metrics = Metrics{};
+}
+
+bool LoRaUsbAdapter_E22_400T22U::sendProbe() {
+    if (!m_serial || !m_serial->isOpen()) return false;
+    if (!negotiatedCapabilities().has(LoRaCapabilities::LINK_PROBE)) return false;
+
+    return writeFrame(makeFrame(FrameType::PING, 0, 0)) > 0;
+}
+
+void LoRaUsbAdapter_E22_400T22U::onLinkUp() {
+    for (int i = 0; i < MAX_PORTS; ++i) {
+        const quint8 port = static_cast<quint8>(i);
+        Port &p = m_ports[i];
+        if (p.currentChunkIndex < 0) {
+            startNextPacket(port);
+        } else if (!p.timer.isActive()) {
+            // The transmission was paused while the link was down
+            p.retries = 0;
+            resendCurrent(port);
+        }
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::sendRpcRequest(quint16 id, quint32 service, const QByteArray &payload) {
+    if (!m_serial || !m_serial->isOpen()) return;
+
+    writeFrame(makeFrame(FrameType::RPC_REQUEST, id, service, payload));
+}
+
+void LoRaUsbAdapter_E22_400T22U::sendRpcReply(quint16 id, quint8 status, const QByteArray &payload) {
+    if (!m_serial || !m_serial->isOpen()) return;
+
+    writeFrame(makeFrame(FrameType::RPC_REPLY, id, status, payload));
+}
+
+void LoRaUsbAdapter_E22_400T22U::setChunkSize(int bytes) {
+    m_chunkSize = qBound(1, bytes, static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE));
+    if (m_autoTuner.isRunning()) {
+        m_autoTuner.start(m_chunkSize, m_ackDelayMs);
+    }
+}
+
+int LoRaUsbAdapter_E22_400T22U::chunkSize() const {
+    return m_chunkSize;
+}
+
+int LoRaUsbAdapter_E22_400T22U::sendChunkSize() const {
+    return qBound(1, qMin(m_chunkSize, static_cast<int>(negotiatedCapabilities().maxPayload)),
+                  static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE));
+}
+
+int LoRaUsbAdapter_E22_400T22U::maxPacketSize() const {
+    return MAX_PACKET_CHUNKS * sendChunkSize();
+}
+
+void LoRaUsbAdapter_E22_400T22U::setAckDelay(int ms) {
+    m_ackDelayMs = qMax(ms, 0);
+    if (m_autoTuner.isRunning()) {
+        m_autoTuner.start(m_chunkSize, m_ackDelayMs);
+    }
+}
+
+int LoRaUsbAdapter_E22_400T22U::ackDelay() const {
+    return m_ackDelayMs;
+}
+
+int LoRaUsbAdapter_E22_400T22U::retransmitTimeout() const {
+    return m_rtoMs;
+}
+
+void LoRaUsbAdapter_E22_400T22U::addRttSample(qint64 rttMs) {
+    const double r = static_cast<double>(rttMs);
+    if (m_rttSamples == 0) {
+        m_srttMs = r;
+        m_rttVarMs = r / 2.0;
+    } else {
+        // RFC 6298 with alpha = 1/8 and beta = 1/4
+        m_rttVarMs = 0.75 * m_rttVarMs + 0.25 * qAbs(m_srttMs - r);
+        m_srttMs = 0.875 * m_srttMs + 0.125 * r;
+    }
+    m_rttSamples++;
+    m_rtoMs = qBound(MIN_RTO_MS, static_cast<int>(m_srttMs + 4.0 * m_rttVarMs), MAX_RTO_MS);
+}
+
+LoRaLinkProfile LoRaUsbAdapter_E22_400T22U::linkProfile() const {
+    LoRaLinkProfile profile = m_appliedProfile;
+    profile.srttMs = static_cast<quint32>(m_srttMs);
+    profile.rttVarMs = static_cast<quint32>(m_rttVarMs);
+    profile.rttSamples = m_rttSamples;
+    profile.chunkSize = static_cast<quint16>(m_chunkSize);
+    if (m_handshakeComplete && !m_peerCaps.isLegacy()) {
+        profile.peerCapabilities = m_peerCaps;
+    }
+    profile.updatedAtSecs = 0;
+    return profile;
+}
+
+void LoRaUsbAdapter_E22_400T22U::applyLinkProfile(const LoRaLinkProfile &profile) {
+    m_appliedProfile = profile;
+    if (profile.srttMs > 0) {
+        m_srttMs = profile.srttMs;
+        m_rttVarMs = profile.rttVarMs;
+        // With an aged-out history the next sample restarts the estimate
+        m_rttSamples = profile.rttSamples;
+        m_rtoMs = qBound(MIN_RTO_MS, static_cast<int>(m_srttMs + 4.0 * m_rttVarMs), MAX_RTO_MS);
+    }
+    if (profile.chunkSize > 0) {
+        setChunkSize(profile.chunkSize);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::setNodeId(quint32 id) {
+    m_nodeId = id;
+}
+
+quint32 LoRaUsbAdapter_E22_400T22U::nodeId() const {
+    return m_nodeId;
+}
+
+LoRaCapabilities LoRaUsbAdapter_E22_400T22U::localCapabilities() const {
+    LoRaCapabilities caps;
+    caps.version = LoRaCapabilities::PROTOCOL_VERSION;
+    caps.features = LoRaCapabilities::LINK_PROBE | LoRaCapabilities::PIGGYBACK_ACK | LoRaCapabilities::RPC |
+                    LoRaCapabilities::PORTS | LoRaCapabilities::PARTIAL_RELIABILITY;
+    if (m_dedupEnabled) {
+        caps.features |= LoRaCapabilities::DEDUP;
+    }
+    if (m_pubSubEnabled) {
+        caps.features |= LoRaCapabilities::PUBSUB;
+    }
+    caps.maxPayload = static_cast<quint8>(FrameSize::MAX_PAYLOAD_SIZE);
+    caps.nodeId = m_nodeId;
+    return caps;
+}
+
+void LoRaUsbAdapter_E22_400T22U::startHandshake(const LoRaCapabilities &cached) {
+    m_handshakeStarted = true;
+    m_handshakeComplete = false;
+    // Until the peer answers, only use what it is known to support
+    m_peerCaps = cached.isLegacy() ? LoRaCapabilities::legacy(static_cast<quint8>(FrameSize::MAX_PAYLOAD_SIZE)) : cached;
+    m_helloAttempts = 0;
+    sendHello();
+}
+
+void LoRaUsbAdapter_E22_400T22U::resetHandshake() {
+    m_helloTimer.stop();
+    m_handshakeStarted = false;
+    m_handshakeComplete = false;
+    m_peerCaps = LoRaCapabilities{};
+    m_helloAttempts = 0;
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isHandshakeComplete() const {
+    return m_handshakeComplete;
+}
+
+bool LoRaUsbAdapter_E22_400T22U::isHandshakePending() const {
+    return m_handshakeStarted && !m_handshakeComplete;
+}
+
+LoRaCapabilities LoRaUsbAdapter_E22_400T22U::peerCapabilities() const {
+    return m_peerCaps;
+}
+
+LoRaCapabilities LoRaUsbAdapter_E22_400T22U::negotiatedCapabilities() const {
+    // Without a handshake the peer may predate every optional frame
+    if (!m_handshakeStarted) return LoRaCapabilities::legacy(static_cast<quint8>(FrameSize::MAX_PAYLOAD_SIZE));
+
+    return localCapabilities().negotiate(m_peerCaps);
+}
+
+void LoRaUsbAdapter_E22_400T22U::sendHello() {
+    if (!m_serial || !m_serial->isOpen()) return;
+
+    m_helloAttempts++;
+    writeFrame(makeFrame(FrameType::HELLO, 0, 0, localCapabilities().encode()));
+    m_helloTimer.start(qMin(m_rtoMs << (m_helloAttempts - 1), MAX_RTO_MS));
+}
+
+void LoRaUsbAdapter_E22_400T22U::onHelloTimeout() {
+    if (m_helloAttempts < HELLO_ATTEMPTS) {
+        sendHello();
         return;
     }
-    
+
+    // No answer: the peer predates the handshake
+    completeHandshake(LoRaCapabilities::legacy(static_cast<quint8>(FrameSize::MAX_PAYLOAD_SIZE)));
+}
+
+void LoRaUsbAdapter_E22_400T22U::completeHandshake(const LoRaCapabilities &peer) {
+    m_helloTimer.stop();
+    m_handshakeStarted = true;
+    m_handshakeComplete = true;
+    m_peerCaps = peer;
+
+    if (m_linkMonitor.isRunning() && !negotiatedCapabilities().has(LoRaCapabilities::LINK_PROBE)) {
+        // The peer would never answer PING and the link would be declared down
+        emit error("Peer does not answer PING, link monitoring stopped");
+        setLinkMonitorEnabled(false);
+    }
+    emit capabilitiesNegotiated();
+}
+
+LoRaUsbAdapter_E22_400T22U::Chunk LoRaUsbAdapter_E22_400T22U::chunkAt(quint8 port, int index) const {
+    const Port &p = m_ports[port];
+    const int start = index * p.chunkSize;
+    return {static_cast<quint16>(index), static_cast<quint32>(p.totalChunks),
+            p.sendData.mid(start, qMin(p.chunkSize, p.sendData.size() - start))};
+}
+
+bool LoRaUsbAdapter_E22_400T22U::waitForBytesWritten(int timeoutMs) {
     // Simulate blocking waitForBytesWritten using QEventLoop
+    m_stallWatchdog.beginSection("waitForBytesWritten");
     QEventLoop loop;
     QTimer timeoutTimer;
     timeoutTimer.setSingleShot(true);
-    timeoutTimer.setInterval(WRITE_TIMEOUT_MS); // timeout in ms
-    
+    timeoutTimer.setInterval(timeoutMs); // timeout in ms
+
     QObject::connect(m_serial.get(), &QCrossPlatformSerialPort::bytesWritten,
                      &loop, &QEventLoop::quit, Qt::UniqueConnection);
     QObject::connect(&timeoutTimer, &QTimer::timeout, &loop, &QEventLoop::quit);
-    
+
     timeoutTimer.start();
     loop.exec();
-    
+
     QObject::disconnect(m_serial.get(), &QCrossPlatformSerialPort::bytesWritten,
                        &loop, &QEventLoop::quit);
-    
-    if (!timeoutTimer.isActive()) {
+
+    const bool written = timeoutTimer.isActive();
+    timeoutTimer.stop();
+    m_stallWatchdog.endSection();
+    return written;
+}
+
+qint64 LoRaUsbAdapter_E22_400T22U::writeFrame(const QByteArray &frame) {
+    LORA_TRACE(frame_out, static_cast<quint8>(frame[static_cast<int>(FramePosition::TYPE_POS)]),
+               static_cast<quint8>(frame[static_cast<int>(FramePosition::SEQ_LOW_POS)]) |
+               (static_cast<quint8>(frame[static_cast<int>(FramePosition::SEQ_HIGH_POS)]) << 8),
+               static_cast<quint8>(frame[static_cast<int>(FramePosition::TOTAL_LOW_POS)]) |
+               (static_cast<quint8>(frame[static_cast<int>(FramePosition::TOTAL_MIDDLE_POS)]) << 8) |
+               (static_cast<quint8>(frame[static_cast<int>(FramePosition::TOTAL_HIGH_POS)]) << 16),
+               static_cast<quint8>(frame[static_cast<int>(FramePosition::LEN_POS)]));
+    QByteArray wire = frame;
+    if (m_protectedHeader) {
+        const int headerSize = static_cast<int>(FrameSize::HEADER_SIZE);
+        wire.insert(headerSize, static_cast<char>(crc8(frame.left(headerSize))));
+    }
+    wire.append(m_frameCode.parity(frame));
+    const qint64 written = m_serial->write(wire);
+    if (written != wire.size()) {
+        emit deviceFailed();
+        return -1;
+    }
+    return frame.size();
+}
+
+void LoRaUsbAdapter_E22_400T22U::sendChunk(quint8 port, int index) {
+    Port &p = m_ports[port];
+    if (index < 0 || index >= p.totalChunks) return;
+
+    if (index != p.currentChunkIndex) {
+        p.sendFullChunk = false;
+    }
+    p.currentChunkIndex = index;
+    if (p.deadline >= 0 && m_clock.elapsed() >= p.deadline && canAbandon(port)) {
+        // The rest of the packet has gone stale
+        sendSkip(port, p.totalChunks - index);
+        return;
+    }
+    const Chunk chunk = chunkAt(port, index);
+
+    QByteArray frame;
+    const LoRaCapabilities caps = negotiatedCapabilities();
+    const bool refsAllowed = caps.has(LoRaCapabilities::DEDUP);
+    const quint64 key = refsAllowed && !p.sendFullChunk && LoRaChunkCache::isCacheable(chunk.payload) ?
+                        LoRaChunkCache::keyOf(chunk.payload) : 0;
+    if (m_ackPending && m_pendingAckPort != port) {
+        // A DATA_ACK only acknowledges chunks of its own port
+        flushAck();
+    }
+    if (key != 0 && m_chunkCache.contains(key)) {
+        flushAck();
+        frame = makeFrame(FrameType::DATA_REF, chunk.seq, chunk.total, LoRaChunkCache::encodeKey(key), port);
+    } else if (m_ackPending && caps.has(LoRaCapabilities::PIGGYBACK_ACK)) {
+        // The pending ACK rides on this chunk
+        QByteArray payload;
+        payload.append(static_cast<char>(m_pendingAckSeq & 0xFF));
+        payload.append(static_cast<char>((m_pendingAckSeq >> 8) & 0xFF));
+        payload.append(chunk.payload);
+        frame = makeFrame(FrameType::DATA_ACK, chunk.seq, chunk.total, payload, port);
+        m_metrics.piggybackedAcks++;
+        m_ackPending = false;
+        m_ackTimer.stop();
+    } else {
+        frame = makeFrame(FrameType::DATA, chunk.seq, chunk.total, chunk.payload, port);
+    }
+    // Max frame size: Type(1) + Seq(2) + Total(3) + Len(1) + Payload(24) + CRC(1) = 32 bytes,
+    // plus the ACK field of DATA_ACK
+    if (frame.size() > static_cast<int>(FrameSize::MAX_FRAME_SIZE) + static_cast<int>(FrameSize::ACK_FIELD_SIZE)) {
+        emit error("Frame too large!");
+        return;
+    }
+
+    transmit(port, frame);
+}
+
+void LoRaUsbAdapter_E22_400T22U::sendSkip(quint8 port, int count) {
+    Port &p = m_ports[port];
+    if (p.skipCount == 0) {
+        // A new frame, with retries of its own
+        p.retries = 0;
+        p.abandonedChunks += count;
+        m_metrics.chunksAbandoned += count;
+    }
+    p.skipCount = count;
+
+    QByteArray payload;
+    payload.append(static_cast<char>(count & 0xFF));
+    payload.append(static_cast<char>((count >> 8) & 0xFF));
+    payload.append(static_cast<char>(p.chunkSize));
+    payload.append(static_cast<char>(p.totalPacketBytes & 0xFF));
+    payload.append(static_cast<char>((p.totalPacketBytes >> 8) & 0xFF));
+    payload.append(static_cast<char>((p.totalPacketBytes >> 16) & 0xFF));
+    transmit(port, makeFrame(FrameType::SKIP, static_cast<quint16>(p.currentChunkIndex),
+                             static_cast<quint32>(p.totalChunks), payload, port));
+}
+
+void LoRaUsbAdapter_E22_400T22U::resendCurrent(quint8 port) {
+    const Port &p = m_ports[port];
+    if (p.skipCount > 0) {
+        sendSkip(port, p.skipCount);
+    } else {
+        sendChunk(port, p.currentChunkIndex);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::transmit(quint8 port, const QByteArray &frame) {
+    Port &p = m_ports[port];
+    qint64 written = writeFrame(frame);
+    if (written != frame.size()) {
+        emit error("Serial write failed");
+        if (!m_holdOnDeviceFailure) {
+            finishPacket(port, false);
+            return;
+        }
+    } else if (!waitForBytesWritten(WRITE_TIMEOUT_MS)) {
         // Timeout occurred
         emit error("Write timeout");
-        emit packetSent(false);
-        resetSendState();
-        return;
+        emit deviceFailed();
+        if (!m_holdOnDeviceFailure) {
+            finishPacket(port, false);
+            return;
+        }
+    } else {
+        m_metrics.framesTransmitted++;
     }
-    timeoutTimer.stop();
 
-    m_timer.start(TIMEOUT_MS);
+    // Exponential backoff on retries; a held frame is retried like one lost on the air
+    p.timer.start(qMin(m_rtoMs << qMin(p.retries, 6), MAX_RTO_MS));
+    p.rttClock.start();
 }
 
-void LoRaUsbAdapter_E22_400T22U::onSendTimeout() {
-    if (m_currentChunkIndex < 0) return;
+bool LoRaUsbAdapter_E22_400T22U::canAbandon(quint8 port) const {
+    return m_ports[port].deadline >= 0 && negotiatedCapabilities().has(LoRaCapabilities::PARTIAL_RELIABILITY);
+}
+
+void LoRaUsbAdapter_E22_400T22U::onSendTimeout(quint8 port) {
+    Port &p = m_ports[port];
+    if (p.currentChunkIndex < 0) return;
 
-    m_retries++;
-    if (m_retries > MAX_RETRIES) {
+    p.retries++;
+    if (m_linkMonitor.isRunning()) {
+        m_linkMonitor.responseMissed();
+        if (!m_linkMonitor.isUp()) {
+            // Stop burning retries; onLinkUp() resumes this chunk
+            return;
+        }
+    }
+
+    if (p.retries > MAX_RETRIES) {
+        if (p.skipCount == 0 && canAbandon(port)) {
+            // Give up on this chunk only, the rest may still get through
+            sendSkip(port, 1);
+            return;
+        }
         emit error("Max retries exceeded");
-        emit packetSent(false);
-        resetSendState();
+        finishPacket(port, false);
         return;
     }
 
-    sendChunk(m_currentChunkIndex);
+    m_metrics.retransmissions++;
+    LORA_TRACE(retransmit, port, p.currentChunkIndex, p.retries, qMin(m_rtoMs << qMin(p.retries, 6), MAX_RTO_MS));
+    resendCurrent(port);
 }
 
 void LoRaUsbAdapter_E22_400T22U::onReadyRead() {
-    static QByteArray buffer;
-    buffer.append(m_serial->readAll());
-
-    while (buffer.size() >= static_cast<int>(FrameSize::MIN_FRAME_SIZE)) {
-        quint8 len = static_cast<quint8>(buffer[static_cast<int>(FramePosition::LEN_POS)]);
-        int frameSize = static_cast<int>(FrameSize::MIN_FRAME_SIZE) + len;
-        if (buffer.size() < frameSize) break;
+    if (m_standby && !m_forwardFrames) {
+        // The active adapter handles these frames
+        m_serial->readAll();
+        return;
+    }
 
-        QByteArray frame = buffer.left(frameSize);
-        buffer = buffer.mid(frameSize);
+    m_stallWatchdog.beginSection("onReadyRead");
+    m_rxBuffer.append(m_serial->readAll());
 
-        FrameType type;
-        quint16 seq;
-        quint32 total;
-        QByteArray payload;
-        if (!parseFrame(frame, type, seq, total, payload)) {
+    QByteArray frame;
+    while (takeFrame(frame)) {
+        if (m_forwardFrames) {
+            // Checked here, so a damaged copy never shadows a good one
+            FrameType type;
+            quint16 seq;
+            quint32 total;
+            QByteArray payload;
+            quint8 port;
+            if (parseFrame(frame, type, seq, total, payload, port)) {
+                emit frameHeard(frame);
+            } else {
+                emit frameDamaged(frame);
+            }
             continue;
         }
+        receiveFrame(frame);
+    }
+    m_stallWatchdog.endSection();
+}
 
-        switch (type) {
-        case FrameType::DATA: {
-            if (total == 0) {
-                emit error("Invalid total=0 in DATA");
-                break;
+bool LoRaUsbAdapter_E22_400T22U::takeFrame(QByteArray &frame) {
+    const int headerSize = static_cast<int>(FrameSize::HEADER_SIZE);
+    const int crcSize = static_cast<int>(FrameSize::CRC_SIZE);
+    const int paritySize = m_frameCode.parityBytes();
+    if (!m_protectedHeader) {
+        if (m_rxBuffer.size() < headerSize + crcSize + paritySize) return false;
+
+        const quint8 len = static_cast<quint8>(m_rxBuffer[static_cast<int>(FramePosition::LEN_POS)]);
+        const int frameSize = headerSize + len + crcSize;
+        if (m_rxBuffer.size() < frameSize + paritySize) return false;
+
+        frame = m_rxBuffer.left(frameSize);
+        correctFrame(frame, m_rxBuffer.mid(frameSize, paritySize));
+        m_rxBuffer.remove(0, frameSize + paritySize);
+        return true;
+    }
+
+    const int checkedSize = headerSize + static_cast<int>(FrameSize::HEADER_CHECK_SIZE);
+    const int maxLen = static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE) + static_cast<int>(FrameSize::ACK_FIELD_SIZE);
+    while (m_rxBuffer.size() >= checkedSize + crcSize + paritySize) {
+        QByteArray header = m_rxBuffer.left(headerSize);
+        const int result = correctHeader(header, static_cast<quint8>(m_rxBuffer[headerSize]));
+        const quint8 len = static_cast<quint8>(header[static_cast<int>(FramePosition::LEN_POS)]);
+        // Out of sync, a corrected header is more likely noise than a frame
+        if (result < 0 || (result > 0 && !m_rxSynced) || len > maxLen) {
+            if (m_rxSynced) {
+                m_metrics.framingErrors++;
+                m_rxSynced = false;
             }
+            m_rxBuffer.remove(0, 1);
+            continue;
+        }
 
-            if (m_recvState.total == 0) {
-                m_recvState.total = total;
-                m_recvState.expectedSize = -1;
-            } else if (m_recvState.total != total) {
-                resetReceiveState();
-                m_recvState.total = total;
-                m_recvState.expectedSize = -1;
+        const int wireSize = checkedSize + len + crcSize + paritySize;
+        if (m_rxBuffer.size() < wireSize) return false;
+
+        frame = header + m_rxBuffer.mid(checkedSize, len + crcSize);
+        correctFrame(frame, m_rxBuffer.mid(checkedSize + len + crcSize, paritySize));
+        if (!m_rxSynced) {
+            if (crc8(frame.left(headerSize + len)) != static_cast<quint8>(frame[frame.size() - 1])) {
+                m_rxBuffer.remove(0, 1);
+                continue;
             }
+            m_rxSynced = true;
+        }
+        if (result > 0) {
+            m_metrics.headersCorrected++;
+        }
+        m_rxBuffer.remove(0, wireSize);
+        return true;
+    }
+    return false;
+}
+
+void LoRaUsbAdapter_E22_400T22U::correctFrame(QByteArray &frame, const QByteArray &parity) {
+    if (parity.isEmpty()) return;
+
+    QByteArray codeword = frame + parity;
+    const int corrected = m_frameCode.decode(codeword);
+    if (corrected <= 0) return;
+
+    // The framing already relied on the length; a codeword that disagrees is miscorrected
+    const int lenPos = static_cast<int>(FramePosition::LEN_POS);
+    if (codeword[lenPos] != frame[lenPos]) return;
+
+    frame = codeword.left(frame.size());
+    m_metrics.framesCorrected++;
+    m_metrics.bytesCorrected += static_cast<quint64>(corrected);
+}
+
+int LoRaUsbAdapter_E22_400T22U::correctHeader(QByteArray &header, quint8 check) {
+    const int headerBits = static_cast<int>(FrameSize::HEADER_SIZE) * 8;
+    // Syndrome of each single-bit error: the CRC is linear, so it is the CRC of the error
+    static const std::array<qint8, 256> errorBit = [headerBits]() {
+        std::array<qint8, 256> table;
+        table.fill(-1);
+        for (int bit = 0; bit < headerBits; ++bit) {
+            QByteArray error(headerBits / 8, '\0');
+            error[bit / 8] = static_cast<char>(1 << (bit % 8));
+            table[crc8(error)] = static_cast<qint8>(bit);
+        }
+        for (int bit = 0; bit < 8; ++bit) {
+            table[1 << bit] = static_cast<qint8>(headerBits + bit);
+        }
+        return table;
+    }();
 
-            QByteArray ack = makeFrame(FrameType::ACK, seq, total);
-            m_serial->write(ack);
-            
-            // Simulate blocking waitForBytesWritten using QEventLoop
-            QEventLoop loop;
-            QTimer timeoutTimer;
-            timeoutTimer.setSingleShot(true);
-            timeoutTimer.setInterval(ACK_WRITE_TIMEOUT_MS); // timeout in ms
-            
-            QObject::connect(m_serial.get(), &QCrossPlatformSerialPort::bytesWritten,
-                             &loop, &QEventLoop::quit, Qt::UniqueConnection);
-            QObject::connect(&timeoutTimer, &QTimer::timeout, &loop, &QEventLoop::quit);
-            
-            timeoutTimer.start();
-            loop.exec();
-            
-            QObject::disconnect(m_serial.get(), &QCrossPlatformSerialPort::bytesWritten,
-                               &loop, &QEventLoop::quit);
-            
-            if (!timeoutTimer.isActive()) {
+    const quint8 syndrome = crc8(header) ^ check;
+    if (syndrome == 0) return 0;
+
+    const int bit = errorBit[syndrome];
+    if (bit < 0) return -1;
+
+    if (bit < headerBits) {
+        header[bit / 8] = static_cast<char>(header[bit / 8] ^ (1 << (bit % 8)));
+    }
+    return 1;
+}
+
+void LoRaUsbAdapter_E22_400T22U::receiveFrame(const QByteArray &frame) {
+    FrameType type;
+    quint16 seq;
+    quint32 total;
+    QByteArray payload;
+    quint8 port;
+    if (!parseFrame(frame, type, seq, total, payload, port)) {
+        recoverFrame(frame);
+        return;
+    }
+    if (m_frameRecoveryEnabled) {
+        // Damaged copies of this frame are no longer needed
+        m_frameRecovery.frameReceived(frame);
+    }
+    LORA_TRACE(frame_in, static_cast<quint8>(frame[static_cast<int>(FramePosition::TYPE_POS)]),
+               seq, total, payload.size());
+
+    // Any valid frame proves the peer is alive
+    m_linkMonitor.frameReceived();
+
+    switch (type) {
+    case FrameType::DATA:
+        handleDataChunk(port, seq, total, payload);
+        break;
+
+    case FrameType::DATA_REF: {
+        quint64 key = 0;
+        QByteArray chunk;
+        if (!LoRaChunkCache::decodeKey(payload, key)) {
+            emit error("Invalid key in DATA_REF");
+            break;
+        }
+        if (!m_dedupEnabled || !m_chunkCache.lookup(key, chunk)) {
+            // Ask the sender to fall back to the full chunk
+            QByteArray nack = makeFrame(FrameType::NACK, seq, total, {}, port);
+            writeFrame(nack);
+            if (!waitForBytesWritten(ACK_WRITE_TIMEOUT_MS)) {
                 // Timeout occurred - log warning but continue
-                qWarning() << "ACK write timeout";
-            }
-            timeoutTimer.stop();
-
-            if (!m_recvState.chunks.contains(seq)) {
-                m_recvState.chunks[seq] = payload;
-                m_recvState.receivedCount++;
-
-                int receivedBytes = 0;
-                for (const auto &ch : m_recvState.chunks) {
-                    receivedBytes += ch.size();
-                }
-
-                if (m_recvState.expectedSize == -1) {
-                    if (seq == total - 1) {
-                        m_recvState.expectedSize = total * static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE);
-                    } else {
-                        m_recvState.expectedSize = total * static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE);
-                    }
-                }
-
-                if (m_recvState.receivedCount == m_recvState.total) {
-                    int exactSize = 0;
-                    for (quint16 i = 0; i < total; ++i) {
-                        if (m_recvState.chunks.contains(i)) {
-                            exactSize += m_recvState.chunks[i].size();
-                        }
-                    }
-                    m_recvState.expectedSize = exactSize;
-                }
-
-                int totalBytes = (m_recvState.expectedSize == -1) ?
-                                total * static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE) :
-                                m_recvState.expectedSize;
-
-                emit packetProgress(receivedBytes, totalBytes);
+                qWarning() << "NACK write timeout";
             }
+            break;
+        }
+        handleDataChunk(port, seq, total, chunk);
+        break;
+    }
 
-            if (m_recvState.receivedCount == m_recvState.total && !m_recvState.packetAckSent) {
-                QByteArray full;
-                int exactSize = 0;
-                for (quint16 i = 0; i < m_recvState.total; ++i) {
-                    if (m_recvState.chunks.contains(i)) {
-                        const QByteArray &ch = m_recvState.chunks[i];
-                        full.append(ch);
-                        exactSize += ch.size();
-                    } else {
-                        emit error("Missing chunk despite count match");
-                        return;
-                    }
-                }
-
-                m_recvState.expectedSize = exactSize;
-
-                QByteArray packAck = makeFrame(FrameType::PACKET_ACK, 0, 0);
-                m_serial->write(packAck);
-                
-                // Simulate blocking waitForBytesWritten using QEventLoop
-                QEventLoop loop;
-                QTimer timeoutTimer;
-                timeoutTimer.setSingleShot(true);
-                timeoutTimer.setInterval(ACK_WRITE_TIMEOUT_MS); // timeout in ms
-                
-                QObject::connect(m_serial.get(), &QCrossPlatformSerialPort::bytesWritten,
-                                 &loop, &QEventLoop::quit, Qt::UniqueConnection);
-                QObject::connect(&timeoutTimer, &QTimer::timeout, &loop, &QEventLoop::quit);
-                
-                timeoutTimer.start();
-                loop.exec();
-                
-                QObject::disconnect(m_serial.get(), &QCrossPlatformSerialPort::bytesWritten,
-                                   &loop, &QEventLoop::quit);
-                
-                if (!timeoutTimer.isActive()) {
-                    // Timeout occurred - log warning but continue
-                    qWarning() << "PACKET_ACK write timeout";
-                }
-                timeoutTimer.stop();
-                
-                m_recvState.packetAckSent = true;
-
-                emit packetProgress(exactSize, exactSize);
-                emit packetReceived(full);
-                QTimer::singleShot(RECEIVE_STATE_RESET_DELAY_MS, this, &LoRaUsbAdapter_E22_400T22U::resetReceiveState);
-            }
+    case FrameType::DATA_ACK: {
+        if (payload.size() < static_cast<int>(FrameSize::ACK_FIELD_SIZE)) {
+            emit error("Invalid DATA_ACK");
             break;
         }
+        const quint16 ackSeq = static_cast<quint8>(payload[0]) |
+                               (static_cast<quint16>(static_cast<quint8>(payload[1])) << 8);
+        // Data first, so the next chunk sent by handleAck() carries its ACK
+        handleDataChunk(port, seq, total, payload.mid(static_cast<int>(FrameSize::ACK_FIELD_SIZE)));
+        handleAck(port, ackSeq);
+        break;
+    }
 
-        case FrameType::ACK: {
-            if (m_currentChunkIndex >= 0 && seq == m_chunks[m_currentChunkIndex].seq) {
-                m_timer.stop();
-                m_retries = 0;
+    case FrameType::ACK:
+        handleAck(port, seq);
+        break;
 
-                if (m_currentChunkIndex >= 0 && m_currentChunkIndex < m_chunks.size()) {
-                    m_sentBytes += m_chunks[m_currentChunkIndex].payload.size();
-                    emit packetSendProgress(m_sentBytes, m_totalPacketBytes);
-                }
+    case FrameType::SKIP:
+        handleSkip(port, seq, total, payload);
+        break;
 
-                if (m_currentChunkIndex + 1 < m_chunks.size()) {
-                    sendChunk(m_currentChunkIndex + 1);
-                } else {
-                    emit packetSendProgress(m_totalPacketBytes, m_totalPacketBytes);
-                    emit packetSent(true);
-                    resetSendState();
-                }
-            }
-            break;
+    case FrameType::NACK: {
+        Port &p = m_ports[port];
+        if (p.currentChunkIndex >= 0 && p.skipCount == 0 && seq == static_cast<quint16>(p.currentChunkIndex)) {
+            // The peer no longer holds the referenced chunk
+            p.timer.stop();
+            m_chunkCache.remove(LoRaChunkCache::keyOf(chunkAt(port, p.currentChunkIndex).payload));
+            p.sendFullChunk = true;
+            sendChunk(port, p.currentChunkIndex);
         }
+        break;
+    }
 
-        case FrameType::PACKET_ACK: {
-            if (m_currentChunkIndex >= 0 && m_currentChunkIndex == m_chunks.size() - 1) {
-                m_timer.stop();
-                emit packetSendProgress(m_totalPacketBytes, m_totalPacketBytes);
-                emit packetSent(true);
-                resetSendState();
+    case FrameType::PACKET_ACK: {
+        // The receiver sends PACKET_ACK right after the ACK of the final
+        // chunk, so it may arrive after the next queued packet has started.
+        // Only trust it once the final chunk has been retransmitted, i.e.
+        // its ACK was lost.
+        Port &p = m_ports[port];
+        if (p.currentChunkIndex >= 0 && p.currentChunkIndex + qMax(p.skipCount, 1) == p.totalChunks &&
+            p.retries > 0) {
+            p.timer.stop();
+            const bool complete = p.abandonedChunks == 0;
+            if (complete) {
+                emit packetSendProgress(p.totalPacketBytes, p.totalPacketBytes, port);
             }
+            finishPacket(port, complete);
+        }
+        break;
+    }
+
+    case FrameType::PING: {
+        QByteArray pong = makeFrame(FrameType::PONG, seq, total);
+        writeFrame(pong);
+        break;
+    }
+
+    case FrameType::PONG:
+        // Already accounted for by the link monitor
+        break;
+
+    case FrameType::RPC_REQUEST:
+        emit rpcRequestReceived(seq, total, payload);
+        break;
+
+    case FrameType::RPC_REPLY:
+        emit rpcReplyReceived(seq, static_cast<quint8>(total), payload);
+        break;
+
+    case FrameType::HELLO: {
+        LoRaCapabilities peer;
+        if (!LoRaCapabilities::decode(payload, peer)) {
+            emit error("Invalid capabilities in HELLO");
             break;
         }
+        writeFrame(makeFrame(FrameType::HELLO_ACK, seq, total, localCapabilities().encode()));
+        // Also completes our own handshake, and re-negotiates after a peer restart
+        completeHandshake(peer);
+        break;
+    }
 
-        default:
-            emit error("Unknown frame type");
+    case FrameType::HELLO_ACK: {
+        if (!m_helloTimer.isActive()) {
+            // Duplicate, or crossed with the peer's own HELLO
             break;
         }
+        LoRaCapabilities peer;
+        if (!LoRaCapabilities::decode(payload, peer)) {
+            emit error("Invalid capabilities in HELLO_ACK");
+            break;
+        }
+        completeHandshake(peer);
+        break;
+    }
+
+    default:
+        emit error("Unknown frame type");
+        break;
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::handleAck(quint8 port, quint16 seq) {
+    Port &p = m_ports[port];
+    if (p.currentChunkIndex < 0 || seq != static_cast<quint16>(p.currentChunkIndex)) return;
+
+    p.timer.stop();
+    LORA_TRACE(chunk_ack, port, seq, p.totalChunks, p.rttClock.elapsed(), p.retries);
+    if (p.retries == 0 && p.skipCount == 0) {
+        // Karn's algorithm: an ACK after a retransmission is ambiguous. The
+        // ACK of a SKIP may also be the late ACK of the abandoned chunk.
+        addRttSample(p.rttClock.elapsed());
+    }
+    p.retries = 0;
+
+    int next = p.currentChunkIndex + 1;
+    if (p.skipCount > 0) {
+        next = p.currentChunkIndex + p.skipCount;
+        p.skipCount = 0;
+    } else if (p.currentChunkIndex < p.totalChunks) {
+        const QByteArray ackedPayload = chunkAt(port, p.currentChunkIndex).payload;
+        if (m_dedupEnabled) {
+            m_chunkCache.insert(ackedPayload);
+        }
+        p.sentBytes += ackedPayload.size();
+        m_metrics.payloadBytesAcked += ackedPayload.size();
+        m_autoTuner.recordBytes(ackedPayload.size());
+        emit packetSendProgress(p.sentBytes, p.totalPacketBytes, port);
+    }
+
+    if (next < p.totalChunks) {
+        sendChunk(port, next);
+    } else if (p.abandonedChunks > 0) {
+        finishPacket(port, false);
+    } else {
+        emit packetSendProgress(p.totalPacketBytes, p.totalPacketBytes, port);
+        finishPacket(port, true);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::queueAck(quint8 port, quint16 seq, quint32 total) {
+    if (m_ackPending && (m_pendingAckSeq != seq || m_pendingAckPort != port)) {
+        flushAck();
+    }
+    m_ackPending = true;
+    m_pendingAckSeq = seq;
+    m_pendingAckTotal = total;
+    m_pendingAckPort = port;
+
+    // Reverse data is only to be expected while sending; the answer to a
+    // completed packet comes too late, as PACKET_ACK flushes the ACK first
+    if (m_ackDelayMs == 0 || !isSending(port) || !negotiatedCapabilities().has(LoRaCapabilities::PIGGYBACK_ACK)) {
+        flushAck();
+    } else if (!m_ackTimer.isActive()) {
+        m_ackTimer.start(m_ackDelayMs);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::flushAck() {
+    m_ackTimer.stop();
+    if (!m_ackPending) return;
+
+    m_ackPending = false;
+    if (!m_serial || !m_serial->isOpen()) return;
+
+    QByteArray ack = makeFrame(FrameType::ACK, m_pendingAckSeq, m_pendingAckTotal, {}, m_pendingAckPort);
+    writeFrame(ack);
+    if (!waitForBytesWritten(ACK_WRITE_TIMEOUT_MS)) {
+        // Timeout occurred - log warning but continue
+        qWarning() << "ACK write timeout";
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::writeToReceiveDevice(quint8 port, quint16 seq, const QByteArray &payload) {
+    Port &p = m_ports[port];
+    PacketReassembly &state = p.recvState;
+    const int total = state.total;
+    if (seq + 1 < total && state.chunkStride == 0) {
+        state.chunkStride = payload.size();
+    }
+    if (state.chunkStride == 0 && total > 1) {
+        // Final chunk first: its offset is unknown until another chunk arrives
+        state.chunks[seq] = payload;
+        return;
+    }
+
+    auto write = [this, &p](quint16 chunkSeq, const QByteArray &chunk) {
+        const qint64 offset = p.receiveDeviceOffset + static_cast<qint64>(chunkSeq) * p.recvState.chunkStride;
+        if (!p.receiveDevice->seek(offset) || p.receiveDevice->write(chunk) != chunk.size()) {
+            emit error("Receive device write failed");
+        }
+    };
+    write(seq, payload);
+    for (auto it = state.chunks.constBegin(); it != state.chunks.constEnd(); ++it) {
+        write(it.key(), it.value());
+    }
+    state.chunks.clear();
+}
+
+void LoRaUsbAdapter_E22_400T22U::handleDataChunk(quint8 port, quint16 seq, quint32 total, const QByteArray &payload) {
+    if (total == 0) {
+        emit error("Invalid total=0 in DATA");
+        return;
+    }
+    if (total > static_cast<quint32>(MAX_PACKET_CHUNKS) || seq >= total) {
+        emit error("Invalid seq in DATA");
+        return;
+    }
+
+    Port &p = m_ports[port];
+    PacketReassembly &state = p.recvState;
+
+    // After completion only the final chunk can be retransmitted (its ACK
+    // was lost); anything else is the start of the next packet
+    if (state.packetAckSent &&
+        !(static_cast<quint32>(state.total) == total && seq == total - 1 &&
+          payload == state.lastChunk)) {
+        resetReceiveState(port);
+    }
+
+    beginReassembly(port, total);
+    queueAck(port, seq, total);
+
+    if (!state.received.testBit(seq) && !state.skipped.testBit(seq)) {
+        state.received.setBit(seq);
+        state.receivedCount++;
+        state.receivedBytes += payload.size();
+        m_metrics.payloadBytesReceived += payload.size();
+        m_autoTuner.recordBytes(payload.size());
+        if (seq == total - 1) {
+            state.lastChunk = payload;
+        }
+        if (m_dedupEnabled) {
+            m_chunkCache.insert(payload);
+        }
+
+        if (p.receiveDevice) {
+            writeToReceiveDevice(port, seq, payload);
+        } else {
+            state.chunks[seq] = payload;
+        }
+
+        if (state.receivedCount == state.total) {
+            state.expectedSize = state.receivedBytes;
+        }
+
+        int totalBytes = (state.expectedSize == -1) ?
+                        total * static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE) :
+                        state.expectedSize;
+
+        emit packetProgress(state.receivedBytes, totalBytes, port);
+    }
+
+    if (state.receivedCount + state.skippedCount == state.total && !state.packetAckSent) {
+        completeReassembly(port);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::handleSkip(quint8 port, quint16 seq, quint32 total, const QByteArray &payload) {
+    if (payload.size() < static_cast<int>(FrameSize::SKIP_PAYLOAD_SIZE)) {
+        emit error("Invalid SKIP");
+        return;
+    }
+    const quint32 count = static_cast<quint8>(payload[0]) | (static_cast<quint32>(static_cast<quint8>(payload[1])) << 8);
+    const int chunkSize = static_cast<quint8>(payload[2]);
+    const int packetSize = static_cast<quint8>(payload[3]) |
+                           (static_cast<quint8>(payload[4]) << 8) |
+                           (static_cast<quint8>(payload[5]) << 16);
+    if (total == 0 || total > static_cast<quint32>(MAX_PACKET_CHUNKS) || count == 0 ||
+        static_cast<quint32>(seq) + count > total || chunkSize == 0 ||
+        static_cast<quint32>((packetSize + chunkSize - 1) / chunkSize) != total) {
+        emit error("Invalid SKIP");
+        return;
+    }
+
+    Port &p = m_ports[port];
+    PacketReassembly &state = p.recvState;
+
+    // After completion only a SKIP ending the packet can be retransmitted
+    if (state.packetAckSent &&
+        !(static_cast<quint32>(state.total) == total && static_cast<quint32>(seq) + count == total)) {
+        resetReceiveState(port);
+    }
+
+    beginReassembly(port, total);
+    queueAck(port, seq, total);
+
+    state.expectedSize = packetSize;
+    if (state.chunkStride == 0) {
+        state.chunkStride = chunkSize;
+        if (p.receiveDevice && !state.chunks.isEmpty()) {
+            // A final chunk held back for want of the stride can be written now
+            const quint16 heldSeq = state.chunks.constBegin().key();
+            writeToReceiveDevice(port, heldSeq, state.chunks.take(heldSeq));
+        }
+    }
+    for (quint32 i = seq; i < seq + count; ++i) {
+        if (!state.received.testBit(i) && !state.skipped.testBit(i)) {
+            state.skipped.setBit(i);
+            state.skippedCount++;
+        }
+    }
+
+    if (state.receivedCount + state.skippedCount == state.total && !state.packetAckSent) {
+        completeReassembly(port);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::beginReassembly(quint8 port, quint32 total) {
+    Port &p = m_ports[port];
+    PacketReassembly &state = p.recvState;
+    if (state.total != 0 && static_cast<quint32>(state.total) != total) {
+        resetReceiveState(port);
+    }
+    if (state.total == 0) {
+        p.recvResetTimer.stop();
+        state.total = total;
+        state.expectedSize = -1;
+        state.received.resize(total);
+        state.skipped.resize(total);
+    }
+}
+
+void LoRaUsbAdapter_E22_400T22U::completeReassembly(quint8 port) {
+    Port &p = m_ports[port];
+    PacketReassembly &state = p.recvState;
+    const bool partial = state.skippedCount > 0;
+
+    QByteArray full;
+    if (!p.receiveDevice && partial) {
+        // Abandoned chunks stay zero-filled at their offset
+        full = QByteArray(state.expectedSize, '\0');
+        for (auto it = state.chunks.constBegin(); it != state.chunks.constEnd(); ++it) {
+            full.replace(it.key() * state.chunkStride, it.value().size(), it.value());
+        }
+    } else if (!p.receiveDevice) {
+        full.reserve(state.receivedBytes);
+        for (int i = 0; i < state.total; ++i) {
+            const quint16 chunkSeq = static_cast<quint16>(i);
+            if (state.chunks.contains(chunkSeq)) {
+                full.append(state.chunks[chunkSeq]);
+            } else {
+                emit error("Missing chunk despite count match");
+                return;
+            }
+        }
+    }
+
+    const int exactSize = partial ? state.expectedSize : state.receivedBytes;
+    state.expectedSize = exactSize;
+    LORA_TRACE(packet_received, port, exactSize, state.total, state.skippedCount);
+
+    // The sender ignores a PACKET_ACK that overtakes the ACK of the final chunk
+    flushAck();
+    QByteArray packAck = makeFrame(FrameType::PACKET_ACK, 0, 0, {}, port);
+    writeFrame(packAck);
+    if (!waitForBytesWritten(ACK_WRITE_TIMEOUT_MS)) {
+        // Timeout occurred - log warning but continue
+        qWarning() << "PACKET_ACK write timeout";
+    }
+
+    state.packetAckSent = true;
+    state.chunks.clear();
+    m_metrics.packetsReceived++;
+
+    emit packetProgress(exactSize, exactSize, port);
+    if (p.receiveDevice) {
+        p.receiveDeviceOffset += exactSize;
+        emit packetReceivedToDevice(exactSize, port);
+    } else if (partial) {
+        emit packetReceivedPartial(full, state.received, state.chunkStride, port);
+    } else {
+        emit packetReceived(full, port);
     }
+    p.recvResetTimer.start(RECEIVE_STATE_RESET_DELAY_MS);
 }
 
-void LoRaUsbAdapter_E22_400T22U::resetSendState() {
-    m_chunks.clear();
-    m_currentChunkIndex = -1;
-    m_retries = 0;
-    m_timer.stop();
+void LoRaUsbAdapter_E22_400T22U::resetSendState(quint8 port) {
+    Port &p = m_ports[port];
+    p.sendData.clear();
+    p.totalChunks = 0;
+    p.currentChunkIndex = -1;
+    p.retries = 0;
+    p.sendFullChunk = false;
+    p.deadline = -1;
+    p.skipCount = 0;
+    p.abandonedChunks = 0;
+    p.timer.stop();
 }
 
-void LoRaUsbAdapter_E22_400T22U::resetReceiveState() {
-    m_recvState = PacketReassembly{};
+void LoRaUsbAdapter_E22_400T22U::resetReceiveState(quint8 port) {
+    m_ports[port].recvState = PacketReassembly{};
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <QObject>
 #include "QCrossPlatformSerialPort.hpp"
@@ -7,6 +8,17 @@
 #include <QByteArray>
 #include <QQueue>
 #include <QHash>
+#include <QBitArray>
+#include <QIODevice>
+#include "LoRaChunkCache.hpp"
+#include "LoRaLinkMonitor.hpp"
+#include "LoRaLinkProfileStore.hpp"
+#include "LoRaCapabilities.hpp"
+#include "LoRaAutoTuner.hpp"
+#include "LoRaStallWatchdog.hpp"
+#include "LoRaFrameRecovery.hpp"
+#include "LoRaReedSolomon.hpp"
+#include <QElapsedTimer>
 
 /**
  * @file LoRaUsbAdapter_E22_400T22U.hpp
@@ -21,10 +33,34 @@
  *          for the E22-400T22U LoRa module over USB/Serial. Features include:
  *          - Automatic packet chunking for large data (max FrameSize::MAX_PAYLOAD_SIZE bytes per chunk)
  *          - CRC-8 checksum verification for data integrity
- *          - Automatic retransmission with configurable retry limit
+ *          - Automatic retransmission with configurable retry limit and an
+ *            adaptive timeout learned from measured round-trip times
  *          - Packet reassembly on receiver side
  *          - Progress reporting for send/receive operations
  *          - ACK/NACK protocol for reliable delivery
+ *          - Optional chunk deduplication (see setDedupEnabled())
+ *          - Optional link liveness monitoring (see setLinkMonitorEnabled())
+ *          - Packets passed to sendPacket() while busy are queued
+ *          - Optional capability handshake (see startHandshake())
+ *          - Delayed ACKs that ride on reverse data once negotiated (see setAckDelay())
+ *          - Single-frame requests and replies for LoRaRpc (see sendRpcRequest())
+ *          - Logical ports with independent send and reassembly state, so a
+ *            long transfer on one port does not delay packets on another
+ *            (see sendPacket())
+ *          - Optional per-port lifetimes for data that goes stale, after which
+ *            chunks are abandoned instead of retransmitted (see setPortLifetime())
+ *          - Optional online tuning of chunk size and delayed-ACK window
+ *            (see setAutoTuningEnabled()), observable through metrics()
+ *          - Optional event-loop stall watchdog (see setStallWatchdogEnabled())
+ *          - Session hand-over to a standby adapter on the same channel
+ *            (see takeOver() and LoRaAdapterGroup)
+ *          - Optional recovery of frames from damaged copies
+ *            (see setFrameRecoveryEnabled())
+ *          - Optional header check byte that corrects single-bit header
+ *            errors, so a damaged length does not break the framing
+ *            (see setProtectedHeaderEnabled())
+ *          - Optional Reed-Solomon parity that corrects damaged bytes
+ *            within a frame (see setFrameParity())
  *
  *          Protocol Frame Format:
  *          [Type(1)][Seq(2)][Total(3)][Len(1)][Payload(0-FrameSize::MAX_PAYLOAD_SIZE)][CRC(1)]
@@ -32,8 +68,30 @@
  *          Frame Types (see FrameType enum):
  *          - DATA (0x10): Data chunk transmission
  *          - ACK (0x20): Acknowledgment for received chunk
- *          - NACK (0x30): Negative acknowledgment (not currently used)
+ *          - NACK (0x30): Negative acknowledgment for an unresolvable DATA_REF
+ *          - DATA_REF (0x40): Chunk replaced by its LoRaChunkCache key
  *          - PACKET_ACK (0x50): Acknowledgment for complete packet reception
+ *          - PING (0x60): Liveness probe, answered with PONG
+ *          - PONG (0x61): Answer to PING
+ *          - HELLO (0x62): Capability announcement, answered with HELLO_ACK
+ *          - HELLO_ACK (0x63): Answer to HELLO carrying the responder's capabilities
+ *          - DATA_ACK (0x70): DATA frame whose payload starts with the
+ *            sequence number of an acknowledged chunk of the reverse direction
+ *          - RPC_REQUEST (0x80): Request; Seq is the correlation ID, Total the service
+ *          - RPC_REPLY (0x81): Reply; Seq is the correlation ID, Total the status
+ *          - SKIP (0x90): Chunks from Seq on abandoned by the sender,
+ *            acknowledged like a chunk
+ *
+ *          The frames of the packet path (DATA, ACK, NACK, DATA_REF,
+ *          PACKET_ACK, DATA_ACK, SKIP) carry their logical port in the low nibble
+ *          of the Type byte. Port 0 leaves the byte unchanged, so it is the
+ *          original frame format.
+ *
+ *          With a protected header, a check byte follows the header on the wire:
+ *          [Type(1)][Seq(2)][Total(3)][Len(1)][HeaderCheck(1)][Payload][CRC(1)]
+ *          With frame parity, setFrameParity() bytes follow the CRC on the
+ *          wire. Check byte and parity are removed on reception, so frames
+ *          have the format above everywhere else.
  */
 class LoRaUsbAdapter_E22_400T22U : public QObject
 {
@@ -48,8 +106,17 @@ public:
     enum class FrameType : quint8 {
         DATA = 0x10,       ///< Data frame carrying a chunk of the payload
         ACK  = 0x20,       ///< Acknowledgment frame for received data chunk
-        NACK = 0x30,       ///< Negative acknowledgment (reserved for future use)
-        PACKET_ACK = 0x50  ///< Acknowledgment for complete packet reception
+        NACK = 0x30,       ///< Negative acknowledgment for a DATA_REF whose chunk is not cached
+        DATA_REF = 0x40,   ///< Data frame carrying the cache key of a chunk instead of the chunk
+        PACKET_ACK = 0x50, ///< Acknowledgment for complete packet reception
+        PING = 0x60,       ///< Liveness probe sent by the link monitor on an idle link
+        PONG = 0x61,       ///< Answer to PING
+        HELLO = 0x62,      ///< Capability announcement (see LoRaCapabilities)
+        HELLO_ACK = 0x63,  ///< Answer to HELLO carrying the responder's capabilities
+        DATA_ACK = 0x70,   ///< DATA frame with a piggybacked ACK: [AckSeq(2)][Chunk]
+        RPC_REQUEST = 0x80,///< Single-frame RPC request, answered with RPC_REPLY
+        RPC_REPLY = 0x81,  ///< Single-frame RPC reply, also acknowledging the request
+        SKIP = 0x90        ///< Abandoned chunks: [Count(2)][ChunkSize(1)][PacketSize(3)]
     };
 
     /**
@@ -82,9 +149,94 @@ public:
         HEADER_SIZE = 7,        ///< Total header size (Type + Seq + Total + Len)
         MIN_FRAME_SIZE = 8,     ///< Minimum frame size (HEADER_SIZE + CRC_SIZE)
         MAX_PAYLOAD_SIZE = 24,   ///< Maximum payload size in bytes
-        MAX_FRAME_SIZE = 32     ///< Maximum frame size (HEADER_SIZE + MAX_PAYLOAD_SIZE + CRC_SIZE)
+        MAX_FRAME_SIZE = 32,    ///< Maximum frame size (HEADER_SIZE + MAX_PAYLOAD_SIZE + CRC_SIZE)
+        ACK_FIELD_SIZE = 2,     ///< Size of the piggybacked ACK field in front of a DATA_ACK chunk
+        SKIP_PAYLOAD_SIZE = 6,  ///< Size of the SKIP payload (Count + ChunkSize + PacketSize)
+        HEADER_CHECK_SIZE = 1   ///< Size of the header check byte of a protected header
+    };
+
+    /**
+     * @brief Maximum number of chunks in one packet
+     * @details Limited by the 16-bit sequence number field.
+     */
+    static constexpr int MAX_PACKET_CHUNKS = 0x10000;
+
+    /**
+     * @brief Maximum packet size in bytes accepted by sendPacket() with full-size chunks
+     * @see maxPacketSize()
+     */
+    static constexpr int MAX_PACKET_SIZE = MAX_PACKET_CHUNKS * static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE);
+
+    /**
+     * @brief Number of logical ports, limited by the low nibble of the Type byte
+     */
+    static constexpr int MAX_PORTS = 16;
+
+    /**
+     * @enum Delivery
+     * @brief What a port does with its queued packets when a packet fails
+     */
+    enum class Delivery {
+        Unordered,  ///< The failed packet is skipped and the next one is sent (default)
+        Ordered     ///< The queued packets fail too, so the peer never receives a packet after a gap
     };
 
+    /**
+     * @struct Metrics
+     * @brief Counters and settings of the adapter, for monitoring
+     * @see metrics()
+     */
+    struct Metrics {
+        quint64 framesTransmitted = 0;  ///< Chunk and SKIP frames written, retransmissions included
+        quint64 retransmissions = 0;    ///< Frames written again after a timeout
+        quint64 chunksAbandoned = 0;    ///< Chunks given up on (see setPortLifetime())
+        quint64 piggybackedAcks = 0;    ///< ACKs sent inside DATA_ACK frames
+        quint64 payloadBytesAcked = 0;  ///< Payload bytes acknowledged by the peer
+        quint64 payloadBytesReceived = 0; ///< New payload bytes received from the peer
+        quint64 packetsSent = 0;        ///< Packets reported with packetSent(true)
+        quint64 packetsFailed = 0;      ///< Packets reported with packetSent(false)
+        quint64 packetsReceived = 0;    ///< Packets delivered, partial ones included
+        quint64 crcErrors = 0;          ///< Frames dropped for a CRC mismatch
+        quint64 framesRecovered = 0;    ///< Frames rebuilt from damaged copies
+        quint64 headersCorrected = 0;   ///< Protected headers with a bit error corrected
+        quint64 framingErrors = 0;      ///< Protected headers too damaged to correct; framing was resynchronized
+        quint64 framesCorrected = 0;    ///< Frames repaired by their Reed-Solomon parity
+        quint64 bytesCorrected = 0;     ///< Bytes repaired by the Reed-Solomon parity
+        int chunkSize = 0;              ///< Chunk size for new packets
+        int ackDelayMs = 0;             ///< Delayed-ACK window
+        int retransmitTimeoutMs = 0;    ///< Current retransmission timeout
+        bool autoTuning = false;        ///< Whether the auto-tuner is running
+        LoRaAutoTuner::Stats tuner;     ///< Auto-tuner state (meaningful while autoTuning)
+        quint64 stalls = 0;             ///< Event-loop stalls detected by the watchdog
+        int maxStallMs = 0;             ///< Longest stall detected by the watchdog
+        QVector<quint64> stallHistogram; ///< Stalls per LoRaStallWatchdog bucket
+    };
+
+    /**
+     * @brief Returns whether a frame type carries a logical port
+     * @param type Frame type
+     * @return true for the frames of the packet path
+     */
+    static bool isPortFrameType(FrameType type);
+
+    /**
+     * @brief Splits a received Type byte into frame type and port
+     * @param typeByte First byte of a frame
+     * @param type Output parameter for the frame type
+     * @param port Output parameter for the logical port (0 for frames without one)
+     */
+    static void splitTypeByte(quint8 typeByte, FrameType &type, quint8 &port);
+
+    /**
+     * @brief Corrects a protected header with its check byte
+     * @param header Header of HEADER_SIZE bytes, corrected in place
+     * @param check Header check byte as received
+     * @return 0 if header and check match, 1 if a single-bit error was
+     *         corrected, -1 if the error cannot be corrected
+     * @see setProtectedHeaderEnabled()
+     */
+    static int correctHeader(QByteArray &header, quint8 check);
+
     /**
      * @brief Constructor for LoRaUsbAdapter_E22_400T22U
      * @param serial Shared pointer to the QCrossPlatformSerialPort instance for communication
@@ -107,6 +259,7 @@ public:
     /**
      * @brief Sends a packet of data via LoRa
      * @param data The byte array containing the packet data to send
+     * @param port Logical port, below MAX_PORTS (default: 0)
      * @details Splits the data into chunks of maximum FrameSize::MAX_PAYLOAD_SIZE bytes each,
      *          then transmits each chunk with automatic retry on failure.
      *          Each chunk is sent as a separate frame with sequence numbers.
@@ -118,24 +271,604 @@ public:
      *          4. After MAX_RETRIES, abort and emit error
      *          5. On final chunk ACK, optionally wait for PACKET_ACK
      *
+     *          If a packet is already being sent on the same port, or the
+     *          link monitor reports the peer unreachable, the packet is queued
+     *          and sent later. Every call results in exactly one packetSent().
+     *
+     *          Each port has its own queue, chunk in flight and retransmission
+     *          timer, and the receiver reassembles each port separately. A
+     *          packet stuck in retransmissions on one port therefore does not
+     *          hold back the others. Packets on port 0 use the original frame
+     *          format. Other ports need LoRaCapabilities::PORTS; without a
+     *          handshake, or with a peer that lacks it, they fail at once.
+     *
+     *          Chunks are cut lazily from data when they are sent, so the
+     *          buffer is never copied. Passing a QByteArray::fromRawData() view
+     *          over a memory-mapped file is supported as long as the mapping
+     *          outlives the transmission.
+     *
      * @note Emits packetSent(bool) when transmission completes or fails
      * @note Emits packetSendProgress(int, int) during transmission
-     * @note Emits error(QString) if serial port is not open or write fails
+     * @note Emits error(QString) if serial port is not open, the packet exceeds
+     *       maxPacketSize(), the port is invalid or write fails
+     */
+    void sendPacket(const QByteArray &data, quint8 port = 0);
+
+    /**
+     * @brief Aborts the packet currently being sent and all queued packets
+     * @details Stops retransmission and releases the send buffers of every
+     *          port. Does nothing if no packet is being sent.
+     * @note Emits packetSent(false) once for every aborted packet
+     */
+    void cancelSend();
+
+    /**
+     * @brief Aborts the packet being sent and the queued packets of one port
+     * @param port Logical port
+     * @note Emits packetSent(false) once for every aborted packet
+     */
+    void cancelSend(quint8 port);
+
+    /**
+     * @brief Returns whether a packet is being sent or queued on any port
+     */
+    bool isSending() const;
+
+    /**
+     * @brief Returns whether a packet is being sent or queued on a port
+     * @param port Logical port
+     */
+    bool isSending(quint8 port) const;
+
+    /**
+     * @brief Sets what a port does with its queued packets when a packet fails
+     * @param port Logical port
+     * @param delivery Delivery mode (default: Delivery::Unordered)
+     * @details Within a port, packets are always sent and received in the
+     *          order of sendPacket(). With Delivery::Ordered, a packet that
+     *          fails also fails every packet queued behind it, so the peer
+     *          never sees a later packet without the earlier one. The mode is
+     *          local to the sender; the receiver needs no configuration.
+     */
+    void setPortDelivery(quint8 port, Delivery delivery);
+
+    /**
+     * @brief Returns the delivery mode of a port
+     * @param port Logical port
+     */
+    Delivery portDelivery(quint8 port) const;
+
+    /**
+     * @brief Sets how long packets on a port stay worth delivering
+     * @param port Logical port
+     * @param ms Lifetime in milliseconds from sendPacket(), 0 for fully
+     *        reliable delivery (default: 0)
+     * @details Partial reliability in the spirit of PR-SCTP, for data such as
+     *          sensor snapshots that is worthless once it is old. A queued
+     *          packet whose lifetime has run out is dropped before any of
+     *          it is sent. Once the packet is on the air, its chunks are
+     *          abandoned instead of retransmitted:
+     *          - When the lifetime runs out, the chunks not yet acknowledged
+     *          - Before that, a single chunk that exhausts MAX_RETRIES, so the
+     *            rest of the packet still gets through
+     *
+     *          Abandoned chunks are announced with a SKIP frame, which the
+     *          receiver acknowledges like a chunk. It completes the packet
+     *          without them and emits packetReceivedPartial().
+     *
+     *          Chunks are only abandoned when the peer understands SKIP (see
+     *          LoRaCapabilities::PARTIAL_RELIABILITY); otherwise a packet that
+     *          has started is sent in full. The lifetime applies to packets
+     *          passed to sendPacket() from now on.
+     * @note A packet with abandoned chunks reports packetSent(false), but does
+     *       not fail the queued packets of a Delivery::Ordered port.
+     */
+    void setPortLifetime(quint8 port, int ms);
+
+    /**
+     * @brief Returns the packet lifetime of a port in milliseconds, 0 if fully reliable
+     * @param port Logical port
+     */
+    int portLifetime(quint8 port) const;
+
+    /**
+     * @brief Redirects received packets into a device instead of memory
+     * @param device Seekable device to write chunks to, or nullptr to return
+     *        to in-memory reassembly (default)
+     * @param port Logical port whose packets are redirected (default: 0)
+     * @details While a device is set, each received chunk is written directly
+     *          at its offset in the device and is not kept in memory.
+     *          Consecutive packets are laid out back to back, starting at
+     *          offset 0. Completion is reported with packetReceivedToDevice()
+     *          instead of packetReceived().
+     *          Other ports keep reassembling in memory.
+     * @note The adapter does not take ownership of the device.
+     */
+    void setReceiveDevice(QIODevice *device, quint8 port = 0);
+
+    /**
+     * @brief Enables or disables chunk deduplication
+     * @param enabled True to enable deduplication (default: disabled)
+     * @details While enabled, every chunk sent and acknowledged or received is
+     *          stored in a bounded LoRaChunkCache. A chunk that is already in
+     *          the cache is sent as a DATA_REF frame carrying its
+     *          LoRaChunkCache::KEY_SIZE-byte key instead of the payload. If the
+     *          peer cannot resolve the key it answers with NACK and the chunk
+     *          is resent as a regular DATA frame.
+     *
+     *          DATA_REF frames are always understood on the receive side, but
+     *          only resolved when deduplication is enabled, so both ends should
+     *          enable it to benefit. References are only sent once the
+     *          handshake (see startHandshake()) showed that the peer announces
+     *          LoRaCapabilities::DEDUP, and toggling deduplication announces
+     *          the change to the peer.
+     *
+     *          Disabling deduplication clears the cache.
+     */
+    void setDedupEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether chunk deduplication is enabled
+     */
+    bool isDedupEnabled() const;
+
+    /**
+     * @brief Announces whether packets carry LoRaPubSub topic IDs
+     * @param enabled True if the owner tags every packet with a topic ID
+     * @details Packets are passed through untouched; the setting only adds
+     *          LoRaCapabilities::PUBSUB to localCapabilities() so that the
+     *          owner can check that the peer tags packets too. Changing it
+     *          after a completed handshake announces the change to the peer.
+     */
+    void setPubSubEnabled(bool enabled);
+
+    /**
+     * @brief Sets the number of chunks kept for deduplication
+     * @param capacity Maximum number of cached chunks
+     *        (default: LoRaChunkCache::DEFAULT_CAPACITY)
+     * @note Both ends should use the same capacity to keep cache misses rare.
+     */
+    void setChunkCacheCapacity(int capacity);
+
+    /**
+     * @brief Enables or disables link liveness monitoring
+     * @param enabled True to monitor the link (default: disabled)
+     * @details While enabled, a LoRaLinkMonitor watches incoming frames and
+     *          probes the peer with PING frames when the link is idle.
+     *          Chunk timeouts count as missed responses; once the monitor
+     *          declares the link down, retransmission stops and queued
+     *          packets are held back instead of burning retries. Sending
+     *          resumes with fresh retries when the peer is heard again.
+     *
+     *          PING is only sent once the handshake showed that the peer
+     *          answers it (LoRaCapabilities::LINK_PROBE); until then, only
+     *          chunk timeouts and incoming frames drive the monitor, and an
+     *          idle link stays up. Enabling is refused with error() after a
+     *          handshake without LINK_PROBE. PING is always answered with
+     *          PONG, whether or not monitoring is enabled locally.
+     * @note Emits linkUp() and linkDown() on link state changes
+     */
+    void setLinkMonitorEnabled(bool enabled);
+
+    /**
+     * @brief Sets the payload size of the chunks of subsequent packets
+     * @param bytes Chunk size, clamped to [1, FrameSize::MAX_PAYLOAD_SIZE]
+     *        (default: FrameSize::MAX_PAYLOAD_SIZE)
+     * @details Smaller chunks lose less airtime per lost frame on poor links.
+     *          The receiver needs no configuration: it derives the chunk size
+     *          from the frames it receives.
+     */
+    void setChunkSize(int bytes);
+
+    /**
+     * @brief Returns the payload size of outgoing chunks
+     */
+    int chunkSize() const;
+
+    /**
+     * @brief Returns the largest packet sendPacket() accepts with the current chunk size
+     * @details Takes the payload size announced by the peer into account.
+     */
+    int maxPacketSize() const;
+
+    /**
+     * @brief Sets how long an ACK may wait for reverse data to ride on
+     * @param ms Delayed-ACK window in milliseconds, 0 to always acknowledge
+     *        at once (default: DEFAULT_ACK_DELAY_MS)
+     * @details Only used once the handshake has confirmed that the peer
+     *          understands LoRaCapabilities::PIGGYBACK_ACK. A received chunk
+     *          is then not acknowledged right away: if this adapter sends a
+     *          chunk within the window, the ACK travels inside it as a
+     *          DATA_ACK frame, otherwise a standalone ACK is sent when the
+     *          window expires. With traffic in both directions this roughly
+     *          halves the number of frames.
+     *
+     *          ACKs are only delayed while this adapter is sending on the
+     *          chunk's port. Otherwise no reverse data is expected and the ACK
+     *          is sent at once. A pending ACK is always sent before the
+     *          PACKET_ACK of a completed packet, as the sender ignores a
+     *          PACKET_ACK that overtakes it. The window adds to the
+     *          peer's measured round-trip time, so it should stay well below
+     *          MIN_RTO_MS.
+     * @note A DATA_ACK frame is ACK_FIELD_SIZE bytes longer than
+     *       FrameSize::MAX_FRAME_SIZE.
+     */
+    void setAckDelay(int ms);
+
+    /**
+     * @brief Returns the delayed-ACK window in milliseconds
+     */
+    int ackDelay() const;
+
+    /**
+     * @brief Enables or disables online tuning of chunk size and delayed-ACK window
+     * @param enabled True to tune (default: disabled)
+     * @details A LoRaAutoTuner moves chunkSize() and ackDelay() within its
+     *          bounds, one step per epoch, towards the setting with the best
+     *          measured goodput, and keeps following the channel as it
+     *          changes. Tuning starts from the current values; calling
+     *          setChunkSize() or setAckDelay() while it runs restarts it from
+     *          the new ones. Disabling keeps the values reached so far.
+     *
+     *          A new chunk size applies to packets started afterwards, so
+     *          the tuner needs epochs long enough to span several packets
+     *          (see LoRaAutoTuner::setEpochDuration()).
+     */
+    void setAutoTuningEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether online tuning is enabled
+     */
+    bool isAutoTuningEnabled() const;
+
+    /**
+     * @brief Returns the auto-tuner
+     * @details Allows setting bounds and epoch duration.
+     */
+    LoRaAutoTuner *autoTuner();
+
+    /**
+     * @brief Enables or disables the event-loop stall watchdog
+     * @param enabled True to watch the adapter's thread (default: disabled)
+     * @details A LoRaStallWatchdog in the adapter's thread records every
+     *          time its event loop is blocked for more than the stall
+     *          threshold, with the adapter section that ran longest
+     *          (frame handling, a blocking write, a retransmission) and the
+     *          protocol state at the time. Enabling clears earlier records.
+     * @note Emits stallDetected() for each stall
+     */
+    void setStallWatchdogEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether the stall watchdog is enabled
+     */
+    bool isStallWatchdogEnabled() const;
+
+    /**
+     * @brief Returns the stall watchdog
+     * @details Allows tuning thresholds and reading the recorded stalls.
      */
-    void sendPacket(const QByteArray &data);
+    LoRaStallWatchdog *stallWatchdog();
+
+    /**
+     * @brief Enables or disables the recovery of frames from damaged copies
+     * @param enabled true to keep frames that fail their CRC and combine them
+     *        with later copies (see LoRaFrameRecovery)
+     * @details A chunk whose copies all arrive damaged can then be rebuilt
+     *          from two or three of them instead of being retransmitted until
+     *          one arrives intact. A rebuilt frame is only as trustworthy as
+     *          the 8-bit CRC and the header checks that accepted it; for
+     *          data that must never be wrong, check it end to end as well.
+     *          Off by default; disabling drops the kept frames.
+     */
+    void setFrameRecoveryEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether frame recovery is enabled
+     */
+    bool isFrameRecoveryEnabled() const;
+
+    /**
+     * @brief Returns the frame recovery, e.g. to change its candidate budget
+     */
+    LoRaFrameRecovery *frameRecovery();
+
+    /**
+     * @brief Offers a frame that failed its CRC to the recovery
+     * @param frame Damaged frame, e.g. heard by another dongle (see frameDamaged())
+     * @details Handles the rebuilt frame like a received one. Does nothing
+     *          while recovery is disabled.
+     */
+    void recoverFrame(const QByteArray &frame);
+
+    /**
+     * @brief Enables or disables the protected frame header
+     * @param enabled true to send and expect a check byte after each header
+     * @details Without it, the length byte is trusted before any check: a
+     *          bit error in it makes the parser cut the byte stream in the
+     *          wrong places, and the following frames are lost with it.
+     *          The check byte is the CRC-8 of the header. Over the 8 bytes of
+     *          header and check it corrects any single-bit error and detects
+     *          any two-bit error. A header that cannot be corrected costs
+     *          its frame only: the parser then searches the following bytes
+     *          for a header whose check and frame CRC both match, without
+     *          correcting, and continues from there.
+     *
+     *          Changes the frame format, so both ends must use the same
+     *          setting. Costs one byte per frame. Off by default; changing it
+     *          drops partly received bytes.
+     */
+    void setProtectedHeaderEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether the protected frame header is enabled
+     */
+    bool isProtectedHeaderEnabled() const;
+
+    /**
+     * @brief Sets the number of Reed-Solomon parity bytes sent with each frame
+     * @param bytes Parity bytes, 0-LoRaReedSolomon::MAX_PARITY_BYTES (0 = none)
+     * @details The parity covers the whole frame and corrects up to bytes / 2
+     *          damaged bytes, however many bits are wrong in each, before the
+     *          CRC is checked. A frame with a few damaged bytes is then
+     *          repaired instead of retransmitted. The CRC still rejects the
+     *          frames the code gets wrong with too many errors. The length
+     *          byte is needed before decoding, so a damaged length is left to
+     *          the protected header (see setProtectedHeaderEnabled()).
+     *
+     *          Changes the frame format, so both ends must use the same
+     *          setting. Costs that many bytes per frame, which may push a full frame
+     *          over the module's sub-packet size; a smaller chunk size avoids
+     *          that. Default 0; changing it drops partly received bytes.
+     */
+    void setFrameParity(int bytes);
+
+    /**
+     * @brief Returns the number of Reed-Solomon parity bytes per frame
+     */
+    int frameParity() const;
+
+    /**
+     * @brief Puts the adapter in hot standby or back in service
+     * @param standby true to discard received bytes instead of handling them
+     * @details A standby adapter keeps its device open, so it can take over
+     *          without reopening it, but stays silent on the channel: it must
+     *          not acknowledge the frames its active twin is handling.
+     *          Cleared by takeOver().
+     */
+    void setStandby(bool standby);
+
+    /**
+     * @brief Returns whether the adapter is in hot standby
+     */
+    bool isStandby() const;
+
+    /**
+     * @brief Sets whether received frames are handed out instead of handled
+     * @param forward true to emit every CRC-valid frame with frameHeard()
+     * @details Used for receive diversity, where LoRaAdapterGroup combines
+     *          the frames of several dongles and passes one copy of each to
+     *          receiveFrame() of the active adapter. Also applies in standby.
+     */
+    void setFrameForwarding(bool forward);
+
+    /**
+     * @brief Returns whether received frames are handed out
+     */
+    bool isFrameForwarding() const;
+
+    /**
+     * @brief Handles a frame as if it had been read from the serial device
+     * @param frame Complete frame, checked again for its CRC
+     * @details Entry point for frames heard by another dongle (see setFrameForwarding()).
+     */
+    void receiveFrame(const QByteArray &frame);
+
+    /**
+     * @brief Sets whether a failed write holds the packet instead of failing it
+     * @param hold true to treat a failed or timed-out write like a frame lost on the air
+     * @details With hold, the frame is retried after the retransmission
+     *          timeout, which gives a standby adapter time to take over
+     *          (see deviceFailed()). The packet still fails once the
+     *          retries are exhausted. Off by default.
+     */
+    void setHoldOnDeviceFailure(bool hold);
+
+    /**
+     * @brief Returns whether a failed write holds the packet
+     */
+    bool holdsOnDeviceFailure() const;
+
+    /**
+     * @brief Returns whether the serial device is open
+     */
+    bool isDeviceOpen() const;
+
+    /**
+     * @brief Continues the session of a failed adapter on this one
+     * @param failed Adapter whose device failed, talking to the same peer
+     * @details Moves everything the peer knows about this node from failed:
+     *          the packets in flight and queued on every port, the
+     *          reassembly state, the pending ACK, the handshake result, the
+     *          RTT estimate, the node ID and the tuned chunk size and ACK
+     *          delay. The frames in flight are resent at once rather than
+     *          after a timeout, so the peer sees no more than one RTO of
+     *          silence and transfers continue where they stopped.
+     *
+     *          failed is left idle and in standby, without reporting its
+     *          packets as failed. The chunk cache is not moved; the peer's
+     *          DATA_REF frames are answered with NACK until it refills.
+     */
+    void takeOver(LoRaUsbAdapter_E22_400T22U &failed);
+
+    /**
+     * @brief Returns the counters and current settings of the adapter
+     */
+    Metrics metrics() const;
+
+    /**
+     * @brief Clears the counters returned by metrics()
+     */
+    void resetMetrics();
+
+    /**
+     * @brief Returns the current retransmission timeout in milliseconds
+     * @details Computed from the smoothed round-trip time as in RFC 6298:
+     *          SRTT + 4 * RTTVAR, clamped to [MIN_RTO_MS, MAX_RTO_MS].
+     *          TIMEOUT_MS is used until the first sample is taken.
+     *          Only chunks acknowledged without retransmission are sampled
+     *          (Karn's algorithm), and each retry doubles the timeout.
+     */
+    int retransmitTimeout() const;
+
+    /**
+     * @brief Returns the link parameters learned so far
+     * @details Suitable for LoRaLinkProfileStore::setProfile(). Parameters the
+     *          adapter does not measure itself are passed through from the
+     *          last applyLinkProfile().
+     */
+    LoRaLinkProfile linkProfile() const;
+
+    /**
+     * @brief Starts from previously learned link parameters
+     * @param profile Profile, typically from LoRaLinkProfileStore::profile()
+     * @details Fields that are zero keep their current value.
+     */
+    void applyLinkProfile(const LoRaLinkProfile &profile);
+
+    /**
+     * @brief Sets the node identifier announced in HELLO
+     * @param id Node identifier (default: LoRaCapabilities::defaultNodeId())
+     * @details The peer uses it to recognise this node across restarts.
+     */
+    void setNodeId(quint32 id);
+
+    /**
+     * @brief Returns the node identifier announced in HELLO
+     */
+    quint32 nodeId() const;
+
+    /**
+     * @brief Returns the capabilities this node announces
+     * @details DEDUP is announced only while deduplication is enabled.
+     */
+    LoRaCapabilities localCapabilities() const;
+
+    /**
+     * @brief Negotiates capabilities with the peer
+     * @param cached Capabilities learned from this peer earlier, used until
+     *        the peer answers (default: none)
+     * @details Sends HELLO with localCapabilities() and waits for HELLO_ACK,
+     *          retrying HELLO_ATTEMPTS times. From this call on, optional
+     *          features are only used once the peer announced them:
+     *          - Until the answer arrives, cached is assumed, or legacy()
+     *            capabilities if cached is empty, so sending starts at once
+     *          - A peer that never answers is legacy: the original frame
+     *            format, no DATA_REF, and no PING (a running link monitor is
+     *            stopped, since the peer would never answer it)
+     *
+     *          A HELLO from the peer also completes the handshake, so a peer
+     *          that restarts re-negotiates by itself. Chunks larger than the
+     *          peer's maxPayload are never sent.
+     * @note Emits capabilitiesNegotiated() when the handshake completes
+     */
+    void startHandshake(const LoRaCapabilities &cached = {});
+
+    /**
+     * @brief Forgets the peer's capabilities
+     * @details Stops a handshake in progress and returns to the behavior
+     *          before startHandshake(): the peer is taken as legacy.
+     */
+    void resetHandshake();
+
+    /**
+     * @brief Returns whether the peer's capabilities are known
+     * @details True once the peer answered HELLO, sent its own HELLO, or
+     *          the handshake gave up and the peer is taken as legacy.
+     */
+    bool isHandshakeComplete() const;
+
+    /**
+     * @brief Returns whether a handshake was started and the peer has not answered yet
+     * @details Capabilities cached from an earlier session may be in effect
+     *          meanwhile, which the peer does not necessarily assume too.
+     */
+    bool isHandshakePending() const;
+
+    /**
+     * @brief Returns the capabilities announced by the peer
+     * @details Legacy capabilities if the peer did not answer HELLO.
+     */
+    LoRaCapabilities peerCapabilities() const;
+
+    /**
+     * @brief Returns the capabilities in effect on the link
+     * @details What both ends support (see LoRaCapabilities::negotiate()).
+     *          Legacy capabilities if no handshake was started: a peer that
+     *          was never asked is not sent any optional frame.
+     */
+    LoRaCapabilities negotiatedCapabilities() const;
+
+    /**
+     * @brief Sends an RPC request frame
+     * @param id Correlation ID, echoed in the reply
+     * @param service Service number on the peer (24 bits)
+     * @param payload Request payload (max FrameSize::MAX_PAYLOAD_SIZE bytes)
+     * @details The frame is not acknowledged; LoRaRpc resends it until the
+     *          reply arrives. It is independent of packet transmission and
+     *          may be sent while a packet is in flight.
+     */
+    void sendRpcRequest(quint16 id, quint32 service, const QByteArray &payload);
+
+    /**
+     * @brief Sends an RPC reply frame
+     * @param id Correlation ID of the request
+     * @param status Status code (see LoRaRpcReply::Status)
+     * @param payload Reply payload (max FrameSize::MAX_PAYLOAD_SIZE bytes)
+     */
+    void sendRpcReply(quint16 id, quint8 status, const QByteArray &payload);
+
+    /**
+     * @brief Returns the link monitor
+     * @details Allows reading the link state and tuning probe intervals.
+     */
+    LoRaLinkMonitor *linkMonitor();
 
 signals:
     /**
      * @brief Signal emitted when packet transmission completes
      * @param success True if packet was sent successfully, false otherwise
+     * @param port Logical port of the packet
      */
-    void packetSent(bool success);
+    void packetSent(bool success, quint8 port);
 
     /**
      * @brief Signal emitted when a complete packet is received
      * @param data The received packet data as a byte array
+     * @param port Logical port of the packet
      */
-    void packetReceived(const QByteArray &data);
+    void packetReceived(const QByteArray &data, quint8 port);
+
+    /**
+     * @brief Signal emitted when a complete packet has been written to the receive device
+     * @param size Size of the packet in bytes
+     * @param port Logical port of the packet
+     * @see setReceiveDevice()
+     */
+    void packetReceivedToDevice(qint64 size, quint8 port);
+
+    /**
+     * @brief Signal emitted when a packet completes with chunks the sender abandoned
+     * @param data Packet data at its full size, with abandoned chunks zero-filled
+     * @param present Bit per chunk, set for the chunks that arrived
+     * @param chunkSize Payload size of the chunks; chunk i starts at i * chunkSize
+     * @param port Logical port of the packet
+     * @details Emitted instead of packetReceived(). With a receive device,
+     *          packetReceivedToDevice() is emitted as usual and the abandoned
+     *          chunks are left unwritten.
+     * @see setPortLifetime()
+     */
+    void packetReceivedPartial(const QByteArray &data, const QBitArray &present, int chunkSize, quint8 port);
 
     /**
      * @brief Signal emitted when an error occurs
@@ -147,21 +880,90 @@ signals:
      * @brief Signal emitted during packet reception progress
      * @param receivedBytes Number of bytes received so far
      * @param totalBytes Total number of bytes expected
+     * @param port Logical port of the packet
      */
-    void packetProgress(int receivedBytes, int totalBytes);
+    void packetProgress(int receivedBytes, int totalBytes, quint8 port);
 
     /**
      * @brief Signal emitted during packet transmission progress
      * @param sentBytes Number of bytes sent so far
      * @param totalBytes Total number of bytes to send
+     * @param port Logical port of the packet
+     */
+    void packetSendProgress(int sentBytes, int totalBytes, quint8 port);
+
+    /**
+     * @brief Signal emitted when the monitored peer becomes reachable
+     * @see setLinkMonitorEnabled()
+     */
+    void linkUp();
+
+    /**
+     * @brief Signal emitted when the monitored peer stops responding
+     * @see setLinkMonitorEnabled()
+     */
+    void linkDown();
+
+    /**
+     * @brief Signal emitted when the handshake completes
+     * @details Read the result with peerCapabilities() and negotiatedCapabilities().
+     * @see startHandshake()
      */
-    void packetSendProgress(int sentBytes, int totalBytes);
+    void capabilitiesNegotiated();
+
+    /**
+     * @brief Signal emitted when an RPC request frame is received
+     * @param id Correlation ID
+     * @param service Service number
+     * @param payload Request payload
+     */
+    void rpcRequestReceived(quint16 id, quint32 service, const QByteArray &payload);
+
+    /**
+     * @brief Signal emitted when an RPC reply frame is received
+     * @param id Correlation ID
+     * @param status Status code
+     * @param payload Reply payload
+     */
+    void rpcReplyReceived(quint16 id, quint8 status, const QByteArray &payload);
+
+    /**
+     * @brief Signal emitted when the adapter's event loop was blocked
+     * @param durationMs How long the event loop was blocked
+     * @param section Adapter section that ran longest meanwhile, empty if none
+     * @param state Protocol state when the stall was detected
+     * @see setStallWatchdogEnabled()
+     */
+    void stallDetected(int durationMs, const QString &section, const QString &state);
+
+    /**
+     * @brief Signal emitted when a write to the serial device fails or times out
+     * @details A hint that the dongle is gone; LoRaAdapterGroup answers it
+     *          with a takeover. Emitted from inside the write, so receivers
+     *          should use a queued connection.
+     */
+    void deviceFailed();
+
+    /**
+     * @brief Signal emitted for every CRC-valid frame received while forwarding
+     * @param frame Complete frame
+     * @see setFrameForwarding()
+     */
+    void frameHeard(const QByteArray &frame);
+
+    /**
+     * @brief Signal emitted for every frame failing its CRC while forwarding
+     * @param frame Complete frame as received
+     * @see setFrameForwarding(), recoverFrame()
+     */
+    void frameDamaged(const QByteArray &frame);
 
 private slots:
     /**
      * @brief Slot called when data is available on the serial port
-     * @details Reads incoming data from the serial port, parses frames,
-     *          and handles them according to their type:
+     * @details Reads incoming data from the serial port, splits it into
+     *          frames and passes them to receiveFrame(), which handles them
+     *          according to their type:
      *          - DATA: Store chunk, send ACK, check for packet completion
      *          - ACK: Stop timer, send next chunk or complete transmission
      *          - PACKET_ACK: Complete transmission
@@ -172,12 +974,32 @@ private slots:
     void onReadyRead();
 
     /**
-     * @brief Slot called when send timeout occurs
-     * @details Handles timeout during chunk transmission by retrying
-     *          the current chunk. If maximum retries are exceeded,
-     *          aborts the transmission and emits an error.
+     * @brief Slot called when the link monitor reports the peer reachable
+     * @details On every port, resumes a paused transmission with fresh
+     *          retries, or starts the next queued packet.
+     */
+    void onLinkUp();
+
+    /**
+     * @brief Slot called when HELLO was not answered in time
+     * @details Resends HELLO, or takes the peer as legacy after HELLO_ATTEMPTS.
      */
-    void onSendTimeout();
+    void onHelloTimeout();
+
+    /**
+     * @brief Slot called when the delayed-ACK window expires
+     * @details Sends the pending ACK as a standalone frame.
+     */
+    void flushAck();
+
+    /**
+     * @brief Slot called when the retransmission timer of a port expires
+     * @param port Logical port
+     * @details Retries the frame in flight. If maximum retries are exceeded,
+     *          abandons the chunk when canAbandon(), otherwise aborts the
+     *          transmission and emits an error.
+     */
+    void onSendTimeout(quint8 port);
 
 private:
     /**
@@ -193,44 +1015,126 @@ private:
     };
 
     /**
-     * @brief Total number of bytes in the current packet being sent
+     * @brief Shared pointer to the QCrossPlatformSerialPort instance
+     * @details Used for all serial communication with the LoRa module.
      */
-    int m_totalPacketBytes = 0;
+    std::shared_ptr<QCrossPlatformSerialPort> m_serial;
 
     /**
-     * @brief Number of bytes successfully sent so far
+     * @brief Bytes read from the serial port that do not form a complete frame yet
      */
-    int m_sentBytes = 0;
+    QByteArray m_rxBuffer;
 
     /**
-     * @brief Shared pointer to the QCrossPlatformSerialPort instance
-     * @details Used for all serial communication with the LoRa module.
+     * @brief Link liveness monitor, running only when enabled
      */
-    std::shared_ptr<QCrossPlatformSerialPort> m_serial;
+    LoRaLinkMonitor m_linkMonitor;
+
+    /**
+     * @brief Online tuner of m_chunkSize and m_ackDelayMs, running only when enabled
+     */
+    LoRaAutoTuner m_autoTuner;
+
+    /**
+     * @brief Event-loop stall watchdog, running only when enabled
+     */
+    LoRaStallWatchdog m_stallWatchdog;
+
+    /**
+     * @brief Counters returned by metrics()
+     */
+    Metrics m_metrics;
+
+    /**
+     * @brief Chunk payload size for packets started from now on
+     */
+    int m_chunkSize = static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE);
+
+    /**
+     * @brief Smoothed round-trip time in milliseconds
+     */
+    double m_srttMs = 0.0;
+
+    /**
+     * @brief Round-trip time variation in milliseconds
+     */
+    double m_rttVarMs = 0.0;
+
+    /**
+     * @brief Number of RTT samples taken
+     */
+    quint32 m_rttSamples = 0;
+
+    /**
+     * @brief Current retransmission timeout in milliseconds, before backoff
+     */
+    int m_rtoMs = TIMEOUT_MS;
+
+    /**
+     * @brief Last applied profile, source of the parameters not measured here
+     */
+    LoRaLinkProfile m_appliedProfile;
+
+    /**
+     * @brief Node identifier announced in HELLO
+     */
+    quint32 m_nodeId = LoRaCapabilities::defaultNodeId();
+
+    /**
+     * @brief Capabilities announced by the peer, or assumed until it answers
+     */
+    LoRaCapabilities m_peerCaps;
+
+    /**
+     * @brief Whether startHandshake() was called since the last resetHandshake()
+     * @details Without it, the peer is taken as legacy and no optional feature is used.
+     */
+    bool m_handshakeStarted = false;
+
+    /**
+     * @brief Whether m_peerCaps holds the peer's answer (or the legacy fallback)
+     */
+    bool m_handshakeComplete = false;
+
+    /**
+     * @brief Number of HELLO frames sent in the current handshake
+     */
+    int m_helloAttempts = 0;
+
+    /**
+     * @brief Timer for resending HELLO
+     */
+    QTimer m_helloTimer;
 
     /**
-     * @brief Timer for detecting send timeouts
-     * @details Single-shot timer that triggers retransmission
-     *          when no ACK is received within TIMEOUT_MS.
+     * @brief Delayed-ACK window in milliseconds
      */
-    QTimer m_timer;
+    int m_ackDelayMs = DEFAULT_ACK_DELAY_MS;
 
     /**
-     * @brief List of chunks to be sent
-     * @details Stores all chunks of the current packet pending transmission.
+     * @brief Whether a received chunk waits to be acknowledged
      */
-    QList<Chunk> m_chunks;
+    bool m_ackPending = false;
 
     /**
-     * @brief Index of the currently transmitting chunk
-     * @details -1 indicates no transmission in progress.
+     * @brief Sequence number of the chunk waiting to be acknowledged
      */
-    int m_currentChunkIndex = -1;
+    quint16 m_pendingAckSeq = 0;
 
     /**
-     * @brief Current retry count for the chunk being sent
+     * @brief Total chunks of the packet of the chunk waiting to be acknowledged
      */
-    int m_retries = 0;
+    quint32 m_pendingAckTotal = 0;
+
+    /**
+     * @brief Logical port of the chunk waiting to be acknowledged
+     */
+    quint8 m_pendingAckPort = 0;
+
+    /**
+     * @brief Timer ending the delayed-ACK window
+     */
+    QTimer m_ackTimer;
 
     /**
      * @brief Maximum number of retry attempts per chunk
@@ -238,10 +1142,30 @@ private:
     static constexpr int MAX_RETRIES = 5;
 
     /**
-     * @brief Timeout in milliseconds for ACK reception
+     * @brief Timeout in milliseconds for ACK reception before any RTT was measured
      */
     static constexpr int TIMEOUT_MS = 1000;
 
+    /**
+     * @brief Lower bound of the adaptive retransmission timeout
+     */
+    static constexpr int MIN_RTO_MS = 200;
+
+    /**
+     * @brief Upper bound of the adaptive retransmission timeout, including backoff
+     */
+    static constexpr int MAX_RTO_MS = 16000;
+
+    /**
+     * @brief Default delayed-ACK window in milliseconds
+     */
+    static constexpr int DEFAULT_ACK_DELAY_MS = 50;
+
+    /**
+     * @brief Number of HELLO frames sent before the peer is taken as legacy
+     */
+    static constexpr int HELLO_ATTEMPTS = 3;
+
     /**
      * @brief Timeout in milliseconds for serial write operations
      */
@@ -265,15 +1189,124 @@ private:
     struct PacketReassembly {
         int total = 0;                      ///< Total number of chunks expected
         int receivedCount = 0;              ///< Number of chunks received so far
+        int receivedBytes = 0;              ///< Number of payload bytes received so far
         int expectedSize = -1;              ///< Expected total packet size (-1 if unknown)
-        QHash<quint16, QByteArray> chunks;   ///< Map of sequence number to chunk data
+        QBitArray received;                 ///< Bit per sequence number, set once the chunk arrived
+        QBitArray skipped;                  ///< Bit per sequence number, set once the sender abandoned the chunk
+        int skippedCount = 0;               ///< Number of chunks abandoned by the sender
+        QHash<quint16, QByteArray> chunks;   ///< Map of sequence number to chunk data (in-memory mode only)
+        QByteArray lastChunk;               ///< Payload of the final chunk, used to spot its retransmissions
+        int chunkStride = 0;                ///< Payload size of non-final chunks (0 until one arrives)
         bool packetAckSent = false;         ///< Whether PACKET_ACK has been sent
     };
 
     /**
-     * @brief Current packet reassembly state
+     * @struct OutgoingPacket
+     * @brief Packet waiting in the outbox of a port
+     */
+    struct OutgoingPacket {
+        QByteArray data;                    ///< Packet data
+        qint64 deadline = -1;               ///< m_clock time after which the packet is abandoned (-1: never)
+    };
+
+    /**
+     * @struct Port
+     * @brief Send and reassembly state of one logical port
      */
-    PacketReassembly m_recvState;
+    struct Port {
+        // Sender
+        QByteArray sendData;                ///< Packet being sent; chunks are cut on demand by chunkAt()
+        int totalChunks = 0;                ///< Number of chunks in the packet being sent
+        int chunkSize = static_cast<int>(FrameSize::MAX_PAYLOAD_SIZE); ///< Chunk payload size of the packet being sent
+        int currentChunkIndex = -1;         ///< Index of the chunk in flight (-1 when idle)
+        int retries = 0;                    ///< Retry count of the chunk in flight
+        int totalPacketBytes = 0;           ///< Size of the packet being sent
+        int sentBytes = 0;                  ///< Bytes of the packet acknowledged so far
+        bool sendFullChunk = false;         ///< Whether the peer answered a DATA_REF with NACK
+        qint64 deadline = -1;               ///< m_clock time after which the packet is abandoned (-1: never)
+        qint64 startedAt = 0;               ///< m_clock time the packet being sent was started
+        int skipCount = 0;                  ///< Chunks announced by the SKIP in flight (0: a chunk is in flight)
+        int abandonedChunks = 0;            ///< Chunks of the packet abandoned so far
+        QQueue<OutgoingPacket> outbox;      ///< Packets waiting for the current one to finish
+        Delivery delivery = Delivery::Unordered; ///< What a failed packet does to the queue
+        int lifetimeMs = 0;                 ///< Lifetime given to new packets (0: fully reliable)
+        QTimer timer;                       ///< Retransmission timer of the chunk in flight
+        QElapsedTimer rttClock;             ///< Time since the chunk in flight was sent
+
+        // Receiver
+        PacketReassembly recvState;         ///< Packet being reassembled
+        QTimer recvResetTimer;              ///< Clears recvState RECEIVE_STATE_RESET_DELAY_MS after completion,
+                                            ///< so retransmissions of the final chunk are still acknowledged
+        QIODevice *receiveDevice = nullptr; ///< Device receiving packet data, or nullptr for in-memory reassembly
+        qint64 receiveDeviceOffset = 0;     ///< Offset in receiveDevice where the current packet starts
+    };
+
+    /**
+     * @brief State of each logical port, indexed by port number
+     */
+    std::array<Port, MAX_PORTS> m_ports;
+
+    /**
+     * @brief Monotonic clock for packet deadlines, started at construction
+     */
+    QElapsedTimer m_clock;
+
+    /**
+     * @brief Cache of chunks known to both ends, used for deduplication
+     */
+    LoRaChunkCache m_chunkCache;
+
+    /**
+     * @brief Whether chunk deduplication is enabled
+     */
+    bool m_dedupEnabled = false;
+
+    /**
+     * @brief Whether LoRaCapabilities::PUBSUB is announced
+     */
+    bool m_pubSubEnabled = false;
+
+    /**
+     * @brief Whether received bytes are discarded (see setStandby())
+     */
+    bool m_standby = false;
+
+    /**
+     * @brief Whether received frames are emitted instead of handled (see setFrameForwarding())
+     */
+    bool m_forwardFrames = false;
+
+    /**
+     * @brief Damaged frames kept for recovery, used only when enabled
+     */
+    LoRaFrameRecovery m_frameRecovery;
+
+    /**
+     * @brief Whether frame recovery is enabled
+     */
+    bool m_frameRecoveryEnabled = false;
+
+    /**
+     * @brief Whether frames carry a header check byte (see setProtectedHeaderEnabled())
+     */
+    bool m_protectedHeader = false;
+
+    /**
+     * @brief Whether the receive buffer starts at a frame boundary
+     * @details Cleared when a protected header cannot be corrected; headers
+     *          are not corrected until a frame passes its CRC again.
+     */
+    bool m_rxSynced = true;
+
+    /**
+     * @brief Reed-Solomon code of the frame parity (see setFrameParity())
+     */
+    LoRaReedSolomon m_frameCode;
+
+    /**
+     * @brief Whether a failed write holds the packet (see setHoldOnDeviceFailure())
+     */
+    bool m_holdOnDeviceFailure = false;
 
     /**
      * @brief Creates a protocol frame with the given parameters
@@ -281,10 +1314,12 @@ private:
      * @param seq Sequence number of the chunk (FrameSize::SEQ_SIZE bytes, little-endian)
      * @param total Total number of chunks in the packet (FrameSize::TOTAL_SIZE bytes, little-endian)
      * @param payload Optional payload data (max FrameSize::MAX_PAYLOAD_SIZE bytes)
+     * @param port Logical port, merged into the Type byte if isPortFrameType(type) (default: 0)
      * @return Complete frame with CRC-8 checksum appended
      * @details Frame format: [Type(FrameSize::TYPE_SIZE)][Seq(FrameSize::SEQ_SIZE)][Total(FrameSize::TOTAL_SIZE)][Len(FrameSize::LEN_SIZE)][Payload...][CRC(FrameSize::CRC_SIZE)]
      */
-    QByteArray makeFrame(FrameType type, quint16 seq, quint32 total, const QByteArray &payload = {});
+    QByteArray makeFrame(FrameType type, quint16 seq, quint32 total, const QByteArray &payload = {},
+                         quint8 port = 0);
 
     /**
      * @brief Parses a raw frame into its components
@@ -293,11 +1328,13 @@ private:
      * @param seq Output parameter for the sequence number (FrameSize::SEQ_SIZE bytes, little-endian)
      * @param total Output parameter for the total chunks (FrameSize::TOTAL_SIZE bytes, little-endian)
      * @param payload Output parameter for the payload data
+     * @param port Output parameter for the logical port (see splitTypeByte())
      * @return true if frame was parsed successfully, false otherwise
      * @details Validates frame length and CRC-8 checksum.
      *          Returns false if frame is malformed or CRC mismatch.
      */
-    bool parseFrame(const QByteArray &raw, FrameType &type, quint16 &seq, quint32 &total, QByteArray &payload);
+    bool parseFrame(const QByteArray &raw, FrameType &type, quint16 &seq, quint32 &total, QByteArray &payload,
+                    quint8 &port);
 
     /**
      * @brief Calculates CRC-8 checksum for data
@@ -308,26 +1345,241 @@ private:
      */
     static quint8 crc8(const QByteArray &data);
 
+    /**
+     * @brief Checks a frame rebuilt by the recovery
+     * @param frame Candidate frame
+     * @return true if its length and CRC match, its type is known and, for
+     *         frames of the packet path, its sequence number is below its total
+     */
+    static bool isPlausibleFrame(const QByteArray &frame);
+
+    /**
+     * @brief Takes the next complete frame from the receive buffer
+     * @param frame Output: the frame, without a header check byte
+     * @return false if the buffer does not hold a complete frame yet
+     * @details With a protected header, also corrects the header and skips
+     *          bytes until the framing is found again (see setProtectedHeaderEnabled()).
+     */
+    bool takeFrame(QByteArray &frame);
+
+    /**
+     * @brief Corrects a received frame with its Reed-Solomon parity
+     * @param frame Frame without header check byte, corrected in place
+     * @param parity Parity bytes received after the frame (none without frame parity)
+     * @details Leaves the frame as received if it cannot be corrected or if
+     *          the correction would change its length byte.
+     */
+    void correctFrame(QByteArray &frame, const QByteArray &parity);
+
+    /**
+     * @brief Cuts the chunk at the specified index from a port's send buffer
+     * @param port Logical port
+     * @param index Index of the chunk (0-based)
+     * @return Chunk with its sequence information and payload
+     */
+    Chunk chunkAt(quint8 port, int index) const;
+
+    /**
+     * @brief Waits until the serial port reports the last write as flushed
+     * @param timeoutMs Maximum time to wait in milliseconds
+     * @return true if bytesWritten arrived in time, false on timeout
+     * @details Simulates a blocking waitForBytesWritten with a local QEventLoop.
+     */
+    bool waitForBytesWritten(int timeoutMs);
+
+    /**
+     * @brief Writes a frame to the serial port
+     * @param frame Frame built by makeFrame()
+     * @return frame.size() once the whole frame is written, or -1 on error
+     * @details Single exit point of every frame, for the frame_out tracepoint.
+     *          Inserts the header check byte of a protected header.
+     */
+    qint64 writeFrame(const QByteArray &frame);
+
     /**
      * @brief Sends a chunk at the specified index
-     * @param index Index of the chunk to send in m_chunks
+     * @param port Logical port
+     * @param index Index of the chunk to send (see chunkAt())
      * @details Creates a frame from the chunk and writes it to the serial port.
      *          Starts the timeout timer after successful write.
      * @note Emits error() if frame is too large or write fails
      */
-    void sendChunk(int index);
+    void sendChunk(quint8 port, int index);
+
+    /**
+     * @brief Abandons chunks of the packet being sent on a port
+     * @param port Logical port
+     * @param count Number of chunks from the current one on
+     * @details Writes a SKIP frame and waits for its ACK like for a chunk.
+     *          Also used to retransmit the SKIP in flight.
+     */
+    void sendSkip(quint8 port, int count);
+
+    /**
+     * @brief Resends the frame in flight on a port, chunk or SKIP
+     * @param port Logical port
+     */
+    void resendCurrent(quint8 port);
+
+    /**
+     * @brief Writes a frame of the packet being sent and starts its retransmission timer
+     * @param port Logical port
+     * @param frame Frame to write
+     * @note Fails the packet if the write fails
+     */
+    void transmit(quint8 port, const QByteArray &frame);
+
+    /**
+     * @brief Sends a probe for the link monitor
+     * @return true if a PING frame was written; false if the port is closed
+     *         or the peer is not known to answer PING
+     */
+    bool sendProbe();
+
+    /**
+     * @brief Returns whether chunks of the packet being sent on a port may be abandoned
+     * @param port Logical port
+     * @details True if the packet has a lifetime and the peer understands SKIP.
+     */
+    bool canAbandon(quint8 port) const;
+
+    /**
+     * @brief Describes the protocol state for a stall record
+     * @return Link and handshake state, RTO, pending ACK, and the ports
+     *         with a packet in flight or in reassembly
+     */
+    QString protocolState() const;
+
+    /**
+     * @brief Updates the RTT estimate and retransmission timeout
+     * @param rttMs Measured round-trip time in milliseconds
+     */
+    void addRttSample(qint64 rttMs);
+
+    /**
+     * @brief Returns the payload size of the chunks of the next packet
+     * @details chunkSize(), limited to what the peer accepts.
+     */
+    int sendChunkSize() const;
+
+    /**
+     * @brief Writes a received chunk at its offset in the receive device
+     * @param port Logical port
+     * @param seq Sequence number of the chunk
+     * @param payload Chunk payload
+     * @details The offset depends on the chunk stride; a final chunk that
+     *          arrives before the stride is known is held back until it is.
+     */
+    void writeToReceiveDevice(quint8 port, quint16 seq, const QByteArray &payload);
+
+    /**
+     * @brief Writes a HELLO frame announcing localCapabilities()
+     * @details Starts m_helloTimer with the current retransmission timeout.
+     */
+    void sendHello();
+
+    /**
+     * @brief Records the peer's capabilities and completes the handshake
+     * @param peer Capabilities announced by the peer, or legacy()
+     * @note Emits capabilitiesNegotiated()
+     */
+    void completeHandshake(const LoRaCapabilities &peer);
+
+    /**
+     * @brief Acknowledges a received chunk, at once or within the delayed-ACK window
+     * @param port Logical port of the chunk
+     * @param seq Sequence number of the chunk
+     * @param total Total number of chunks in its packet
+     * @details Delays the ACK only when DATA_ACK is negotiated and reverse
+     *          data is likely (see setAckDelay()). A pending ACK for another
+     *          chunk is flushed first. The ACK only rides on a chunk of the
+     *          same port.
+     */
+    void queueAck(quint8 port, quint16 seq, quint32 total);
+
+    /**
+     * @brief Handles the acknowledgment of the chunk being sent on a port
+     * @param port Logical port
+     * @param seq Acknowledged sequence number, from ACK or DATA_ACK
+     * @details Takes an RTT sample and sends the next chunk, or completes the
+     *          packet after the final one.
+     */
+    void handleAck(quint8 port, quint16 seq);
+
+    /**
+     * @brief Handles a received data chunk
+     * @param port Logical port
+     * @param seq Sequence number of the chunk
+     * @param total Total number of chunks in the packet
+     * @param payload Chunk payload, already resolved for DATA_REF frames
+     * @details Stores the chunk, acknowledges it (see queueAck()) and
+     *          completes the packet once all chunks have arrived.
+     */
+    void handleDataChunk(quint8 port, quint16 seq, quint32 total, const QByteArray &payload);
+
+    /**
+     * @brief Handles a received SKIP frame
+     * @param port Logical port
+     * @param seq First abandoned chunk
+     * @param total Total number of chunks in the packet
+     * @param payload SKIP payload (see FrameType::SKIP)
+     * @details Marks the abandoned chunks that have not arrived, acknowledges
+     *          the frame and completes the packet if nothing else is missing.
+     */
+    void handleSkip(quint8 port, quint16 seq, quint32 total, const QByteArray &payload);
+
+    /**
+     * @brief Prepares a port for the chunks of a packet
+     * @param port Logical port
+     * @param total Total number of chunks in the packet
+     * @details Starts a new reassembly unless one for the same packet size is in progress.
+     */
+    void beginReassembly(quint8 port, quint32 total);
+
+    /**
+     * @brief Delivers the packet reassembled on a port
+     * @param port Logical port
+     * @details Sends the pending ACK, then PACKET_ACK, and emits packetReceived(),
+     *          packetReceivedPartial() or packetReceivedToDevice().
+     */
+    void completeReassembly(quint8 port);
+
+    /**
+     * @brief Starts transmitting a packet
+     * @param port Logical port
+     * @param packet Packet data, already validated, and its deadline
+     */
+    void startPacket(quint8 port, const OutgoingPacket &packet);
+
+    /**
+     * @brief Starts the next queued packet if the port is idle and the link is up
+     * @param port Logical port
+     * @details Queued packets whose deadline has passed are dropped.
+     */
+    void startNextPacket(quint8 port);
+
+    /**
+     * @brief Ends the current transmission and moves on to the next queued packet
+     * @param port Logical port
+     * @param success Result reported through packetSent()
+     * @details On a Delivery::Ordered port, a failure also fails the queued
+     *          packets, unless it is only due to abandoned chunks.
+     */
+    void finishPacket(quint8 port, bool success);
 
     /**
-     * @brief Resets the send state to idle
-     * @details Clears chunks, resets indices and counters, and stops the timer.
+     * @brief Resets the send state of a port to idle
+     * @param port Logical port
+     * @details Releases the send buffer, resets indices and counters, and stops the timer.
      *          Called after transmission completes or fails.
      */
-    void resetSendState();
+    void resetSendState(quint8 port);
 
     /**
-     * @brief Resets the receive state to idle
+     * @brief Resets the receive state of a port to idle
+     * @param port Logical port
      * @details Clears all reassembly state including chunks and counters.
      *          Called after packet reception completes or on error.
      */
-    void resetReceiveState();
+    void resetReceiveState(quint8 port);
 };
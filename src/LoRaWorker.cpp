@@ -1,13 +1,58 @@
 #include "LoRaWorker.hpp"
+#include <QThread>
 
 LoRaWorker::LoRaWorker(QObject *parent) :
     QObject(parent)
     , m_serial { new QCrossPlatformSerialPort(this) }
     , m_transport { new LoRaUsbAdapter_E22_400T22U(m_serial, this) }
+    , m_payloadPipeline { this }
 {
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetSent,
+            this, &LoRaWorker::onPacketSent);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetReceived,
+            this, &LoRaWorker::onPacketReceived);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetReceivedPartial,
+            this, &LoRaWorker::onPacketReceivedPartial);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetProgress,
+            this, &LoRaWorker::onPacketReceiveProgress);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetSendProgress,
+            this, &LoRaWorker::onPacketSendProgress);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetReceivedToDevice,
+            this, &LoRaWorker::onPacketReceivedToDevice);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::error,
+            this, &LoRaWorker::errorOccurred);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::linkUp,
+            this, &LoRaWorker::linkUp);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::linkDown,
+            this, &LoRaWorker::linkDown);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::stallDetected,
+            this, &LoRaWorker::stallDetected);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::capabilitiesNegotiated,
+            this, &LoRaWorker::onCapabilitiesNegotiated);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::rpcRequestReceived,
+            &m_rpc, &LoRaRpc::requestReceived);
+    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::rpcReplyReceived,
+            &m_rpc, &LoRaRpc::replyReceived);
+    connect(&m_rpc, &LoRaRpc::sendRequest,
+            m_transport.get(), &LoRaUsbAdapter_E22_400T22U::sendRpcRequest);
+    connect(&m_rpc, &LoRaRpc::sendReply,
+            m_transport.get(), &LoRaUsbAdapter_E22_400T22U::sendRpcReply);
+    connect(&m_pubSub, &LoRaPubSub::sendPacket,
+            this, &LoRaWorker::onPubSubPacket);
+    connect(&m_pubSub, &LoRaPubSub::plainPacketReceived,
+            this, &LoRaWorker::onPlainPacketReceived);
+    connect(&m_pubSub, &LoRaPubSub::error,
+            this, &LoRaWorker::errorOccurred);
+    connect(&m_payloadPipeline, &LoRaPayloadPipeline::encoded,
+            this, &LoRaWorker::onPayloadEncoded);
+    connect(&m_payloadPipeline, &LoRaPayloadPipeline::decoded,
+            this, &LoRaWorker::onPayloadDecoded);
+    connect(&m_payloadPipeline, &LoRaPayloadPipeline::error,
+            this, &LoRaWorker::errorOccurred);
 }
 
 LoRaWorker::~LoRaWorker() {
+    cancelFileTransfer();
     closePort();
 }
 
@@ -37,31 +82,570 @@ void LoRaWorker::openPort(const QString &portName, qint32 baud) {
         return;
     }
 
-
-    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetSent,
-            this, &LoRaWorker::packetSent);
-    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetReceived,
-            this, &LoRaWorker::packetReceived);
-    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetProgress,
-            this, &LoRaWorker::packetReceiveProgress);
-    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::packetSendProgress,
-            this, &LoRaWorker::packetSendProgress);
-    connect(m_transport.get(), &LoRaUsbAdapter_E22_400T22U::error,
-            this, &LoRaWorker::errorOccurred);
+    m_portName = portName;
+    m_peerId = portName;
+    LoRaLinkProfile profile;
+    if (!m_profileStore.path().isEmpty()) {
+        if (!m_profileStore.load()) {
+            emit errorOccurred("Failed to load link profiles");
+        }
+        profile = m_profileStore.profile(m_peerId);
+        if (profile.isValid()) {
+            m_transport->applyLinkProfile(profile);
+        }
+    }
+    if (m_negotiationEnabled) {
+        m_transport->startHandshake(profile.peerCapabilities);
+    }
 
     emit portOpened(true);
 }
 
+void LoRaWorker::setDedupEnabled(bool enabled) {
+    m_transport->setDedupEnabled(enabled);
+}
+
+void LoRaWorker::setLinkMonitorEnabled(bool enabled) {
+    m_transport->setLinkMonitorEnabled(enabled);
+}
+
+void LoRaWorker::setAutoTuningEnabled(bool enabled) {
+    m_transport->setAutoTuningEnabled(enabled);
+}
+
+void LoRaWorker::setFrameRecoveryEnabled(bool enabled) {
+    m_transport->setFrameRecoveryEnabled(enabled);
+}
+
+void LoRaWorker::setProtectedHeaderEnabled(bool enabled) {
+    m_transport->setProtectedHeaderEnabled(enabled);
+}
+
+void LoRaWorker::setFrameParity(int bytes) {
+    m_transport->setFrameParity(bytes);
+}
+
+LoRaUsbAdapter_E22_400T22U::Metrics LoRaWorker::metrics() const {
+    return m_transport->metrics();
+}
+
+void LoRaWorker::setRealtimeSettings(const LoRaRealtime::Settings &settings) {
+    QString error;
+    if (!LoRaRealtime::applyToCurrentThread(settings, error)) {
+        emit errorOccurred(QString("Real-time settings: %1").arg(error));
+    }
+
+    // Payload stages run at normal priority, away from the CPUs of this thread
+    LoRaRealtime::Settings stageSettings;
+    if (!settings.cpus.isEmpty()) {
+        for (int cpu = 0; cpu < QThread::idealThreadCount(); ++cpu) {
+            if (!settings.cpus.contains(cpu)) {
+                stageSettings.cpus.append(cpu);
+            }
+        }
+    }
+    m_payloadPipeline.setThreadSettings(stageSettings);
+}
+
+void LoRaWorker::setPayloadThreads(int threads) {
+    m_payloadPipeline.setMaxThreads(threads);
+}
+
+void LoRaWorker::setPayloadQueueLimit(int packets) {
+    m_payloadPipeline.setMaxPendingEncodes(packets);
+}
+
+void LoRaWorker::setPayloadStages(LoRaPayloadPipeline::Stage encode, LoRaPayloadPipeline::Stage decode) {
+    m_payloadPipeline.setEncodeStage(std::move(encode));
+    m_payloadPipeline.setDecodeStage(std::move(decode));
+}
+
+void LoRaWorker::setStallWatchdogEnabled(bool enabled) {
+    m_transport->setStallWatchdogEnabled(enabled);
+}
+
+LoRaRealtime::LatencyStats LoRaWorker::measureWakeupLatency(int samples, int intervalUs) {
+    return LoRaRealtime::measureWakeupLatency(samples, intervalUs);
+}
+
+void LoRaWorker::setLinkProfilePath(const QString &path) {
+    m_profileStore.setPath(path);
+}
+
+void LoRaWorker::setCapabilityNegotiationEnabled(bool enabled) {
+    m_negotiationEnabled = enabled;
+}
+
+void LoRaWorker::setNodeId(quint32 id) {
+    m_transport->setNodeId(id);
+}
+
+QFuture<LoRaRpcReply> LoRaWorker::call(quint32 service, const QByteArray &request, int timeoutMs) {
+    const bool connected = m_serial && m_serial->isOpen();
+    const bool supported = m_transport->negotiatedCapabilities().has(LoRaCapabilities::RPC);
+    if (!connected || !supported) {
+        QPromise<LoRaRpcReply> promise;
+        promise.start();
+        promise.addResult({LoRaRpcReply::NotConnected, {}});
+        promise.finish();
+        return promise.future();
+    }
+
+    m_rpc.setRetransmitInterval(m_transport->retransmitTimeout());
+    return m_rpc.call(service, request, timeoutMs);
+}
+
+void LoRaWorker::setRpcHandler(quint32 service, LoRaRpc::Handler handler, bool atMostOnce) {
+    m_rpc.setHandler(service, std::move(handler), atMostOnce);
+}
+
+void LoRaWorker::subscribe(const QString &topic, QObject *context, LoRaPubSub::Callback callback) {
+    m_pubSub.subscribe(topic, context, std::move(callback));
+}
+
+void LoRaWorker::unsubscribe(const QString &topic, QObject *context) {
+    m_pubSub.unsubscribe(topic, context);
+}
+
+void LoRaWorker::setPubSubEnabled(bool enabled) {
+    m_pubSubEnabled = enabled;
+    m_pubSub.resetPeer();
+    m_transport->setPubSubEnabled(enabled);
+}
+
+void LoRaWorker::publish(const QString &topic, const QByteArray &data) {
+    if (!m_pubSubEnabled) {
+        emit errorOccurred("Pub/sub not enabled");
+        return;
+    }
+    if (!m_pubSub.publish(topic, data)) {
+        emit errorOccurred("Too many topics");
+    }
+}
+
+void LoRaWorker::onPubSubPacket(const QByteArray &packet) {
+    sendTransportPacket(packet, PacketKind::PubSub);
+}
+
+void LoRaWorker::onPacketReceived(const QByteArray &data, quint8 port) {
+    if (port == DEFAULT_PORT && m_pubSubEnabled) {
+        m_pubSub.packetReceived(data);
+    } else {
+        // File segments arriving without receiveToFile() are plain packets,
+        // delivered without the decode stage
+        receivePayload(port, data);
+    }
+}
+
+void LoRaWorker::onPlainPacketReceived(const QByteArray &data) {
+    receivePayload(DEFAULT_PORT, data);
+}
+
+void LoRaWorker::receivePayload(quint8 port, const QByteArray &data) {
+    // Packets still in the stage must not be overtaken after it is removed.
+    // File segments were never encoded, so they are never decoded.
+    if (!hasPayloadStages(port) ||
+        (!m_payloadPipeline.hasDecodeStage() && m_payloadPipeline.pendingDecodes() == 0)) {
+        deliverPayload(port, data);
+        return;
+    }
+
+    m_payloadPipeline.decode(port, data);
+}
+
+void LoRaWorker::onPayloadDecoded(quint8 port, const QByteArray &data, bool ok) {
+    if (!ok) {
+        emit errorOccurred("Payload decoding failed");
+        return;
+    }
+
+    deliverPayload(port, data);
+}
+
+void LoRaWorker::deliverPayload(quint8 port, const QByteArray &data) {
+    if (port >= FIRST_USER_PORT) {
+        emit portPacketReceived(port, data);
+    } else {
+        emit packetReceived(data);
+    }
+}
+
+void LoRaWorker::onPacketReceivedPartial(const QByteArray &data, const QBitArray &present, int chunkSize,
+                                         quint8 port) {
+    if (port >= FIRST_USER_PORT) {
+        emit portPacketReceivedPartial(port, data, present, chunkSize);
+    } else {
+        emit errorOccurred("Incomplete packet dropped");
+    }
+}
+
+void LoRaWorker::sendTransportPacket(const QByteArray &data, PacketKind kind, quint8 port) {
+    // Queued first: the transport may report failure before returning
+    m_sentKinds[port].enqueue(kind);
+    m_transport->sendPacket(data, port);
+}
+
+void LoRaWorker::onCapabilitiesNegotiated() {
+    const LoRaCapabilities peer = m_transport->peerCapabilities();
+    const LoRaCapabilities negotiated = m_transport->negotiatedCapabilities();
+    emit capabilitiesNegotiated(peer.nodeId, negotiated.features);
+    // The peer may have restarted and forgotten our topic IDs
+    m_pubSub.resetPeer();
+    if (m_pubSubEnabled && !negotiated.has(LoRaCapabilities::PUBSUB)) {
+        emit errorOccurred("Peer does not use pub/sub");
+    }
+    startWaitingFileTransfers();
+    if (peer.nodeId == 0 || m_peerId.isEmpty()) return;
+
+    const QString nodePeerId = QString("node:%1").arg(peer.nodeId, 8, 16, QChar('0'));
+    if (nodePeerId == m_peerId) return;
+
+    m_peerId = nodePeerId;
+    if (!m_profileStore.path().isEmpty()) {
+        const LoRaLinkProfile profile = m_profileStore.profile(m_peerId);
+        // Whatever was assumed for the port belongs to another peer; this
+        // peer's own history is the better estimate
+        if (profile.isValid()) {
+            m_transport->applyLinkProfile(profile);
+        }
+    }
+}
+
+void LoRaWorker::saveLinkProfile() {
+    if (m_peerId.isEmpty() || m_profileStore.path().isEmpty()) return;
+
+    const LoRaLinkProfile profile = m_transport->linkProfile();
+    if (profile.isValid()) {
+        m_profileStore.setProfile(m_peerId, profile);
+        if (m_portName != m_peerId) {
+            // Warm start for whoever is on this port next time
+            m_profileStore.setProfile(m_portName, profile);
+        }
+        if (!m_profileStore.save()) {
+            emit errorOccurred("Failed to save link profiles");
+        }
+    }
+    m_peerId.clear();
+}
+
 void LoRaWorker::closePort() {
+    saveLinkProfile();
+    m_portName.clear();
+    m_rpc.cancelAll();
+    m_pubSub.resetPeer();
+    if (m_transport) {
+        m_transport->resetHandshake();
+    }
+
     if (m_serial) {
         m_serial->close();
     }
+    // Without a handshake the file port is known; a send fails on the closed port
+    startWaitingFileTransfers();
 }
 
 void LoRaWorker::sendPacket(const QByteArray &data) {
+    if (m_sendFile && !m_sendFileWaiting && m_sendFilePort == DEFAULT_PORT) {
+        // Without ports the receiver would write this packet into the file
+        emit errorOccurred("File transfer in progress");
+        return;
+    }
+
     if (m_transport) {
-        m_transport->sendPacket(data);
+        sendPayload(data, PacketKind::User, DEFAULT_PORT);
     } else {
         emit errorOccurred("Transport not ready");
     }
 }
+
+void LoRaWorker::sendPortPacket(quint8 port, const QByteArray &data) {
+    if (port < FIRST_USER_PORT || port >= LoRaUsbAdapter_E22_400T22U::MAX_PORTS) {
+        emit errorOccurred("Invalid port");
+        emit portPacketSent(port, false);
+        return;
+    }
+
+    sendPayload(data, PacketKind::PortUser, port);
+}
+
+void LoRaWorker::sendPayload(const QByteArray &data, PacketKind kind, quint8 port) {
+    QQueue<PacketKind> &encoding = m_encodingKinds[port];
+    // Packets still in the stage must not be overtaken after it is removed.
+    // The receiver would not decode data sharing its port with files.
+    if (!hasPayloadStages(port) || (!m_payloadPipeline.hasEncodeStage() && encoding.isEmpty())) {
+        sendEncodedPayload(data, kind, port);
+        return;
+    }
+
+    if (!m_payloadPipeline.encode(port, data)) {
+        emit errorOccurred("Payload queue full");
+        reportSendFailed(kind, port);
+        return;
+    }
+    encoding.enqueue(kind);
+}
+
+void LoRaWorker::onPayloadEncoded(quint8 port, const QByteArray &data, bool ok) {
+    QQueue<PacketKind> &encoding = m_encodingKinds[port];
+    const PacketKind kind = encoding.isEmpty() ? PacketKind::User : encoding.dequeue();
+    if (!ok) {
+        emit errorOccurred("Payload encoding failed");
+        reportSendFailed(kind, port);
+        return;
+    }
+
+    sendEncodedPayload(data, kind, port);
+}
+
+void LoRaWorker::sendEncodedPayload(const QByteArray &data, PacketKind kind, quint8 port) {
+    if (kind == PacketKind::User) {
+        sendTransportPacket(m_pubSubEnabled ? LoRaPubSub::wrapPlain(data) : data, kind);
+    } else {
+        sendTransportPacket(data, kind, port);
+    }
+}
+
+void LoRaWorker::reportSendFailed(PacketKind kind, quint8 port) {
+    if (kind == PacketKind::User) {
+        emit packetSent(false);
+    } else {
+        emit portPacketSent(port, false);
+    }
+}
+
+void LoRaWorker::setPortDelivery(quint8 port, LoRaUsbAdapter_E22_400T22U::Delivery delivery) {
+    m_transport->setPortDelivery(port, delivery);
+}
+
+void LoRaWorker::setPortLifetime(quint8 port, int ms) {
+    if (port < FIRST_USER_PORT || port >= LoRaUsbAdapter_E22_400T22U::MAX_PORTS) {
+        emit errorOccurred("Invalid port");
+        return;
+    }
+
+    m_transport->setPortLifetime(port, ms);
+}
+
+bool LoRaWorker::hasPayloadStages(quint8 port) const {
+    return port >= FIRST_USER_PORT || (port == DEFAULT_PORT && filePort() != DEFAULT_PORT);
+}
+
+quint8 LoRaWorker::filePort() const {
+    // Same decision on both ends, as long as both negotiate or neither does.
+    // Capabilities cached while the handshake is pending are not assumed by
+    // the peer, so they do not count.
+    return m_transport->isHandshakeComplete() &&
+           m_transport->negotiatedCapabilities().has(LoRaCapabilities::PORTS) ? FILE_PORT : DEFAULT_PORT;
+}
+
+void LoRaWorker::sendFile(const QString &path) {
+    if (!m_transport) {
+        emit errorOccurred("Transport not ready");
+        return;
+    }
+    if (m_sendFile) {
+        emit errorOccurred("File transfer already in progress");
+        return;
+    }
+    // The file port is only known once the handshake completes
+    const bool waiting = m_transport->isHandshakePending();
+    if (!waiting && m_transport->isSending(filePort())) {
+        emit errorOccurred("Transport busy");
+        return;
+    }
+
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        emit errorOccurred(QString("Failed to open file: %1").arg(file->errorString()));
+        return;
+    }
+
+    m_sendFile = std::move(file);
+    m_sendFileWaiting = waiting;
+    if (!waiting) {
+        startFileSend();
+    }
+}
+
+void LoRaWorker::startFileSend() {
+    m_sendFileWaiting = false;
+    m_sendFilePort = filePort();
+    m_sendFileOffset = 0;
+    m_sendSegmentSize = 0;
+    sendNextFileSegment();
+}
+
+void LoRaWorker::sendNextFileSegment() {
+    if (m_sendMap) {
+        m_sendFile->unmap(m_sendMap);
+        m_sendMap = nullptr;
+    }
+    m_sendFileOffset += m_sendSegmentSize;
+
+    const qint64 fileSize = m_sendFile->size();
+    if (m_sendFileOffset >= fileSize) {
+        emit fileSendProgress(fileSize, fileSize);
+        finishFileSend(true);
+        return;
+    }
+
+    m_sendSegmentSize = qMin<qint64>(m_transport->maxPacketSize(), fileSize - m_sendFileOffset);
+    m_sendMap = m_sendFile->map(m_sendFileOffset, m_sendSegmentSize);
+    if (!m_sendMap) {
+        emit errorOccurred(QString("Failed to map file: %1").arg(m_sendFile->errorString()));
+        finishFileSend(false);
+        return;
+    }
+
+    // The transport cuts chunks lazily from this view, so nothing is copied
+    sendTransportPacket(QByteArray::fromRawData(reinterpret_cast<const char *>(m_sendMap),
+                                                static_cast<int>(m_sendSegmentSize)),
+                        PacketKind::FileSegment, m_sendFilePort);
+}
+
+void LoRaWorker::finishFileSend(bool success) {
+    if (!m_sendFile) return;
+
+    if (m_sendMap) {
+        m_sendFile->unmap(m_sendMap);
+        m_sendMap = nullptr;
+    }
+    m_sendFile.reset();
+    m_sendFileWaiting = false;
+    m_sendFileOffset = 0;
+    m_sendSegmentSize = 0;
+    emit fileSent(success);
+}
+
+void LoRaWorker::receiveToFile(const QString &path, qint64 expectedSize) {
+    if (!m_transport) {
+        emit errorOccurred("Transport not ready");
+        return;
+    }
+
+    finishFileReceive();
+
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        emit errorOccurred(QString("Failed to open file: %1").arg(file->errorString()));
+        return;
+    }
+
+    m_recvFileWritten = 0;
+    m_recvFileExpected = expectedSize;
+    if (expectedSize <= 0) {
+        file->close();
+        emit fileReceived(path, 0);
+        return;
+    }
+
+    m_recvFile = std::move(file);
+    if (m_transport->isHandshakePending()) {
+        // Attached once the handshake shows which port the sender uses
+        m_recvFileWaiting = true;
+        return;
+    }
+    startFileReceive();
+}
+
+void LoRaWorker::startFileReceive() {
+    m_recvFileWaiting = false;
+    m_recvFilePort = filePort();
+    m_transport->setReceiveDevice(m_recvFile.get(), m_recvFilePort);
+}
+
+void LoRaWorker::finishFileReceive() {
+    if (!m_recvFile) return;
+
+    if (m_transport && !m_recvFileWaiting) {
+        m_transport->setReceiveDevice(nullptr, m_recvFilePort);
+    }
+    m_recvFileWaiting = false;
+    m_recvFile->close();
+    m_recvFile.reset();
+}
+
+void LoRaWorker::startWaitingFileTransfers() {
+    if (m_recvFileWaiting) {
+        startFileReceive();
+    }
+    if (m_sendFileWaiting) {
+        if (m_transport->isSending(filePort())) {
+            emit errorOccurred("Transport busy");
+            finishFileSend(false);
+        } else {
+            startFileSend();
+        }
+    }
+}
+
+void LoRaWorker::cancelFileTransfer() {
+    if (m_sendFile && !m_sendFileWaiting && m_transport) {
+        // Emits packetSent(false), which ends the file send
+        m_transport->cancelSend(m_sendFilePort);
+    }
+    finishFileSend(false);
+    finishFileReceive();
+}
+
+void LoRaWorker::onPacketSent(bool success, quint8 port) {
+    QQueue<PacketKind> &kinds = m_sentKinds[port];
+    const PacketKind kind = kinds.isEmpty() ? PacketKind::User : kinds.dequeue();
+    switch (kind) {
+    case PacketKind::User:
+        emit packetSent(success);
+        break;
+
+    case PacketKind::PortUser:
+        emit portPacketSent(port, success);
+        break;
+
+    case PacketKind::FileSegment:
+        if (!m_sendFile) break;
+        if (success) {
+            sendNextFileSegment();
+        } else {
+            finishFileSend(false);
+        }
+        break;
+
+    case PacketKind::PubSub:
+        if (!success) {
+            emit errorOccurred("Publication not delivered");
+        }
+        break;
+    }
+}
+
+void LoRaWorker::onPacketSendProgress(int sentBytes, int totalBytes, quint8 port) {
+    const QQueue<PacketKind> kinds = m_sentKinds.value(port);
+    const PacketKind kind = kinds.isEmpty() ? PacketKind::User : kinds.head();
+    if (kind == PacketKind::User) {
+        emit packetSendProgress(sentBytes, totalBytes);
+    } else if (kind == PacketKind::FileSegment && m_sendFile) {
+        emit fileSendProgress(m_sendFileOffset + sentBytes, m_sendFile->size());
+    }
+}
+
+void LoRaWorker::onPacketReceiveProgress(int receivedBytes, int totalBytes, quint8 port) {
+    if (!m_recvFile || m_recvFileWaiting || port != m_recvFilePort) {
+        if (port == DEFAULT_PORT) {
+            emit packetReceiveProgress(receivedBytes, totalBytes);
+        }
+        return;
+    }
+
+    emit fileReceiveProgress(m_recvFileWritten + receivedBytes, m_recvFileExpected);
+}
+
+void LoRaWorker::onPacketReceivedToDevice(qint64 size, quint8 port) {
+    if (!m_recvFile || m_recvFileWaiting || port != m_recvFilePort) return;
+
+    m_recvFileWritten += size;
+    if (m_recvFileWritten >= m_recvFileExpected) {
+        const QString path = m_recvFile->fileName();
+        const qint64 written = m_recvFileWritten;
+        finishFileReceive();
+        emit fileReceived(path, written);
+    }
+}
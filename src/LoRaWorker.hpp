@@ -1,8 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <QFile>
+#include <QQueue>
 #include "QCrossPlatformSerialPort.hpp"
 #include "LoRaUsbAdapter_E22_400T22U.hpp"
+#include "LoRaLinkProfileStore.hpp"
+#include "LoRaRpc.hpp"
+#include "LoRaPubSub.hpp"
+#include "LoRaRealtime.hpp"
+#include "LoRaPayloadPipeline.hpp"
 
 /**
  * @file LoRaWorker.hpp
@@ -39,6 +46,116 @@ public:
      */
     ~LoRaWorker() override;
 
+    /**
+     * @brief Calls a service on the peer
+     * @param service Service number on the peer (24 bits)
+     * @param request Request payload, at most LoRaRpc::MAX_MESSAGE_SIZE bytes
+     * @param timeoutMs Time to wait for the reply (default: LoRaRpc::DEFAULT_TIMEOUT_MS)
+     * @return Future finishing with the reply, or with a local error status
+     *         (Timeout, RequestTooLarge, NotConnected)
+     * @details The request and the reply each take one frame; the reply
+     *          acknowledges the request. See LoRaRpc. The request is resent
+     *          every retransmission timeout of the link until the reply
+     *          arrives. Calls are independent of packets and files in flight.
+     *          Unless the handshake showed that the peer supports RPC, the
+     *          call fails at once with NotConnected.
+     * @note Must be called from the worker's thread. Use QFuture::then()
+     *       with a context object to handle the reply in another thread.
+     */
+    QFuture<LoRaRpcReply> call(quint32 service, const QByteArray &request,
+                               int timeoutMs = LoRaRpc::DEFAULT_TIMEOUT_MS);
+
+    /**
+     * @brief Registers the handler of a service called by the peer
+     * @param service Service number (24 bits)
+     * @param handler Handler returning the reply payload, or an empty
+     *        function to remove the service
+     * @param atMostOnce True if the handler must not run twice for a
+     *        repeated request; its replies are then cached (default: false)
+     * @details Handlers run in the worker's thread. Replies larger than
+     *          LoRaRpc::MAX_MESSAGE_SIZE are answered with HandlerFailed.
+     */
+    void setRpcHandler(quint32 service, LoRaRpc::Handler handler, bool atMostOnce = false);
+
+    /**
+     * @brief Subscribes to a topic published by the peer
+     * @param topic Topic name
+     * @param context Subscriber; the subscription ends when it is destroyed
+     * @param callback Called in the worker's thread with the data of each publication
+     * @details Publications on topics without subscribers are dropped
+     *          before delivery. See setPubSubEnabled().
+     */
+    void subscribe(const QString &topic, QObject *context, LoRaPubSub::Callback callback);
+
+    /**
+     * @brief Ends the subscriptions of a subscriber to a topic
+     * @param topic Topic name
+     * @param context Subscriber given to subscribe()
+     */
+    void unsubscribe(const QString &topic, QObject *context);
+
+    /**
+     * @brief Sets the stages run on packet data off the worker's thread
+     * @param encode Stage run on the data of sendPacket() and sendPortPacket()
+     *        before it is sent, or an empty function for none
+     * @param decode Stage run on received data before packetReceived() and
+     *        portPacketReceived(), or an empty function for none
+     * @details Compression, encryption or coding of large packets would
+     *          otherwise delay the ACKs and retransmissions handled by this
+     *          thread. The stages run on a LoRaPayloadPipeline; packets keep
+     *          their order within each logical port. A stage that fails
+     *          reports errorOccurred(), and a failed send packetSent(false)
+     *          or portPacketSent(false). Both ends must use matching stages.
+     *
+     *          Publications, RPC calls and files bypass the stages, and so
+     *          do partial deliveries of portPacketReceivedPartial(). Files
+     *          use DEFAULT_PORT unless the handshake negotiated ports (see
+     *          setCapabilityNegotiationEnabled()); their segments cannot be
+     *          told apart from sendPacket() data then, so that data bypasses
+     *          the stages too, on both ends.
+     * @note Must be called from the worker's thread. The stages are called
+     *       on pool threads, several at once.
+     */
+    void setPayloadStages(LoRaPayloadPipeline::Stage encode, LoRaPayloadPipeline::Stage decode);
+
+    /**
+     * @brief Returns the counters and current settings of the link
+     * @details See LoRaUsbAdapter_E22_400T22U::metrics().
+     * @note Must be called from the worker's thread
+     */
+    LoRaUsbAdapter_E22_400T22U::Metrics metrics() const;
+
+    /**
+     * @brief Measures how late the worker's thread wakes up from timed sleeps
+     * @param samples Number of wake-ups
+     * @param intervalUs Sleep between wake-ups in microseconds
+     * @return Latency statistics; see LoRaRealtime::measureWakeupLatency()
+     * @details Run it after setRealtimeSettings() and under the usual host
+     *          load to see the timing the protocol gets. The worker handles
+     *          no traffic while it runs.
+     * @note Must be called from the worker's thread
+     */
+    LoRaRealtime::LatencyStats measureWakeupLatency(int samples = LoRaRealtime::DEFAULT_LATENCY_SAMPLES,
+                                                    int intervalUs = LoRaRealtime::DEFAULT_LATENCY_INTERVAL_US);
+
+    /**
+     * @brief Logical port of sendPacket(), publish() and packetReceived()
+     */
+    static constexpr quint8 DEFAULT_PORT = 0;
+
+    /**
+     * @brief Logical port of sendFile() and receiveToFile()
+     * @details Used when the handshake showed that both ends support
+     *          LoRaCapabilities::PORTS, so that packets are not queued behind
+     *          a file. DEFAULT_PORT otherwise.
+     */
+    static constexpr quint8 FILE_PORT = 1;
+
+    /**
+     * @brief First logical port available to sendPortPacket()
+     */
+    static constexpr quint8 FIRST_USER_PORT = 2;
+
 public slots:
     /**
      * @brief Opens a serial port for LoRa communication
@@ -49,9 +166,11 @@ public slots:
      *          - No parity
      *          - 1 stop bit
      *          - No flow control
-     *          Upon successful opening, connects transport layer signals
-     *          and emits portOpened(true). On failure, emits portOpened(false)
-     *          with an error message.
+     *          Upon successful opening, applies the stored link profile of
+     *          the peer last seen on this port (see setLinkProfilePath()),
+     *          starts the capability handshake if enabled and emits
+     *          portOpened(true). On failure, emits portOpened(false) with an
+     *          error message.
      * @note Emits portOpened() signal upon completion
      * @note Emits errorOccurred() signal if port is already open
      */
@@ -59,7 +178,9 @@ public slots:
 
     /**
      * @brief Closes the currently open serial port
-     * @details Safely closes the serial port if it is open.
+     * @details Saves the learned link profile (see setLinkProfilePath()),
+     *          forgets the peer's capabilities and safely closes the serial
+     *          port if it is open.
      *          Does nothing if the port is not open.
      * @note This method is idempotent - safe to call multiple times
      */
@@ -72,10 +193,231 @@ public slots:
      *          If the transport is not ready, emits an error signal.
      * @note Emits packetSent() signal when transmission completes
      * @note Emits packetSendProgress() signal during transmission
-     * @note Emits errorOccurred() signal if transport is not ready
+     * @note Emits errorOccurred() signal if transport is not ready, or if a
+     *       file transfer is in progress and the peer does not support ports
      */
     void sendPacket(const QByteArray &data);
 
+    /**
+     * @brief Sends a packet on a logical port
+     * @param port Logical port, from FIRST_USER_PORT to
+     *        LoRaUsbAdapter_E22_400T22U::MAX_PORTS - 1
+     * @param data Packet data
+     * @details Each port has its own queue and reassembly state on both
+     *          ends, so packets on different ports do not wait for each other.
+     *          The peer receives the packet through portPacketReceived().
+     * @note Emits portPacketSent() when transmission completes
+     * @note Emits errorOccurred() if the port is invalid or the peer does
+     *       not support ports
+     */
+    void sendPortPacket(quint8 port, const QByteArray &data);
+
+    /**
+     * @brief Sets what a port does with its queued packets when a packet fails
+     * @param port Logical port
+     * @param delivery Delivery mode (default: Unordered)
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setPortDelivery().
+     */
+    void setPortDelivery(quint8 port, LoRaUsbAdapter_E22_400T22U::Delivery delivery);
+
+    /**
+     * @brief Sets how long packets on a port stay worth delivering
+     * @param port Logical port, from FIRST_USER_PORT to
+     *        LoRaUsbAdapter_E22_400T22U::MAX_PORTS - 1
+     * @param ms Lifetime in milliseconds, 0 for fully reliable delivery (default: 0)
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setPortLifetime().
+     *          The peer receives packets that lost chunks through
+     *          portPacketReceivedPartial().
+     * @note Emits errorOccurred() if the port is invalid
+     */
+    void setPortLifetime(quint8 port, int ms);
+
+    /**
+     * @brief Sends the contents of a file via LoRa
+     * @param path Path of the file to send
+     * @details Streams the file without loading it into memory. The file is
+     *          sent as a sequence of packets of at most
+     *          LoRaUsbAdapter_E22_400T22U::maxPacketSize() bytes; each segment
+     *          is memory-mapped only while it is in flight and chunks are cut
+     *          lazily from the mapping, so memory use is constant regardless of
+     *          the file size. The receiving side should use receiveToFile().
+     *
+     *          When the handshake showed that both ends support
+     *          LoRaCapabilities::PORTS, the file travels on FILE_PORT and
+     *          packets keep flowing during the transfer. While the handshake
+     *          is pending, the transfer waits for it to complete.
+     * @note Emits fileSendProgress() during transmission and fileSent() on completion
+     * @note Emits errorOccurred() if the file cannot be opened or mapped, or if
+     *       a file transfer or packet is already in progress on its port
+     */
+    void sendFile(const QString &path);
+
+    /**
+     * @brief Writes incoming packets directly to a file
+     * @param path Path of the destination file (created or truncated)
+     * @param expectedSize Size of the file being sent by the peer in bytes
+     * @details Each received chunk is written at its offset in the destination
+     *          file instead of being reassembled in memory. While this mode is
+     *          active packetReceived() is not emitted. The mode ends when
+     *          expectedSize bytes have been received or on cancelFileTransfer().
+     *          While the handshake is pending, the file is attached to a
+     *          port once it completes, the same port the sender picks.
+     * @note Emits fileReceiveProgress() during reception and fileReceived() on completion
+     * @note Emits errorOccurred() if the file cannot be opened
+     */
+    void receiveToFile(const QString &path, qint64 expectedSize);
+
+    /**
+     * @brief Cancels the file transfers in progress
+     * @details Aborts an ongoing sendFile() and leaves receive-to-file mode.
+     *          A partially received file is kept on disk.
+     * @note Emits fileSent(false) if a file send was aborted
+     */
+    void cancelFileTransfer();
+
+    /**
+     * @brief Enables or disables chunk deduplication on the link
+     * @param enabled True to replace chunks the peer already holds with short references
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setDedupEnabled().
+     *          Both ends should enable deduplication.
+     */
+    void setDedupEnabled(bool enabled);
+
+    /**
+     * @brief Enables or disables link liveness monitoring
+     * @param enabled True to track peer reachability and pause sends while it is unreachable
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setLinkMonitorEnabled().
+     * @note Emits linkUp() and linkDown() on link state changes
+     */
+    void setLinkMonitorEnabled(bool enabled);
+
+    /**
+     * @brief Enables or disables online tuning of chunk size and delayed-ACK window
+     * @param enabled True to follow the best measured goodput as the channel changes
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setAutoTuningEnabled().
+     *          With a link profile path set, the chunk size reached is saved
+     *          in closePort() and tuning resumes from it.
+     */
+    void setAutoTuningEnabled(bool enabled);
+
+    /**
+     * @brief Enables or disables the recovery of frames from damaged copies
+     * @param enabled True to combine copies that fail their CRC instead of dropping them
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setFrameRecoveryEnabled().
+     *          Rebuilt frames are counted in metrics().
+     */
+    void setFrameRecoveryEnabled(bool enabled);
+
+    /**
+     * @brief Enables or disables the protected frame header
+     * @param enabled True to send and expect a header check byte; both ends must agree
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setProtectedHeaderEnabled().
+     */
+    void setProtectedHeaderEnabled(bool enabled);
+
+    /**
+     * @brief Sets the number of Reed-Solomon parity bytes sent with each frame
+     * @param bytes Parity bytes (0 = none); both ends must agree
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setFrameParity().
+     */
+    void setFrameParity(int bytes);
+
+    /**
+     * @brief Applies real-time scheduling settings to the worker's thread
+     * @param settings Policy, priority, CPU affinity and memory locking
+     * @details Keeps late wake-ups on a loaded host from delaying ACKs and
+     *          firing spurious retransmissions. See LoRaRealtime.
+     * @note Must run in the worker's thread; invoke it through a queued
+     *       connection or QMetaObject::invokeMethod() after moveToThread().
+     *       Emits errorOccurred() listing the settings that could not be applied.
+     */
+    void setRealtimeSettings(const LoRaRealtime::Settings &settings);
+
+    /**
+     * @brief Sets the number of threads running the payload stages
+     * @param threads Thread count, at least 1 (default: one per CPU core)
+     * @details See setPayloadStages(). setRealtimeSettings() keeps these
+     *          threads off the CPUs reserved for the worker's thread.
+     */
+    void setPayloadThreads(int threads);
+
+    /**
+     * @brief Sets how many sent packets may wait for their encode stage
+     * @param packets Limit, at least 1 (default: LoRaPayloadPipeline::DEFAULT_MAX_PENDING_ENCODES)
+     * @details Beyond it, sendPacket() and sendPortPacket() fail at once
+     *          with errorOccurred() and packetSent(false) or portPacketSent(false).
+     */
+    void setPayloadQueueLimit(int packets);
+
+    /**
+     * @brief Enables or disables the event-loop stall watchdog
+     * @param enabled True to record stalls of the worker's thread
+     * @details Delegates to LoRaUsbAdapter_E22_400T22U::setStallWatchdogEnabled().
+     *          The stall histogram is part of metrics().
+     * @note Emits stallDetected() for each stall
+     */
+    void setStallWatchdogEnabled(bool enabled);
+
+    /**
+     * @brief Enables persistence of learned link parameters
+     * @param path Path of the profile file, or an empty string to disable
+     * @details The link profile (RTT estimate, chunk size, ...) of the peer
+     *          is loaded from this file in openPort() and saved back in
+     *          closePort(), so the adapter starts with tuned parameters after
+     *          a restart. Profiles age as described in LoRaLinkProfileStore.
+     *          Profiles are keyed by the peer's node identifier once the
+     *          capability handshake has identified it, and by the port name
+     *          otherwise, so a reopened port starts from the profile of the
+     *          peer last seen on it.
+     * @note Takes effect at the next openPort()
+     */
+    void setLinkProfilePath(const QString &path);
+
+    /**
+     * @brief Enables or disables the capability handshake
+     * @param enabled True to negotiate features with the peer at openPort()
+     *        (default: disabled)
+     * @details See LoRaUsbAdapter_E22_400T22U::startHandshake(). The
+     *          capabilities cached in the peer's link profile are used until
+     *          the peer answers, so a known peer gets the fast path at once.
+     *          Peers that do not answer fall back to the original frame format.
+     *          So does every link without the handshake: deduplication, link
+     *          probes, piggybacked ACKs, ports other than 0, abandoned chunks
+     *          and RPC are only used once the peer has announced them.
+     * @note Takes effect at the next openPort()
+     * @note Emits capabilitiesNegotiated() when the handshake completes
+     */
+    void setCapabilityNegotiationEnabled(bool enabled);
+
+    /**
+     * @brief Sets the node identifier announced to peers
+     * @param id Node identifier (default: LoRaCapabilities::defaultNodeId())
+     */
+    void setNodeId(quint32 id);
+
+    /**
+     * @brief Enables or disables the publish/subscribe layer
+     * @param enabled True to tag every packet with a topic ID (default: disabled)
+     * @details While enabled, packets of sendPacket() carry a one-byte
+     *          untagged marker and publish() sends publications whose topic
+     *          travels as a 1-2 byte ID; see LoRaPubSub. File transfers are
+     *          not tagged. Both ends must enable it: the setting is announced
+     *          in the capability handshake, and errorOccurred() reports a
+     *          peer that does not tag its packets.
+     */
+    void setPubSubEnabled(bool enabled);
+
+    /**
+     * @brief Publishes data on a topic
+     * @param topic Topic name
+     * @param data Message data, at most maxPacketSize() minus 2 bytes
+     * @details The first publication of a topic is preceded by a packet
+     *          announcing its ID. Publications are queued like packets and
+     *          may be sent during a file transfer.
+     * @note Emits errorOccurred() if pub/sub is disabled or a publication is lost
+     */
+    void publish(const QString &topic, const QByteArray &data);
+
 signals:
     /**
      * @brief Signal emitted when port opening completes
@@ -90,6 +432,30 @@ signals:
      */
     void packetSent(bool success);
 
+    /**
+     * @brief Signal emitted when a packet of sendPortPacket() completes
+     * @param port Logical port of the packet
+     * @param success True if packet was sent successfully, false otherwise
+     */
+    void portPacketSent(quint8 port, bool success);
+
+    /**
+     * @brief Signal emitted when a packet is received on a port from FIRST_USER_PORT on
+     * @param port Logical port of the packet
+     * @param data The received packet data
+     */
+    void portPacketReceived(quint8 port, const QByteArray &data);
+
+    /**
+     * @brief Signal emitted when a packet arrives on a port without the chunks its sender abandoned
+     * @param port Logical port of the packet
+     * @param data Packet data, with abandoned chunks zero-filled
+     * @param present Bit per chunk, set for the chunks that arrived
+     * @param chunkSize Payload size of the chunks
+     * @see setPortLifetime()
+     */
+    void portPacketReceivedPartial(quint8 port, const QByteArray &data, const QBitArray &present, int chunkSize);
+
     /**
      * @brief Signal emitted during packet transmission progress
      * @param sentBytes Number of bytes sent so far
@@ -110,13 +476,269 @@ signals:
      */
     void packetReceiveProgress(int receivedBytes, int totalBytes);
 
+    /**
+     * @brief Signal emitted when a file transmission completes
+     * @param success True if the whole file was sent successfully, false otherwise
+     */
+    void fileSent(bool success);
+
+    /**
+     * @brief Signal emitted during file transmission progress
+     * @param sentBytes Number of bytes sent so far
+     * @param totalBytes Size of the file in bytes
+     */
+    void fileSendProgress(qint64 sentBytes, qint64 totalBytes);
+
+    /**
+     * @brief Signal emitted when a file has been completely received
+     * @param path Path of the destination file
+     * @param size Size of the received file in bytes
+     */
+    void fileReceived(const QString &path, qint64 size);
+
+    /**
+     * @brief Signal emitted during file reception progress
+     * @param receivedBytes Number of bytes received so far
+     * @param totalBytes Expected size of the file in bytes
+     */
+    void fileReceiveProgress(qint64 receivedBytes, qint64 totalBytes);
+
+    /**
+     * @brief Signal emitted when the monitored peer becomes reachable
+     */
+    void linkUp();
+
+    /**
+     * @brief Signal emitted when the monitored peer stops responding
+     */
+    void linkDown();
+
+    /**
+     * @brief Signal emitted when the worker's event loop was blocked
+     * @param durationMs How long the event loop was blocked
+     * @param section Adapter section that ran longest meanwhile, empty if none
+     * @param state Protocol state when the stall was detected
+     * @see setStallWatchdogEnabled()
+     */
+    void stallDetected(int durationMs, const QString &section, const QString &state);
+
+    /**
+     * @brief Signal emitted when the capability handshake completes
+     * @param peerNodeId Node identifier of the peer (0 for a legacy peer)
+     * @param features Features in effect on the link (LoRaCapabilities::Feature bits)
+     */
+    void capabilitiesNegotiated(quint32 peerNodeId, quint32 features);
+
     /**
      * @brief Signal emitted when an error occurs
      * @param msg Error message describing the problem
      */
     void errorOccurred(const QString &msg);
 
+private slots:
+    /**
+     * @brief Slot called when the transport finishes sending a packet
+     * @param success True if the packet was sent successfully
+     * @param port Logical port of the packet
+     * @details Advances to the next file segment for a segment of
+     *          sendFile(), reports lost publications, and forwards the
+     *          result of sendPacket() packets as packetSent().
+     */
+    void onPacketSent(bool success, quint8 port);
+
+    /**
+     * @brief Slot called on transport send progress
+     * @param sentBytes Number of bytes of the current packet sent so far
+     * @param totalBytes Size of the current packet in bytes
+     * @param port Logical port of the packet
+     */
+    void onPacketSendProgress(int sentBytes, int totalBytes, quint8 port);
+
+    /**
+     * @brief Slot called on transport receive progress
+     * @param receivedBytes Number of bytes of the current packet received so far
+     * @param totalBytes Size of the current packet in bytes
+     * @param port Logical port of the packet
+     */
+    void onPacketReceiveProgress(int receivedBytes, int totalBytes, quint8 port);
+
+    /**
+     * @brief Slot called when a packet has been written to the receive file
+     * @param size Size of the packet in bytes
+     * @param port Logical port of the packet
+     */
+    void onPacketReceivedToDevice(qint64 size, quint8 port);
+
+    /**
+     * @brief Slot called when the transport completes the capability handshake
+     * @details Re-keys the link profile on the peer's node identifier and
+     *          applies its stored profile when the peer is known.
+     */
+    void onCapabilitiesNegotiated();
+
+    /**
+     * @brief Slot called when the transport has received a complete packet
+     * @param data Packet data
+     * @param port Logical port of the packet
+     * @details Hands packets of DEFAULT_PORT to the pub/sub layer when it is
+     *          enabled, and forwards the others as packetReceived() or
+     *          portPacketReceived().
+     */
+    void onPacketReceived(const QByteArray &data, quint8 port);
+
+    /**
+     * @brief Slot called when the transport has received a packet with abandoned chunks
+     * @param data Packet data, with abandoned chunks zero-filled
+     * @param present Bit per chunk, set for the chunks that arrived
+     * @param chunkSize Payload size of the chunks
+     * @param port Logical port of the packet
+     * @details Forwards packets of user ports as portPacketReceivedPartial().
+     *          Lifetimes are only set on user ports, so anything else is
+     *          dropped with an error.
+     */
+    void onPacketReceivedPartial(const QByteArray &data, const QBitArray &present, int chunkSize, quint8 port);
+
+    /**
+     * @brief Slot called when the pub/sub layer has a packet to send
+     * @param packet Publication or topic announcement
+     */
+    void onPubSubPacket(const QByteArray &packet);
+
+    /**
+     * @brief Handles a plain packet unwrapped by the pub/sub layer
+     * @param data Packet data
+     */
+    void onPlainPacketReceived(const QByteArray &data);
+
+    /**
+     * @brief Sends a packet whose encode stage has finished
+     * @param port Logical port
+     * @param data Encoded data
+     * @param ok false if the stage failed; the send is reported failed
+     */
+    void onPayloadEncoded(quint8 port, const QByteArray &data, bool ok);
+
+    /**
+     * @brief Delivers a packet whose decode stage has finished
+     * @param port Logical port
+     * @param data Decoded data
+     * @param ok false if the stage failed; the packet is dropped
+     */
+    void onPayloadDecoded(quint8 port, const QByteArray &data, bool ok);
+
 private:
+    /**
+     * @enum PacketKind
+     * @brief Origin of a packet handed to the transport
+     */
+    enum class PacketKind {
+        User,        ///< sendPacket(), reported through packetSent()
+        PortUser,    ///< sendPortPacket(), reported through portPacketSent()
+        FileSegment, ///< Segment of sendFile()
+        PubSub       ///< Publication or topic announcement
+    };
+
+    /**
+     * @brief Hands a packet to the transport and records its origin
+     * @param data Packet data
+     * @param kind Origin, used to route its packetSent() result
+     * @param port Logical port (default: DEFAULT_PORT)
+     */
+    void sendTransportPacket(const QByteArray &data, PacketKind kind, quint8 port = DEFAULT_PORT);
+
+    /**
+     * @brief Sends user data through the encode stage, if any
+     * @param data Packet data
+     * @param kind PacketKind::User or PacketKind::PortUser
+     * @param port Logical port
+     */
+    void sendPayload(const QByteArray &data, PacketKind kind, quint8 port);
+
+    /**
+     * @brief Hands encoded user data to the transport
+     * @param data Encoded packet data
+     * @param kind PacketKind::User or PacketKind::PortUser
+     * @param port Logical port
+     */
+    void sendEncodedPayload(const QByteArray &data, PacketKind kind, quint8 port);
+
+    /**
+     * @brief Reports a user packet that was never handed to the transport
+     * @param kind PacketKind::User or PacketKind::PortUser
+     * @param port Logical port
+     */
+    void reportSendFailed(PacketKind kind, quint8 port);
+
+    /**
+     * @brief Passes received user data through the decode stage, if any
+     * @param port Logical port
+     * @param data Packet data
+     */
+    void receivePayload(quint8 port, const QByteArray &data);
+
+    /**
+     * @brief Emits decoded user data through packetReceived() or portPacketReceived()
+     * @param port Logical port
+     * @param data Decoded packet data
+     */
+    void deliverPayload(quint8 port, const QByteArray &data);
+
+    /**
+     * @brief Returns whether user data of a port passes through the payload stages
+     * @param port Logical port
+     * @return true for user ports, and for DEFAULT_PORT once files travel on
+     *         FILE_PORT; false where file segments may arrive
+     * @details Decides for both directions, so that exactly what one end
+     *          encoded is decoded by the other: both ends agree on
+     *          filePort(). File segments sharing DEFAULT_PORT cannot be
+     *          told apart from sendPacket() data, so neither is staged there.
+     */
+    bool hasPayloadStages(quint8 port) const;
+
+    /**
+     * @brief Returns the port for a new file transfer
+     * @return FILE_PORT if the completed handshake showed that both ends
+     *         support ports, DEFAULT_PORT otherwise
+     */
+    quint8 filePort() const;
+
+    /**
+     * @brief Starts sending the file opened by sendFile() on filePort()
+     */
+    void startFileSend();
+
+    /**
+     * @brief Attaches the file opened by receiveToFile() to filePort()
+     */
+    void startFileReceive();
+
+    /**
+     * @brief Starts the file transfers that waited for the handshake
+     */
+    void startWaitingFileTransfers();
+
+    /**
+     * @brief Maps and sends the next segment of the file being sent
+     * @details Finishes the file transfer when the whole file has been sent.
+     */
+    void sendNextFileSegment();
+
+    /**
+     * @brief Ends the file send in progress and releases the file
+     * @param success Result reported through fileSent()
+     */
+    void finishFileSend(bool success);
+
+    /**
+     * @brief Leaves receive-to-file mode and closes the destination file
+     */
+    void finishFileReceive();
+
+    /**
+     * @brief Stores the learned link profile of the current peer and writes the profile file
+     */
+    void saveLinkProfile();
+
     /**
      * @brief Shared pointer to the QCrossPlatformSerialPort instance
      * @details Manages the serial port connection. Set to nullptr when port
@@ -130,4 +752,115 @@ private:
      *          protocol for the E22-400T22U LoRa module.
      */
     std::unique_ptr<LoRaUsbAdapter_E22_400T22U> m_transport;
+
+    /**
+     * @brief Request/response layer on top of the transport
+     */
+    LoRaRpc m_rpc;
+
+    /**
+     * @brief Publish/subscribe layer on top of the transport
+     */
+    LoRaPubSub m_pubSub;
+
+    /**
+     * @brief Whether packets are tagged with topic IDs
+     */
+    bool m_pubSubEnabled = false;
+
+    /**
+     * @brief Thread pool running the payload stages
+     * @details Child of the worker, so that it follows moveToThread() and
+     *          its results arrive in the worker's thread.
+     */
+    LoRaPayloadPipeline m_payloadPipeline;
+
+    /**
+     * @brief Origins of the packets in the encode stage, oldest first, by port
+     * @details The pipeline reports them in submission order within a port.
+     */
+    QHash<quint8, QQueue<PacketKind>> m_encodingKinds;
+
+    /**
+     * @brief Origins of the packets handed to the transport, oldest first, by port
+     * @details The transport reports exactly one packetSent() per packet,
+     *          in order within a port, so the head is the packet in flight.
+     */
+    QHash<quint8, QQueue<PacketKind>> m_sentKinds;
+
+    /**
+     * @brief Persistent link profiles, keyed by peer identifier
+     */
+    LoRaLinkProfileStore m_profileStore;
+
+    /**
+     * @brief Identifier of the peer on the open port, empty when closed
+     * @details The port name until the handshake identifies the peer.
+     */
+    QString m_peerId;
+
+    /**
+     * @brief Name of the open port, empty when closed
+     */
+    QString m_portName;
+
+    /**
+     * @brief Whether the capability handshake is started in openPort()
+     */
+    bool m_negotiationEnabled = false;
+
+    /**
+     * @brief File being sent by sendFile(), or nullptr when idle
+     */
+    std::unique_ptr<QFile> m_sendFile;
+
+    /**
+     * @brief Logical port of the file being sent
+     */
+    quint8 m_sendFilePort = DEFAULT_PORT;
+
+    /**
+     * @brief Whether the file being sent waits for the handshake to pick its port
+     */
+    bool m_sendFileWaiting = false;
+
+    /**
+     * @brief Mapping of the file segment currently in flight
+     */
+    uchar *m_sendMap = nullptr;
+
+    /**
+     * @brief Offset in the file of the segment currently in flight
+     */
+    qint64 m_sendFileOffset = 0;
+
+    /**
+     * @brief Size of the segment currently in flight
+     */
+    qint64 m_sendSegmentSize = 0;
+
+    /**
+     * @brief Destination file of receiveToFile(), or nullptr when idle
+     */
+    std::unique_ptr<QFile> m_recvFile;
+
+    /**
+     * @brief Logical port of the file being received
+     */
+    quint8 m_recvFilePort = DEFAULT_PORT;
+
+    /**
+     * @brief Whether the file being received waits for the handshake to pick its port
+     */
+    bool m_recvFileWaiting = false;
+
+    /**
+     * @brief Number of bytes written to the destination file so far
+     */
+    qint64 m_recvFileWritten = 0;
+
+    /**
+     * @brief Expected size of the file being received
+     */
+    qint64 m_recvFileExpected = 0;
 };
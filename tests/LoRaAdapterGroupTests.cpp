@@ -0,0 +1,222 @@
+/**
+ * @file LoRaAdapterGroupTests.cpp
+ * @brief Unit tests for LoRaAdapterGroup and the adapter takeover
+ * @date 2026-10-19
+ *
+ * This file contains unit tests for hot-standby failover:
+ * - addAdapter(): active adapter and standbys
+ * - failOver(): refused without a standby whose device is open
+ * - sendPacket(): routed through the active adapter
+ * - setDiversityEnabled(): frame forwarding of the members, antenna statistics
+ * - LoRaUsbAdapter_E22_400T22U::takeOver(): session settings and standby roles
+ * - failover on a device failure: the packet in flight, the outbox, the
+ *   deadlines and a partly received packet continue on the standby
+ *
+ * Most tests never open the serial ports, so no frames are exchanged. The
+ * failover of a packet in flight runs both adapters on pseudo-terminals
+ * (see LoRaPtyPeer).
+ */
+
+#include <gtest/gtest.h>
+#include <QSignalSpy>
+#include <QThread>
+#include "../src/LoRaAdapterGroup.hpp"
+#include "LoRaPtyPeer.hpp"
+
+/**
+ * @class LoRaAdapterGroupTest
+ * @brief Test suite for the adapter group
+ */
+class LoRaAdapterGroupTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Creates an adapter on an unopened serial port
+     */
+    static std::shared_ptr<LoRaUsbAdapter_E22_400T22U> makeAdapter() {
+        return std::make_shared<LoRaUsbAdapter_E22_400T22U>(std::make_shared<QCrossPlatformSerialPort>());
+    }
+
+    /**
+     * @brief Group being tested
+     */
+    LoRaAdapterGroup group;
+};
+
+/**
+ * @test Verify the first adapter is active and the others stand by
+ */
+TEST_F(LoRaAdapterGroupTest, FirstAdapterIsActive) {
+    EXPECT_EQ(group.activeIndex(), -1);
+    EXPECT_EQ(group.activeAdapter(), nullptr);
+
+    const auto primary = makeAdapter();
+    const auto standby = makeAdapter();
+    group.addAdapter(primary);
+    group.addAdapter(standby);
+    group.addAdapter(primary);
+
+    ASSERT_EQ(group.adapterCount(), 2);
+    EXPECT_EQ(group.activeIndex(), 0);
+    EXPECT_EQ(group.activeAdapter(), primary.get());
+    EXPECT_FALSE(primary->isStandby());
+    EXPECT_TRUE(standby->isStandby());
+    EXPECT_TRUE(primary->holdsOnDeviceFailure());
+    EXPECT_TRUE(standby->holdsOnDeviceFailure());
+}
+
+/**
+ * @test Verify failover needs a standby with an open device
+ */
+TEST_F(LoRaAdapterGroupTest, FailOverNeedsOpenStandby) {
+    group.addAdapter(makeAdapter());
+    group.addAdapter(makeAdapter());
+    QSignalSpy failedOverSpy(&group, &LoRaAdapterGroup::failedOver);
+    QSignalSpy errorSpy(&group, &LoRaAdapterGroup::error);
+
+    EXPECT_FALSE(group.failOver());
+    EXPECT_EQ(group.activeIndex(), 0);
+    EXPECT_EQ(group.failoverCount(), 0);
+    EXPECT_EQ(failedOverSpy.count(), 0);
+    EXPECT_EQ(errorSpy.count(), 1);
+}
+
+/**
+ * @test Verify packets go through the active adapter and its signals are forwarded
+ */
+TEST_F(LoRaAdapterGroupTest, SendGoesThroughActiveAdapter) {
+    QSignalSpy sentSpy(&group, &LoRaAdapterGroup::packetSent);
+    group.sendPacket("data");
+    ASSERT_EQ(sentSpy.count(), 1);
+    EXPECT_FALSE(sentSpy.takeFirst()[0].toBool());
+
+    const auto primary = makeAdapter();
+    group.addAdapter(primary);
+    group.sendPacket("data", 0);
+
+    // The port is not open
+    ASSERT_EQ(sentSpy.count(), 1);
+    EXPECT_FALSE(sentSpy.takeFirst()[0].toBool());
+    EXPECT_EQ(primary->metrics().packetsFailed, 1u);
+    EXPECT_FALSE(group.isSending());
+}
+
+/**
+ * @test Verify diversity makes every member forward its frames
+ */
+TEST_F(LoRaAdapterGroupTest, DiversityForwardsFrames) {
+    const auto primary = makeAdapter();
+    group.addAdapter(primary);
+    group.setDiversityEnabled(true);
+    const auto standby = makeAdapter();
+    group.addAdapter(standby);
+
+    EXPECT_TRUE(primary->isFrameForwarding());
+    EXPECT_TRUE(standby->isFrameForwarding());
+    EXPECT_EQ(group.antennaStats().size(), 2);
+
+    group.setDiversityEnabled(false);
+    EXPECT_FALSE(primary->isFrameForwarding());
+    EXPECT_FALSE(standby->isFrameForwarding());
+}
+
+/**
+ * @test Verify a takeover carries the session settings and swaps the roles
+ */
+TEST_F(LoRaAdapterGroupTest, TakeOverCarriesSession) {
+    const auto failed = makeAdapter();
+    const auto standby = makeAdapter();
+    failed->setNodeId(0x1234);
+    failed->setChunkSize(12);
+    failed->setAckDelay(80);
+    failed->setPortLifetime(3, 500);
+    standby->setStandby(true);
+
+    standby->takeOver(*failed);
+
+    EXPECT_EQ(standby->nodeId(), 0x1234u);
+    EXPECT_EQ(standby->chunkSize(), 12);
+    EXPECT_EQ(standby->ackDelay(), 80);
+    EXPECT_EQ(standby->portLifetime(3), 500);
+    EXPECT_FALSE(standby->isStandby());
+    EXPECT_TRUE(failed->isStandby());
+    EXPECT_FALSE(failed->isSending());
+}
+
+/**
+ * @test Verify a packet in flight completes once on the standby when the active device fails
+ */
+TEST_F(LoRaAdapterGroupTest, FailoverCompletesPacketInFlight) {
+    using FrameType = LoRaUsbAdapter_E22_400T22U::FrameType;
+    constexpr quint8 SEND_PORT = 2;
+    constexpr quint8 RECEIVE_PORT = 3;
+    LoRaPtyPeer primaryPeer;
+    LoRaPtyPeer standbyPeer;
+    if (!primaryPeer.isOpen() || !standbyPeer.isOpen()) {
+        GTEST_SKIP() << "No pseudo-terminal available";
+    }
+    const auto primary = std::make_shared<LoRaUsbAdapter_E22_400T22U>(primaryPeer.serial());
+    const auto standby = std::make_shared<LoRaUsbAdapter_E22_400T22U>(standbyPeer.serial());
+    primary->setAckDelay(0);
+    primary->setPortLifetime(SEND_PORT, 300);
+    LoRaPtyPeer::handshake(*primary);
+    primaryPeer.readFrames();
+    group.addAdapter(primary);
+    group.addAdapter(standby);
+    QSignalSpy sentSpy(&group, &LoRaAdapterGroup::packetSent);
+    QSignalSpy receivedSpy(&group, &LoRaAdapterGroup::packetReceived);
+    QSignalSpy failedOverSpy(&group, &LoRaAdapterGroup::failedOver);
+
+    QByteArray packet;
+    for (int i = 0; i < 60; ++i) {
+        packet.append(static_cast<char>(i));
+    }
+    group.sendPacket(packet, SEND_PORT);
+    group.sendPacket(QByteArray(10, 'q'), SEND_PORT);
+    primary->receiveFrame(LoRaPtyPeer::frame(FrameType::ACK, 0, 3, {}, SEND_PORT));
+    // First half of a packet from the peer
+    primary->receiveFrame(LoRaPtyPeer::frame(FrameType::DATA, 0, 2, "first ", RECEIVE_PORT));
+    QList<QByteArray> frames = primaryPeer.readFrames();
+    ASSERT_EQ(frames.size(), 3);
+    EXPECT_EQ(LoRaPtyPeer::typeOf(frames[1]), FrameType::DATA);
+    EXPECT_EQ(LoRaPtyPeer::seqOf(frames[1]), 1);
+    EXPECT_EQ(LoRaPtyPeer::typeOf(frames[2]), FrameType::ACK);
+
+    // The retransmission of chunk 1 finds the device gone
+    primaryPeer.serial()->close();
+    QMetaObject::invokeMethod(primary.get(), "onSendTimeout", Qt::DirectConnection, Q_ARG(quint8, SEND_PORT));
+    frames = standbyPeer.readFrames();
+    ASSERT_EQ(failedOverSpy.count(), 1);
+    EXPECT_EQ(group.activeAdapter(), standby.get());
+    EXPECT_TRUE(primary->isStandby());
+    EXPECT_FALSE(primary->isSending());
+
+    // The standby resumes with chunk 1, not with chunk 0
+    ASSERT_EQ(frames.size(), 1);
+    quint8 port = 0;
+    EXPECT_EQ(LoRaPtyPeer::typeOf(frames[0], &port), FrameType::DATA);
+    EXPECT_EQ(port, SEND_PORT);
+    EXPECT_EQ(LoRaPtyPeer::seqOf(frames[0]), 1);
+    EXPECT_EQ(LoRaPtyPeer::payloadOf(frames[0]), packet.mid(24, 24));
+
+    standby->receiveFrame(LoRaPtyPeer::frame(FrameType::ACK, 1, 3, {}, SEND_PORT));
+    frames = standbyPeer.readFrames();
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(LoRaPtyPeer::seqOf(frames[0]), 2);
+    EXPECT_EQ(sentSpy.count(), 0);
+
+    // The second half completes the packet the failed adapter had begun
+    standby->receiveFrame(LoRaPtyPeer::frame(FrameType::DATA, 1, 2, "second", RECEIVE_PORT));
+    ASSERT_EQ(receivedSpy.count(), 1);
+    EXPECT_EQ(receivedSpy.at(0).at(0).toByteArray(), QByteArray("first second"));
+    EXPECT_EQ(receivedSpy.at(0).at(1).toInt(), RECEIVE_PORT);
+    standbyPeer.readFrames();
+
+    // All chunks went out in time; the queued packet kept its deadline and expired
+    QThread::msleep(350);
+    standby->receiveFrame(LoRaPtyPeer::frame(FrameType::ACK, 2, 3, {}, SEND_PORT));
+    EXPECT_TRUE(standbyPeer.readFrames().isEmpty());
+    ASSERT_EQ(sentSpy.count(), 2);
+    EXPECT_TRUE(sentSpy.at(0).at(0).toBool());
+    EXPECT_FALSE(sentSpy.at(1).at(0).toBool());
+    EXPECT_FALSE(standby->isSending());
+}
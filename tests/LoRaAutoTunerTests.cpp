@@ -0,0 +1,132 @@
+/**
+ * @file LoRaAutoTunerTests.cpp
+ * @brief Unit tests for LoRaAutoTuner
+ * @date 2026-10-18
+ *
+ * This file contains unit tests for the online parameter hill-climber:
+ * - start(): clamping to the bounds
+ * - evaluate(): probing, acceptance and revert
+ * - Bounds: moves never leave the configured range
+ *
+ * The epoch timer is not driven here; epochs are ended by calling
+ * evaluate() directly with a goodput figure.
+ */
+
+#include <gtest/gtest.h>
+#include <QSignalSpy>
+#include "../src/LoRaAutoTuner.hpp"
+
+/**
+ * @class LoRaAutoTunerTest
+ * @brief Test suite for the auto-tuner
+ */
+class LoRaAutoTunerTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Tuner being tested
+     */
+    LoRaAutoTuner tuner;
+};
+
+/**
+ * @test Verify a stopped tuner ignores evaluations
+ */
+TEST_F(LoRaAutoTunerTest, StoppedTunerIgnoresEvaluate) {
+    QSignalSpy spy(&tuner, &LoRaAutoTuner::parametersChanged);
+
+    tuner.evaluate(1000.0);
+
+    EXPECT_FALSE(tuner.isRunning());
+    EXPECT_EQ(spy.count(), 0);
+    EXPECT_EQ(tuner.stats().epochs, 0u);
+}
+
+/**
+ * @test Verify the first epoch sets the baseline and starts a probe
+ */
+TEST_F(LoRaAutoTunerTest, FirstEpochStartsProbe) {
+    QSignalSpy spy(&tuner, &LoRaAutoTuner::parametersChanged);
+    tuner.start(24, 50);
+    EXPECT_EQ(spy.count(), 0);
+
+    tuner.evaluate(1000.0);
+
+    // Chunk size cannot grow past 24, so the first probe shrinks it
+    ASSERT_EQ(spy.count(), 1);
+    EXPECT_EQ(spy.at(0).at(0).toInt(), 20);
+    EXPECT_EQ(spy.at(0).at(1).toInt(), 50);
+    EXPECT_TRUE(tuner.stats().probing);
+    EXPECT_DOUBLE_EQ(tuner.stats().baselineGoodputBps, 1000.0);
+}
+
+/**
+ * @test Verify a better probe is kept and the next one goes the same way
+ */
+TEST_F(LoRaAutoTunerTest, ImprovementIsAccepted) {
+    QSignalSpy spy(&tuner, &LoRaAutoTuner::parametersChanged);
+    tuner.start(24, 50);
+    tuner.evaluate(1000.0);
+
+    tuner.evaluate(1200.0);
+
+    ASSERT_EQ(spy.count(), 2);
+    EXPECT_EQ(spy.at(1).at(0).toInt(), 16);
+    EXPECT_EQ(spy.at(1).at(1).toInt(), 50);
+    EXPECT_EQ(tuner.stats().accepted, 1u);
+    EXPECT_DOUBLE_EQ(tuner.stats().baselineGoodputBps, 1200.0);
+}
+
+/**
+ * @test Verify a worse probe is undone and the next direction is tried
+ */
+TEST_F(LoRaAutoTunerTest, RegressionIsReverted) {
+    QSignalSpy spy(&tuner, &LoRaAutoTuner::parametersChanged);
+    tuner.start(24, 50);
+    tuner.evaluate(1000.0);
+
+    // Within the improvement threshold counts as no better
+    tuner.evaluate(1020.0);
+
+    ASSERT_EQ(spy.count(), 2);
+    EXPECT_EQ(spy.at(1).at(0).toInt(), 24);
+    EXPECT_EQ(spy.at(1).at(1).toInt(), 50);
+    EXPECT_EQ(tuner.stats().reverted, 1u);
+    EXPECT_FALSE(tuner.stats().probing);
+
+    // A fresh baseline, then a probe of the ACK delay
+    tuner.evaluate(1000.0);
+    ASSERT_EQ(spy.count(), 3);
+    EXPECT_EQ(spy.at(2).at(0).toInt(), 24);
+    EXPECT_EQ(spy.at(2).at(1).toInt(), 75);
+}
+
+/**
+ * @test Verify start() clamps to the bounds and moves stay within them
+ */
+TEST_F(LoRaAutoTunerTest, MovesStayWithinBounds) {
+    LoRaAutoTuner::Bounds bounds;
+    bounds.minChunkSize = 12;
+    bounds.maxChunkSize = 16;
+    bounds.minAckDelayMs = 0;
+    bounds.maxAckDelayMs = 0;
+    tuner.setBounds(bounds);
+
+    QSignalSpy spy(&tuner, &LoRaAutoTuner::parametersChanged);
+    tuner.start(24, 50);
+    ASSERT_EQ(spy.count(), 1);
+    EXPECT_EQ(spy.at(0).at(0).toInt(), 16);
+    EXPECT_EQ(spy.at(0).at(1).toInt(), 0);
+
+    // Keep rewarding every probe
+    double goodput = 1000.0;
+    for (int i = 0; i < 10; ++i) {
+        tuner.evaluate(goodput);
+        goodput *= 2.0;
+    }
+
+    for (const QList<QVariant> &args : spy) {
+        EXPECT_GE(args.at(0).toInt(), 12);
+        EXPECT_LE(args.at(0).toInt(), 16);
+        EXPECT_EQ(args.at(1).toInt(), 0);
+    }
+}
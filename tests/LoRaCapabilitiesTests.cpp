@@ -0,0 +1,107 @@
+/**
+ * @file LoRaCapabilitiesTests.cpp
+ * @brief Unit tests for LoRaCapabilities
+ * @date 2026-10-18
+ *
+ * This file contains unit tests for the capability handshake payload:
+ * - encode(), decode(): wire format and forward compatibility
+ * - negotiate(): common version, features and payload size
+ * - defaultNodeId(): stable non-zero identifier
+ */
+
+#include <gtest/gtest.h>
+#include <QByteArray>
+#include "../src/LoRaCapabilities.hpp"
+
+/**
+ * @class LoRaCapabilitiesTest
+ * @brief Test suite for the capability handshake payload
+ */
+class LoRaCapabilitiesTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Creates the capabilities of a current node
+     */
+    LoRaCapabilities makeCaps(quint32 features, quint8 maxPayload, quint32 nodeId) {
+        LoRaCapabilities caps;
+        caps.version = LoRaCapabilities::PROTOCOL_VERSION;
+        caps.features = features;
+        caps.maxPayload = maxPayload;
+        caps.nodeId = nodeId;
+        return caps;
+    }
+};
+
+/**
+ * @test Verify capabilities survive the wire encoding
+ */
+TEST_F(LoRaCapabilitiesTest, EncodeDecodeRoundTrip) {
+    const LoRaCapabilities caps = makeCaps(LoRaCapabilities::DEDUP | LoRaCapabilities::LINK_PROBE, 24, 0xA1B2C3D4);
+    const QByteArray encoded = caps.encode();
+    ASSERT_EQ(encoded.size(), LoRaCapabilities::ENCODED_SIZE);
+
+    LoRaCapabilities decoded;
+    ASSERT_TRUE(LoRaCapabilities::decode(encoded, decoded));
+    EXPECT_EQ(decoded.version, caps.version);
+    EXPECT_EQ(decoded.features, caps.features);
+    EXPECT_EQ(decoded.maxPayload, 24);
+    EXPECT_EQ(decoded.nodeId, 0xA1B2C3D4u);
+}
+
+/**
+ * @test Verify fields appended by later versions are ignored
+ */
+TEST_F(LoRaCapabilitiesTest, TrailingBytesAreIgnored) {
+    const LoRaCapabilities caps = makeCaps(LoRaCapabilities::LINK_PROBE, 16, 7);
+    LoRaCapabilities decoded;
+    ASSERT_TRUE(LoRaCapabilities::decode(caps.encode() + QByteArray(4, '\x55'), decoded));
+    EXPECT_EQ(decoded.nodeId, 7u);
+    EXPECT_EQ(decoded.maxPayload, 16);
+}
+
+/**
+ * @test Verify short or meaningless payloads are rejected
+ */
+TEST_F(LoRaCapabilitiesTest, InvalidPayloadsAreRejected) {
+    LoRaCapabilities decoded = makeCaps(0, 24, 99);
+    EXPECT_FALSE(LoRaCapabilities::decode(QByteArray(LoRaCapabilities::ENCODED_SIZE - 1, '\x01'), decoded));
+    EXPECT_FALSE(LoRaCapabilities::decode(QByteArray(LoRaCapabilities::ENCODED_SIZE, '\0'), decoded));
+    EXPECT_EQ(decoded.nodeId, 99u);
+}
+
+/**
+ * @test Verify only what both ends support is negotiated
+ */
+TEST_F(LoRaCapabilitiesTest, NegotiateKeepsCommonSubset) {
+    const LoRaCapabilities local = makeCaps(LoRaCapabilities::DEDUP | LoRaCapabilities::LINK_PROBE, 24, 1);
+    const LoRaCapabilities peer = makeCaps(LoRaCapabilities::LINK_PROBE, 16, 2);
+
+    const LoRaCapabilities common = local.negotiate(peer);
+    EXPECT_TRUE(common.has(LoRaCapabilities::LINK_PROBE));
+    EXPECT_FALSE(common.has(LoRaCapabilities::DEDUP));
+    EXPECT_EQ(common.maxPayload, 16);
+    EXPECT_EQ(common.nodeId, 2u);
+}
+
+/**
+ * @test Verify a legacy peer gets the original format without features
+ */
+TEST_F(LoRaCapabilitiesTest, LegacyPeerDisablesFeatures) {
+    const LoRaCapabilities local = makeCaps(LoRaCapabilities::DEDUP | LoRaCapabilities::LINK_PROBE, 24, 1);
+    const LoRaCapabilities legacy = LoRaCapabilities::legacy(24);
+    EXPECT_TRUE(legacy.isLegacy());
+
+    const LoRaCapabilities common = local.negotiate(legacy);
+    EXPECT_TRUE(common.isLegacy());
+    EXPECT_EQ(common.features, 0u);
+    EXPECT_EQ(common.maxPayload, 24);
+}
+
+/**
+ * @test Verify the default node identifier is usable and stable
+ */
+TEST_F(LoRaCapabilitiesTest, DefaultNodeIdIsStable) {
+    const quint32 id = LoRaCapabilities::defaultNodeId();
+    EXPECT_NE(id, 0u);
+    EXPECT_EQ(LoRaCapabilities::defaultNodeId(), id);
+}
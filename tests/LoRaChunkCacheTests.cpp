@@ -0,0 +1,115 @@
+/**
+ * @file LoRaChunkCacheTests.cpp
+ * @brief Unit tests for LoRaChunkCache
+ * @date 2026-10-18
+ *
+ * This file contains unit tests for the chunk deduplication cache:
+ * - keyOf(), encodeKey(), decodeKey(): key calculation and wire format
+ * - insert(), lookup(), remove(): cache contents
+ * - setCapacity(): bounded size and LRU eviction
+ */
+
+#include <gtest/gtest.h>
+#include <QByteArray>
+#include "../src/LoRaChunkCache.hpp"
+
+/**
+ * @class LoRaChunkCacheTest
+ * @brief Test suite for the chunk deduplication cache
+ */
+class LoRaChunkCacheTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Creates a distinct full-size chunk
+     */
+    QByteArray makeChunk(int n) {
+        return QByteArray("chunk-payload-") + QByteArray::number(n).rightJustified(10, '0');
+    }
+};
+
+/**
+ * @test Verify keys survive the wire encoding
+ */
+TEST_F(LoRaChunkCacheTest, KeyRoundTrip) {
+    const quint64 key = LoRaChunkCache::keyOf(makeChunk(1));
+    const QByteArray encoded = LoRaChunkCache::encodeKey(key);
+    quint64 decoded = 0;
+
+    EXPECT_EQ(encoded.size(), LoRaChunkCache::KEY_SIZE);
+    EXPECT_TRUE(LoRaChunkCache::decodeKey(encoded, decoded));
+    EXPECT_EQ(decoded, key);
+    EXPECT_FALSE(LoRaChunkCache::decodeKey(encoded.left(3), decoded));
+}
+
+/**
+ * @test Verify different chunks get different keys
+ */
+TEST_F(LoRaChunkCacheTest, DistinctChunksHaveDistinctKeys) {
+    EXPECT_EQ(LoRaChunkCache::keyOf(makeChunk(1)), LoRaChunkCache::keyOf(makeChunk(1)));
+    EXPECT_NE(LoRaChunkCache::keyOf(makeChunk(1)), LoRaChunkCache::keyOf(makeChunk(2)));
+}
+
+/**
+ * @test Verify an inserted chunk can be looked up by its key
+ */
+TEST_F(LoRaChunkCacheTest, InsertThenLookup) {
+    LoRaChunkCache cache;
+    const quint64 key = cache.insert(makeChunk(7));
+    QByteArray chunk;
+
+    EXPECT_TRUE(cache.contains(key));
+    EXPECT_TRUE(cache.lookup(key, chunk));
+    EXPECT_EQ(chunk, makeChunk(7));
+
+    cache.remove(key);
+    EXPECT_FALSE(cache.lookup(key, chunk));
+}
+
+/**
+ * @test Verify chunks not longer than a key are not cached
+ */
+TEST_F(LoRaChunkCacheTest, ShortChunksAreNotCached) {
+    LoRaChunkCache cache;
+    const quint64 key = cache.insert(QByteArray("tiny"));
+
+    EXPECT_FALSE(LoRaChunkCache::isCacheable(QByteArray(LoRaChunkCache::KEY_SIZE, 'x')));
+    EXPECT_FALSE(cache.contains(key));
+    EXPECT_EQ(cache.size(), 0);
+}
+
+/**
+ * @test Verify the cache stays bounded and evicts the least recently used chunk
+ */
+TEST_F(LoRaChunkCacheTest, EvictsLeastRecentlyUsed) {
+    LoRaChunkCache cache(3);
+    const quint64 first = cache.insert(makeChunk(1));
+    const quint64 second = cache.insert(makeChunk(2));
+    cache.insert(makeChunk(3));
+
+    // Touch the first chunk so that the second one becomes the oldest
+    QByteArray chunk;
+    EXPECT_TRUE(cache.lookup(first, chunk));
+    cache.insert(makeChunk(4));
+
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_TRUE(cache.contains(first));
+    EXPECT_FALSE(cache.contains(second));
+}
+
+/**
+ * @test Verify shrinking the capacity evicts chunks immediately
+ */
+TEST_F(LoRaChunkCacheTest, ShrinkingCapacityEvicts) {
+    LoRaChunkCache cache(10);
+    for (int i = 0; i < 10; ++i) {
+        cache.insert(makeChunk(i));
+    }
+
+    cache.setCapacity(4);
+    EXPECT_EQ(cache.capacity(), 4);
+    EXPECT_EQ(cache.size(), 4);
+
+    cache.setCapacity(0);
+    cache.insert(makeChunk(11));
+    EXPECT_EQ(cache.size(), 0);
+}
@@ -0,0 +1,225 @@
+/**
+ * @file LoRaDeltaSyncTests.cpp
+ * @brief Unit tests for LoRaDeltaSync
+ * @date 2026-10-18
+ *
+ * This file contains unit tests for the delta sync codec:
+ * - makeSignature(): block signature generation
+ * - makeDelta(): delta computation against a signature, malformed signatures
+ * - applyDelta(): reconstruction and verification, malformed and oversized deltas
+ */
+
+#include <gtest/gtest.h>
+#include <QByteArray>
+#include "../src/LoRaDeltaSync.hpp"
+
+/**
+ * @class LoRaDeltaSyncTest
+ * @brief Test suite for the delta sync codec
+ */
+class LoRaDeltaSyncTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Creates a configuration-like text blob of the given size
+     */
+    QByteArray makeConfig(int size) {
+        QByteArray data;
+        int line = 0;
+        while (data.size() < size) {
+            data.append("option_");
+            data.append(QByteArray::number(line));
+            data.append(" = value_");
+            data.append(QByteArray::number(line * 7919 % 1000));
+            data.append('\n');
+            line++;
+        }
+        return data.left(size);
+    }
+
+    /**
+     * @brief Appends an unsigned LEB128 varint, as used in deltas
+     */
+    static void appendVarint(QByteArray &out, quint32 value) {
+        while (value >= 0x80) {
+            out.append(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.append(static_cast<char>(value));
+    }
+
+    /**
+     * @brief Returns a delta header with an arbitrary target hash
+     */
+    static QByteArray deltaHeader(quint32 blockSize, quint32 targetSize) {
+        QByteArray delta("D");
+        appendVarint(delta, blockSize);
+        appendVarint(delta, targetSize);
+        delta.append("hash");
+        return delta;
+    }
+
+    /**
+     * @brief Runs a full signature/delta/apply round trip
+     */
+    bool roundTrip(const QByteArray &base, const QByteArray &target, QByteArray &delta) {
+        const QByteArray signature = LoRaDeltaSync::makeSignature(base);
+        delta = LoRaDeltaSync::makeDelta(signature, target);
+        QByteArray rebuilt;
+        if (!LoRaDeltaSync::applyDelta(base, delta, rebuilt)) return false;
+        return rebuilt == target;
+    }
+};
+
+/**
+ * @test Verify identical versions produce a delta much smaller than the data
+ */
+TEST_F(LoRaDeltaSyncTest, IdenticalVersionsProduceTinyDelta) {
+    const QByteArray base = makeConfig(20000);
+    QByteArray delta;
+
+    EXPECT_TRUE(roundTrip(base, base, delta));
+    EXPECT_LT(delta.size(), 64);
+}
+
+/**
+ * @test Verify a small in-place edit costs airtime proportional to the change
+ */
+TEST_F(LoRaDeltaSyncTest, SmallEditProducesSmallDelta) {
+    const QByteArray base = makeConfig(20000);
+    QByteArray target = base;
+    target.replace(10000, 5, "EDITED");
+    QByteArray delta;
+
+    EXPECT_TRUE(roundTrip(base, target, delta));
+    EXPECT_LT(delta.size(), 512);
+}
+
+/**
+ * @test Verify inserted bytes do not break matching of the following blocks
+ */
+TEST_F(LoRaDeltaSyncTest, InsertionShiftsAreMatched) {
+    const QByteArray base = makeConfig(8000);
+    QByteArray target = base;
+    target.insert(123, QByteArray("inserted line\n"));
+    QByteArray delta;
+
+    EXPECT_TRUE(roundTrip(base, target, delta));
+    EXPECT_LT(delta.size(), 512);
+}
+
+/**
+ * @test Verify an empty base degrades to a full literal transfer
+ */
+TEST_F(LoRaDeltaSyncTest, EmptyBaseSendsLiteral) {
+    const QByteArray target = makeConfig(500);
+    QByteArray delta;
+
+    EXPECT_TRUE(roundTrip(QByteArray(), target, delta));
+    EXPECT_GE(delta.size(), target.size());
+}
+
+/**
+ * @test Verify an empty target round-trips
+ */
+TEST_F(LoRaDeltaSyncTest, EmptyTargetRoundTrips) {
+    QByteArray delta;
+    EXPECT_TRUE(roundTrip(makeConfig(1000), QByteArray(), delta));
+}
+
+/**
+ * @test Verify a delta applied to the wrong base is rejected
+ */
+TEST_F(LoRaDeltaSyncTest, WrongBaseIsRejected) {
+    const QByteArray base = makeConfig(4000);
+    QByteArray target = base;
+    target[2000] = 'X';
+
+    const QByteArray delta = LoRaDeltaSync::makeDelta(LoRaDeltaSync::makeSignature(base), target);
+    QByteArray otherBase = base;
+    otherBase[100] = 'Y';
+
+    QByteArray rebuilt;
+    EXPECT_FALSE(LoRaDeltaSync::applyDelta(otherBase, delta, rebuilt));
+}
+
+/**
+ * @test Verify malformed signatures and deltas are rejected
+ */
+TEST_F(LoRaDeltaSyncTest, MalformedInputIsRejected) {
+    QByteArray rebuilt;
+    EXPECT_TRUE(LoRaDeltaSync::makeDelta(QByteArray("garbage"), QByteArray("x")).isEmpty());
+    EXPECT_FALSE(LoRaDeltaSync::applyDelta(QByteArray("base"), QByteArray("garbage"), rebuilt));
+
+    QByteArray delta = LoRaDeltaSync::makeDelta(LoRaDeltaSync::makeSignature(makeConfig(1000)), makeConfig(1200));
+    delta.chop(3);
+    EXPECT_FALSE(LoRaDeltaSync::applyDelta(makeConfig(1000), delta, rebuilt));
+}
+
+/**
+ * @test Verify deltas with sizes or block ranges out of all proportion are rejected
+ */
+TEST_F(LoRaDeltaSyncTest, OversizedDeltaIsRejected) {
+    const QByteArray base = makeConfig(1000);
+    QByteArray rebuilt;
+
+    // A target size of 4 GiB is rejected without allocating it
+    QByteArray delta = deltaHeader(64, 0xFFFFFFFFu);
+    delta.append('\x02');
+    appendVarint(delta, 3);
+    delta.append("abc");
+    EXPECT_FALSE(LoRaDeltaSync::applyDelta(base, delta, rebuilt));
+
+    // first * blockSize and count * blockSize would overflow 64 bits
+    const std::pair<quint32, quint32> ranges[] = {{0xFFFFFFFFu, 1}, {0, 0xFFFFFFFFu}};
+    for (const auto &[first, count] : ranges) {
+        delta = deltaHeader(0xFFFFFFFFu, 1000);
+        delta.append('\x01');
+        appendVarint(delta, first);
+        appendVarint(delta, count);
+        EXPECT_FALSE(LoRaDeltaSync::applyDelta(base, delta, rebuilt));
+    }
+
+    // A block range past the end of the base
+    delta = deltaHeader(64, 1000);
+    delta.append('\x01');
+    appendVarint(delta, 15);
+    appendVarint(delta, 2);
+    EXPECT_FALSE(LoRaDeltaSync::applyDelta(base, delta, rebuilt));
+}
+
+/**
+ * @test Verify signatures whose base size does not match their blocks are rejected
+ */
+TEST_F(LoRaDeltaSyncTest, MalformedSignatureIsRejected) {
+    const QByteArray target("x");
+
+    // baseSize + blockSize - 1 would wrap to zero blocks in 32 bits
+    QByteArray signature("S");
+    appendVarint(signature, 2);
+    appendVarint(signature, 0xFFFFFFFFu);
+    EXPECT_TRUE(LoRaDeltaSync::makeDelta(signature, target).isEmpty());
+
+    // Far more blocks than entries; the expected size would overflow an int
+    signature = "S";
+    appendVarint(signature, 1);
+    appendVarint(signature, 0x7FFFFFFFu);
+    signature.append(QByteArray(6, '\0'));
+    EXPECT_TRUE(LoRaDeltaSync::makeDelta(signature, target).isEmpty());
+
+    // A consistent signature of an empty base is still accepted
+    signature = "S";
+    appendVarint(signature, 2);
+    appendVarint(signature, 0);
+    EXPECT_FALSE(LoRaDeltaSync::makeDelta(signature, target).isEmpty());
+}
+
+/**
+ * @test Verify the rolling checksum matches a direct computation at every offset
+ */
+TEST_F(LoRaDeltaSyncTest, WeakChecksumIsPositionIndependent) {
+    const QByteArray data = makeConfig(300);
+    const QByteArray block = data.mid(77, 64);
+
+    EXPECT_EQ(LoRaDeltaSync::weakChecksum(block.constData(), block.size()),
+              LoRaDeltaSync::weakChecksum(data.constData() + 77, 64));
+}
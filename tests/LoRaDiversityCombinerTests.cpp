@@ -0,0 +1,82 @@
+/**
+ * @file LoRaDiversityCombinerTests.cpp
+ * @brief Unit tests for LoRaDiversityCombiner
+ * @date 2026-10-19
+ *
+ * This file contains unit tests for the receive diversity combiner:
+ * - accept(): first copy passed, later copies within the window dropped
+ * - accept(): byte-identical retransmissions after the window passed again
+ * - stats(): frames heard, contributed first and heard exclusively
+ *
+ * Times are passed explicitly, so no test waits.
+ */
+
+#include <gtest/gtest.h>
+#include "../src/LoRaDiversityCombiner.hpp"
+
+/**
+ * @class LoRaDiversityCombinerTest
+ * @brief Test suite for the diversity combiner
+ */
+class LoRaDiversityCombinerTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Combiner being tested, with a 100 ms window
+     */
+    LoRaDiversityCombiner combiner{100};
+};
+
+/**
+ * @test Verify only the first copy of a frame is passed
+ */
+TEST_F(LoRaDiversityCombinerTest, FirstCopyWins) {
+    EXPECT_TRUE(combiner.accept("frame-a", 1, 0));
+    EXPECT_FALSE(combiner.accept("frame-a", 0, 20));
+    EXPECT_FALSE(combiner.accept("frame-a", 2, 40));
+    EXPECT_TRUE(combiner.accept("frame-b", 0, 50));
+
+    const QVector<LoRaDiversityCombiner::AntennaStats> stats = combiner.stats();
+    ASSERT_EQ(stats.size(), 3);
+    EXPECT_EQ(stats[0].framesHeard, 2u);
+    EXPECT_EQ(stats[0].framesFirst, 1u);
+    EXPECT_EQ(stats[1].framesHeard, 1u);
+    EXPECT_EQ(stats[1].framesFirst, 1u);
+    EXPECT_EQ(stats[2].framesFirst, 0u);
+}
+
+/**
+ * @test Verify a retransmission after the window is passed again
+ */
+TEST_F(LoRaDiversityCombinerTest, RetransmissionAfterWindowPasses) {
+    EXPECT_TRUE(combiner.accept("frame", 0, 0));
+    EXPECT_FALSE(combiner.accept("frame", 1, 99));
+    EXPECT_TRUE(combiner.accept("frame", 1, 300));
+}
+
+/**
+ * @test Verify frames heard by one antenna only are counted once their window passed
+ */
+TEST_F(LoRaDiversityCombinerTest, ExclusiveFramesCounted) {
+    combiner.accept("both", 0, 0);
+    combiner.accept("both", 1, 10);
+    combiner.accept("only-1", 1, 20);
+    EXPECT_EQ(combiner.stats()[1].framesExclusive, 0u);
+
+    combiner.accept("later", 0, 500);
+    const QVector<LoRaDiversityCombiner::AntennaStats> stats = combiner.stats();
+    EXPECT_EQ(stats[0].framesExclusive, 0u);
+    EXPECT_EQ(stats[1].framesExclusive, 1u);
+}
+
+/**
+ * @test Verify reset() forgets recent frames and statistics
+ */
+TEST_F(LoRaDiversityCombinerTest, ResetClearsState) {
+    combiner.accept("frame", 0, 0);
+    combiner.reset();
+
+    EXPECT_TRUE(combiner.stats().isEmpty());
+    EXPECT_TRUE(combiner.accept("frame", 1, 10));
+    EXPECT_TRUE(combiner.accept("frame", LoRaDiversityCombiner::MAX_ANTENNAS, 20));
+    EXPECT_EQ(combiner.stats().size(), 2);
+}
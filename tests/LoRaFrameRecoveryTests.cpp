@@ -0,0 +1,138 @@
+/**
+ * @file LoRaFrameRecoveryTests.cpp
+ * @brief Unit tests for LoRaFrameRecovery
+ * @date 2026-10-19
+ *
+ * This file contains unit tests for the recovery of damaged frames:
+ * - recover(): majority vote with tied bytes tried both ways
+ * - recover(): bit flips where the copies disagree with the vote
+ * - recover(): a single copy is never repaired, ambiguous results are rejected
+ * - frameReceived() and the maximum age: kept copies are dropped
+ *
+ * The validator checks a trailing CRC-8 with the adapter's polynomial.
+ */
+
+#include <gtest/gtest.h>
+#include "../src/LoRaFrameRecovery.hpp"
+
+/**
+ * @class LoRaFrameRecoveryTest
+ * @brief Test suite for the frame recovery
+ */
+class LoRaFrameRecoveryTest : public ::testing::Test {
+protected:
+    /**
+     * @brief CRC-8, polynomial 0x31, initial value 0
+     */
+    static quint8 crc8(const QByteArray &data) {
+        quint8 crc = 0;
+        for (quint8 byte : data) {
+            crc ^= byte;
+            for (int i = 0; i < 8; ++i) {
+                crc = (crc & 0x80) ? static_cast<quint8>((crc << 1) ^ 0x31) : static_cast<quint8>(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief Returns true if the last byte is the CRC of the others
+     */
+    static bool hasValidCrc(const QByteArray &frame) {
+        if (frame.size() < 2) return false;
+
+        return crc8(frame.left(frame.size() - 1)) == static_cast<quint8>(frame.at(frame.size() - 1));
+    }
+
+    /**
+     * @brief Returns a copy of the frame with the bits of mask flipped in one byte
+     */
+    static QByteArray damage(QByteArray frame, int pos, quint8 mask) {
+        frame[pos] = static_cast<char>(frame[pos] ^ mask);
+        return frame;
+    }
+
+    void SetUp() override {
+        original = QByteArray::fromHex("100100030000066c6f726121");
+        original.append(static_cast<char>(crc8(original)));
+        recovery.setValidator(&LoRaFrameRecoveryTest::hasValidCrc);
+    }
+
+    /**
+     * @brief Frame as sent, 14 bytes including the CRC
+     */
+    QByteArray original;
+
+    /**
+     * @brief Recovery being tested
+     */
+    LoRaFrameRecovery recovery;
+};
+
+/**
+ * @test Verify two copies damaged in different bytes are combined by the vote
+ */
+TEST_F(LoRaFrameRecoveryTest, VoteCombinesCopies) {
+    EXPECT_TRUE(recovery.recover(damage(original, 2, 0x04), 0).isEmpty());
+    EXPECT_EQ(recovery.size(), 1);
+
+    EXPECT_EQ(recovery.recover(damage(original, 9, 0x10), 10), original);
+    EXPECT_EQ(recovery.size(), 0);
+    EXPECT_EQ(recovery.stats().offered, 2u);
+    EXPECT_EQ(recovery.stats().recoveredByVote, 1u);
+    EXPECT_EQ(recovery.stats().recoveredByBitFlip, 0u);
+}
+
+/**
+ * @test Verify an error shared by the majority is found by flipping disagreeing bits
+ */
+TEST_F(LoRaFrameRecoveryTest, BitFlipFixesSharedError) {
+    const QByteArray shared = damage(original, 8, 0x01);
+    EXPECT_TRUE(recovery.recover(shared, 0).isEmpty());
+    EXPECT_TRUE(recovery.recover(shared, 1).isEmpty());
+
+    EXPECT_EQ(recovery.recover(damage(original, 5, 0x20), 2), original);
+    EXPECT_EQ(recovery.stats().recoveredByVote, 0u);
+    EXPECT_EQ(recovery.stats().recoveredByBitFlip, 1u);
+    EXPECT_EQ(recovery.size(), 0);
+}
+
+/**
+ * @test Verify a single damaged copy is kept but not repaired
+ */
+TEST_F(LoRaFrameRecoveryTest, SingleCopyNotRepaired) {
+    EXPECT_TRUE(recovery.recover(damage(original, 4, 0x80), 0).isEmpty());
+    EXPECT_TRUE(recovery.recover(original.left(10), 0).isEmpty());
+    EXPECT_EQ(recovery.size(), 2);
+    EXPECT_EQ(recovery.stats().recoveredByVote + recovery.stats().recoveredByBitFlip, 0u);
+}
+
+/**
+ * @test Verify nothing is returned when more than one candidate is valid
+ */
+TEST_F(LoRaFrameRecoveryTest, AmbiguousResultRejected) {
+    recovery.setValidator([](const QByteArray &) { return true; });
+
+    recovery.recover(damage(original, 3, 0x02), 0);
+    EXPECT_TRUE(recovery.recover(damage(original, 3, 0x40), 1).isEmpty());
+    EXPECT_EQ(recovery.stats().ambiguous, 1u);
+    EXPECT_EQ(recovery.size(), 2);
+}
+
+/**
+ * @test Verify kept copies are dropped when the frame arrives intact or gets too old
+ */
+TEST_F(LoRaFrameRecoveryTest, CopiesDropped) {
+    recovery.recover(damage(original, 2, 0x04), 0);
+    recovery.frameReceived(original);
+    EXPECT_EQ(recovery.size(), 0);
+
+    recovery.setMaxAge(100);
+    recovery.recover(damage(original, 2, 0x04), 0);
+    EXPECT_TRUE(recovery.recover(damage(original, 9, 0x10), 101).isEmpty());
+    EXPECT_EQ(recovery.size(), 1);
+
+    recovery.clear();
+    EXPECT_EQ(recovery.size(), 0);
+    EXPECT_EQ(recovery.stats().offered, 0u);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file LoRaGf256Tests.cpp
+ * @brief Unit tests for LoRaGf256
+ * @date 2026-10-19
+ *
+ * This file contains unit tests for the GF(256) arithmetic:
+ * - mul(), div(), exp() and log(): field identities
+ * - mulRegion() and mulAddRegion(): every kernel the CPU supports matches a
+ *   shift-and-add reference for all constants, odd sizes and offsets
+ * - setKernel(): unsupported kernels are rejected
+ */
+
+#include <gtest/gtest.h>
+#include <QByteArray>
+#include <QRandomGenerator>
+#include "../src/LoRaGf256.hpp"
+
+/**
+ * @class LoRaGf256Test
+ * @brief Test suite for the field arithmetic and the region kernels
+ */
+class LoRaGf256Test : public ::testing::Test {
+protected:
+    /**
+     * @brief Remembers the kernel selected on start
+     */
+    void SetUp() override {
+        defaultKernel = LoRaGf256::kernel();
+    }
+
+    /**
+     * @brief Restores the kernel selected on start
+     */
+    void TearDown() override {
+        LoRaGf256::setKernel(defaultKernel);
+    }
+
+    /**
+     * @brief Multiplies by shifting and adding, reducing by 0x11D
+     */
+    static quint8 referenceMul(quint8 a, quint8 b) {
+        int product = 0;
+        int x = a;
+        for (int bit = 0; bit < 8; ++bit) {
+            if (b & (1 << bit)) product ^= x;
+            x <<= 1;
+            if (x & 0x100) x ^= 0x11D;
+        }
+        return static_cast<quint8>(product);
+    }
+
+    /**
+     * @brief Returns random bytes of the given size
+     */
+    QByteArray randomData(int size) {
+        QByteArray data(size, '\0');
+        for (int i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(rng.bounded(256));
+        }
+        return data;
+    }
+
+    /**
+     * @brief Kernel selected before the test
+     */
+    LoRaGf256::Kernel defaultKernel = LoRaGf256::Kernel::Scalar;
+
+    /**
+     * @brief Seeded generator for the data
+     */
+    QRandomGenerator rng{42};
+};
+
+/**
+ * @test Verify the scalar operations against the reference and each other
+ */
+TEST_F(LoRaGf256Test, FieldIdentities) {
+    for (int a = 0; a < 256; ++a) {
+        for (int b = 0; b < 256; ++b) {
+            const quint8 product = LoRaGf256::mul(static_cast<quint8>(a), static_cast<quint8>(b));
+            ASSERT_EQ(product, referenceMul(static_cast<quint8>(a), static_cast<quint8>(b)));
+            if (b != 0) {
+                ASSERT_EQ(LoRaGf256::div(product, static_cast<quint8>(b)), a);
+            }
+        }
+    }
+    for (int i = 0; i < 255; ++i) {
+        EXPECT_EQ(LoRaGf256::log(LoRaGf256::exp(i)), i);
+    }
+    EXPECT_EQ(LoRaGf256::exp(-1), LoRaGf256::exp(254));
+    EXPECT_EQ(LoRaGf256::exp(255), 1);
+}
+
+/**
+ * @test Verify every supported kernel against the reference
+ */
+TEST_F(LoRaGf256Test, KernelsMatchReference) {
+    const QByteArray source = randomData(80);
+    const QByteArray initial = randomData(80);
+    for (LoRaGf256::Kernel kernel : {LoRaGf256::Kernel::Scalar, LoRaGf256::Kernel::Ssse3,
+                                     LoRaGf256::Kernel::Avx2, LoRaGf256::Kernel::Neon}) {
+        if (!LoRaGf256::setKernel(kernel)) continue;
+
+        for (int c = 0; c < 256; ++c) {
+            // Sizes around the 16 and 32 byte steps, at unaligned offsets
+            for (int size : {0, 1, 15, 16, 17, 24, 31, 32, 33, 63, 64, 77}) {
+                const int offset = (c + size) % 3;
+                const auto *src = reinterpret_cast<const quint8 *>(source.constData()) + offset;
+
+                QByteArray product = initial;
+                QByteArray sum = initial;
+                auto *productBytes = reinterpret_cast<quint8 *>(product.data()) + offset;
+                auto *sumBytes = reinterpret_cast<quint8 *>(sum.data()) + offset;
+                LoRaGf256::mulRegion(productBytes, src, static_cast<quint8>(c), size);
+                LoRaGf256::mulAddRegion(sumBytes, src, static_cast<quint8>(c), size);
+
+                for (int i = 0; i < product.size(); ++i) {
+                    const bool inRegion = i >= offset && i < offset + size;
+                    const quint8 expected = referenceMul(static_cast<quint8>(source[i]), static_cast<quint8>(c));
+                    const quint8 before = static_cast<quint8>(initial[i]);
+                    ASSERT_EQ(static_cast<quint8>(product[i]), inRegion ? expected : before)
+                        << LoRaGf256::kernelName(kernel) << " c " << c << " size " << size << " at " << i;
+                    ASSERT_EQ(static_cast<quint8>(sum[i]), inRegion ? static_cast<quint8>(before ^ expected) : before)
+                        << LoRaGf256::kernelName(kernel) << " c " << c << " size " << size << " at " << i;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @test Verify multiplying a region in place
+ */
+TEST_F(LoRaGf256Test, MulRegionInPlace) {
+    const QByteArray data = randomData(100);
+    QByteArray region = data;
+    auto *bytes = reinterpret_cast<quint8 *>(region.data());
+    LoRaGf256::mulRegion(bytes, bytes, 0x53, region.size());
+    for (int i = 0; i < data.size(); ++i) {
+        EXPECT_EQ(static_cast<quint8>(region[i]), referenceMul(static_cast<quint8>(data[i]), 0x53));
+    }
+}
+
+/**
+ * @test Verify the scalar kernel is always available and others only where supported
+ */
+TEST_F(LoRaGf256Test, KernelSelection) {
+    EXPECT_TRUE(LoRaGf256::isSupported(LoRaGf256::Kernel::Scalar));
+    EXPECT_TRUE(LoRaGf256::isSupported(defaultKernel));
+    EXPECT_FALSE(LoRaGf256::isSupported(LoRaGf256::Kernel::Ssse3) &&
+                 LoRaGf256::isSupported(LoRaGf256::Kernel::Neon));
+
+    EXPECT_TRUE(LoRaGf256::setKernel(LoRaGf256::Kernel::Scalar));
+    EXPECT_EQ(LoRaGf256::kernel(), LoRaGf256::Kernel::Scalar);
+    for (LoRaGf256::Kernel kernel : {LoRaGf256::Kernel::Ssse3, LoRaGf256::Kernel::Avx2, LoRaGf256::Kernel::Neon}) {
+        if (!LoRaGf256::isSupported(kernel)) {
+            EXPECT_FALSE(LoRaGf256::setKernel(kernel));
+            EXPECT_EQ(LoRaGf256::kernel(), LoRaGf256::Kernel::Scalar);
+        }
+    }
+    EXPECT_STREQ(LoRaGf256::kernelName(LoRaGf256::Kernel::Avx2), "avx2");
+}
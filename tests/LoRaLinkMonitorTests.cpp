@@ -0,0 +1,118 @@
+/**
+ * @file LoRaLinkMonitorTests.cpp
+ * @brief Unit tests for LoRaLinkMonitor
+ * @date 2026-10-18
+ *
+ * This file contains unit tests for the link liveness state machine:
+ * - frameReceived(): piggybacked liveness
+ * - responseMissed(): transition to the Down state
+ * - setProbeIntervals(): interval bounds
+ *
+ * The probe timer is not driven here; only the transitions triggered
+ * directly by the owner are tested.
+ */
+
+#include <gtest/gtest.h>
+#include <QSignalSpy>
+#include "../src/LoRaLinkMonitor.hpp"
+
+/**
+ * @class LoRaLinkMonitorTest
+ * @brief Test suite for the link liveness monitor
+ */
+class LoRaLinkMonitorTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Monitor being tested
+     */
+    LoRaLinkMonitor monitor;
+};
+
+/**
+ * @test Verify a stopped monitor ignores traffic and never blocks sends
+ */
+TEST_F(LoRaLinkMonitorTest, StoppedMonitorIgnoresEvents) {
+    QSignalSpy downSpy(&monitor, &LoRaLinkMonitor::linkDown);
+
+    for (int i = 0; i < LoRaLinkMonitor::MISSED_LIMIT; ++i) {
+        monitor.responseMissed();
+    }
+
+    EXPECT_FALSE(monitor.isRunning());
+    EXPECT_TRUE(monitor.isUp());
+    EXPECT_EQ(downSpy.count(), 0);
+}
+
+/**
+ * @test Verify the first frame heard brings the link up
+ */
+TEST_F(LoRaLinkMonitorTest, FrameBringsLinkUp) {
+    QSignalSpy upSpy(&monitor, &LoRaLinkMonitor::linkUp);
+    monitor.start();
+    EXPECT_EQ(monitor.state(), LoRaLinkMonitor::State::Unknown);
+    EXPECT_TRUE(monitor.isUp());
+
+    monitor.frameReceived();
+    monitor.frameReceived();
+
+    EXPECT_EQ(monitor.state(), LoRaLinkMonitor::State::Up);
+    EXPECT_EQ(upSpy.count(), 1);
+}
+
+/**
+ * @test Verify the link goes down after MISSED_LIMIT consecutive misses only
+ */
+TEST_F(LoRaLinkMonitorTest, ConsecutiveMissesBringLinkDown) {
+    QSignalSpy downSpy(&monitor, &LoRaLinkMonitor::linkDown);
+    monitor.start();
+    monitor.frameReceived();
+
+    for (int i = 0; i < LoRaLinkMonitor::MISSED_LIMIT - 1; ++i) {
+        monitor.responseMissed();
+    }
+    EXPECT_TRUE(monitor.isUp());
+
+    // A frame in between resets the count
+    monitor.frameReceived();
+    for (int i = 0; i < LoRaLinkMonitor::MISSED_LIMIT - 1; ++i) {
+        monitor.responseMissed();
+    }
+    EXPECT_TRUE(monitor.isUp());
+
+    monitor.responseMissed();
+    EXPECT_FALSE(monitor.isUp());
+    EXPECT_EQ(monitor.state(), LoRaLinkMonitor::State::Down);
+    EXPECT_EQ(downSpy.count(), 1);
+}
+
+/**
+ * @test Verify a frame after the link went down brings it back up
+ */
+TEST_F(LoRaLinkMonitorTest, RecoversWhenPeerIsHeard) {
+    QSignalSpy upSpy(&monitor, &LoRaLinkMonitor::linkUp);
+    monitor.start();
+    for (int i = 0; i < LoRaLinkMonitor::MISSED_LIMIT; ++i) {
+        monitor.responseMissed();
+    }
+    ASSERT_FALSE(monitor.isUp());
+
+    monitor.frameReceived();
+    EXPECT_TRUE(monitor.isUp());
+    EXPECT_EQ(upSpy.count(), 1);
+}
+
+/**
+ * @test Verify misses reset the probe interval to the minimum
+ */
+TEST_F(LoRaLinkMonitorTest, ProbeIntervalStaysWithinBounds) {
+    monitor.setProbeIntervals(100, 50);
+    monitor.start();
+    EXPECT_EQ(monitor.probeInterval(), 100);
+
+    monitor.responseMissed();
+    EXPECT_EQ(monitor.probeInterval(), 100);
+
+    monitor.setProbeIntervals(200, 800);
+    EXPECT_GE(monitor.probeInterval(), 200);
+    EXPECT_LE(monitor.probeInterval(), 800);
+}
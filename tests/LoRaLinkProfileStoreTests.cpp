@@ -0,0 +1,147 @@
+/**
+ * @file LoRaLinkProfileStoreTests.cpp
+ * @brief Unit tests for LoRaLinkProfileStore
+ * @date 2026-10-18
+ *
+ * This file contains unit tests for persisted link profiles:
+ * - save() and load(): file round trip
+ * - profile(): aging and expiry
+ * - load(): rejection of malformed files
+ */
+
+#include <gtest/gtest.h>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include "../src/LoRaLinkProfileStore.hpp"
+
+/**
+ * @class LoRaLinkProfileStoreTest
+ * @brief Test suite for the link profile store
+ */
+class LoRaLinkProfileStoreTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Creates a profile learned at the given time
+     */
+    LoRaLinkProfile makeProfile(qint64 updatedAtSecs) {
+        LoRaLinkProfile p;
+        p.srttMs = 400;
+        p.rttVarMs = 40;
+        p.rttSamples = 100;
+        p.chunkSize = 16;
+        p.airRateBps = 2400;
+        p.rssiBaselineDbm = -92;
+        p.updatedAtSecs = updatedAtSecs;
+        return p;
+    }
+
+    /**
+     * @brief Directory for profile files
+     */
+    QTemporaryDir dir;
+};
+
+/**
+ * @test Verify profiles survive a save/load round trip
+ */
+TEST_F(LoRaLinkProfileStoreTest, SaveAndLoadRoundTrip) {
+    const QString path = dir.filePath("profiles.bin");
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    LoRaLinkProfileStore store(path);
+    store.setProfile("/dev/ttyUSB0", makeProfile(now));
+    store.setProfile("/dev/ttyUSB1", makeProfile(now));
+    ASSERT_TRUE(store.save());
+
+    LoRaLinkProfileStore reloaded(path);
+    ASSERT_TRUE(reloaded.load());
+    EXPECT_EQ(reloaded.size(), 2);
+
+    const LoRaLinkProfile p = reloaded.profile("/dev/ttyUSB0", now);
+    EXPECT_TRUE(p.isValid());
+    EXPECT_EQ(p.srttMs, 400u);
+    EXPECT_EQ(p.rttVarMs, 40u);
+    EXPECT_EQ(p.chunkSize, 16);
+    EXPECT_EQ(p.airRateBps, 2400u);
+    EXPECT_EQ(p.rssiBaselineDbm, -92);
+}
+
+/**
+ * @test Verify a missing file is not an error
+ */
+TEST_F(LoRaLinkProfileStoreTest, MissingFileLoadsEmpty) {
+    LoRaLinkProfileStore store(dir.filePath("absent.bin"));
+    EXPECT_TRUE(store.load());
+    EXPECT_EQ(store.size(), 0);
+    EXPECT_FALSE(store.profile("peer").isValid());
+}
+
+/**
+ * @test Verify older profiles get a wider RTT variation and fewer samples
+ */
+TEST_F(LoRaLinkProfileStoreTest, ProfilesAgeWithTime) {
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    LoRaLinkProfileStore store;
+    store.setProfile("peer", makeProfile(now - LoRaLinkProfileStore::DEFAULT_HALF_LIFE_SECS));
+
+    const LoRaLinkProfile p = store.profile("peer", now);
+    EXPECT_EQ(p.srttMs, 400u);
+    EXPECT_EQ(p.rttSamples, 50u);
+    EXPECT_EQ(p.rttVarMs, 220u);
+    EXPECT_EQ(p.chunkSize, 16);
+}
+
+/**
+ * @test Verify profiles past the maximum age are ignored
+ */
+TEST_F(LoRaLinkProfileStoreTest, ExpiredProfilesAreDropped) {
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    LoRaLinkProfileStore store;
+    store.setAging(3600, 7200);
+    store.setProfile("peer", makeProfile(now - 7201));
+
+    EXPECT_FALSE(store.profile("peer", now).isValid());
+}
+
+/**
+ * @test Verify a malformed file is rejected
+ */
+TEST_F(LoRaLinkProfileStoreTest, MalformedFileIsRejected) {
+    const QString path = dir.filePath("garbage.bin");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("not a profile file");
+    file.close();
+
+    LoRaLinkProfileStore store(path);
+    EXPECT_FALSE(store.load());
+    EXPECT_EQ(store.size(), 0);
+}
+
+/**
+ * @test Verify the peer's capabilities are cached with its profile
+ */
+TEST_F(LoRaLinkProfileStoreTest, CapabilitiesRoundTrip) {
+    const QString path = dir.filePath("profiles.bin");
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    LoRaLinkProfile p = makeProfile(now);
+    p.peerCapabilities.version = LoRaCapabilities::PROTOCOL_VERSION;
+    p.peerCapabilities.features = LoRaCapabilities::DEDUP;
+    p.peerCapabilities.maxPayload = 20;
+    p.peerCapabilities.nodeId = 0x12345678;
+
+    LoRaLinkProfileStore store(path);
+    store.setProfile("node:12345678", p);
+    store.setProfile("legacy", makeProfile(now));
+    ASSERT_TRUE(store.save());
+
+    LoRaLinkProfileStore reloaded(path);
+    ASSERT_TRUE(reloaded.load());
+    const LoRaCapabilities caps = reloaded.profile("node:12345678", now).peerCapabilities;
+    EXPECT_TRUE(caps.has(LoRaCapabilities::DEDUP));
+    EXPECT_EQ(caps.maxPayload, 20);
+    EXPECT_EQ(caps.nodeId, 0x12345678u);
+    EXPECT_TRUE(reloaded.profile("legacy", now).peerCapabilities.isLegacy());
+}
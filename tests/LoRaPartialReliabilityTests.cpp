@@ -0,0 +1,260 @@
+/**
+ * @file LoRaPartialReliabilityTests.cpp
+ * @brief Behavioural tests of partial reliability in LoRaUsbAdapter_E22_400T22U
+ * @date 2026-10-19
+ *
+ * This file contains tests of packets with a lifetime (see setPortLifetime()):
+ * - queued packets that expire before they go on the air
+ * - the rest of a packet abandoned with one SKIP once its deadline passes
+ * - a single chunk abandoned after MAX_RETRIES
+ * - SKIP frames validated by the receiver
+ * - abandoned chunks zero-filled at their offset, with the hole map of
+ *   packetReceivedPartial()
+ *
+ * The adapter writes to a pseudo-terminal (see LoRaPtyPeer); the test plays
+ * the peer, passing crafted frames to receiveFrame() and firing
+ * retransmission timeouts itself.
+ */
+
+#include <gtest/gtest.h>
+#include <QBitArray>
+#include <QByteArray>
+#include <QSignalSpy>
+#include <QThread>
+#include <memory>
+#include "LoRaPtyPeer.hpp"
+
+/**
+ * @class LoRaPartialReliabilityTest
+ * @brief Test suite for abandoned chunks, on the sending and receiving side
+ */
+class LoRaPartialReliabilityTest : public ::testing::Test {
+protected:
+    using Adapter = LoRaUsbAdapter_E22_400T22U;
+    using FrameType = Adapter::FrameType;
+
+    /**
+     * @brief Port used by the tests
+     */
+    static constexpr quint8 PORT = 2;
+
+    /**
+     * @brief Retransmissions of a chunk before it is given up on (the adapter's MAX_RETRIES)
+     */
+    static constexpr int MAX_RETRIES = 5;
+
+    /**
+     * @brief Creates the adapter and completes its handshake
+     */
+    void SetUp() override {
+        if (!peer.isOpen()) {
+            GTEST_SKIP() << "No pseudo-terminal available";
+        }
+        adapter = std::make_unique<Adapter>(peer.serial());
+        adapter->setAckDelay(0);
+        LoRaPtyPeer::handshake(*adapter);
+        // Drops the HELLO_ACK
+        peer.readFrames();
+    }
+
+    /**
+     * @brief Passes a frame from the peer to the adapter
+     */
+    void receive(FrameType type, quint16 seq, quint32 total, const QByteArray &payload = {}) {
+        adapter->receiveFrame(LoRaPtyPeer::frame(type, seq, total, payload, PORT));
+    }
+
+    /**
+     * @brief Fires the retransmission timeout of PORT
+     */
+    void timeout() {
+        QMetaObject::invokeMethod(adapter.get(), "onSendTimeout", Qt::DirectConnection, Q_ARG(quint8, PORT));
+    }
+
+    /**
+     * @brief Checks that a frame has the given type, port and sequence number
+     */
+    static void expectFrame(const QByteArray &frame, FrameType type, quint16 seq) {
+        quint8 port = 0;
+        EXPECT_EQ(LoRaPtyPeer::typeOf(frame, &port), type);
+        EXPECT_EQ(port, PORT);
+        EXPECT_EQ(LoRaPtyPeer::seqOf(frame), seq);
+    }
+
+    /**
+     * @brief The far end; declared first, so it outlives the adapter
+     */
+    LoRaPtyPeer peer;
+
+    /**
+     * @brief Adapter under test
+     */
+    std::unique_ptr<Adapter> adapter;
+};
+
+/**
+ * @test Verify the rest of a stale packet is abandoned with one SKIP, and stale queued packets are dropped
+ */
+TEST_F(LoRaPartialReliabilityTest, StalePacketsAreAbandoned) {
+    QSignalSpy sentSpy(adapter.get(), &Adapter::packetSent);
+    adapter->setPortLifetime(PORT, 20);
+
+    adapter->sendPacket(QByteArray(60, 'x'), PORT);
+    adapter->sendPacket(QByteArray(10, 'y'), PORT);
+    QList<QByteArray> frames = peer.readFrames();
+    ASSERT_EQ(frames.size(), 1);
+    expectFrame(frames[0], FrameType::DATA, 0);
+
+    QThread::msleep(40);
+    receive(FrameType::ACK, 0, 3);
+    frames = peer.readFrames();
+    ASSERT_EQ(frames.size(), 1);
+    expectFrame(frames[0], FrameType::SKIP, 1);
+    EXPECT_EQ(LoRaPtyPeer::payloadOf(frames[0]), LoRaPtyPeer::skipPayload(2, 24, 60));
+    EXPECT_EQ(sentSpy.count(), 0);
+
+    // The queued packet expired while waiting and never goes on the air
+    receive(FrameType::ACK, 1, 3);
+    EXPECT_TRUE(peer.readFrames().isEmpty());
+    ASSERT_EQ(sentSpy.count(), 2);
+    for (const QList<QVariant> &args : sentSpy) {
+        EXPECT_FALSE(args.at(0).toBool());
+        EXPECT_EQ(args.at(1).toInt(), PORT);
+    }
+    EXPECT_EQ(adapter->metrics().chunksAbandoned, 2u);
+    EXPECT_FALSE(adapter->isSending(PORT));
+}
+
+/**
+ * @test Verify a chunk is abandoned after MAX_RETRIES and the rest of the packet still sent
+ */
+TEST_F(LoRaPartialReliabilityTest, ChunkAbandonedAfterMaxRetries) {
+    QSignalSpy sentSpy(adapter.get(), &Adapter::packetSent);
+    adapter->setPortLifetime(PORT, 60000);
+
+    adapter->sendPacket(QByteArray(60, 'x'), PORT);
+    QList<QByteArray> frames = peer.readFrames();
+    ASSERT_EQ(frames.size(), 1);
+    expectFrame(frames[0], FrameType::DATA, 0);
+
+    for (int i = 0; i < MAX_RETRIES; ++i) {
+        timeout();
+        frames = peer.readFrames();
+        ASSERT_EQ(frames.size(), 1);
+        expectFrame(frames[0], FrameType::DATA, 0);
+    }
+
+    timeout();
+    frames = peer.readFrames();
+    ASSERT_EQ(frames.size(), 1);
+    expectFrame(frames[0], FrameType::SKIP, 0);
+    EXPECT_EQ(LoRaPtyPeer::payloadOf(frames[0]), LoRaPtyPeer::skipPayload(1, 24, 60));
+
+    for (quint16 seq = 0; seq < 2; ++seq) {
+        receive(FrameType::ACK, seq, 3);
+        frames = peer.readFrames();
+        ASSERT_EQ(frames.size(), 1);
+        expectFrame(frames[0], FrameType::DATA, seq + 1);
+    }
+    EXPECT_EQ(sentSpy.count(), 0);
+
+    receive(FrameType::ACK, 2, 3);
+    ASSERT_EQ(sentSpy.count(), 1);
+    EXPECT_FALSE(sentSpy.at(0).at(0).toBool());
+    EXPECT_EQ(adapter->metrics().chunksAbandoned, 1u);
+    EXPECT_EQ(adapter->metrics().retransmissions, static_cast<quint64>(MAX_RETRIES));
+}
+
+/**
+ * @test Verify malformed SKIP frames are rejected without an ACK
+ */
+TEST_F(LoRaPartialReliabilityTest, SkipValidated) {
+    QSignalSpy errorSpy(adapter.get(), &Adapter::error);
+    QSignalSpy partialSpy(adapter.get(), &Adapter::packetReceivedPartial);
+
+    struct Invalid {
+        quint16 seq;
+        quint32 total;
+        QByteArray payload;
+    };
+    const Invalid invalid[] = {
+        {0, 3, LoRaPtyPeer::skipPayload(1, 10, 25).left(5)}, // Short payload
+        {0, 3, LoRaPtyPeer::skipPayload(0, 10, 25)},         // Nothing skipped
+        {2, 3, LoRaPtyPeer::skipPayload(2, 10, 25)},         // Beyond the last chunk
+        {0, 3, LoRaPtyPeer::skipPayload(1, 0, 25)},          // No chunk size
+        {0, 3, LoRaPtyPeer::skipPayload(1, 10, 35)},         // Packet size of four chunks
+        {0, 0, LoRaPtyPeer::skipPayload(1, 10, 25)},         // Empty packet
+    };
+    for (const Invalid &skip : invalid) {
+        receive(FrameType::SKIP, skip.seq, skip.total, skip.payload);
+    }
+    EXPECT_EQ(errorSpy.count(), static_cast<int>(sizeof(invalid) / sizeof(invalid[0])));
+    EXPECT_TRUE(peer.readFrames().isEmpty());
+
+    errorSpy.clear();
+    receive(FrameType::SKIP, 0, 3, LoRaPtyPeer::skipPayload(1, 10, 25));
+    EXPECT_EQ(errorSpy.count(), 0);
+    const QList<QByteArray> frames = peer.readFrames();
+    ASSERT_EQ(frames.size(), 1);
+    expectFrame(frames[0], FrameType::ACK, 0);
+    EXPECT_EQ(partialSpy.count(), 0);
+}
+
+/**
+ * @test Verify an abandoned chunk in the middle is zero-filled at its offset
+ */
+TEST_F(LoRaPartialReliabilityTest, PartialPacketIsZeroFilled) {
+    QSignalSpy receivedSpy(adapter.get(), &Adapter::packetReceived);
+    QSignalSpy partialSpy(adapter.get(), &Adapter::packetReceivedPartial);
+
+    receive(FrameType::DATA, 0, 3, QByteArray(10, 'a'));
+    receive(FrameType::DATA, 2, 3, QByteArray(5, 'c'));
+    EXPECT_EQ(partialSpy.count(), 0);
+    receive(FrameType::SKIP, 1, 3, LoRaPtyPeer::skipPayload(1, 10, 25));
+
+    EXPECT_EQ(receivedSpy.count(), 0);
+    ASSERT_EQ(partialSpy.count(), 1);
+    const QList<QVariant> args = partialSpy.at(0);
+    EXPECT_EQ(args.at(0).toByteArray(), QByteArray(10, 'a') + QByteArray(10, '\0') + QByteArray(5, 'c'));
+    const QBitArray present = args.at(1).toBitArray();
+    ASSERT_EQ(present.size(), 3);
+    EXPECT_TRUE(present.testBit(0));
+    EXPECT_FALSE(present.testBit(1));
+    EXPECT_TRUE(present.testBit(2));
+    EXPECT_EQ(args.at(2).toInt(), 10);
+    EXPECT_EQ(args.at(3).toInt(), PORT);
+
+    // The ACK of the SKIP goes out before PACKET_ACK
+    const QList<QByteArray> frames = peer.readFrames();
+    ASSERT_EQ(frames.size(), 4);
+    expectFrame(frames[0], FrameType::ACK, 0);
+    expectFrame(frames[1], FrameType::ACK, 2);
+    expectFrame(frames[2], FrameType::ACK, 1);
+    expectFrame(frames[3], FrameType::PACKET_ACK, 0);
+}
+
+/**
+ * @test Verify a skipped tail is zero-filled up to the packet size, and a retransmitted SKIP only acknowledged
+ */
+TEST_F(LoRaPartialReliabilityTest, SkippedTailIsZeroFilled) {
+    QSignalSpy partialSpy(adapter.get(), &Adapter::packetReceivedPartial);
+
+    receive(FrameType::DATA, 0, 3, QByteArray(10, 'a'));
+    receive(FrameType::SKIP, 1, 3, LoRaPtyPeer::skipPayload(2, 10, 25));
+
+    ASSERT_EQ(partialSpy.count(), 1);
+    EXPECT_EQ(partialSpy.at(0).at(0).toByteArray(), QByteArray(10, 'a') + QByteArray(15, '\0'));
+    const QBitArray present = partialSpy.at(0).at(1).toBitArray();
+    ASSERT_EQ(present.size(), 3);
+    EXPECT_TRUE(present.testBit(0));
+    EXPECT_FALSE(present.testBit(1));
+    EXPECT_FALSE(present.testBit(2));
+    peer.readFrames();
+
+    // Its ACK was lost: acknowledged again, but not delivered twice
+    receive(FrameType::SKIP, 1, 3, LoRaPtyPeer::skipPayload(2, 10, 25));
+    const QList<QByteArray> frames = peer.readFrames();
+    ASSERT_EQ(frames.size(), 1);
+    expectFrame(frames[0], FrameType::ACK, 1);
+    EXPECT_EQ(partialSpy.count(), 1);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file LoRaPayloadPipelineTests.cpp
+ * @brief Unit tests for LoRaPayloadPipeline
+ * @date 2026-10-19
+ *
+ * This file contains unit tests for the payload stage pipeline:
+ * - encode() and decode(): stages run off the calling thread, results in
+ *   submission order per port even when later packets finish first
+ * - failed stages reported with the original data
+ * - the limit of packets waiting for their encoding
+ * - data passed through unchanged without stages
+ *
+ * Results are collected with waitForDone(), so no event loop is needed.
+ */
+
+#include <gtest/gtest.h>
+#include <QByteArray>
+#include <QSignalSpy>
+#include <QThread>
+#include <atomic>
+#include "../src/LoRaPayloadPipeline.hpp"
+
+/**
+ * @class LoRaPayloadPipelineTest
+ * @brief Test suite for the payload stage pipeline
+ */
+class LoRaPayloadPipelineTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Pipeline under test, with a few threads so that stages overlap
+     */
+    void SetUp() override {
+        pipeline.setMaxThreads(4);
+    }
+
+    /**
+     * @brief Pipeline under test
+     */
+    LoRaPayloadPipeline pipeline;
+};
+
+/**
+ * @test Verify results keep their order per port when later packets finish first
+ */
+TEST_F(LoRaPayloadPipelineTest, ResultsInOrderPerPort) {
+    QThread *const caller = QThread::currentThread();
+    std::atomic<bool> ranOnCaller{false};
+    pipeline.setEncodeStage([&](QByteArray &data) {
+        ranOnCaller = ranOnCaller || QThread::currentThread() == caller;
+        // Earlier packets take longer, so they finish last
+        QThread::msleep(static_cast<unsigned long>(2 * (8 - (data.at(1) - '0'))));
+        data = data.toUpper();
+        return true;
+    });
+    QSignalSpy encodedSpy(&pipeline, &LoRaPayloadPipeline::encoded);
+
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(pipeline.encode(2, QByteArray("a") + QByteArray::number(i)));
+        ASSERT_TRUE(pipeline.encode(3, QByteArray("b") + QByteArray::number(i)));
+    }
+    ASSERT_TRUE(pipeline.waitForDone(10000));
+
+    ASSERT_EQ(encodedSpy.count(), 16);
+    int next[2] = {0, 0};
+    for (const QList<QVariant> &args : encodedSpy) {
+        const int port = args.at(0).toInt();
+        const QByteArray data = args.at(1).toByteArray();
+        ASSERT_TRUE(port == 2 || port == 3);
+        EXPECT_TRUE(args.at(2).toBool());
+        EXPECT_EQ(data, (port == 2 ? QByteArray("A") : QByteArray("B")) + QByteArray::number(next[port - 2]++));
+    }
+    EXPECT_FALSE(ranOnCaller);
+    EXPECT_EQ(pipeline.pendingEncodes(), 0);
+}
+
+/**
+ * @test Verify a failed stage is reported with the received data, in its place in the order
+ */
+TEST_F(LoRaPayloadPipelineTest, FailedStageReported) {
+    pipeline.setDecodeStage([](QByteArray &data) {
+        if (data == "bad") {
+            data = "partly decoded";
+            return false;
+        }
+        data.prepend("decoded ");
+        return true;
+    });
+    QSignalSpy decodedSpy(&pipeline, &LoRaPayloadPipeline::decoded);
+
+    pipeline.decode(0, "one");
+    pipeline.decode(0, "bad");
+    pipeline.decode(0, "two");
+    ASSERT_TRUE(pipeline.waitForDone(10000));
+
+    ASSERT_EQ(decodedSpy.count(), 3);
+    EXPECT_EQ(decodedSpy.at(0).at(1).toByteArray(), QByteArray("decoded one"));
+    EXPECT_EQ(decodedSpy.at(1).at(1).toByteArray(), QByteArray("bad"));
+    EXPECT_FALSE(decodedSpy.at(1).at(2).toBool());
+    EXPECT_EQ(decodedSpy.at(2).at(1).toByteArray(), QByteArray("decoded two"));
+    EXPECT_EQ(pipeline.pendingDecodes(), 0);
+}
+
+/**
+ * @test Verify encode() refuses packets beyond the limit until results are emitted
+ */
+TEST_F(LoRaPayloadPipelineTest, EncodeQueueIsBounded) {
+    std::atomic<bool> release{false};
+    pipeline.setMaxPendingEncodes(2);
+    pipeline.setEncodeStage([&release](QByteArray &) {
+        while (!release) {
+            QThread::msleep(1);
+        }
+        return true;
+    });
+    QSignalSpy encodedSpy(&pipeline, &LoRaPayloadPipeline::encoded);
+
+    EXPECT_TRUE(pipeline.encode(2, "first"));
+    EXPECT_TRUE(pipeline.encode(2, "second"));
+    EXPECT_FALSE(pipeline.encode(2, "third"));
+    EXPECT_EQ(pipeline.pendingEncodes(), 2);
+
+    release = true;
+    ASSERT_TRUE(pipeline.waitForDone(10000));
+    EXPECT_EQ(encodedSpy.count(), 2);
+    EXPECT_TRUE(pipeline.encode(2, "third"));
+    ASSERT_TRUE(pipeline.waitForDone(10000));
+    EXPECT_EQ(encodedSpy.count(), 3);
+}
+
+/**
+ * @test Verify data passes through unchanged without stages
+ */
+TEST_F(LoRaPayloadPipelineTest, NoStagePassesThrough) {
+    EXPECT_FALSE(pipeline.hasEncodeStage());
+    EXPECT_FALSE(pipeline.hasDecodeStage());
+    QSignalSpy encodedSpy(&pipeline, &LoRaPayloadPipeline::encoded);
+    QSignalSpy decodedSpy(&pipeline, &LoRaPayloadPipeline::decoded);
+
+    EXPECT_TRUE(pipeline.encode(0, "out"));
+    pipeline.decode(0, "in");
+    // Results are emitted from the pipeline's thread, never from within encode() or decode()
+    EXPECT_EQ(encodedSpy.count(), 0);
+    ASSERT_TRUE(pipeline.waitForDone(10000));
+
+    ASSERT_EQ(encodedSpy.count(), 1);
+    EXPECT_EQ(encodedSpy.at(0).at(1).toByteArray(), QByteArray("out"));
+    ASSERT_EQ(decodedSpy.count(), 1);
+    EXPECT_EQ(decodedSpy.at(0).at(1).toByteArray(), QByteArray("in"));
+}
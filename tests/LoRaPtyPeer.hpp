@@ -0,0 +1,231 @@
+#pragma once
+
+#include <memory>
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include "QCrossPlatformSerialPort.hpp"
+#include "../src/LoRaCapabilities.hpp"
+#include "../src/LoRaUsbAdapter_E22_400T22U.hpp"
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+
+/**
+ * @file LoRaPtyPeer.hpp
+ * @brief Pseudo-terminal standing in for the radio in adapter tests
+ * @date 2026-10-19
+ */
+
+/**
+ * @class LoRaPtyPeer
+ * @brief The far end of an adapter, driven by the test
+ * @details The adapter writes to an open serial port on the slave side of a
+ *          pseudo-terminal; readFrames() returns what it wrote. Frames from
+ *          the peer are not written to the terminal but passed to
+ *          LoRaUsbAdapter_E22_400T22U::receiveFrame(), so the test decides
+ *          exactly when each one arrives. Retransmission timeouts are not
+ *          waited for: the test triggers them itself.
+ *
+ *          Pseudo-terminals exist on Unix only; elsewhere isOpen() is false
+ *          and the tests using the peer are skipped.
+ */
+class LoRaPtyPeer {
+public:
+    using Adapter = LoRaUsbAdapter_E22_400T22U;
+
+    /**
+     * @brief Opens the pseudo-terminal and the serial port on its slave side
+     */
+    LoRaPtyPeer() {
+#ifdef Q_OS_UNIX
+        m_masterFd = ::posix_openpt(O_RDWR | O_NOCTTY);
+        if (m_masterFd < 0 || ::grantpt(m_masterFd) != 0 || ::unlockpt(m_masterFd) != 0) return;
+
+        const char *name = ::ptsname(m_masterFd);
+        if (!name) return;
+        // Raw mode, so frame bytes are not translated by the line discipline
+        m_slaveFd = ::open(name, O_RDWR | O_NOCTTY);
+        termios tio {};
+        if (m_slaveFd < 0 || ::tcgetattr(m_slaveFd, &tio) != 0) return;
+        ::cfmakeraw(&tio);
+        if (::tcsetattr(m_slaveFd, TCSANOW, &tio) != 0) return;
+        ::fcntl(m_masterFd, F_SETFL, ::fcntl(m_masterFd, F_GETFL) | O_NONBLOCK);
+
+        m_serial = std::make_shared<QCrossPlatformSerialPort>();
+        m_serial->setPortName(QString::fromLocal8Bit(name));
+        m_serial->setBaudRate(9600);
+        m_serial->setDataBits(QCrossPlatformDataBits::Data8);
+        m_serial->setParity(QCrossPlatformParity::NoParity);
+        m_serial->setStopBits(QCrossPlatformStopBits::OneStop);
+        m_serial->setFlowControl(QCrossPlatformFlowControl::NoFlowControl);
+        m_serial->open(QIODevice::ReadWrite);
+#endif
+    }
+
+    /**
+     * @brief Closes the serial port and the pseudo-terminal
+     */
+    ~LoRaPtyPeer() {
+        if (m_serial) {
+            m_serial->close();
+        }
+#ifdef Q_OS_UNIX
+        if (m_slaveFd >= 0) ::close(m_slaveFd);
+        if (m_masterFd >= 0) ::close(m_masterFd);
+#endif
+    }
+
+    LoRaPtyPeer(const LoRaPtyPeer &) = delete;
+    LoRaPtyPeer &operator=(const LoRaPtyPeer &) = delete;
+
+    /**
+     * @brief Returns whether the serial port for the adapter is open
+     */
+    bool isOpen() const {
+        return m_serial && m_serial->isOpen();
+    }
+
+    /**
+     * @brief Returns the serial port to construct the adapter with
+     */
+    std::shared_ptr<QCrossPlatformSerialPort> serial() const {
+        return m_serial ? m_serial : std::make_shared<QCrossPlatformSerialPort>();
+    }
+
+    /**
+     * @brief Returns the frames the adapter has written since the last call
+     * @details Frames without a protected header or parity are assumed.
+     */
+    QList<QByteArray> readFrames() {
+        // Lets the serial port flush writes that were not waited for
+        QCoreApplication::processEvents();
+#ifdef Q_OS_UNIX
+        char buffer[512];
+        ssize_t n = 0;
+        while ((n = ::read(m_masterFd, buffer, sizeof(buffer))) > 0) {
+            m_buffer.append(buffer, static_cast<int>(n));
+        }
+#endif
+        QList<QByteArray> frames;
+        const int headerSize = static_cast<int>(Adapter::FrameSize::HEADER_SIZE);
+        while (m_buffer.size() >= headerSize) {
+            const int size = static_cast<int>(Adapter::FrameSize::MIN_FRAME_SIZE) +
+                             static_cast<quint8>(m_buffer[headerSize - 1]);
+            if (m_buffer.size() < size) break;
+
+            frames.append(m_buffer.left(size));
+            m_buffer.remove(0, size);
+        }
+        return frames;
+    }
+
+    /**
+     * @brief Builds a frame as the peer would send it
+     */
+    static QByteArray frame(Adapter::FrameType type, quint16 seq, quint32 total,
+                            const QByteArray &payload = {}, quint8 port = 0) {
+        QByteArray data;
+        const quint8 typeByte = static_cast<quint8>(type) | (Adapter::isPortFrameType(type) ? (port & 0x0F) : 0);
+        data.append(static_cast<char>(typeByte));
+        data.append(static_cast<char>(seq & 0xFF));
+        data.append(static_cast<char>((seq >> 8) & 0xFF));
+        data.append(static_cast<char>(total & 0xFF));
+        data.append(static_cast<char>((total >> 8) & 0xFF));
+        data.append(static_cast<char>((total >> 16) & 0xFF));
+        data.append(static_cast<char>(payload.size()));
+        data.append(payload);
+        data.append(static_cast<char>(crc8(data)));
+        return data;
+    }
+
+    /**
+     * @brief Builds the payload of a SKIP frame
+     */
+    static QByteArray skipPayload(int count, int chunkSize, int packetSize) {
+        QByteArray payload;
+        payload.append(static_cast<char>(count & 0xFF));
+        payload.append(static_cast<char>((count >> 8) & 0xFF));
+        payload.append(static_cast<char>(chunkSize));
+        payload.append(static_cast<char>(packetSize & 0xFF));
+        payload.append(static_cast<char>((packetSize >> 8) & 0xFF));
+        payload.append(static_cast<char>((packetSize >> 16) & 0xFF));
+        return payload;
+    }
+
+    /**
+     * @brief Completes the adapter's handshake as a peer supporting everything it does
+     */
+    static void handshake(Adapter &adapter) {
+        LoRaCapabilities caps = adapter.localCapabilities();
+        caps.nodeId = 0x5EE4;
+        adapter.receiveFrame(frame(Adapter::FrameType::HELLO, 0, 0, caps.encode()));
+    }
+
+    /**
+     * @brief Returns the frame type and port of a frame
+     */
+    static Adapter::FrameType typeOf(const QByteArray &frame, quint8 *port = nullptr) {
+        Adapter::FrameType type;
+        quint8 framePort = 0;
+        Adapter::splitTypeByte(static_cast<quint8>(frame[0]), type, framePort);
+        if (port) *port = framePort;
+        return type;
+    }
+
+    /**
+     * @brief Returns the sequence number of a frame
+     */
+    static quint16 seqOf(const QByteArray &frame) {
+        return static_cast<quint8>(frame[1]) | (static_cast<quint16>(static_cast<quint8>(frame[2])) << 8);
+    }
+
+    /**
+     * @brief Returns the payload of a frame
+     */
+    static QByteArray payloadOf(const QByteArray &frame) {
+        const int headerSize = static_cast<int>(Adapter::FrameSize::HEADER_SIZE);
+        return frame.mid(headerSize, static_cast<quint8>(frame[headerSize - 1]));
+    }
+
+private:
+    /**
+     * @brief CRC-8 of the frame format (polynomial 0x31)
+     */
+    static quint8 crc8(const QByteArray &data) {
+        quint8 crc = 0;
+        for (quint8 byte : data) {
+            crc ^= byte;
+            for (int i = 0; i < 8; ++i) {
+                crc = (crc & 0x80) ? static_cast<quint8>((crc << 1) ^ 0x31) : static_cast<quint8>(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief Master side of the pseudo-terminal, read by readFrames()
+     */
+    int m_masterFd = -1;
+
+    /**
+     * @brief Slave descriptor kept open so the master never hangs up
+     */
+    int m_slaveFd = -1;
+
+    /**
+     * @brief Serial port on the slave side, used by the adapter
+     */
+    std::shared_ptr<QCrossPlatformSerialPort> m_serial;
+
+    /**
+     * @brief Bytes read that do not form a complete frame yet
+     */
+    QByteArray m_buffer;
+};
@@ -0,0 +1,167 @@
+/**
+ * @file LoRaPubSubTests.cpp
+ * @brief Unit tests for LoRaPubSub
+ * @date 2026-10-18
+ *
+ * This file contains unit tests for the publish/subscribe layer:
+ * - encodeId() / decodeId(): one- and two-byte topic IDs
+ * - publish(): one announcement per topic, then bare IDs
+ * - packetReceived(): filtering, untagged packets, unknown IDs
+ *
+ * Publisher and subscriber are wired back to back; no frames are involved.
+ */
+
+#include <gtest/gtest.h>
+#include <QByteArray>
+#include <QSignalSpy>
+#include "../src/LoRaPubSub.hpp"
+
+/**
+ * @class LoRaPubSubTest
+ * @brief Test suite for the publish/subscribe layer
+ */
+class LoRaPubSubTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Connects each side's packets to the other side
+     */
+    void SetUp() override {
+        QObject::connect(&publisher, &LoRaPubSub::sendPacket, &subscriber, &LoRaPubSub::packetReceived);
+        QObject::connect(&subscriber, &LoRaPubSub::sendPacket, &publisher, &LoRaPubSub::packetReceived);
+    }
+
+    /**
+     * @brief Publishing side
+     */
+    LoRaPubSub publisher;
+
+    /**
+     * @brief Subscribing side
+     */
+    LoRaPubSub subscriber;
+
+    /**
+     * @brief Subscription context
+     */
+    QObject context;
+};
+
+/**
+ * @test Verify topic IDs take one byte below 0x80 and round-trip up to MAX_TOPIC_ID
+ */
+TEST_F(LoRaPubSubTest, IdEncodingRoundTrip) {
+    EXPECT_EQ(LoRaPubSub::encodeId(5).size(), 1);
+    EXPECT_EQ(LoRaPubSub::encodeId(0x7F).size(), 1);
+    EXPECT_EQ(LoRaPubSub::encodeId(0x80).size(), 2);
+
+    for (quint16 id : {quint16(0), quint16(2), quint16(0x7F), quint16(0x80), quint16(300), LoRaPubSub::MAX_TOPIC_ID}) {
+        const QByteArray data = LoRaPubSub::encodeId(id) + "x";
+        int pos = 0;
+        quint16 decoded = 0;
+        ASSERT_TRUE(LoRaPubSub::decodeId(data, pos, decoded));
+        EXPECT_EQ(decoded, id);
+        EXPECT_EQ(pos, data.size() - 1);
+    }
+
+    int pos = 0;
+    quint16 decoded = 0;
+    EXPECT_FALSE(LoRaPubSub::decodeId(QByteArray("\x81", 1), pos, decoded));
+}
+
+/**
+ * @test Verify the topic name is sent once and publications carry only the ID
+ */
+TEST_F(LoRaPubSubTest, TopicAnnouncedOnce) {
+    QList<QByteArray> received;
+    subscriber.subscribe("sensors/temperature", &context, [&](const QByteArray &data) { received.append(data); });
+    QSignalSpy sendSpy(&publisher, &LoRaPubSub::sendPacket);
+
+    publisher.publish("sensors/temperature", "21.5");
+    publisher.publish("sensors/temperature", "21.7");
+
+    ASSERT_EQ(sendSpy.count(), 3);
+    EXPECT_TRUE(sendSpy.at(0).at(0).toByteArray().contains("sensors/temperature"));
+    EXPECT_EQ(sendSpy.at(2).at(0).toByteArray(), LoRaPubSub::encodeId(LoRaPubSub::FIRST_TOPIC_ID) + "21.7");
+    EXPECT_EQ(received, (QList<QByteArray>{"21.5", "21.7"}));
+}
+
+/**
+ * @test Verify publications are delivered only to subscribers of their topic
+ */
+TEST_F(LoRaPubSubTest, DeliveryFilteredByTopic) {
+    int temperature = 0;
+    int humidity = 0;
+    subscriber.subscribe("temperature", &context, [&](const QByteArray &) { ++temperature; });
+
+    publisher.publish("temperature", "1");
+    publisher.publish("humidity", "2");
+    publisher.publish("humidity", "3");
+
+    EXPECT_EQ(temperature, 1);
+    EXPECT_EQ(humidity, 0);
+
+    subscriber.subscribe("humidity", &context, [&](const QByteArray &) { ++humidity; });
+    publisher.publish("humidity", "4");
+    EXPECT_EQ(humidity, 1);
+
+    subscriber.unsubscribe("temperature", &context);
+    publisher.publish("temperature", "5");
+    EXPECT_EQ(temperature, 1);
+}
+
+/**
+ * @test Verify a subscription ends when its context is destroyed
+ */
+TEST_F(LoRaPubSubTest, DestroyedContextUnsubscribes) {
+    int calls = 0;
+    auto *owner = new QObject;
+    subscriber.subscribe("t", owner, [&](const QByteArray &) { ++calls; });
+    EXPECT_TRUE(subscriber.isSubscribed("t"));
+
+    delete owner;
+    publisher.publish("t", "x");
+
+    EXPECT_FALSE(subscriber.isSubscribed("t"));
+    EXPECT_EQ(calls, 0);
+}
+
+/**
+ * @test Verify untagged packets pass through with their marker removed
+ */
+TEST_F(LoRaPubSubTest, PlainPacketsPassThrough) {
+    QSignalSpy plainSpy(&subscriber, &LoRaPubSub::plainPacketReceived);
+
+    subscriber.packetReceived(LoRaPubSub::wrapPlain("raw"));
+
+    ASSERT_EQ(plainSpy.count(), 1);
+    EXPECT_EQ(plainSpy.at(0).at(0).toByteArray(), QByteArray("raw"));
+}
+
+/**
+ * @test Verify a subscriber that lost the announcement queries it and gets the held publication
+ */
+TEST_F(LoRaPubSubTest, UnknownIdIsQueried) {
+    QList<QByteArray> received;
+    subscriber.subscribe("t", &context, [&](const QByteArray &data) { received.append(data); });
+    publisher.publish("t", "1");
+
+    // The subscriber restarts and forgets the publisher's topics
+    subscriber.resetPeer();
+    QSignalSpy querySpy(&subscriber, &LoRaPubSub::sendPacket);
+    publisher.publish("t", "2");
+
+    EXPECT_EQ(querySpy.count(), 1);
+    EXPECT_EQ(received, (QList<QByteArray>{"1", "2"}));
+}
+
+/**
+ * @test Verify resetPeer() makes the next publication announce its topic again
+ */
+TEST_F(LoRaPubSubTest, ResetPeerReannounces) {
+    QSignalSpy sendSpy(&publisher, &LoRaPubSub::sendPacket);
+    publisher.publish("t", "1");
+    publisher.resetPeer();
+    publisher.publish("t", "2");
+
+    EXPECT_EQ(sendSpy.count(), 4);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file LoRaRealtimeTests.cpp
+ * @brief Unit tests for LoRaRealtime
+ * @date 2026-10-19
+ *
+ * This file contains unit tests for the I/O thread scheduling helpers:
+ * - applyToCurrentThread(): defaults and invalid settings
+ * - measureWakeupLatency(): shape of the statistics
+ *
+ * Real-time priorities and memory locking need privileges the test
+ * environment usually lacks, so they are not applied here.
+ */
+
+#include <gtest/gtest.h>
+#include "../src/LoRaRealtime.hpp"
+
+/**
+ * @test Verify the default settings apply everywhere
+ */
+TEST(LoRaRealtimeTest, DefaultSettingsApply) {
+    QString error;
+    EXPECT_TRUE(LoRaRealtime::applyToCurrentThread(LoRaRealtime::Settings{}, error));
+    EXPECT_TRUE(error.isEmpty());
+}
+
+/**
+ * @test Verify an invalid CPU is reported instead of ignored
+ */
+TEST(LoRaRealtimeTest, InvalidCpuFails) {
+    LoRaRealtime::Settings settings;
+    settings.cpus = {-1};
+
+    QString error;
+    EXPECT_FALSE(LoRaRealtime::applyToCurrentThread(settings, error));
+    EXPECT_FALSE(error.isEmpty());
+}
+
+/**
+ * @test Verify latency statistics are ordered and count every sample
+ */
+TEST(LoRaRealtimeTest, WakeupLatencyStatsAreOrdered) {
+    const LoRaRealtime::LatencyStats stats = LoRaRealtime::measureWakeupLatency(50, 200);
+
+    EXPECT_EQ(stats.samples, 50);
+    EXPECT_GE(stats.minUs, 0);
+    EXPECT_LE(stats.minUs, stats.p50Us);
+    EXPECT_LE(stats.p50Us, stats.p99Us);
+    EXPECT_LE(stats.p99Us, stats.maxUs);
+}
+
+/**
+ * @test Verify no samples give empty statistics
+ */
+TEST(LoRaRealtimeTest, NoSamplesGiveEmptyStats) {
+    const LoRaRealtime::LatencyStats stats = LoRaRealtime::measureWakeupLatency(0);
+
+    EXPECT_EQ(stats.samples, 0);
+    EXPECT_EQ(stats.maxUs, 0);
+}
@@ -0,0 +1,123 @@
+/**
+ * @file LoRaReedSolomonTests.cpp
+ * @brief Unit tests for LoRaReedSolomon
+ * @date 2026-10-19
+ *
+ * This file contains unit tests for the per-frame Reed-Solomon code:
+ * - parity(): systematic codewords, no parity without parity bytes
+ * - decode(): up to parityBytes() / 2 damaged bytes corrected anywhere
+ * - decode(): too many errors reported and the codeword left unchanged
+ *
+ * Errors are placed by a seeded generator, so runs are repeatable.
+ */
+
+#include <gtest/gtest.h>
+#include <QRandomGenerator>
+#include "../src/LoRaReedSolomon.hpp"
+
+/**
+ * @class LoRaReedSolomonTest
+ * @brief Test suite for the Reed-Solomon code
+ */
+class LoRaReedSolomonTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Returns random data of the given size
+     */
+    QByteArray randomData(int size) {
+        QByteArray data(size, '\0');
+        for (int i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(rng.bounded(256));
+        }
+        return data;
+    }
+
+    /**
+     * @brief Damages count distinct bytes of a codeword with nonzero error values
+     */
+    QByteArray damage(QByteArray codeword, int count) {
+        QList<int> positions;
+        while (positions.size() < count) {
+            const int pos = rng.bounded(static_cast<int>(codeword.size()));
+            if (!positions.contains(pos)) {
+                positions.append(pos);
+            }
+        }
+        for (int pos : positions) {
+            codeword[pos] = static_cast<char>(codeword[pos] ^ (1 + rng.bounded(255)));
+        }
+        return codeword;
+    }
+
+    /**
+     * @brief Seeded generator for data and error positions
+     */
+    QRandomGenerator rng{42};
+};
+
+/**
+ * @test Verify codewords are systematic and decode as intact
+ */
+TEST_F(LoRaReedSolomonTest, IntactCodewordAccepted) {
+    const LoRaReedSolomon code(4);
+    const QByteArray data = randomData(32);
+    const QByteArray parity = code.parity(data);
+    ASSERT_EQ(parity.size(), 4);
+
+    QByteArray codeword = data + parity;
+    EXPECT_EQ(code.decode(codeword), 0);
+    EXPECT_EQ(codeword.left(data.size()), data);
+}
+
+/**
+ * @test Verify up to parityBytes() / 2 damaged bytes are corrected for several code sizes
+ */
+TEST_F(LoRaReedSolomonTest, CorrectsUpToHalfTheParity) {
+    for (int parityBytes : {2, 4, 8, 16}) {
+        const LoRaReedSolomon code(parityBytes);
+        EXPECT_EQ(code.correctableBytes(), parityBytes / 2);
+        for (int trial = 0; trial < 50; ++trial) {
+            const QByteArray data = randomData(1 + static_cast<int>(rng.bounded(40)));
+            const QByteArray codeword = data + code.parity(data);
+            const int errors = 1 + static_cast<int>(rng.bounded(code.correctableBytes()));
+
+            QByteArray received = damage(codeword, errors);
+            EXPECT_EQ(code.decode(received), errors) << "parity " << parityBytes;
+            EXPECT_EQ(received, codeword) << "parity " << parityBytes;
+        }
+    }
+}
+
+/**
+ * @test Verify a codeword with too many errors is left unchanged when reported
+ */
+TEST_F(LoRaReedSolomonTest, TooManyErrorsReported) {
+    const LoRaReedSolomon code(4);
+    int reported = 0;
+    for (int trial = 0; trial < 100; ++trial) {
+        const QByteArray data = randomData(24);
+        const QByteArray damaged = damage(data + code.parity(data), 4);
+
+        QByteArray received = damaged;
+        if (code.decode(received) < 0) {
+            reported++;
+            EXPECT_EQ(received, damaged);
+        }
+    }
+    // Most, but not all, uncorrectable codewords are recognised as such
+    EXPECT_GT(reported, 50);
+}
+
+/**
+ * @test Verify a code without parity bytes changes nothing
+ */
+TEST_F(LoRaReedSolomonTest, NoParity) {
+    const LoRaReedSolomon code;
+    EXPECT_EQ(code.parityBytes(), 0);
+    EXPECT_TRUE(code.parity("frame").isEmpty());
+
+    QByteArray frame = "frame";
+    EXPECT_EQ(code.decode(frame), 0);
+    EXPECT_EQ(frame, QByteArray("frame"));
+    EXPECT_EQ(LoRaReedSolomon(100).parityBytes(), LoRaReedSolomon::MAX_PARITY_BYTES);
+}
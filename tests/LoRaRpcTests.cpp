@@ -0,0 +1,153 @@
+/**
+ * @file LoRaRpcTests.cpp
+ * @brief Unit tests for LoRaRpc
+ * @date 2026-10-18
+ *
+ * This file contains unit tests for the request/response layer:
+ * - call(): completion by the reply and local errors
+ * - setHandler(): dispatch and unknown services
+ * - at-most-once handlers: cached replies for repeated requests
+ *
+ * Client and server are wired back to back; no frames or timers are involved.
+ */
+
+#include <gtest/gtest.h>
+#include <QByteArray>
+#include <QSignalSpy>
+#include "../src/LoRaRpc.hpp"
+
+/**
+ * @class LoRaRpcTest
+ * @brief Test suite for the request/response layer
+ */
+class LoRaRpcTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Connects client requests to the server and server replies to the client
+     */
+    void SetUp() override {
+        QObject::connect(&client, &LoRaRpc::sendRequest, &server, &LoRaRpc::requestReceived);
+        QObject::connect(&server, &LoRaRpc::sendReply, &client, &LoRaRpc::replyReceived);
+    }
+
+    /**
+     * @brief Calling side
+     */
+    LoRaRpc client;
+
+    /**
+     * @brief Serving side
+     */
+    LoRaRpc server;
+};
+
+/**
+ * @test Verify a call completes with the handler's reply
+ */
+TEST_F(LoRaRpcTest, CallReturnsHandlerReply) {
+    server.setHandler(7, [](const QByteArray &request) { return request.toUpper(); });
+
+    QFuture<LoRaRpcReply> future = client.call(7, "status?");
+
+    ASSERT_TRUE(future.isFinished());
+    EXPECT_TRUE(future.result().isOk());
+    EXPECT_EQ(future.result().data, QByteArray("STATUS?"));
+    EXPECT_EQ(client.pendingCalls(), 0);
+}
+
+/**
+ * @test Verify a call to a missing service reports UnknownService
+ */
+TEST_F(LoRaRpcTest, UnknownServiceIsReported) {
+    QFuture<LoRaRpcReply> future = client.call(99, "ping");
+
+    ASSERT_TRUE(future.isFinished());
+    EXPECT_EQ(future.result().status, LoRaRpcReply::UnknownService);
+}
+
+/**
+ * @test Verify requests that do not fit in one frame fail without being sent
+ */
+TEST_F(LoRaRpcTest, OversizedRequestFailsLocally) {
+    QSignalSpy sendSpy(&client, &LoRaRpc::sendRequest);
+
+    QFuture<LoRaRpcReply> future = client.call(1, QByteArray(LoRaRpc::MAX_MESSAGE_SIZE + 1, 'x'));
+
+    ASSERT_TRUE(future.isFinished());
+    EXPECT_EQ(future.result().status, LoRaRpcReply::RequestTooLarge);
+    EXPECT_EQ(sendSpy.count(), 0);
+}
+
+/**
+ * @test Verify oversized replies are turned into HandlerFailed
+ */
+TEST_F(LoRaRpcTest, OversizedReplyFails) {
+    server.setHandler(3, [](const QByteArray &) { return QByteArray(LoRaRpc::MAX_MESSAGE_SIZE + 1, 'y'); });
+
+    QFuture<LoRaRpcReply> future = client.call(3, "dump");
+
+    ASSERT_TRUE(future.isFinished());
+    EXPECT_EQ(future.result().status, LoRaRpcReply::HandlerFailed);
+}
+
+/**
+ * @test Verify an at-most-once handler runs once for a repeated request
+ */
+TEST_F(LoRaRpcTest, AtMostOnceHandlerRunsOnce) {
+    int runs = 0;
+    server.setHandler(5, [&runs](const QByteArray &) {
+        return QByteArray::number(++runs);
+    }, true);
+    QSignalSpy replySpy(&server, &LoRaRpc::sendReply);
+
+    // The same request arriving twice, as after a lost reply
+    server.requestReceived(42, 5, "increment");
+    server.requestReceived(42, 5, "increment");
+
+    EXPECT_EQ(runs, 1);
+    ASSERT_EQ(replySpy.count(), 2);
+    EXPECT_EQ(replySpy.at(1).at(2).toByteArray(), QByteArray("1"));
+
+    // A reused ID with another request is a new call
+    server.requestReceived(42, 5, "increment again");
+    EXPECT_EQ(runs, 2);
+}
+
+/**
+ * @test Verify a regular handler runs again for a repeated request
+ */
+TEST_F(LoRaRpcTest, RegularHandlerRunsAgain) {
+    int runs = 0;
+    server.setHandler(6, [&runs](const QByteArray &) {
+        ++runs;
+        return QByteArray();
+    });
+
+    server.requestReceived(1, 6, "read");
+    server.requestReceived(1, 6, "read");
+
+    EXPECT_EQ(runs, 2);
+}
+
+/**
+ * @test Verify outstanding calls are completed by cancelAll()
+ */
+TEST_F(LoRaRpcTest, CancelAllCompletesPendingCalls) {
+    LoRaRpc lonely;
+    QFuture<LoRaRpcReply> future = lonely.call(1, "anyone?");
+    EXPECT_EQ(lonely.pendingCalls(), 1);
+
+    lonely.cancelAll();
+
+    ASSERT_TRUE(future.isFinished());
+    EXPECT_EQ(future.result().status, LoRaRpcReply::NotConnected);
+    EXPECT_EQ(lonely.pendingCalls(), 0);
+}
+
+/**
+ * @test Verify replies to unknown calls are ignored
+ */
+TEST_F(LoRaRpcTest, StrayReplyIsIgnored) {
+    client.replyReceived(1234, LoRaRpcReply::Ok, "late");
+    EXPECT_EQ(client.pendingCalls(), 0);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file LoRaStallWatchdogTests.cpp
+ * @brief Unit tests for LoRaStallWatchdog
+ * @date 2026-10-19
+ *
+ * This file contains unit tests for the event-loop stall watchdog:
+ * - recordStall(): histogram buckets, counters and the recent list
+ * - beginSection()/endSection(): attribution of a stall
+ * - setStateProvider(): protocol state of a stall
+ *
+ * The heartbeat timer is not driven here; stalls are recorded directly.
+ */
+
+#include <gtest/gtest.h>
+#include <QSignalSpy>
+#include "../src/LoRaStallWatchdog.hpp"
+
+/**
+ * @class LoRaStallWatchdogTest
+ * @brief Test suite for the stall watchdog
+ */
+class LoRaStallWatchdogTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Watchdog being tested
+     */
+    LoRaStallWatchdog watchdog;
+};
+
+/**
+ * @test Verify stalls land in the bucket of their duration
+ */
+TEST_F(LoRaStallWatchdogTest, StallsFillHistogram) {
+    watchdog.start();
+    watchdog.recordStall(30);
+    watchdog.recordStall(75);
+    watchdog.recordStall(99);
+    watchdog.recordStall(6000);
+
+    const QVector<quint64> histogram = watchdog.histogram();
+    ASSERT_EQ(histogram.size(), LoRaStallWatchdog::BUCKET_COUNT);
+    EXPECT_EQ(histogram[0], 1u);
+    EXPECT_EQ(histogram[1], 2u);
+    EXPECT_EQ(histogram[LoRaStallWatchdog::BUCKET_COUNT - 1], 1u);
+    EXPECT_EQ(watchdog.stallCount(), 4u);
+    EXPECT_EQ(watchdog.maxStallMs(), 6000);
+}
+
+/**
+ * @test Verify a stall inside open sections is reported with their path
+ */
+TEST_F(LoRaStallWatchdogTest, OpenSectionsNameTheStall) {
+    QSignalSpy spy(&watchdog, &LoRaStallWatchdog::stallDetected);
+    watchdog.start();
+    watchdog.setStateProvider([]() { return QString("tx2=3/10"); });
+
+    watchdog.beginSection("onReadyRead");
+    watchdog.beginSection("waitForBytesWritten");
+    watchdog.recordStall(40);
+    watchdog.endSection();
+    watchdog.endSection();
+
+    ASSERT_EQ(spy.count(), 1);
+    const QList<LoRaStallWatchdog::Stall> stalls = watchdog.recentStalls();
+    ASSERT_EQ(stalls.size(), 1);
+    EXPECT_EQ(stalls[0].durationMs, 40);
+    EXPECT_EQ(stalls[0].section, QString("onReadyRead/waitForBytesWritten"));
+    EXPECT_EQ(stalls[0].state, QString("tx2=3/10"));
+}
+
+/**
+ * @test Verify sections are ignored while stopped
+ */
+TEST_F(LoRaStallWatchdogTest, StoppedWatchdogIgnoresSections) {
+    watchdog.beginSection("onReadyRead");
+    watchdog.recordStall(40);
+
+    ASSERT_EQ(watchdog.recentStalls().size(), 1);
+    EXPECT_TRUE(watchdog.recentStalls()[0].section.isEmpty());
+}
+
+/**
+ * @test Verify only the most recent stalls are kept and start() clears them
+ */
+TEST_F(LoRaStallWatchdogTest, RecentStallsAreBounded) {
+    watchdog.start();
+    for (int i = 0; i < LoRaStallWatchdog::MAX_RECENT_STALLS + 10; ++i) {
+        watchdog.recordStall(20 + i);
+    }
+
+    const QList<LoRaStallWatchdog::Stall> stalls = watchdog.recentStalls();
+    ASSERT_EQ(stalls.size(), LoRaStallWatchdog::MAX_RECENT_STALLS);
+    EXPECT_EQ(stalls.first().durationMs, 30);
+
+    watchdog.start();
+    EXPECT_TRUE(watchdog.recentStalls().isEmpty());
+    EXPECT_EQ(watchdog.stallCount(), 0u);
+}
@@ -7,6 +7,11 @@
  * - crc8(): CRC-8 calculation
  * - makeFrame(): Frame creation
  * - parseFrame(): Frame parsing
+ * - splitTypeByte(): Logical port in the Type byte
+ * - correctHeader(): Single-bit correction and two-bit detection of protected headers
+ * - negotiatedCapabilities(): no optional feature without a handshake
+ * - setLinkMonitorEnabled(): no probes, and no link down, while the peer is
+ *   not known to answer PING
  *
  * These tests do not require hardware mocking and can run independently.
  */
@@ -14,7 +19,11 @@
 #include <gtest/gtest.h>
 #include <QByteArray>
 #include <QString>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QThread>
 #include "../src/LoRaUsbAdapter_E22_400T22U.hpp"
+#include "LoRaPtyPeer.hpp"
 
 /**
  * @class CRC8Test
@@ -643,3 +652,210 @@ TEST_F(ParseFrameTest, ParsePreservesBinaryData) {
     EXPECT_TRUE(result);
     EXPECT_EQ(parsedPayload, payload);
 }
+
+/**
+ * @test Verify packet-path frame types carry the port in the low nibble
+ */
+TEST(PortTypeByteTest, PacketFramesCarryPort) {
+    using Adapter = LoRaUsbAdapter_E22_400T22U;
+    Adapter::FrameType type;
+    quint8 port = 0xFF;
+
+    Adapter::splitTypeByte(0x10, type, port);
+    EXPECT_EQ(type, Adapter::FrameType::DATA);
+    EXPECT_EQ(port, 0);
+
+    Adapter::splitTypeByte(0x2F, type, port);
+    EXPECT_EQ(type, Adapter::FrameType::ACK);
+    EXPECT_EQ(port, 15);
+
+    Adapter::splitTypeByte(0x73, type, port);
+    EXPECT_EQ(type, Adapter::FrameType::DATA_ACK);
+    EXPECT_EQ(port, 3);
+}
+
+/**
+ * @test Verify control frame types are not split into type and port
+ */
+TEST(PortTypeByteTest, ControlFramesHaveNoPort) {
+    using Adapter = LoRaUsbAdapter_E22_400T22U;
+    Adapter::FrameType type;
+    quint8 port = 0xFF;
+
+    Adapter::splitTypeByte(0x61, type, port);
+    EXPECT_EQ(type, Adapter::FrameType::PONG);
+    EXPECT_EQ(port, 0);
+
+    Adapter::splitTypeByte(0x81, type, port);
+    EXPECT_EQ(type, Adapter::FrameType::RPC_REPLY);
+    EXPECT_EQ(port, 0);
+
+    EXPECT_TRUE(Adapter::isPortFrameType(Adapter::FrameType::PACKET_ACK));
+    EXPECT_FALSE(Adapter::isPortFrameType(Adapter::FrameType::HELLO));
+}
+
+/**
+ * @test Verify SKIP frames carry the port of the packet they cut short
+ */
+TEST(PortTypeByteTest, SkipFramesCarryPort) {
+    using Adapter = LoRaUsbAdapter_E22_400T22U;
+    Adapter::FrameType type;
+    quint8 port = 0xFF;
+
+    EXPECT_TRUE(Adapter::isPortFrameType(Adapter::FrameType::SKIP));
+
+    Adapter::splitTypeByte(0x95, type, port);
+    EXPECT_EQ(type, Adapter::FrameType::SKIP);
+    EXPECT_EQ(port, 5);
+}
+
+/**
+ * @class ProtectedHeaderTest
+ * @brief Test suite for the header check byte of protected headers
+ */
+class ProtectedHeaderTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Helper to calculate CRC-8
+     */
+    quint8 calculateCRC(const QByteArray &data) {
+        quint8 crc = 0;
+        for (quint8 byte : data) {
+            crc ^= byte;
+            for (int i = 0; i < 8; ++i) {
+                if (crc & 0x80) {
+                    crc = (crc << 1) ^ 0x31;
+                } else {
+                    crc <<= 1;
+                }
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief Flips one bit of the header (bits 0-55) or of the check byte (bits 56-63)
+     */
+    static void flip(QByteArray &header, quint8 &check, int bit) {
+        if (bit < header.size() * 8) {
+            header[bit / 8] = static_cast<char>(header[bit / 8] ^ (1 << (bit % 8)));
+        } else {
+            check ^= static_cast<quint8>(1 << (bit % 8));
+        }
+    }
+
+    /**
+     * @brief Header of a DATA frame: port 2, chunk 7 of 40, 12 payload bytes
+     */
+    const QByteArray header = QByteArray::fromHex("1207002800000c");
+};
+
+/**
+ * @test Verify an intact header is accepted unchanged
+ */
+TEST_F(ProtectedHeaderTest, IntactHeaderAccepted) {
+    QByteArray received = header;
+    EXPECT_EQ(LoRaUsbAdapter_E22_400T22U::correctHeader(received, calculateCRC(header)), 0);
+    EXPECT_EQ(received, header);
+}
+
+/**
+ * @test Verify every single-bit error in header or check byte is corrected
+ */
+TEST_F(ProtectedHeaderTest, SingleBitErrorsCorrected) {
+    for (int bit = 0; bit < 64; ++bit) {
+        QByteArray received = header;
+        quint8 check = calculateCRC(header);
+        flip(received, check, bit);
+
+        EXPECT_EQ(LoRaUsbAdapter_E22_400T22U::correctHeader(received, check), 1) << "bit " << bit;
+        EXPECT_EQ(received, header) << "bit " << bit;
+    }
+}
+
+/**
+ * @test Verify every two-bit error is detected and not miscorrected
+ */
+TEST_F(ProtectedHeaderTest, TwoBitErrorsDetected) {
+    for (int first = 0; first < 64; ++first) {
+        for (int second = first + 1; second < 64; ++second) {
+            QByteArray received = header;
+            quint8 check = calculateCRC(header);
+            flip(received, check, first);
+            flip(received, check, second);
+
+            EXPECT_EQ(LoRaUsbAdapter_E22_400T22U::correctHeader(received, check), -1)
+                << "bits " << first << ", " << second;
+        }
+    }
+}
+
+/**
+ * @test Verify no optional feature is used unless a handshake was started
+ */
+TEST(CapabilityGateTest, LegacyWithoutHandshake) {
+    LoRaUsbAdapter_E22_400T22U adapter(std::make_shared<QCrossPlatformSerialPort>());
+    adapter.setDedupEnabled(true);
+    EXPECT_TRUE(adapter.negotiatedCapabilities().isLegacy());
+    EXPECT_EQ(adapter.negotiatedCapabilities().features, 0u);
+
+    // A cached profile of a peer that supports everything
+    LoRaCapabilities cached = adapter.localCapabilities();
+    cached.nodeId = 0x1234;
+    adapter.startHandshake(cached);
+    EXPECT_TRUE(adapter.isHandshakePending());
+    EXPECT_TRUE(adapter.negotiatedCapabilities().has(LoRaCapabilities::DEDUP));
+    EXPECT_TRUE(adapter.negotiatedCapabilities().has(LoRaCapabilities::PORTS));
+
+    adapter.resetHandshake();
+    EXPECT_FALSE(adapter.isHandshakePending());
+    EXPECT_TRUE(adapter.negotiatedCapabilities().isLegacy());
+    EXPECT_EQ(adapter.negotiatedCapabilities().features, 0u);
+}
+
+/**
+ * @test Verify an idle link is not declared down while no PING can be sent
+ */
+TEST(LinkMonitorGateTest, IdleLinkStaysUpWithoutHandshake) {
+    LoRaPtyPeer peer;
+    if (!peer.isOpen()) {
+        GTEST_SKIP() << "No pseudo-terminal available";
+    }
+    LoRaUsbAdapter_E22_400T22U adapter(peer.serial());
+    QSignalSpy downSpy(&adapter, &LoRaUsbAdapter_E22_400T22U::linkDown);
+    adapter.setLinkMonitorEnabled(true);
+
+    // Past the first probe interval plus MISSED_LIMIT probe timeouts
+    QElapsedTimer idle;
+    idle.start();
+    while (idle.elapsed() < 11500) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        QThread::msleep(10);
+    }
+    EXPECT_TRUE(peer.readFrames().isEmpty());
+    EXPECT_EQ(downSpy.count(), 0);
+    EXPECT_TRUE(adapter.linkMonitor()->isUp());
+
+    adapter.sendPacket("hello");
+    const QList<QByteArray> frames = peer.readFrames();
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(LoRaPtyPeer::typeOf(frames[0]), LoRaUsbAdapter_E22_400T22U::FrameType::DATA);
+    EXPECT_EQ(LoRaPtyPeer::payloadOf(frames[0]), QByteArray("hello"));
+}
+
+/**
+ * @test Verify the monitor is not started after a handshake without LINK_PROBE
+ */
+TEST(LinkMonitorGateTest, RefusedWithoutLinkProbe) {
+    LoRaUsbAdapter_E22_400T22U adapter(std::make_shared<QCrossPlatformSerialPort>());
+    QSignalSpy errorSpy(&adapter, &LoRaUsbAdapter_E22_400T22U::error);
+    LoRaCapabilities peer = adapter.localCapabilities();
+    peer.features &= ~LoRaCapabilities::LINK_PROBE;
+    adapter.receiveFrame(LoRaPtyPeer::frame(LoRaUsbAdapter_E22_400T22U::FrameType::HELLO, 0, 0, peer.encode()));
+    ASSERT_TRUE(adapter.isHandshakeComplete());
+    errorSpy.clear();
+
+    adapter.setLinkMonitorEnabled(true);
+    EXPECT_FALSE(adapter.linkMonitor()->isRunning());
+    EXPECT_EQ(errorSpy.count(), 1);
+}
@@ -13,6 +13,7 @@
 #include <QByteArray>
 #include <QString>
 #include <QSignalSpy>
+#include <QTemporaryFile>
 #include "../src/LoRaWorker.hpp"
 #include "../src/LoRaUsbAdapter_E22_400T22U.hpp"
 
@@ -486,3 +487,162 @@ TEST_F(LoRaWorkerEdgeCaseTest, HandlesUTF8Data) {
     worker->sendPacket(data);
     SUCCEED();
 }
+
+/**
+ * @test Verify lifetimes are only accepted on user ports
+ */
+TEST_F(LoRaWorkerEdgeCaseTest, PortLifetimeRejectsReservedPorts) {
+    int errors = 0;
+    QObject::connect(worker, &LoRaWorker::errorOccurred, [&](const QString&) {
+        ++errors;
+    });
+
+    worker->setPortLifetime(LoRaWorker::FILE_PORT, 500);
+    worker->setPortLifetime(LoRaUsbAdapter_E22_400T22U::MAX_PORTS, 500);
+    EXPECT_EQ(errors, 2);
+
+    worker->setPortLifetime(LoRaWorker::FIRST_USER_PORT, 500);
+    EXPECT_EQ(errors, 2);
+}
+
+/**
+ * @test Verify metrics count failed sends and report auto-tuning
+ */
+TEST_F(LoRaWorkerEdgeCaseTest, MetricsCountFailedSends) {
+    EXPECT_EQ(worker->metrics().packetsFailed, 0u);
+    EXPECT_FALSE(worker->metrics().autoTuning);
+
+    // The port is not open
+    worker->sendPacket("data");
+    EXPECT_EQ(worker->metrics().packetsFailed, 1u);
+    EXPECT_EQ(worker->metrics().packetsSent, 0u);
+
+    worker->setAutoTuningEnabled(true);
+    EXPECT_TRUE(worker->metrics().autoTuning);
+    worker->setAutoTuningEnabled(false);
+    EXPECT_FALSE(worker->metrics().autoTuning);
+}
+
+/**
+ * @class LoRaWorkerFileTest
+ * @brief Test suite for LoRaWorker file transfer API
+ */
+class LoRaWorkerFileTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Set up test fixture
+     */
+    void SetUp() override {
+        worker = new LoRaWorker();
+    }
+
+    /**
+     * @brief Tear down test fixture
+     */
+    void TearDown() override {
+        delete worker;
+        worker = nullptr;
+    }
+
+    /**
+     * @brief Pointer to the worker being tested
+     */
+    LoRaWorker* worker;
+};
+
+/**
+ * @test Verify sending a missing file reports an error
+ */
+TEST_F(LoRaWorkerFileTest, SendMissingFileEmitsError) {
+    bool errorReceived = false;
+    QObject::connect(worker, &LoRaWorker::errorOccurred, [&](const QString&) {
+        errorReceived = true;
+    });
+
+    worker->sendFile("/nonexistent/dir/file.bin");
+
+    EXPECT_TRUE(errorReceived);
+}
+
+/**
+ * @test Verify sending a file without an open port reports failure
+ */
+TEST_F(LoRaWorkerFileTest, SendFileOnClosedPortFails) {
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+    file.write(QByteArray(100, 'A'));
+    file.flush();
+
+    bool fileSentReceived = false;
+    bool fileSentResult = true;
+    QObject::connect(worker, &LoRaWorker::fileSent, [&](bool success) {
+        fileSentReceived = true;
+        fileSentResult = success;
+    });
+
+    worker->sendFile(file.fileName());
+
+    EXPECT_TRUE(fileSentReceived);
+    EXPECT_FALSE(fileSentResult);
+}
+
+/**
+ * @test Verify receiving an empty file completes immediately
+ */
+TEST_F(LoRaWorkerFileTest, ReceiveEmptyFileCompletesImmediately) {
+    QTemporaryFile file;
+    ASSERT_TRUE(file.open());
+
+    bool fileReceivedSignal = false;
+    QObject::connect(worker, &LoRaWorker::fileReceived, [&](const QString&, qint64 size) {
+        fileReceivedSignal = true;
+        EXPECT_EQ(size, 0);
+    });
+
+    worker->receiveToFile(file.fileName(), 0);
+
+    EXPECT_TRUE(fileReceivedSignal);
+}
+
+/**
+ * @test Verify cancelFileTransfer is safe when nothing is in progress
+ */
+TEST_F(LoRaWorkerFileTest, CancelWithoutTransferIsSafe) {
+    bool fileSentReceived = false;
+    QObject::connect(worker, &LoRaWorker::fileSent, [&](bool) {
+        fileSentReceived = true;
+    });
+
+    worker->cancelFileTransfer();
+    worker->cancelFileTransfer();
+
+    EXPECT_FALSE(fileSentReceived);
+}
+
+/**
+ * @test Verify file segments are delivered without the decode stage, as they were sent without encoding
+ */
+TEST_F(LoRaWorkerFileTest, FileSegmentsBypassDecodeStage) {
+    worker->setPayloadStages(
+        [](QByteArray &) { return true; },
+        [](QByteArray &data) { data.prepend("decoded "); return true; });
+    QSignalSpy receivedSpy(worker, &LoRaWorker::packetReceived);
+    QSignalSpy portSpy(worker, &LoRaWorker::portPacketReceived);
+    auto receive = [this](const QByteArray &data, quint8 port) {
+        // Stands in for the transport's packetReceived()
+        QMetaObject::invokeMethod(worker, "onPacketReceived", Qt::DirectConnection,
+                                  Q_ARG(QByteArray, data), Q_ARG(quint8, port));
+    };
+
+    // Without a handshake files share DEFAULT_PORT with sendPacket()
+    receive("segment", LoRaWorker::DEFAULT_PORT);
+    receive("segment", LoRaWorker::FILE_PORT);
+    ASSERT_EQ(receivedSpy.count(), 2);
+    EXPECT_EQ(receivedSpy.at(0).at(0).toByteArray(), QByteArray("segment"));
+    EXPECT_EQ(receivedSpy.at(1).at(0).toByteArray(), QByteArray("segment"));
+
+    receive("packet", LoRaWorker::FIRST_USER_PORT);
+    ASSERT_TRUE(portSpy.count() > 0 || portSpy.wait(5000));
+    EXPECT_EQ(portSpy.at(0).at(1).toByteArray(), QByteArray("decoded packet"));
+    EXPECT_EQ(receivedSpy.count(), 2);
+}
@@ -5,6 +5,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <QCoreApplication>
 
 /**
  * @brief Main entry point for the test suite
@@ -13,6 +14,8 @@
  * @return Test result code (0 for success, non-zero for failures)
  */
 int main(int argc, char **argv) {
+    // Serial ports, timers and waitForBytesWritten() need an application object
+    QCoreApplication app(argc, argv);
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }